@@ -16,7 +16,7 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_BFS_BFS_GENERIC_H_
 #define ANALYTICAL_ENGINE_APPS_BFS_BFS_GENERIC_H_
 
-#include <utility>
+#include <string>
 #include <vector>
 
 #include "bfs/bfs_generic_context.h"
@@ -30,6 +30,12 @@ namespace gs {
  * @brief Breadth-first search. The predecessor or successor will be found and
  * hold in the context. The behavior of the algorithm can be controlled by a
  * source vertex and depth limit.
+ *
+ * Each superstep expands the frontier of one depth, either top-down by pushing
+ * along the outgoing edges of the frontier, or bottom-up by letting unvisited
+ * vertices pull from the frontier along their incoming edges. The direction is
+ * chosen by the sizes of the global frontier, and a pull step exchanges the
+ * frontiers of all fragments as bitmaps of gids.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -38,7 +44,7 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
  public:
   INSTALL_DEFAULT_WORKER(BFSGeneric<FRAG_T>, BFSGenericContext<FRAG_T>, FRAG_T)
   static constexpr grape::MessageStrategy message_strategy =
-      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+      grape::MessageStrategy::kAlongEdgeToOuterVertex;
   static constexpr grape::LoadStrategy load_strategy =
       grape::LoadStrategy::kBothOutIn;
   using vertex_t = typename fragment_t::vertex_t;
@@ -46,7 +52,6 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
-    ctx.depth = 0;
     vertex_t source;
     bool native_source = frag.GetInnerVertex(ctx.source_id, source);
 
@@ -54,78 +59,176 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
     ctx.exec_time -= GetCurrentTime();
 #endif
 
+    AllGather(ctx.gid_base, ctx.gid_bases);
+    ctx.depth = 0;
     if (native_source) {
-      ctx.visited[source] = true;
-      ctx.predecessor[source] = frag.Vertex2Gid(source);
-      vertexProcess(source, frag, ctx, messages);
+      visit(source, frag.Vertex2Gid(source), frag, ctx);
     }
+    expand(frag, ctx, messages);
 
 #ifdef PROFILING
     ctx.exec_time += GetCurrentTime();
-    ctx.post_time -= GetCurrentTime();
-#endif
-
-    messages.ForceContinue();
-
-#ifdef PROFILING
-    ctx.post_time += GetCurrentTime();
 #endif
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices();
 #ifdef PROFILING
-    ctx.pre_time -= GetCurrentTime();
+    ctx.preprocess_time -= GetCurrentTime();
 #endif
 
     vid_t msg;
     vertex_t u;
+    if (ctx.syncing_predecessors) {
+      // predecessors of the outer vertices, for finding successors
+      while (messages.GetMessage<fragment_t, vid_t>(frag, u, msg)) {
+        ctx.predecessor[u] = msg;
+      }
+      writeToCtx(frag, ctx);
+      return;
+    }
+    // vertices found by the push step of other fragments
     while (messages.GetMessage<fragment_t, vid_t>(frag, u, msg)) {
-      // Update predecessor of mirror u in this fragment.
-      ctx.visited[u] = true;
-      ctx.predecessor[u] = msg;
-      vid_t u_vid = frag.Vertex2Gid(u);
-      // Iterate and activate all unvisited neighbors.
-      for (auto w : inner_vertices) {
-        if (ctx.visited[w] == false) {
-          auto oes = frag.GetOutgoingAdjList(w);
-          for (auto& e : oes)
-            if (e.get_neighbor() == u) {
-              ctx.visited[w] = true;
-              ctx.predecessor[w] = u_vid;
-              ctx.next_level_inner.push(w);
-            }
-        }
+      if (!ctx.visited[u]) {
+        visit(u, msg, frag, ctx);
       }
     }
-    ctx.curr_level_inner.swap(ctx.next_level_inner);
 
 #ifdef PROFILING
-    ctx.pre_time += GetCurrentTime();
+    ctx.preprocess_time += GetCurrentTime();
     ctx.exec_time -= GetCurrentTime();
 #endif
+
     ctx.depth++;
-    if (ctx.depth < ctx.depth_limit) {
-      while (!ctx.curr_level_inner.empty()) {
-        vertex_t v = ctx.curr_level_inner.front();
-        ctx.curr_level_inner.pop();
-        vertexProcess(v, frag, ctx, messages);
-      }
+    expand(frag, ctx, messages);
 
-      // Make sure IncEval continues when all activated neighbor is local.
-      if (ctx.next_level_inner.empty()) {
-        writeToCtx(frag, ctx);
-      } else {
-        messages.ForceContinue();
-      }
-    }
 #ifdef PROFILING
-    ctx.post_time += GetCurrentTime();
+    ctx.exec_time += GetCurrentTime();
 #endif
   }
 
  private:
+  // Switches to pull when the edges to check from the frontier exceed
+  // 1/alpha of the edges to check from the unvisited vertices, and back to
+  // push when the frontier is less than 1/beta of the vertices.
+  static constexpr size_t alpha = 14;
+  static constexpr size_t beta = 24;
+
+  void visit(vertex_t v, vid_t predecessor, const fragment_t& frag,
+             context_t& ctx) {
+    ctx.visited[v] = true;
+    ctx.predecessor[v] = predecessor;
+    ctx.next_level_inner.push_back(v);
+    ctx.unvisited_edges -= frag.GetLocalInDegree(v);
+  }
+
+  void expand(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    ctx.curr_level_inner.swap(ctx.next_level_inner);
+    ctx.next_level_inner.clear();
+
+    size_t frontier_edges = 0;
+    for (auto v : ctx.curr_level_inner) {
+      frontier_edges += frag.GetLocalOutDegree(v);
+    }
+    size_t frontier_num = ctx.curr_level_inner.size();
+    size_t total_frontier_num, total_frontier_edges, total_unvisited_edges;
+    Sum(frontier_num, total_frontier_num);
+    Sum(frontier_edges, total_frontier_edges);
+    Sum(ctx.unvisited_edges, total_unvisited_edges);
+
+    if (total_frontier_num == 0 || ctx.depth >= ctx.depth_limit) {
+      finish(frag, ctx, messages);
+      return;
+    }
+
+    if (!ctx.pull && total_frontier_edges * alpha > total_unvisited_edges) {
+      ctx.pull = true;
+    } else if (ctx.pull &&
+               total_frontier_num * beta < frag.GetTotalVerticesNum()) {
+      ctx.pull = false;
+    }
+    if (ctx.pull) {
+      pull(frag, ctx);
+    } else {
+      push(frag, ctx, messages);
+    }
+    messages.ForceContinue();
+  }
+
+  void push(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    for (auto v : ctx.curr_level_inner) {
+      vid_t v_vid = frag.Vertex2Gid(v);
+      auto oes = frag.GetOutgoingAdjList(v);
+      for (auto& e : oes) {
+        vertex_t u = e.get_neighbor();
+        if (ctx.visited[u]) {
+          continue;
+        }
+        if (frag.IsOuterVertex(u)) {
+          ctx.visited[u] = true;
+          messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, u, v_vid);
+        } else {
+          visit(u, v_vid, frag, ctx);
+        }
+      }
+    }
+  }
+
+  void pull(const fragment_t& frag, context_t& ctx) {
+    std::vector<uint64_t> bitmap((ctx.gid_num + 63) / 64, 0);
+    for (auto v : ctx.curr_level_inner) {
+      vid_t offset = frag.Vertex2Gid(v) - ctx.gid_base;
+      bitmap[offset / 64] |= static_cast<uint64_t>(1) << (offset % 64);
+    }
+    AllGather(bitmap, ctx.frontier_bitmaps);
+
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      if (ctx.visited[v]) {
+        continue;
+      }
+      auto ies = frag.GetIncomingAdjList(v);
+      for (auto& e : ies) {
+        vertex_t u = e.get_neighbor();
+        vid_t u_vid = frag.Vertex2Gid(u);
+        if (inFrontier(frag.GetFragId(u), u_vid, ctx)) {
+          visit(v, u_vid, frag, ctx);
+          break;
+        }
+      }
+    }
+  }
+
+  bool inFrontier(grape::fid_t fid, vid_t gid, const context_t& ctx) const {
+    auto& bitmap = ctx.frontier_bitmaps[fid];
+    vid_t offset = gid - ctx.gid_bases[fid];
+    return offset / 64 < bitmap.size() &&
+           (bitmap[offset / 64] >> (offset % 64)) & 1;
+  }
+
+  void finish(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    if (ctx.output_format != "successors") {
+      writeToCtx(frag, ctx);
+      return;
+    }
+    // The owner of a vertex decides its predecessor, sync it to the fragments
+    // finding successors along the outgoing edges of their inner vertices,
+    // which are reached through the edges of the vertex as message_strategy
+    // declares.
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      if (ctx.visited[v]) {
+        messages.SendMsgThroughEdges<fragment_t, vid_t>(frag, v,
+                                                        ctx.predecessor[v]);
+      }
+    }
+    ctx.syncing_predecessors = true;
+    messages.ForceContinue();
+  }
+
   void writeToCtx(const fragment_t& frag, context_t& ctx) {
     auto& output_format = ctx.output_format;
     auto inner_vertices = frag.InnerVertices();
@@ -169,29 +272,6 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
     std::vector<size_t> shape{row_num, 2};
     ctx.assign(data, shape);
   }
-
-  void vertexProcess(vertex_t v, const fragment_t& frag, context_t& ctx,
-                     message_manager_t& messages) {
-    vid_t v_vid = frag.Vertex2Gid(v);
-    auto oes = frag.GetOutgoingAdjList(v);
-    bool need_sync = false;
-    for (auto& e : oes) {
-      vertex_t u = e.get_neighbor();
-      if (!frag.IsOuterVertex(u)) {
-        if (ctx.visited[u] == false) {
-          ctx.predecessor[u] = v_vid;
-          ctx.next_level_inner.push(u);
-        }
-      } else {
-        need_sync = true;
-      }
-      ctx.visited[u] = true;
-    }
-    if (need_sync) {
-      messages.SendMsgThroughOEdges<fragment_t, vid_t>(frag, v,
-                                                       ctx.predecessor[v]);
-    }
-  }
 };
 
 }  // namespace gs
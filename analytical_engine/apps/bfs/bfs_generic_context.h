@@ -16,9 +16,10 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_BFS_BFS_GENERIC_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_BFS_BFS_GENERIC_CONTEXT_H_
 
+#include <algorithm>
 #include <limits>
-#include <queue>
 #include <string>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -52,7 +53,24 @@ class BFSGenericContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
     }
 
     visited.Init(vertices, false);
-    predecessor.Init(vertices);
+    predecessor.Init(vertices, std::numeric_limits<vid_t>::max());
+    curr_level_inner.clear();
+    next_level_inner.clear();
+    pull = false;
+    syncing_predecessors = false;
+
+    // inner vertices are indexed by gid - gid_base in the frontier bitmaps
+    auto inner_vertices = frag.InnerVertices();
+    vid_t min_gid = std::numeric_limits<vid_t>::max(), max_gid = 0;
+    unvisited_edges = 0;
+    for (auto v : inner_vertices) {
+      vid_t gid = frag.Vertex2Gid(v);
+      min_gid = std::min(min_gid, gid);
+      max_gid = std::max(max_gid, gid);
+      unvisited_edges += frag.GetLocalInDegree(v);
+    }
+    gid_base = min_gid > max_gid ? 0 : min_gid;
+    gid_num = min_gid > max_gid ? 0 : max_gid - min_gid + 1;
 
 #ifdef PROFILING
     preprocess_time = 0;
@@ -80,12 +98,21 @@ class BFSGenericContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
   oid_t source_id;
   typename FRAG_T::template vertex_array_t<vid_t> predecessor;
   typename FRAG_T::template vertex_array_t<bool> visited;
-  std::queue<vertex_t> curr_level_inner, next_level_inner;
+  std::vector<vertex_t> curr_level_inner, next_level_inner;
 
   int depth_limit;
   std::string output_format;
   int depth;
 
+  // whether the current depth is expanded bottom-up
+  bool pull;
+  // sum of the in-degrees of the unvisited inner vertices
+  size_t unvisited_edges;
+  vid_t gid_base, gid_num;
+  std::vector<vid_t> gid_bases;
+  std::vector<std::vector<uint64_t>> frontier_bitmaps;
+  bool syncing_predecessors;
+
 #ifdef PROFILING
   double preprocess_time = 0;
   double exec_time = 0;
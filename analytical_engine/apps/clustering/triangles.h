@@ -21,6 +21,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "clustering/triangles_context.h"
+#include "core/parallel/message_codec.h"
 
 namespace gs {
 /**
@@ -73,7 +74,8 @@ class Triangles
         int degree = ctx.global_degree[v];
         nbr_vec.reserve(degree);
         auto es = frag.GetOutgoingAdjList(v);
-        std::vector<vid_t> msg_vec;
+        DeltaVarintList<vid_t> msg;
+        auto& msg_vec = msg.values;
         msg_vec.reserve(degree);
         for (auto& e : es) {
           auto u = e.get_neighbor();
@@ -89,17 +91,20 @@ class Triangles
             }
           }
         }
-        messages.SendMsgThroughOEdges<fragment_t, std::vector<vid_t>>(
-            frag, v, msg_vec, tid);
+        // sorted gids are sent as varint deltas
+        msg.Sort();
+        messages.SendMsgThroughOEdges<fragment_t, DeltaVarintList<vid_t>>(
+            frag, v, msg, tid);
       });
       messages.ForceContinue();
     } else if (ctx.stage == 1) {
       ctx.stage = 2;
-      messages.ParallelProcess<fragment_t, std::vector<vid_t>>(
+      messages.ParallelProcess<fragment_t, DeltaVarintList<vid_t>>(
           thread_num(), frag,
-          [&frag, &ctx](int tid, vertex_t u, const std::vector<vid_t>& msg) {
+          [&frag, &ctx](int tid, vertex_t u,
+                        const DeltaVarintList<vid_t>& msg) {
             auto& nbr_vec = ctx.complete_neighbor[u];
-            for (auto gid : msg) {
+            for (auto gid : msg.values) {
               vertex_t v;
               if (frag.Gid2Vertex(gid, v)) {
                 nbr_vec.push_back(v);
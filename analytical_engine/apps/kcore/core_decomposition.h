@@ -0,0 +1,225 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_H_
+#define ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_H_
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "kcore/core_decomposition_context.h"
+
+namespace gs {
+/**
+ * @brief Compute the core number of every vertex, i.e., the largest k such
+ * that the vertex belongs to the k-core.
+ *
+ * Vertices are peeled level by level. At level k, every fragment repeatedly
+ * peels the inner vertices whose remaining degree is at most k, until no such
+ * vertex is left locally, and the degrees of neighbors are decremented
+ * atomically. A vertex joins the bucket of the level exactly once, by the
+ * decrement which brings its degree from above k to k or below. Decrements of
+ * outer vertices are accumulated, and sent once per superstep. Then a single
+ * Min decides the next level: a fragment that sent decrements stays at k,
+ * otherwise it proposes the smallest remaining degree, thus empty levels are
+ * skipped.
+ *
+ * For directed graphs, the degree is the sum of in- and out-degree, as
+ * networkx does.
+ *
+ * @tparam FRAG_T
+ * @tparam CONTEXT_T CoreDecompositionContext or a context deriving from it
+ */
+template <typename FRAG_T,
+          typename CONTEXT_T = CoreDecompositionContext<FRAG_T>>
+class CoreDecomposition : public grape::ParallelAppBase<FRAG_T, CONTEXT_T>,
+                          public grape::ParallelEngine,
+                          public grape::Communicator {
+ public:
+  // the injected class name, a template-id with a comma can not be passed to
+  // the macro
+  INSTALL_PARALLEL_WORKER(CoreDecomposition, CONTEXT_T, FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename FRAG_T::vid_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+
+    messages.InitChannels(thread_num());
+    thread_buckets_.clear();
+    thread_buckets_.resize(thread_num());
+    thread_sent_.clear();
+    thread_sent_.resize(thread_num());
+
+    bool directed = frag.directed();
+    ForEach(inner_vertices, [&frag, &ctx, directed](int tid, vertex_t v) {
+      int degree = frag.GetLocalOutDegree(v);
+      if (directed) {
+        degree += frag.GetLocalInDegree(v);
+      }
+      ctx.degree[v] = degree;
+    });
+    for (auto v : inner_vertices) {
+      ctx.remaining.push_back(v);
+    }
+
+    int local_next = nextLevel(ctx), next;
+    Min(local_next, next);
+    ctx.curr_k = next;
+    if (local_next != next) {
+      ctx.bucket.clear();
+    }
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    int k = ctx.curr_k;
+    messages.ParallelProcess<fragment_t, int>(
+        thread_num(), frag, [&ctx, k, this](int tid, vertex_t v, int msg) {
+          decrease(ctx, v, msg, k, tid);
+        });
+    step(frag, ctx, messages);
+  }
+
+ private:
+  // Decrease the remaining degree of an inner vertex, which joins the bucket
+  // of level k if the degree drops to k or below.
+  inline void decrease(context_t& ctx, vertex_t v, int delta, int k,
+                       int tid) {
+    int old = __atomic_fetch_sub(&ctx.degree[v], delta, __ATOMIC_RELAXED);
+    // degrees of peeled vertices are at most k, thus they never come back
+    if (old > k && old - delta <= k) {
+      thread_buckets_[tid].push_back(v);
+    }
+  }
+
+  // Moves the vertices pushed by threads into the bucket, returns false if
+  // the bucket is empty.
+  bool collectBucket(context_t& ctx) {
+    for (auto& vertices : thread_buckets_) {
+      ctx.bucket.insert(ctx.bucket.end(), vertices.begin(), vertices.end());
+      vertices.clear();
+    }
+    return !ctx.bucket.empty();
+  }
+
+  // Peel inner vertices at curr_k until the degrees of remaining inner
+  // vertices are all larger than curr_k.
+  void peel(const fragment_t& frag, context_t& ctx) {
+    int k = ctx.curr_k;
+    bool directed = frag.directed();
+    while (collectBucket(ctx)) {
+      grape::VertexVector<vid_t> bucket(ctx.bucket);
+      ForEach(bucket, [&frag, &ctx, directed, k, this](int tid, vertex_t u) {
+        ctx.core[u] = k;
+        for (auto& e : frag.GetOutgoingAdjList(u)) {
+          update(frag, ctx, e.get_neighbor(), k, tid);
+        }
+        if (directed) {
+          for (auto& e : frag.GetIncomingAdjList(u)) {
+            update(frag, ctx, e.get_neighbor(), k, tid);
+          }
+        }
+      });
+      ctx.bucket.clear();
+      ++ctx.local_rounds;
+    }
+  }
+
+  inline void update(const fragment_t& frag, context_t& ctx, vertex_t v,
+                     int k, int tid) {
+    if (frag.IsInnerVertex(v)) {
+      decrease(ctx, v, 1, k, tid);
+    } else {
+      __atomic_fetch_add(&ctx.degree[v], 1, __ATOMIC_RELAXED);
+    }
+  }
+
+  // Compacts the remaining vertices, and fills the bucket with the vertices
+  // of the smallest remaining degree, which is returned.
+  int nextLevel(context_t& ctx) {
+    auto& remaining = ctx.remaining;
+    int min_degree = std::numeric_limits<int>::max();
+    size_t size = 0;
+    for (auto v : remaining) {
+      if (ctx.core[v] == context_t::kUnpeeled) {
+        remaining[size++] = v;
+        min_degree = std::min(min_degree, ctx.degree[v]);
+      }
+    }
+    remaining.resize(size);
+    ctx.bucket.clear();
+    for (auto v : remaining) {
+      if (ctx.degree[v] == min_degree) {
+        ctx.bucket.push_back(v);
+      }
+    }
+    return min_degree;
+  }
+
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    auto outer_vertices = frag.OuterVertices();
+    int next = std::numeric_limits<int>::max();
+
+    if (ctx.curr_k <= ctx.max_level) {
+      peel(frag, ctx);
+
+      std::fill(thread_sent_.begin(), thread_sent_.end(), 0);
+      ForEach(outer_vertices, [&frag, &ctx, &messages, this](int tid,
+                                                             vertex_t v) {
+        int delta = ctx.degree[v];
+        if (delta != 0) {
+          messages.SyncStateOnOuterVertex<fragment_t, int>(frag, v, delta,
+                                                           tid);
+          ctx.degree[v] = 0;
+          ++thread_sent_[tid];
+        }
+      });
+      size_t sent = 0;
+      for (auto count : thread_sent_) {
+        sent += count;
+      }
+
+      // receivers may peel more vertices at curr_k
+      int local_next = sent > 0 ? ctx.curr_k : nextLevel(ctx);
+      Min(local_next, next);
+      if (local_next != next) {
+        ctx.bucket.clear();
+      }
+    }
+
+    // all vertices are peeled, or the levels left are not asked for
+    if (next == std::numeric_limits<int>::max() || next > ctx.max_level) {
+      ctx.Finalize();
+      return;
+    }
+    ctx.curr_k = next;
+    messages.ForceContinue();
+  }
+
+  std::vector<std::vector<vertex_t>> thread_buckets_;
+  std::vector<size_t> thread_sent_;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_H_
@@ -0,0 +1,100 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_CONTEXT_H_
+
+#include <limits>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @brief Context of CoreDecomposition. Contexts of apps answering questions
+ * on core numbers, e.g., KCore and KShell, derive from it, limit the peeling
+ * with max_level and hide Finalize to write their own results.
+ *
+ * @tparam FRAG_T
+ * @tparam DATA_T Type of the result of each vertex
+ */
+template <typename FRAG_T, typename DATA_T = int>
+class CoreDecompositionContext
+    : public grape::VertexDataContext<FRAG_T, DATA_T> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  explicit CoreDecompositionContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, DATA_T>(fragment) {}
+
+  void Init(grape::ParallelMessageManager& messages) {
+    auto& frag = this->fragment();
+
+    degree.Init(frag.Vertices(), 0);
+    core.Init(frag.Vertices(), kUnpeeled);
+    remaining.clear();
+    bucket.clear();
+    max_level = std::numeric_limits<int>::max();
+    curr_k = 0;
+    local_rounds = 0;
+  }
+
+  /**
+   * @brief Write the results after the peeling stops.
+   */
+  void Finalize() {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto v : inner_vertices) {
+      this->data()[v] = core[v];
+    }
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << core[v] << '\n';
+    }
+  }
+
+  // the core number of vertices not peeled yet
+  static constexpr int kUnpeeled = -1;
+
+  // remaining degree of inner vertices, and the decrements not sent yet of
+  // outer vertices
+  typename FRAG_T::template vertex_array_t<int> degree;
+  typename FRAG_T::template vertex_array_t<int> core;
+  // inner vertices not peeled yet, compacted once per level
+  std::vector<vertex_t> remaining;
+  // inner vertices to peel at curr_k
+  std::vector<vertex_t> bucket;
+  // levels larger than max_level are not peeled, and the core numbers of
+  // vertices left are kUnpeeled
+  int max_level;
+  int curr_k;
+  size_t local_rounds;
+};
+
+template <typename FRAG_T, typename DATA_T>
+constexpr int CoreDecompositionContext<FRAG_T, DATA_T>::kUnpeeled;
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_CONTEXT_H_
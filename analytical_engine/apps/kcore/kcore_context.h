@@ -16,54 +16,39 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_KCORE_KCORE_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_KCORE_KCORE_CONTEXT_H_
 
-#include <limits>
-#include <map>
-#include <memory>
-#include <queue>
-#include <unordered_set>
-#include <utility>
-
 #include "grape/grape.h"
 
+#include "kcore/core_decomposition_context.h"
+
 namespace gs {
 
 template <typename FRAG_T>
 class KCoreContext
-    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t> {
+    : public CoreDecompositionContext<FRAG_T, typename FRAG_T::oid_t> {
+  using base_t = CoreDecompositionContext<FRAG_T, typename FRAG_T::oid_t>;
+
  public:
   using oid_t = typename FRAG_T::oid_t;
   using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
 
-  explicit KCoreContext(const FRAG_T& fragment)
-      : grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
+  explicit KCoreContext(const FRAG_T& fragment) : base_t(fragment) {}
 
-  typename FRAG_T::template vertex_array_t<std::shared_ptr<std::atomic_int>>
-      degrees;
-  grape::DenseVertexSet<vid_t> to_remove_vertices, remaining_vertices,
-      next_remaining_vertices;
   int k;
-  int curr_k;
 
   void Init(grape::ParallelMessageManager& messages, int k) {
+    base_t::Init(messages);
+    this->k = k;
+    // vertices left after peeling the levels below k form the k-core
+    this->max_level = k - 1;
+  }
+
+  void Finalize() {
     auto& frag = this->fragment();
-    auto vertices = frag.Vertices();
     auto inner_vertices = frag.InnerVertices();
 
-    degrees.Init(vertices);
-    to_remove_vertices.Init(inner_vertices);
-    remaining_vertices.Init(inner_vertices);
-    next_remaining_vertices.Init(inner_vertices);
-    this->k = k;
-    curr_k = 0;
-
-    for (auto& v : vertices) {
-      degrees[v] = std::make_shared<std::atomic_int>(0);
-      if (frag.IsInnerVertex(v)) {
-        remaining_vertices.Insert(v);
-        degrees[v]->store(frag.GetLocalOutDegree(v));
-      } else {
-        degrees[v]->store(0);
-      }
+    for (auto v : inner_vertices) {
+      this->data()[v] = inCore(v) ? 1 : 0;
     }
   }
 
@@ -72,11 +57,14 @@ class KCoreContext
     auto inner_vertices = frag.InnerVertices();
 
     for (auto& v : inner_vertices) {
-      if (remaining_vertices.Exist(v)) {
+      if (inCore(v)) {
         os << frag.GetId(v) << '\n';
       }
     }
   }
+
+ private:
+  bool inCore(vertex_t v) const { return this->core[v] == base_t::kUnpeeled; }
 };
 }  // namespace gs
 
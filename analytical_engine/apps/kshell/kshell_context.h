@@ -16,55 +16,38 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_KSHELL_KSHELL_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_KSHELL_KSHELL_CONTEXT_H_
 
-#include <limits>
-#include <map>
-#include <memory>
-#include <queue>
-#include <unordered_set>
-#include <utility>
-
 #include "grape/grape.h"
 
+#include "kcore/core_decomposition_context.h"
+
 namespace gs {
 
 template <typename FRAG_T>
 class KShellContext
-    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t> {
+    : public CoreDecompositionContext<FRAG_T, typename FRAG_T::oid_t> {
+  using base_t = CoreDecompositionContext<FRAG_T, typename FRAG_T::oid_t>;
+
  public:
   using oid_t = typename FRAG_T::oid_t;
   using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
 
-  explicit KShellContext(const FRAG_T& fragment)
-      : grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
+  explicit KShellContext(const FRAG_T& fragment) : base_t(fragment) {}
 
-  typename FRAG_T::template vertex_array_t<std::shared_ptr<std::atomic_int>>
-      degrees;
-  grape::DenseVertexSet<vid_t> to_remove_vertices_k, to_remove_vertices_inc,
-      remaining_vertices, next_remaining_vertices;
   int k;
-  int curr_k;
 
   void Init(grape::ParallelMessageManager& messages, int k) {
+    base_t::Init(messages);
+    this->k = k;
+    this->max_level = k;
+  }
+
+  void Finalize() {
     auto& frag = this->fragment();
-    auto vertices = frag.Vertices();
     auto inner_vertices = frag.InnerVertices();
 
-    degrees.Init(vertices);
-    to_remove_vertices_k.Init(inner_vertices);
-    to_remove_vertices_inc.Init(inner_vertices);
-    remaining_vertices.Init(inner_vertices);
-    next_remaining_vertices.Init(inner_vertices);
-    this->k = k;
-    curr_k = 0;
-
-    for (auto& v : vertices) {
-      degrees[v] = std::make_shared<std::atomic_int>(0);
-      if (frag.IsInnerVertex(v)) {
-        remaining_vertices.Insert(v);
-        degrees[v]->store(frag.GetLocalOutDegree(v));
-      } else {
-        degrees[v]->store(0);
-      }
+    for (auto v : inner_vertices) {
+      this->data()[v] = inShell(v) ? 1 : 0;
     }
   }
 
@@ -73,11 +56,14 @@ class KShellContext
     auto inner_vertices = frag.InnerVertices();
 
     for (auto& v : inner_vertices) {
-      if (to_remove_vertices_k.Exist(v)) {
+      if (inShell(v)) {
         os << frag.GetId(v) << '\n';
       }
     }
   }
+
+ private:
+  bool inShell(vertex_t v) const { return this->core[v] == k; }
 };
 }  // namespace gs
 
@@ -25,6 +25,7 @@ limitations under the License.
 #include "grape/utils/iterator_pair.h"
 
 #include "core/app/app_base.h"
+#include "core/app/pregel/pregel_communicator.h"
 #include "core/app/pregel/pregel_compute_context.h"
 
 #include "apps/pregel/louvain/auxiliary.h"
@@ -47,7 +48,7 @@ class LouvainAppBase
                                      FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                      typename VERTEX_PROGRAM_T::md_t>>>,
       public grape::ParallelEngine,
-      public grape::Communicator {
+      public PregelCommunicator {
  public:
   using fragment_t = FRAG_T;
   using oid_t = typename FRAG_T::oid_t;
@@ -77,6 +78,7 @@ class LouvainAppBase
     // superstep is 0 in PEval
     uint32_t thrd_num = thread_num();
     messages.InitChannels(thrd_num);
+    ctx.compute_context().set_receiver_num(thrd_num);
 
     // register the aggregators
     ctx.compute_context().register_aggregator(
@@ -119,16 +121,7 @@ class LouvainAppBase
                                       ctx.GetLocalEdgeWeightSum());
       ctx.compute_context().aggregate(actual_quality_aggregator,
                                       ctx.GetLocalQualitySum());
-      for (auto& pair : ctx.compute_context().aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(ctx.compute_context().aggregators());
       ctx.ClearLocalAggregateValues(thrd_num);
     }
 
@@ -183,9 +176,8 @@ class LouvainAppBase
                   for (auto const& msg : buffer[index][tid]) {
                     vertex_t v;
                     frag.InnerVertexGid2Vertex(msg.dst_id, v);
-                    ctx.compute_context().messages_in()[v].emplace_back(
-                        std::move(msg));
-                    ctx.compute_context().activate(v);
+                    ctx.compute_context().receive_message(
+                        v, std::move(msg), static_cast<int>(tid));
                   }
                 }
               },
@@ -194,6 +186,7 @@ class LouvainAppBase
         for (uint32_t tid = 0; tid < thrd_num; ++tid) {
           threads[tid].join();
         }
+        ctx.compute_context().build_inbox();
       }
     }
 
@@ -265,12 +258,8 @@ class LouvainAppBase
         pregel_vertex.set_compute_context(&ctx.compute_context());
         pregel_vertex.set_vertex(v);
         pregel_vertex.set_tid(tid);
-        auto& cur_msgs = (ctx.compute_context().messages_in())[v];
-        this->program_.Compute(
-            grape::IteratorPair<md_t*>(
-                &cur_msgs[0],
-                &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-            pregel_vertex, ctx.compute_context());
+        this->program_.Compute(ctx.compute_context().messages_in(v),
+                               pregel_vertex, ctx.compute_context());
       } else if (ctx.compute_context().superstep() == compress_community_step) {
         ctx.GetVertexState(v).is_alived_community = false;
       }
@@ -284,16 +273,7 @@ class LouvainAppBase
                                       ctx.GetLocalEdgeWeightSum());
       ctx.compute_context().aggregate(actual_quality_aggregator,
                                       ctx.GetLocalQualitySum());
-      for (auto& pair : ctx.compute_context().aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(ctx.compute_context().aggregators());
       ctx.ClearLocalAggregateValues(thrd_num);
     }
 
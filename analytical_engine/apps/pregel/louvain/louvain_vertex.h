@@ -55,7 +55,7 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
   state_t& state() { return context_->GetVertexState(this->vertex_); }
 
   void send_by_gid(vid_t dst_gid, const md_t& md) {
-    this->compute_context_->send_p2p_message(dst_gid, md, tid_);
+    this->compute_context_->send_p2p_message(dst_gid, md, this->tid_);
   }
 
   void set_context(context_t* context) { context_ = context; }
@@ -139,9 +139,6 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
     return context_->GetVertexState(this->vertex_).nodes_in_community;
   }
 
-  int tid() { return tid_; }
-  void set_tid(int id) { tid_ = id; }
-
   PregelComputeContext<fragment_t, VD_T, MD_T>* compute_context() {
     return this->compute_context_;
   }
@@ -150,7 +147,6 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
   context_t* context() { return context_; }
 
  private:
-  int tid_;
   context_t* context_;
 };
 }  // namespace gs
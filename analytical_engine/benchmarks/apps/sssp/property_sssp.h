@@ -85,6 +85,9 @@ class PropertySSSP
   // specialize the templated worker.
   INSTALL_PARALLEL_PROPERTY_WORKER(PropertySSSP<FRAG_T>,
                                    PropertySSSPContext<FRAG_T>, FRAG_T)
+  // the gids of (gid, distance) pairs share the fid and label bits, which are
+  // compressed well
+  static constexpr bool compress_messages = true;
   using vertex_t = typename fragment_t::vertex_t;
 
   void PEval(const fragment_t& frag, context_t& ctx,
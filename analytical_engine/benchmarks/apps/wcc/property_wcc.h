@@ -17,6 +17,7 @@ limitations under the License.
 #define ANALYTICAL_ENGINE_BENCHMARKS_APPS_WCC_PROPERTY_WCC_H_
 
 #include <limits>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -67,6 +68,12 @@ class PropertyWCC
  public:
   INSTALL_PARALLEL_PROPERTY_WORKER(PropertyWCC<FRAG_T>,
                                    PropertyWCCContext<FRAG_T>, FRAG_T)
+  // the (gid, component id) pairs share the fid and label bits, which are
+  // compressed well
+  static constexpr bool compress_messages = true;
+  // labels only decrease, thus they can be received in any order and in any
+  // round, the buffers of other workers are consumed as soon as they arrive
+  static constexpr bool order_insensitive_messages = true;
   using vertex_t = typename fragment_t::vertex_t;
   using vid_t = typename fragment_t::vid_t;
 
@@ -75,9 +82,17 @@ class PropertyWCC
     auto inner_vertices = frag.InnerVertices(0);
     auto outer_vertices = frag.OuterVertices(0);
 
-    // propagate label to incoming and outgoing neighbors
+    // propagate label to incoming and outgoing neighbors, the labels which
+    // arrive in the middle are pushed in the next round
+    std::vector<size_t> pushed(thread_num(), 0);
     ForEach(ctx.curr_modified, inner_vertices,
-            [&frag, &ctx](int tid, vertex_t v) {
+            [&frag, &ctx, &messages, &pushed](int tid, vertex_t v) {
+              if (++pushed[tid] % early_arrival_interval == 0) {
+                messages.ProcessEarlyArrivals<fragment_t, vid_t>(
+                    tid, frag, [&ctx](int, vertex_t u, vid_t msg) {
+                      receive(ctx, ctx.next_modified, u, msg);
+                    });
+              }
               auto cid = ctx.comp_id[v];
               auto es = frag.GetOutgoingAdjList(v, 0);
               for (auto& e : es) {
@@ -159,10 +174,7 @@ class PropertyWCC
     // aggregate messages
     messages.ParallelProcess<fragment_t, vid_t>(
         thread_num(), frag, [&ctx](int tid, vertex_t u, vid_t msg) {
-          if (ctx.comp_id[u] > msg) {
-            grape::atomic_min(ctx.comp_id[u], msg);
-            ctx.curr_modified.Insert(u);
-          }
+          receive(ctx, ctx.curr_modified, u, msg);
         });
 
     PropagateLabelPush(frag, ctx, messages);
@@ -173,6 +185,19 @@ class PropertyWCC
 
     ctx.curr_modified.Swap(ctx.next_modified);
   }
+
+ private:
+  // vertices pushed by a thread between two checks of early arrivals
+  static constexpr size_t early_arrival_interval = 1024;
+
+  static inline void receive(context_t& ctx,
+                             grape::DenseVertexSet<vid_t>& modified,
+                             vertex_t u, vid_t msg) {
+    if (ctx.comp_id[u] > msg) {
+      grape::atomic_min(ctx.comp_id[u], msg);
+      modified.Insert(u);
+    }
+  }
 };
 
 }  // namespace benchmarks
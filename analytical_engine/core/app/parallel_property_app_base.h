@@ -45,6 +45,11 @@ class ParallelPropertyAppBase {
       grape::MessageStrategy::kSyncOnOuterVertex;
   static constexpr grape::LoadStrategy load_strategy =
       grape::LoadStrategy::kOnlyOut;
+  // apps which may process messages in any order and in any round set it to
+  // true, then incoming messages are delivered as soon as they are received
+  static constexpr bool order_insensitive_messages = false;
+  // compress large message buffers sent to other workers
+  static constexpr bool compress_messages = false;
 
   using message_manager_t = ParallelPropertyMessageManager;
 
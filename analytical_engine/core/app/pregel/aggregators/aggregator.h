@@ -84,10 +84,20 @@ class Aggregator : public IAggregator {
     Reset();
   }
 
+  void FromSlot(const AggregatorSlot& slot) override {
+    curr_value_ = slot.Get<AGGR_TYPE>();
+  }
+
   std::shared_ptr<IAggregator> clone() override { return nullptr; }
 
   std::string ToString() override { return std::to_string(curr_value_); }
 
+ protected:
+  bool toSlot(int32_t op, AggregatorSlot& slot) const {
+    slot.Set(op, curr_value_);
+    return true;
+  }
+
  private:
   // The global aggregated value are stored in `last_value_` variable,
   // which can be used in next compute step
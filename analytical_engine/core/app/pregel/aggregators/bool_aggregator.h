@@ -36,6 +36,10 @@ class BoolAndAggregator : public Aggregator<bool> {
   void Init() override { Aggregator<bool>::SetCurrentValue(true); }
 
   void Reset() override { Aggregator<bool>::SetCurrentValue(true); }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<bool>::toSlot(AggregatorSlot::kAnd, slot);
+  }
 };
 
 /**
@@ -52,6 +56,10 @@ class BoolOrAggregator : public Aggregator<bool> {
   void Init() override { Aggregator<bool>::SetCurrentValue(false); }
 
   void Reset() override { Aggregator<bool>::SetCurrentValue(false); }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<bool>::toSlot(AggregatorSlot::kOr, slot);
+  }
 };
 /**
  * @brief Pregel aggregator for bool type. The aggregator only keeps the last
@@ -66,6 +74,10 @@ class BoolOverwriteAggregator : public Aggregator<bool> {
   void Init() override { Aggregator<bool>::SetCurrentValue(false); }
 
   void Reset() override { Aggregator<bool>::SetCurrentValue(false); }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<bool>::toSlot(AggregatorSlot::kOverwrite, slot);
+  }
 };
 
 }  // namespace gs
@@ -45,6 +45,10 @@ class NumericMinAggregator : public Aggregator<AGGR_TYPE> {
     Aggregator<AGGR_TYPE>::SetCurrentValue(
         std::numeric_limits<AGGR_TYPE>::max());
   }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<AGGR_TYPE>::toSlot(AggregatorSlot::kMin, slot);
+  }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. The aggregator
@@ -68,6 +72,10 @@ class NumericMaxAggregator : public Aggregator<AGGR_TYPE> {
     Aggregator<AGGR_TYPE>::SetCurrentValue(
         std::numeric_limits<AGGR_TYPE>::min());
   }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<AGGR_TYPE>::toSlot(AggregatorSlot::kMax, slot);
+  }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. The aggregator
@@ -85,6 +93,10 @@ class NumericSumAggregator : public Aggregator<AGGR_TYPE> {
   void Init() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
 
   void Reset() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<AGGR_TYPE>::toSlot(AggregatorSlot::kSum, slot);
+  }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. The aggregator
@@ -102,6 +114,10 @@ class NumericProductAggregator : public Aggregator<AGGR_TYPE> {
   void Init() override { Aggregator<AGGR_TYPE>::SetCurrentValue(1); }
 
   void Reset() override { Aggregator<AGGR_TYPE>::SetCurrentValue(1); }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<AGGR_TYPE>::toSlot(AggregatorSlot::kProduct, slot);
+  }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. This aggregator only
@@ -118,6 +134,10 @@ class NumericOverwriteAggregator : public Aggregator<AGGR_TYPE> {
   void Init() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
 
   void Reset() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
+
+  bool ToSlot(AggregatorSlot& slot) override {
+    return Aggregator<AGGR_TYPE>::toSlot(AggregatorSlot::kOverwrite, slot);
+  }
 };
 
 }  // namespace gs
@@ -16,8 +16,11 @@
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_I_VERTEX_PROGRAM_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_I_VERTEX_PROGRAM_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "grape/grape.h"
@@ -66,6 +69,52 @@ class ICombinator {
   virtual MD_T CombineMessages(MessageIterator<MD_T> messages) = 0;
 };
 
+/**
+ * @brief AggregatorSlot holds the value of an aggregator in a fixed size,
+ * thus the values of aggregators can be reduced by a single MPI_Allreduce.
+ */
+struct AggregatorSlot {
+  enum Op : int32_t {
+    kMin = 0,
+    kMax = 1,
+    kSum = 2,
+    kProduct = 3,
+    kOverwrite = 4,
+    kAnd = 5,
+    kOr = 6,
+  };
+
+  enum Type : int32_t {
+    kInt64 = 0,
+    kDouble = 1,
+  };
+
+  int32_t op;
+  int32_t type;
+  union {
+    int64_t i;
+    double d;
+  } value;
+
+  template <typename T>
+  void Set(int32_t slot_op, T v) {
+    op = slot_op;
+    if (std::is_floating_point<T>::value) {
+      type = kDouble;
+      value.d = static_cast<double>(v);
+    } else {
+      type = kInt64;
+      value.i = static_cast<int64_t>(v);
+    }
+  }
+
+  template <typename T>
+  T Get() const {
+    return type == kDouble ? static_cast<T>(value.d)
+                           : static_cast<T>(value.i);
+  }
+};
+
 /**
  * @brief Aggregator interface for pregel program
  */
@@ -85,6 +134,13 @@ class IAggregator {
 
   virtual void StartNewRound() = 0;
 
+  // Put the current value into a slot, returns false if the aggregator can not
+  // be reduced in a fixed size slot.
+  virtual bool ToSlot(AggregatorSlot& slot) { return false; }
+
+  // Set the current value as the reduced value in slot.
+  virtual void FromSlot(const AggregatorSlot& slot) {}
+
   virtual std::shared_ptr<IAggregator> clone() = 0;
 
   virtual std::string ToString() { return ""; }
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_APP_BASE_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_APP_BASE_H_
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -24,6 +26,7 @@ limitations under the License.
 #include "grape/utils/iterator_pair.h"
 
 #include "core/app/app_base.h"
+#include "core/app/pregel/pregel_communicator.h"
 #include "core/app/pregel/pregel_compute_context.h"
 #include "core/app/pregel/pregel_context.h"
 
@@ -31,7 +34,10 @@ namespace gs {
 
 /**
  * @brief PregelAppBase is implemented with PIE programming model. The pregel
- * program is driven by the PIE functions.
+ * program is driven by the PIE functions. Vertices are computed by the number
+ * of threads given by the "thread_num" argument (1 by default), in which case
+ * the vertex program must be thread-safe. Messages are received and sent by
+ * the threads of the parallel engine.
  * @tparam FRAG_T
  * @tparam VERTEX_PROGRAM_T
  * @tparam COMBINATOR_T
@@ -39,21 +45,32 @@ namespace gs {
 template <typename FRAG_T, typename VERTEX_PROGRAM_T,
           typename COMBINATOR_T = void>
 class PregelAppBase
-    : public AppBase<
+    : public grape::ParallelAppBase<
           FRAG_T,
           PregelContext<FRAG_T, PregelComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public grape::ParallelEngine,
+      public PregelCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using pregel_compute_context_t = PregelComputeContext<FRAG_T, vd_t, md_t>;
-
-  using app_t = PregelAppBase<FRAG_T, VERTEX_PROGRAM_T>;
   using pregel_context_t = PregelContext<FRAG_T, pregel_compute_context_t>;
-  INSTALL_DEFAULT_WORKER(app_t, pregel_context_t, FRAG_T)
 
  public:
+  using app_t = PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, COMBINATOR_T>;
+  using fragment_t = FRAG_T;
+  using context_t = pregel_context_t;
+  using message_manager_t = grape::ParallelMessageManager;
+  using worker_t = grape::ParallelWorker<app_t>;
+
+  virtual ~PregelAppBase() {}
+
+  static std::shared_ptr<worker_t> CreateWorker(std::shared_ptr<app_t> app,
+                                                std::shared_ptr<FRAG_T> frag) {
+    return std::shared_ptr<worker_t>(new worker_t(app, frag));
+  }
+
   explicit PregelAppBase(const VERTEX_PROGRAM_T& program = VERTEX_PROGRAM_T(),
                          const COMBINATOR_T& combinator = COMBINATOR_T())
       : program_(program), combinator_(combinator) {}
@@ -65,53 +82,39 @@ class PregelAppBase
   void PEval(const fragment_t& frag, pregel_context_t& ctx,
              message_manager_t& messages) {
     // superstep is 0 in PEval
-    ctx.compute_context_.enable_combine();
+    ctx.compute_context_.enable_combine(combinator_);
 
-    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto config = ctx.compute_context_.get_config("thread_num");
+    if (!config.empty()) {
+      ctx.compute_context_.set_thread_num(std::stoi(config));
+    }
+    initChannels(ctx, messages);
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
     grape::IteratorPair<md_t*> null_messages(nullptr, nullptr);
-    auto inner_vertices = frag.InnerVertices();
 
-    for (auto v : inner_vertices) {
+    ctx.compute_context_.foreach_inner_vertex([&](int tid, const vertex_t& v) {
+      auto& pregel_vertex = pregel_vertices[tid];
       pregel_vertex.set_vertex(v);
       program_.Init(pregel_vertex, ctx.compute_context_);
-    }
+    });
 
-    for (auto v : inner_vertices) {
+    ctx.compute_context_.foreach_inner_vertex([&](int tid, const vertex_t& v) {
+      auto& pregel_vertex = pregel_vertices[tid];
       pregel_vertex.set_vertex(v);
       program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-    }
+    });
+    ctx.compute_context_.flush_messages();
 
-    ctx.compute_context_.apply_combine(combinator_);
     ctx.compute_context_.before_comm();
+    sendCombinedMessages(frag, ctx, messages);
 
-    auto outer_vertices = frag.OuterVertices();
-    for (auto v : outer_vertices) {
-      auto& msgs = (ctx.compute_context_.messages_out())[v];
-      assert(msgs.size() <= 1);
-      if (!msgs.empty()) {
-        messages.SyncStateOnOuterVertex<fragment_t, md_t>(frag, v, msgs[0]);
-        msgs.clear();
-      }
-    }
-
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    ctx.compute_context_.merge_aggregators();
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
+
     if (!ctx.compute_context_.all_halted()) {
       messages.ForceContinue();
     }
@@ -120,67 +123,82 @@ class PregelAppBase
   void IncEval(const fragment_t& frag, pregel_context_t& ctx,
                message_manager_t& messages) {
     ctx.compute_context_.inc_step();
-    {
-      // get message
-      vertex_t v(0);
-      md_t msg;
-      while (messages.GetMessage<fragment_t, md_t>(frag, v, msg)) {
-        assert(frag.IsInnerVertex(v));
-        ctx.compute_context_.messages_in[v].emplace_back(std::move(msg));
-      }
-    }
+    receiveMessages(frag, ctx, messages);
 
-    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
-    auto inner_vertices = frag.InnerVertices();
-    for (auto v : inner_vertices) {
+    ctx.compute_context_.foreach_inner_vertex([&](int tid, const vertex_t& v) {
       if (ctx.compute_context_.active(v)) {
+        auto& pregel_vertex = pregel_vertices[tid];
         pregel_vertex.set_vertex(v);
-        auto& cur_msgs = (ctx.compute_context_.messages_in())[v];
-        program_.Compute(
-            grape::IteratorPair<md_t*>(
-                &cur_msgs[0],
-                &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-            pregel_vertex, ctx.compute_context_);
+        program_.Compute(ctx.compute_context_.messages_in(v), pregel_vertex,
+                         ctx.compute_context_);
       }
-    }
+    });
+    ctx.compute_context_.flush_messages();
 
-    ctx.compute_context_.apply_combine(combinator_);
     ctx.compute_context_.before_comm();
+    sendCombinedMessages(frag, ctx, messages);
 
-    auto outer_vertices = frag.OuterVertices();
-    for (auto v : outer_vertices) {
-      auto& msgs = (ctx.compute_context_.messages_out())[v];
-      assert(msgs.size() <= 1);
-      if (!msgs.empty()) {
-        messages.SyncStateOnOuterVertex<fragment_t, md_t>(frag, v, msgs[0]);
-        msgs.clear();
-      }
-    }
-
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    ctx.compute_context_.merge_aggregators();
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
+
     if (!ctx.compute_context_.all_halted()) {
       messages.ForceContinue();
     }
   }
 
  private:
+  // a channel for every thread computing vertices or running in the engine,
+  // the inbox is staged by the threads of the engine
+  void initChannels(pregel_context_t& ctx, message_manager_t& messages) {
+    int engine_thread_num = static_cast<int>(thread_num());
+    messages.InitChannels(
+        std::max(engine_thread_num, ctx.compute_context_.thread_num()));
+    ctx.compute_context_.set_receiver_num(engine_thread_num);
+  }
+
+  // stage the received messages into the inbox in parallel, and build it
+  void receiveMessages(const fragment_t& frag, pregel_context_t& ctx,
+                       message_manager_t& messages) {
+    messages.ParallelProcess<fragment_t, md_t>(
+        static_cast<int>(thread_num()), frag,
+        [&ctx](int tid, vertex_t v, const md_t& msg) {
+          ctx.compute_context_.receive_message(v, msg, tid);
+        });
+    ctx.compute_context_.build_inbox();
+  }
+
+  // send the combined messages to outer vertices through the channels of the
+  // threads of the engine
+  void sendCombinedMessages(const fragment_t& frag, pregel_context_t& ctx,
+                            message_manager_t& messages) {
+    ForEach(frag.OuterVertices(), [&frag, &ctx, &messages](int tid,
+                                                           vertex_t v) {
+      md_t msg;
+      if (ctx.compute_context_.pop_message_out(v, msg)) {
+        messages.Channels()[tid].SyncStateOnOuterVertex<fragment_t, md_t>(
+            frag, v, msg);
+      }
+    });
+  }
+
+  // one PregelVertex per thread, which carries the tid to send messages
+  std::vector<PregelVertex<fragment_t, vd_t, md_t>> makePregelVertices(
+      const fragment_t& frag, pregel_context_t& ctx) {
+    std::vector<PregelVertex<fragment_t, vd_t, md_t>> pregel_vertices(
+        ctx.compute_context_.thread_num());
+    for (size_t tid = 0; tid < pregel_vertices.size(); ++tid) {
+      pregel_vertices[tid].set_fragment(&frag);
+      pregel_vertices[tid].set_compute_context(&ctx.compute_context_);
+      pregel_vertices[tid].set_tid(static_cast<int>(tid));
+    }
+    return pregel_vertices;
+  }
+
   VERTEX_PROGRAM_T program_;
   COMBINATOR_T combinator_;
 };
@@ -191,21 +209,32 @@ class PregelAppBase
  */
 template <typename FRAG_T, typename VERTEX_PROGRAM_T>
 class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
-    : public AppBase<
+    : public grape::ParallelAppBase<
           FRAG_T,
           PregelContext<FRAG_T, PregelComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public grape::ParallelEngine,
+      public PregelCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
-  using app_t = PregelAppBase<FRAG_T, VERTEX_PROGRAM_T>;
   using pregel_compute_context_t = PregelComputeContext<FRAG_T, vd_t, md_t>;
   using pregel_context_t = PregelContext<FRAG_T, pregel_compute_context_t>;
 
-  INSTALL_DEFAULT_WORKER(app_t, pregel_context_t, FRAG_T)
-
  public:
+  using app_t = PregelAppBase<FRAG_T, VERTEX_PROGRAM_T>;
+  using fragment_t = FRAG_T;
+  using context_t = pregel_context_t;
+  using message_manager_t = grape::ParallelMessageManager;
+  using worker_t = grape::ParallelWorker<app_t>;
+
+  virtual ~PregelAppBase() {}
+
+  static std::shared_ptr<worker_t> CreateWorker(std::shared_ptr<app_t> app,
+                                                std::shared_ptr<FRAG_T> frag) {
+    return std::shared_ptr<worker_t>(new worker_t(app, frag));
+  }
+
   explicit PregelAppBase(const VERTEX_PROGRAM_T& program = VERTEX_PROGRAM_T())
       : program_(program) {}
 
@@ -217,37 +246,31 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
              message_manager_t& messages) {
     // superstep is 0 in PEval
 
-    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto config = ctx.compute_context_.get_config("thread_num");
+    if (!config.empty()) {
+      ctx.compute_context_.set_thread_num(std::stoi(config));
+    }
+    initChannels(ctx, messages);
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
     grape::IteratorPair<md_t*> null_messages(nullptr, nullptr);
 
-    auto inner_vertices = frag.InnerVertices();
-
-    for (auto v : inner_vertices) {
+    ctx.compute_context_.foreach_inner_vertex([&](int tid, const vertex_t& v) {
+      auto& pregel_vertex = pregel_vertices[tid];
       pregel_vertex.set_vertex(v);
       program_.Init(pregel_vertex, ctx.compute_context_);
-    }
+    });
 
-    for (auto v : inner_vertices) {
+    ctx.compute_context_.foreach_inner_vertex([&](int tid, const vertex_t& v) {
+      auto& pregel_vertex = pregel_vertices[tid];
       pregel_vertex.set_vertex(v);
       program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-    }
+    });
+    ctx.compute_context_.flush_messages();
 
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    ctx.compute_context_.merge_aggregators();
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
 
@@ -259,46 +282,23 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
   void IncEval(const fragment_t& frag, pregel_context_t& ctx,
                message_manager_t& messages) {
     ctx.compute_context_.inc_step();
-    {
-      // get message
-      vertex_t v(0);
-      md_t msg;
-      while (messages.GetMessage<fragment_t, md_t>(frag, v, msg)) {
-        assert(frag.IsInnerVertex(v));
-        ctx.compute_context_.messages_in()[v].emplace_back(std::move(msg));
-      }
-    }
+    receiveMessages(frag, ctx, messages);
 
-    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
-    auto inner_vertices = frag.InnerVertices();
-    for (auto v : inner_vertices) {
+    ctx.compute_context_.foreach_inner_vertex([&](int tid, const vertex_t& v) {
       if (ctx.compute_context_.active(v)) {
+        auto& pregel_vertex = pregel_vertices[tid];
         pregel_vertex.set_vertex(v);
-        auto& cur_msgs = (ctx.compute_context_.messages_in())[v];
-        program_.Compute(
-            grape::IteratorPair<md_t*>(
-                &cur_msgs[0],
-                &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-            pregel_vertex, ctx.compute_context_);
+        program_.Compute(ctx.compute_context_.messages_in(v), pregel_vertex,
+                         ctx.compute_context_);
       }
-    }
+    });
+    ctx.compute_context_.flush_messages();
 
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    ctx.compute_context_.merge_aggregators();
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
 
@@ -308,6 +308,39 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
   }
 
  private:
+  // a channel for every thread computing vertices or running in the engine,
+  // the inbox is staged by the threads of the engine
+  void initChannels(pregel_context_t& ctx, message_manager_t& messages) {
+    int engine_thread_num = static_cast<int>(thread_num());
+    messages.InitChannels(
+        std::max(engine_thread_num, ctx.compute_context_.thread_num()));
+    ctx.compute_context_.set_receiver_num(engine_thread_num);
+  }
+
+  // stage the received messages into the inbox in parallel, and build it
+  void receiveMessages(const fragment_t& frag, pregel_context_t& ctx,
+                       message_manager_t& messages) {
+    messages.ParallelProcess<fragment_t, md_t>(
+        static_cast<int>(thread_num()), frag,
+        [&ctx](int tid, vertex_t v, const md_t& msg) {
+          ctx.compute_context_.receive_message(v, msg, tid);
+        });
+    ctx.compute_context_.build_inbox();
+  }
+
+  // one PregelVertex per thread, which carries the tid to send messages
+  std::vector<PregelVertex<fragment_t, vd_t, md_t>> makePregelVertices(
+      const fragment_t& frag, pregel_context_t& ctx) {
+    std::vector<PregelVertex<fragment_t, vd_t, md_t>> pregel_vertices(
+        ctx.compute_context_.thread_num());
+    for (size_t tid = 0; tid < pregel_vertices.size(); ++tid) {
+      pregel_vertices[tid].set_fragment(&frag);
+      pregel_vertices[tid].set_compute_context(&ctx.compute_context_);
+      pregel_vertices[tid].set_tid(static_cast<int>(tid));
+    }
+    return pregel_vertices;
+  }
+
   VERTEX_PROGRAM_T program_;
 };
 
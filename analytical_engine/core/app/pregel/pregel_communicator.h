@@ -0,0 +1,193 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_COMMUNICATOR_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_COMMUNICATOR_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/communication/communicator.h"
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+
+#include "core/app/pregel/i_vertex_program.h"
+
+namespace gs {
+
+namespace pregel_impl {
+
+template <typename T>
+inline T reduce_slot_value(int32_t op, T lhs, T rhs) {
+  switch (op) {
+  case AggregatorSlot::kMin:
+    return std::min(lhs, rhs);
+  case AggregatorSlot::kMax:
+    return std::max(lhs, rhs);
+  case AggregatorSlot::kSum:
+    return lhs + rhs;
+  case AggregatorSlot::kProduct:
+    return lhs * rhs;
+  case AggregatorSlot::kAnd:
+    return static_cast<T>(lhs && rhs);
+  case AggregatorSlot::kOr:
+    return static_cast<T>(lhs || rhs);
+  default:
+    // kOverwrite keeps the value of the latter worker
+    return rhs;
+  }
+}
+
+// MPI_User_function for the slots, inout = in op inout
+inline void reduce_slots(void* in, void* inout, int* len, MPI_Datatype*) {
+  auto* lhs = static_cast<const AggregatorSlot*>(in);
+  auto* rhs = static_cast<AggregatorSlot*>(inout);
+  for (int i = 0; i < *len; ++i) {
+    if (rhs[i].type == AggregatorSlot::kDouble) {
+      rhs[i].value.d =
+          reduce_slot_value(rhs[i].op, lhs[i].value.d, rhs[i].value.d);
+    } else {
+      rhs[i].value.i =
+          reduce_slot_value(rhs[i].op, lhs[i].value.i, rhs[i].value.i);
+    }
+  }
+}
+
+}  // namespace pregel_impl
+
+/**
+ * @brief PregelCommunicator synchronizes all registered aggregators with a
+ * single collective per superstep. When every aggregator fits in an
+ * AggregatorSlot, the slots are reduced by MPI_Allreduce. Otherwise, the
+ * aggregators are packed into one archive and gathered at once.
+ */
+class PregelCommunicator : public grape::Communicator {
+ public:
+  PregelCommunicator()
+      : aggregator_comm_(MPI_COMM_NULL),
+        slot_type_(MPI_DATATYPE_NULL),
+        slot_op_(MPI_OP_NULL) {}
+
+  ~PregelCommunicator() {
+    // the app may outlive MPI_Finalize, e.g., when it is held by a static,
+    // and freeing handles after that is erroneous
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (finalized) {
+      return;
+    }
+    if (slot_op_ != MPI_OP_NULL) {
+      MPI_Op_free(&slot_op_);
+    }
+    if (slot_type_ != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&slot_type_);
+    }
+    if (aggregator_comm_ != MPI_COMM_NULL) {
+      MPI_Comm_free(&aggregator_comm_);
+    }
+  }
+
+  // hides grape::Communicator::InitCommunicator, which is invoked by workers
+  void InitCommunicator(MPI_Comm comm) {
+    grape::Communicator::InitCommunicator(comm);
+    MPI_Comm_dup(comm, &aggregator_comm_);
+    MPI_Type_contiguous(sizeof(AggregatorSlot), MPI_BYTE, &slot_type_);
+    MPI_Type_commit(&slot_type_);
+    // not commutative, thus overwrite aggregators keep the value of the last
+    // worker, the same as aggregating the gathered values in order
+    MPI_Op_create(&pregel_impl::reduce_slots, 0, &slot_op_);
+  }
+
+  void SyncAggregators(
+      std::unordered_map<std::string, std::shared_ptr<IAggregator>>&
+          aggregators) {
+    if (aggregators.empty()) {
+      return;
+    }
+    // every worker registers the same aggregators, sort them by name to agree
+    // on the layout
+    std::vector<IAggregator*> sorted;
+    {
+      std::vector<std::pair<std::string, IAggregator*>> named;
+      named.reserve(aggregators.size());
+      for (auto& pair : aggregators) {
+        named.emplace_back(pair.first, pair.second.get());
+      }
+      std::sort(named.begin(), named.end());
+      for (auto& pair : named) {
+        sorted.push_back(pair.second);
+      }
+    }
+
+    std::vector<AggregatorSlot> slots(sorted.size());
+    bool reducible = true;
+    for (size_t i = 0; i < sorted.size() && reducible; ++i) {
+      reducible = sorted[i]->ToSlot(slots[i]);
+    }
+
+    if (reducible) {
+      CHECK(aggregator_comm_ != MPI_COMM_NULL);
+      MPI_Allreduce(MPI_IN_PLACE, slots.data(), static_cast<int>(slots.size()),
+                    slot_type_, slot_op_, aggregator_comm_);
+      for (size_t i = 0; i < sorted.size(); ++i) {
+        sorted[i]->FromSlot(slots[i]);
+        sorted[i]->StartNewRound();
+      }
+      return;
+    }
+
+    grape::InArchive iarc;
+    for (auto* aggregator : sorted) {
+      grape::InArchive sub;
+      aggregator->Serialize(sub);
+      aggregator->Reset();
+      iarc << sub.GetSize();
+      iarc.AddBytes(sub.GetBuffer(), sub.GetSize());
+    }
+    std::vector<grape::InArchive> iarcs;
+    AllGather(std::move(iarc), iarcs);
+    for (auto& arc : iarcs) {
+      grape::OutArchive oarc(std::move(arc));
+      for (auto* aggregator : sorted) {
+        size_t size;
+        oarc >> size;
+        auto* buf = static_cast<char*>(const_cast<void*>(oarc.GetBytes(size)));
+        grape::OutArchive slice;
+        slice.SetSlice(buf, size);
+        aggregator->DeserializeAndAggregate(slice);
+      }
+    }
+    for (auto* aggregator : sorted) {
+      aggregator->StartNewRound();
+    }
+  }
+
+ private:
+  MPI_Comm aggregator_comm_;
+  MPI_Datatype slot_type_;
+  MPI_Op slot_op_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_COMMUNICATOR_H_
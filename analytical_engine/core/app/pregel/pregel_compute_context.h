@@ -18,8 +18,12 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -29,6 +33,7 @@ limitations under the License.
 
 #include "core/app/pregel/aggregators/aggregator.h"
 #include "core/app/pregel/aggregators/aggregator_factory.h"
+#include "core/app/pregel/pregel_message_store.h"
 #include "core/app/pregel/pregel_vertex.h"
 #include "core/config.h"
 
@@ -59,17 +64,117 @@ class PregelComputeContext {
     auto vertices = frag.Vertices();
     auto inner_vertices = frag.InnerVertices();
 
-    messages_out_.Init(vertices, {});
     total_vertex_num_ = vertices.size();
 
-    messages_in_.Init(inner_vertices, {});
     halted_.Init(inner_vertices, false);
     vid_parser_.Init(frag.fnum(), 1);
     inner_vertex_num_ = inner_vertices.size();
 
+    inner_vertex_list_.clear();
+    inner_vertex_list_.reserve(inner_vertex_num_);
+    for (auto v : inner_vertices) {
+      inner_vertex_list_.push_back(v);
+    }
+    max_vertex_value_ = 0;
+    for (auto v : vertices) {
+      max_vertex_value_ = std::max(max_vertex_value_, v.GetValue() + 1);
+    }
+    vid_t max_inner_vertex_value = 0;
+    for (auto v : inner_vertices) {
+      max_inner_vertex_value =
+          std::max(max_inner_vertex_value, v.GetValue() + 1);
+    }
+    messages_in_.Init(max_inner_vertex_value, 1);
+
     step_ = 0;
     voted_to_halt_num_ = 0;
     enable_combine_ = false;
+    set_thread_num(1);
+  }
+
+  /**
+   * @brief Set the number of threads to run the vertex program. With more
+   * than one thread, the vertex program must only modify the vertex it is
+   * computing. Messages are buffered in per-thread outboxes which are
+   * bucketed by the destination, and merged by flush_messages().
+   */
+  void set_thread_num(int thread_num) {
+    thread_num_ = std::max(thread_num, 1);
+    bucket_size_ = std::max<size_t>(
+        (max_vertex_value_ + thread_num_ - 1) / thread_num_, 1);
+    messages_in_.SetWriterNum(thread_num_);
+    outboxes_.clear();
+    local_aggregators_.clear();
+    if (thread_num_ > 1) {
+      outboxes_.resize(thread_num_);
+      for (auto& buckets : outboxes_) {
+        buckets.resize(thread_num_);
+      }
+      local_aggregators_.resize(thread_num_);
+      for (auto& pair : aggregator_types_) {
+        addLocalAggregators(pair.first, pair.second);
+      }
+    }
+  }
+
+  int thread_num() const { return thread_num_; }
+
+  /**
+   * @brief Apply func(tid, v) to every inner vertex. Inner vertices are split
+   * into chunks claimed by threads dynamically, which balances vertices with
+   * skewed degrees.
+   */
+  template <typename FUNC_T>
+  void foreach_inner_vertex(const FUNC_T& func) {
+    static constexpr size_t kChunkSize = 1024;
+    if (thread_num_ <= 1) {
+      for (auto v : inner_vertex_list_) {
+        func(0, v);
+      }
+      return;
+    }
+    std::atomic<size_t> current(0);
+    size_t vnum = inner_vertex_list_.size();
+    runThreads([&](int tid) {
+      while (true) {
+        size_t begin = current.fetch_add(kChunkSize, std::memory_order_relaxed);
+        if (begin >= vnum) {
+          break;
+        }
+        size_t end = std::min(begin + kChunkSize, vnum);
+        for (size_t i = begin; i < end; ++i) {
+          func(tid, inner_vertex_list_[i]);
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Move the messages buffered by threads to the outgoing slots or the
+   * inbox of the next superstep. Each thread merges one bucket of
+   * destinations, thus no lock is needed. Messages to outer vertices without
+   * combining are sent through the channel of the merging thread.
+   */
+  void flush_messages() {
+    if (thread_num_ <= 1) {
+      return;
+    }
+    runThreads([&](int bucket) {
+      for (auto& buckets : outboxes_) {
+        for (auto& msg : buckets[bucket]) {
+          if (enable_combine_) {
+            combined_out_.Put(msg.first.GetValue(), std::move(msg.second),
+                              combine_);
+          } else if (fragment_->IsOuterVertex(msg.first)) {
+            syncStateOnOuterVertex(bucket, msg.first, msg.second);
+          } else {
+            messages_in_.Add(bucket, msg.first.GetValue(),
+                             std::move(msg.second));
+          }
+        }
+        buckets[bucket].clear();
+      }
+    });
   }
 
   void inc_step() { step_++; }
@@ -90,28 +195,34 @@ class PregelComputeContext {
     return vertex_data_[v.vertex()];
   }
 
-  void send_message(const vertex_t& v, const MD_T& value) {
+  void send_message(const vertex_t& v, const MD_T& value, int tid = 0) {
+    if (thread_num_ > 1) {
+      outboxes_[tid][bucketOf(v)].emplace_back(v, value);
+      return;
+    }
     if (enable_combine_) {
-      messages_out_[v].emplace_back(value);
+      combined_out_.Put(v.GetValue(), MD_T(value), combine_);
     } else {
       if (fragment_->IsOuterVertex(v)) {
-        message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
-                                                                   v, value);
+        syncStateOnOuterVertex(tid, v, value);
       } else {
-        messages_out_[v].emplace_back(value);
+        messages_in_.Add(0, v.GetValue(), value);
       }
     }
   }
 
-  void send_message(const vertex_t& v, MD_T&& value) {
+  void send_message(const vertex_t& v, MD_T&& value, int tid = 0) {
+    if (thread_num_ > 1) {
+      outboxes_[tid][bucketOf(v)].emplace_back(v, std::move(value));
+      return;
+    }
     if (enable_combine_) {
-      messages_out_[v].emplace_back(std::move(value));
+      combined_out_.Put(v.GetValue(), std::move(value), combine_);
     } else {
       if (fragment_->IsOuterVertex(v)) {
-        message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
-                                                                   v, value);
+        syncStateOnOuterVertex(tid, v, value);
       } else {
-        messages_out_[v].emplace_back(std::move(value));
+        messages_in_.Add(0, v.GetValue(), std::move(value));
       }
     }
   }
@@ -126,27 +237,50 @@ class PregelComputeContext {
     parallel_message_manager_->Channels()[tid].SendToFragment(fid, value);
   }
 
-  template <typename COMBINATOR_T>
-  void apply_combine(COMBINATOR_T& cb) {
-    auto vertices = fragment_->Vertices();
-    for (auto v : vertices) {
-      auto& msgs = messages_out_[v];
-      if (!msgs.empty()) {
-        MD_T ret = cb.CombineMessages(grape::IteratorPair<MD_T*>(
-            &msgs[0], &msgs[0] + static_cast<ptrdiff_t>(msgs.size())));
-        msgs.clear();
-        msgs.emplace_back(std::move(ret));
-      }
-    }
+  // allow receive_message to be called by thread_num threads concurrently
+  void set_receiver_num(int thread_num) {
+    receiver_num_ = std::max(thread_num, 1);
+    messages_in_.SetWriterNum(receiver_num_);
+  }
+
+  /**
+   * @brief Receive a message for an inner vertex, which is visible after
+   * build_inbox(). Each tid must be used by a single thread at a time.
+   */
+  void receive_message(const vertex_t& v, MD_T&& value, int tid = 0) {
+    messages_in_.Add(tid, v.GetValue(), std::move(value));
+  }
+
+  void receive_message(const vertex_t& v, const MD_T& value, int tid = 0) {
+    messages_in_.Add(tid, v.GetValue(), value);
+  }
+
+  /**
+   * @brief Gather the received messages into the inbox in CSR, and activate
+   * the vertices which receive messages. The inbox is built by the threads
+   * computing vertices or receiving messages, whichever is more.
+   */
+  void build_inbox() {
+    messages_in_.Build(std::max(thread_num_, receiver_num_),
+                       [this](size_t idx) { activate(vertex_t(idx)); });
+  }
+
+  // messages received by an inner vertex in this superstep
+  grape::IteratorPair<MD_T*> messages_in(const vertex_t& v) {
+    return messages_in_.Get(v.GetValue());
+  }
+
+  // take the combined message to an outer vertex
+  bool pop_message_out(const vertex_t& v, MD_T& value) {
+    return combined_out_.Take(v.GetValue(), value);
   }
 
+  // move the combined messages of inner vertices to the inbox
   void before_comm() {
-    auto inner_vertices = fragment_->InnerVertices();
-    for (auto v : inner_vertices) {
-      messages_in_[v].clear();
-      messages_in_[v].swap(messages_out_[v]);
-      if (!messages_in_[v].empty()) {
-        activate(v);
+    MD_T msg;
+    for (auto v : inner_vertex_list_) {
+      if (combined_out_.Take(v.GetValue(), msg)) {
+        messages_in_.Add(0, v.GetValue(), std::move(msg));
       }
     }
   }
@@ -175,36 +309,31 @@ class PregelComputeContext {
     return true;
   }
 
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>>& messages_in() {
-    return messages_in_;
-  }
-
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>>& messages_out() {
-    return messages_out_;
-  }
-
   typename FRAG_T::template vertex_array_t<VD_T>& vertex_data() {
     return vertex_data_;
   }
+  // drop the consumed messages, vertices with pending messages are activated
   void clear_for_next_round() {
-    if (!enable_combine_) {
-      auto inner_vertices = fragment_->InnerVertices();
-      for (auto v : inner_vertices) {
-        messages_in_[v].clear();
-        messages_in_[v].swap(messages_out_[v]);
-        if (!messages_in_[v].empty()) {
-          activate(v);
-        }
-      }
-    }
+    messages_in_.Clear();
+    messages_in_.ForEachStaged([this](size_t idx) { activate(vertex_t(idx)); });
   }
 
-  void enable_combine() { enable_combine_ = true; }
-  void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
-  void set_message_manager(grape::DefaultMessageManager* message_manager) {
-    message_manager_ = message_manager;
+  /**
+   * @brief Combine the messages to the same vertex when they are sent, every
+   * vertex keeps a single message slot.
+   */
+  template <typename COMBINATOR_T>
+  void enable_combine(COMBINATOR_T& cb) {
+    enable_combine_ = true;
+    combined_out_.Init(max_vertex_value_);
+    combine_ = [&cb](MD_T& lhs, MD_T&& rhs) {
+      MD_T msgs[2] = {std::move(lhs), std::move(rhs)};
+      lhs = cb.CombineMessages(grape::IteratorPair<MD_T*>(msgs, msgs + 2));
+    };
   }
 
+  void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
+
   void set_parallel_message_manager(
       grape::ParallelMessageManager* message_manager) {
     parallel_message_manager_ = message_manager;
@@ -235,17 +364,55 @@ class PregelComputeContext {
     if (aggregators_.find(name) == aggregators_.end()) {
       aggregators_.emplace(name, AggregatorFactory::CreateAggregator(type));
       aggregators_.at(name)->Init();
+      aggregator_types_.emplace(name, type);
+      if (thread_num_ > 1) {
+        addLocalAggregators(name, type);
+      }
     }
   }
 
+  /**
+   * @brief Aggregate a value. With more than one thread, values are
+   * aggregated into the partial of the computing thread, which is merged by
+   * merge_aggregators().
+   */
   template <typename AGGR_TYPE>
   void aggregate(const std::string& name, AGGR_TYPE value) {
-    if (aggregators_.find(name) != aggregators_.end()) {
+    if (aggregators_.find(name) == aggregators_.end()) {
+      return;
+    }
+    if (thread_num_ > 1) {
+      auto& local = local_aggregators_[currentTid()].at(name);
+      std::dynamic_pointer_cast<Aggregator<AGGR_TYPE>>(local.aggregator)
+          ->Aggregate(value);
+      local.updated = true;
+    } else {
       std::dynamic_pointer_cast<Aggregator<AGGR_TYPE>>(aggregators_.at(name))
           ->Aggregate(value);
     }
   }
 
+  /**
+   * @brief Merge the partials of threads into the aggregators, which must be
+   * called before the aggregators are synced.
+   */
+  void merge_aggregators() {
+    for (auto& locals : local_aggregators_) {
+      for (auto& pair : locals) {
+        auto& local = pair.second;
+        if (!local.updated) {
+          continue;
+        }
+        grape::InArchive iarc;
+        local.aggregator->Serialize(iarc);
+        grape::OutArchive oarc(std::move(iarc));
+        aggregators_.at(pair.first)->DeserializeAndAggregate(oarc);
+        local.aggregator->Reset();
+        local.updated = false;
+      }
+    }
+  }
+
   template <typename AGGR_TYPE>
   AGGR_TYPE get_aggregated_value(const std::string& name) {
     return std::dynamic_pointer_cast<Aggregator<AGGR_TYPE>>(
@@ -254,8 +421,53 @@ class PregelComputeContext {
   }
 
  private:
+  inline size_t bucketOf(const vertex_t& v) const {
+    return std::min(static_cast<size_t>(v.GetValue() / bucket_size_),
+                    static_cast<size_t>(thread_num_ - 1));
+  }
+
+  template <typename FUNC_T>
+  void runThreads(const FUNC_T& func) {
+    std::vector<std::thread> threads(thread_num_);
+    for (int tid = 0; tid < thread_num_; ++tid) {
+      threads[tid] = std::thread([&func, tid]() {
+        currentTid() = tid;
+        func(tid);
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  // the tid of the thread computing vertices, 0 out of runThreads
+  static int& currentTid() {
+    static thread_local int tid = 0;
+    return tid;
+  }
+
+  inline void syncStateOnOuterVertex(int tid, const vertex_t& v,
+                                     const MD_T& value) {
+    parallel_message_manager_->Channels()[tid]
+        .SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_, v, value);
+  }
+
+  void addLocalAggregators(const std::string& name,
+                           PregelAggregatorType type) {
+    for (auto& locals : local_aggregators_) {
+      LocalAggregator local;
+      local.aggregator = AggregatorFactory::CreateAggregator(type);
+      local.aggregator->Init();
+      locals.emplace(name, std::move(local));
+    }
+  }
+
+  struct LocalAggregator {
+    std::shared_ptr<IAggregator> aggregator;
+    bool updated = false;
+  };
+
   const fragment_t* fragment_;
-  grape::DefaultMessageManager* message_manager_;
   grape::ParallelMessageManager* parallel_message_manager_;
 
   typename FRAG_T::template vertex_array_t<VD_T>& vertex_data_;
@@ -263,8 +475,11 @@ class PregelComputeContext {
   size_t voted_to_halt_num_;
   typename FRAG_T::template vertex_array_t<bool> halted_;
 
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>> messages_out_;
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>> messages_in_;
+  // messages to inner vertices, staged messages are for the next superstep
+  MessageInbox<MD_T> messages_in_;
+  // outgoing messages in the combining mode, indexed by vertex
+  CombinedMessageSlots<MD_T> combined_out_;
+  std::function<void(MD_T&, MD_T&&)> combine_;
 
   size_t inner_vertex_num_;
   size_t total_vertex_num_;
@@ -274,7 +489,19 @@ class PregelComputeContext {
   int step_;
   std::unordered_map<std::string, std::string> config_;
   std::unordered_map<std::string, std::shared_ptr<IAggregator>> aggregators_;
+  std::unordered_map<std::string, PregelAggregatorType> aggregator_types_;
   vineyard::IdParser<vid_t> vid_parser_;
+
+  int thread_num_ = 1;
+  int receiver_num_ = 1;
+  size_t bucket_size_ = 1;
+  vid_t max_vertex_value_{};
+  std::vector<vertex_t> inner_vertex_list_;
+  // outboxes_[tid][bucket] buffers messages sent by thread tid
+  std::vector<std::vector<std::vector<std::pair<vertex_t, MD_T>>>> outboxes_;
+  // local_aggregators_[tid] holds the partials of aggregators of thread tid
+  std::vector<std::unordered_map<std::string, LocalAggregator>>
+      local_aggregators_;
 };
 
 }  // namespace gs
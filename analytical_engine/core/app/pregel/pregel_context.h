@@ -48,12 +48,12 @@ class PregelContext
             fragment),
         compute_context_(this->data()) {}
 
-  void Init(grape::DefaultMessageManager& messages, const std::string& args) {
+  void Init(grape::ParallelMessageManager& messages, const std::string& args) {
     auto& frag = this->fragment();
 
     compute_context_.init(frag);
     compute_context_.set_fragment(&frag);
-    compute_context_.set_message_manager(&messages);
+    compute_context_.set_parallel_message_manager(&messages);
 
     if (!args.empty()) {
       // The app params are passed via serialized json string.
@@ -0,0 +1,249 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_MESSAGE_STORE_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_MESSAGE_STORE_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "grape/utils/iterator_pair.h"
+
+namespace gs {
+
+/**
+ * @brief MessageInbox stores the messages received by vertices in CSR.
+ * Writers stage messages as (index, message) pairs, then Build() counts the
+ * messages of each vertex, computes the prefix sum and scatters the messages
+ * into one contiguous array. All buffers are reused across supersteps, thus
+ * supersteps do not allocate once the buffers are warmed up.
+ *
+ * @tparam MD_T Message type
+ */
+template <typename MD_T>
+class MessageInbox {
+ public:
+  MessageInbox() = default;
+
+  void Init(size_t vnum, int writer_num) {
+    offsets_.clear();
+    offsets_.resize(vnum + 1, 0);
+    cursors_.clear();
+    messages_.clear();
+    staging_.clear();
+    staging_.resize(std::max(writer_num, 1));
+  }
+
+  // Each writer must be used by a single thread at a time.
+  void SetWriterNum(int writer_num) {
+    if (static_cast<size_t>(writer_num) > staging_.size()) {
+      staging_.resize(writer_num);
+    }
+  }
+
+  inline void Add(int writer, size_t idx, const MD_T& msg) {
+    staging_[writer].emplace_back(idx, msg);
+  }
+
+  inline void Add(int writer, size_t idx, MD_T&& msg) {
+    staging_[writer].emplace_back(idx, std::move(msg));
+  }
+
+  /**
+   * @brief Apply func(idx) to the index of every staged message.
+   */
+  template <typename FUNC_T>
+  void ForEachStaged(const FUNC_T& func) const {
+    for (auto& msgs : staging_) {
+      for (auto& msg : msgs) {
+        func(msg.first);
+      }
+    }
+  }
+
+  /**
+   * @brief Move the staged messages to the CSR arrays, the messages built
+   * before are dropped. on_received(idx) is applied once to the index of
+   * every vertex receiving messages.
+   *
+   * With more than one thread, chunks of the staged messages are counted and
+   * scattered concurrently by atomic cursors, thus the order of the messages
+   * to a vertex is arbitrary.
+   */
+  template <typename FUNC_T>
+  void Build(int thread_num, const FUNC_T& on_received) {
+    std::fill(offsets_.begin(), offsets_.end(), 0);
+    size_t total = 0;
+    for (auto& msgs : staging_) {
+      total += msgs.size();
+    }
+    if (thread_num <= 1 || total <= kChunkSize) {
+      for (auto& msgs : staging_) {
+        for (auto& msg : msgs) {
+          if (offsets_[msg.first + 1]++ == 0) {
+            on_received(msg.first);
+          }
+        }
+      }
+      prefixSum();
+      messages_.resize(total);
+      cursors_.assign(offsets_.begin(), offsets_.end() - 1);
+      for (auto& msgs : staging_) {
+        for (auto& msg : msgs) {
+          messages_[cursors_[msg.first]++] = std::move(msg.second);
+        }
+        msgs.clear();
+      }
+      return;
+    }
+
+    forEachStagedChunk(thread_num, [&](std::pair<size_t, MD_T>& msg) {
+      if (__sync_fetch_and_add(&offsets_[msg.first + 1], 1) == 0) {
+        on_received(msg.first);
+      }
+    });
+    prefixSum();
+    messages_.resize(total);
+    cursors_.assign(offsets_.begin(), offsets_.end() - 1);
+    forEachStagedChunk(thread_num, [&](std::pair<size_t, MD_T>& msg) {
+      size_t pos = __sync_fetch_and_add(&cursors_[msg.first], 1);
+      messages_[pos] = std::move(msg.second);
+    });
+    for (auto& msgs : staging_) {
+      msgs.clear();
+    }
+  }
+
+  // Drop the built messages, staged messages are kept.
+  void Clear() {
+    if (!messages_.empty()) {
+      std::fill(offsets_.begin(), offsets_.end(), 0);
+      messages_.clear();
+    }
+  }
+
+  inline grape::IteratorPair<MD_T*> Get(size_t idx) {
+    return grape::IteratorPair<MD_T*>(messages_.data() + offsets_[idx],
+                                      messages_.data() + offsets_[idx + 1]);
+  }
+
+  inline size_t Size(size_t idx) const {
+    return offsets_[idx + 1] - offsets_[idx];
+  }
+
+  inline bool Empty(size_t idx) const { return Size(idx) == 0; }
+
+ private:
+  static constexpr size_t kChunkSize = 4096;
+
+  void prefixSum() {
+    for (size_t i = 1; i < offsets_.size(); ++i) {
+      offsets_[i] += offsets_[i - 1];
+    }
+  }
+
+  // apply func to every staged message, chunks are claimed by threads
+  template <typename FUNC_T>
+  void forEachStagedChunk(int thread_num, const FUNC_T& func) {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    for (size_t writer = 0; writer < staging_.size(); ++writer) {
+      for (size_t begin = 0; begin < staging_[writer].size();
+           begin += kChunkSize) {
+        chunks.emplace_back(writer, begin);
+      }
+    }
+    std::atomic<size_t> current(0);
+    std::vector<std::thread> threads(thread_num);
+    for (int tid = 0; tid < thread_num; ++tid) {
+      threads[tid] = std::thread([&]() {
+        size_t index;
+        while ((index = current.fetch_add(1, std::memory_order_relaxed)) <
+               chunks.size()) {
+          auto& msgs = staging_[chunks[index].first];
+          size_t end = std::min(chunks[index].second + kChunkSize, msgs.size());
+          for (size_t i = chunks[index].second; i < end; ++i) {
+            func(msgs[i]);
+          }
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  std::vector<size_t> offsets_;
+  std::vector<size_t> cursors_;
+  std::vector<MD_T> messages_;
+  // staging_[writer] holds the messages added by a writer
+  std::vector<std::vector<std::pair<size_t, MD_T>>> staging_;
+};
+
+/**
+ * @brief CombinedMessageSlots keeps at most one message for every vertex,
+ * messages sent to the same vertex are combined when they are put.
+ *
+ * @tparam MD_T Message type
+ */
+template <typename MD_T>
+class CombinedMessageSlots {
+ public:
+  CombinedMessageSlots() = default;
+
+  void Init(size_t vnum) {
+    values_.clear();
+    values_.resize(vnum);
+    has_value_.clear();
+    has_value_.resize(vnum, 0);
+  }
+
+  /**
+   * @brief Put a message into the slot of idx.
+   *
+   * @param combine Function to combine a message into the existing one,
+   * combine(MD_T& lhs, MD_T&& rhs).
+   */
+  template <typename FUNC_T>
+  inline void Put(size_t idx, MD_T&& msg, const FUNC_T& combine) {
+    if (has_value_[idx]) {
+      combine(values_[idx], std::move(msg));
+    } else {
+      values_[idx] = std::move(msg);
+      has_value_[idx] = 1;
+    }
+  }
+
+  inline bool Take(size_t idx, MD_T& msg) {
+    if (!has_value_[idx]) {
+      return false;
+    }
+    msg = std::move(values_[idx]);
+    has_value_[idx] = 0;
+    return true;
+  }
+
+ private:
+  std::vector<MD_T> values_;
+  std::vector<uint8_t> has_value_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_MESSAGE_STORE_H_
@@ -24,6 +24,7 @@ limitations under the License.
 #include "grape/utils/iterator_pair.h"
 
 #include "core/app/pregel/pregel_context.h"
+#include "core/app/pregel/pregel_communicator.h"
 #include "core/app/pregel/pregel_property_vertex.h"
 #include "core/app/property_app_base.h"
 
@@ -31,7 +32,9 @@ namespace gs {
 /**
  * @brief PregelPropertyAppBase is implemented with PIE programming model. The
  * pregel program is driven by the PIE functions. Compared with PregelAppBase,
- * this class is designed for the labeled graph.
+ * this class is designed for the labeled graph. Vertices are computed by the
+ * number of threads given by the "thread_num" argument (1 by default), in
+ * which case the vertex program must be thread-safe.
  * @tparam FRAG_T
  * @tparam VERTEX_PROGRAM_T
  * @tparam COMBINATOR_T
@@ -44,7 +47,7 @@ class PregelPropertyAppBase
           PregelContext<FRAG_T, PregelPropertyComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public PregelCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using pregel_compute_context_t =
@@ -71,27 +74,35 @@ class PregelPropertyAppBase
     ctx.compute_context_.enable_combine();
     label_id_t v_label_num = frag.vertex_label_num();
 
-    PregelPropertyVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto thread_num = ctx.compute_context_.get_config("thread_num");
+    if (!thread_num.empty()) {
+      ctx.compute_context_.set_thread_num(std::stoi(thread_num));
+    }
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
     grape::IteratorPair<md_t*> null_messages(nullptr, nullptr);
 
     for (label_id_t i = 0; i < v_label_num; ++i) {
       auto inner_vertices = frag.InnerVertices(i);
 
-      for (auto v : inner_vertices) {
-        pregel_vertex.set_vertex(v);
-        pregel_vertex.set_label_id(i);
-        program_.Init(pregel_vertex, ctx.compute_context_);
-      }
-
-      for (auto v : inner_vertices) {
-        pregel_vertex.set_vertex(v);
-        pregel_vertex.set_label_id(i);
-        program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-      }
+      ctx.compute_context_.foreach_vertex(
+          inner_vertices, [&](int tid, const vertex_t& v) {
+            auto& pregel_vertex = pregel_vertices[tid];
+            pregel_vertex.set_vertex(v);
+            pregel_vertex.set_label_id(i);
+            program_.Init(pregel_vertex, ctx.compute_context_);
+          });
+
+      ctx.compute_context_.foreach_vertex(
+          inner_vertices, [&](int tid, const vertex_t& v) {
+            auto& pregel_vertex = pregel_vertices[tid];
+            pregel_vertex.set_vertex(v);
+            pregel_vertex.set_label_id(i);
+            program_.Compute(null_messages, pregel_vertex,
+                             ctx.compute_context_);
+          });
     }
+    ctx.compute_context_.flush_messages();
 
     ctx.compute_context_.apply_combine(combinator_);
     ctx.compute_context_.before_comm();
@@ -108,19 +119,8 @@ class PregelPropertyAppBase
       }
     }
 
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
 
@@ -147,25 +147,25 @@ class PregelPropertyAppBase
 
     label_id_t v_label_num = frag.vertex_label_num();
 
-    PregelPropertyVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
     for (label_id_t i = 0; i < v_label_num; ++i) {
-      auto inner_vertices = frag.InnerVertices(i);
-      for (auto v : inner_vertices) {
-        if (ctx.compute_context_.active(v)) {
-          pregel_vertex.set_vertex(v);
-          pregel_vertex.set_label_id(i);
-          auto& cur_msgs = (ctx.compute_context_.messages_in(i))[v];
-          program_.Compute(
-              grape::IteratorPair<md_t*>(
-                  &cur_msgs[0],
-                  &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-              pregel_vertex, ctx.compute_context_);
-        }
-      }
+      auto& messages_in = ctx.compute_context_.messages_in(i);
+      ctx.compute_context_.foreach_vertex(
+          frag.InnerVertices(i), [&](int tid, const vertex_t& v) {
+            if (ctx.compute_context_.active(v)) {
+              auto& pregel_vertex = pregel_vertices[tid];
+              pregel_vertex.set_vertex(v);
+              pregel_vertex.set_label_id(i);
+              auto& cur_msgs = messages_in[v];
+              program_.Compute(
+                  grape::IteratorPair<md_t*>(
+                      cur_msgs.data(), cur_msgs.data() + cur_msgs.size()),
+                  pregel_vertex, ctx.compute_context_);
+            }
+          });
     }
+    ctx.compute_context_.flush_messages();
 
     ctx.compute_context_.apply_combine(combinator_);
     ctx.compute_context_.before_comm();
@@ -182,19 +182,8 @@ class PregelPropertyAppBase
       }
     }
 
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
 
@@ -204,6 +193,20 @@ class PregelPropertyAppBase
   }
 
  private:
+  // one PregelPropertyVertex per thread, which carries the tid to send
+  // messages
+  std::vector<PregelPropertyVertex<fragment_t, vd_t, md_t>> makePregelVertices(
+      const fragment_t& frag, pregel_context_t& ctx) {
+    std::vector<PregelPropertyVertex<fragment_t, vd_t, md_t>> pregel_vertices(
+        ctx.compute_context_.thread_num());
+    for (size_t tid = 0; tid < pregel_vertices.size(); ++tid) {
+      pregel_vertices[tid].set_fragment(&frag);
+      pregel_vertices[tid].set_compute_context(&ctx.compute_context_);
+      pregel_vertices[tid].set_tid(static_cast<int>(tid));
+    }
+    return pregel_vertices;
+  }
+
   VERTEX_PROGRAM_T program_;
   COMBINATOR_T combinator_;
 };
@@ -220,7 +223,7 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
           PregelContext<FRAG_T, PregelPropertyComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public PregelCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using app_t = PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T>;
@@ -245,41 +248,38 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
     // superstep is 0 in PEval
     label_id_t v_label_num = frag.vertex_label_num();
 
-    PregelPropertyVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto thread_num = ctx.compute_context_.get_config("thread_num");
+    if (!thread_num.empty()) {
+      ctx.compute_context_.set_thread_num(std::stoi(thread_num));
+    }
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
     grape::IteratorPair<md_t*> null_messages(nullptr, nullptr);
 
     for (label_id_t i = 0; i < v_label_num; ++i) {
       auto inner_vertices = frag.InnerVertices(i);
 
-      for (auto v : inner_vertices) {
-        pregel_vertex.set_vertex(v);
-        pregel_vertex.set_label_id(i);
-        program_.Init(pregel_vertex, ctx.compute_context_);
-      }
-
-      for (auto v : inner_vertices) {
-        pregel_vertex.set_vertex(v);
-        pregel_vertex.set_label_id(i);
-        program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-      }
+      ctx.compute_context_.foreach_vertex(
+          inner_vertices, [&](int tid, const vertex_t& v) {
+            auto& pregel_vertex = pregel_vertices[tid];
+            pregel_vertex.set_vertex(v);
+            pregel_vertex.set_label_id(i);
+            program_.Init(pregel_vertex, ctx.compute_context_);
+          });
+
+      ctx.compute_context_.foreach_vertex(
+          inner_vertices, [&](int tid, const vertex_t& v) {
+            auto& pregel_vertex = pregel_vertices[tid];
+            pregel_vertex.set_vertex(v);
+            pregel_vertex.set_label_id(i);
+            program_.Compute(null_messages, pregel_vertex,
+                             ctx.compute_context_);
+          });
     }
+    ctx.compute_context_.flush_messages();
 
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
 
@@ -306,39 +306,28 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
 
     label_id_t v_label_num = frag.vertex_label_num();
 
-    PregelPropertyVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    auto pregel_vertices = makePregelVertices(frag, ctx);
 
     for (label_id_t i = 0; i < v_label_num; ++i) {
-      auto inner_vertices = frag.InnerVertices(i);
-      for (auto v : inner_vertices) {
-        if (ctx.compute_context_.active(v)) {
-          pregel_vertex.set_vertex(v);
-          pregel_vertex.set_label_id(i);
-          auto& cur_msgs = (ctx.compute_context_.messages_in(i))[v];
-          program_.Compute(
-              grape::IteratorPair<md_t*>(
-                  &cur_msgs[0],
-                  &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-              pregel_vertex, ctx.compute_context_);
-        }
-      }
+      auto& messages_in = ctx.compute_context_.messages_in(i);
+      ctx.compute_context_.foreach_vertex(
+          frag.InnerVertices(i), [&](int tid, const vertex_t& v) {
+            if (ctx.compute_context_.active(v)) {
+              auto& pregel_vertex = pregel_vertices[tid];
+              pregel_vertex.set_vertex(v);
+              pregel_vertex.set_label_id(i);
+              auto& cur_msgs = messages_in[v];
+              program_.Compute(
+                  grape::IteratorPair<md_t*>(
+                      cur_msgs.data(), cur_msgs.data() + cur_msgs.size()),
+                  pregel_vertex, ctx.compute_context_);
+            }
+          });
     }
+    ctx.compute_context_.flush_messages();
 
-    {
-      // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
-    }
+    // sync aggregators in a single collective
+    SyncAggregators(ctx.compute_context_.aggregators());
 
     ctx.compute_context_.clear_for_next_round();
 
@@ -348,6 +337,20 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
   }
 
  private:
+  // one PregelPropertyVertex per thread, which carries the tid to send
+  // messages
+  std::vector<PregelPropertyVertex<fragment_t, vd_t, md_t>> makePregelVertices(
+      const fragment_t& frag, pregel_context_t& ctx) {
+    std::vector<PregelPropertyVertex<fragment_t, vd_t, md_t>> pregel_vertices(
+        ctx.compute_context_.thread_num());
+    for (size_t tid = 0; tid < pregel_vertices.size(); ++tid) {
+      pregel_vertices[tid].set_fragment(&frag);
+      pregel_vertices[tid].set_compute_context(&ctx.compute_context_);
+      pregel_vertices[tid].set_tid(static_cast<int>(tid));
+    }
+    return pregel_vertices;
+  }
+
   VERTEX_PROGRAM_T program_;
 };
 
@@ -16,8 +16,12 @@
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_PROPERTY_VERTEX_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_PROPERTY_VERTEX_H_
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -149,11 +153,11 @@ class PregelPropertyVertex {
   }
 
   void send(const PregelPropertyVertex& v, const MD_T& value) {
-    compute_context_->send_message(v.vertex(), value);
+    compute_context_->send_message(v.vertex(), value, tid_);
   }
 
   void send(const PregelPropertyVertex& v, MD_T&& value) {
-    compute_context_->send_message(v.vertex(), std::move(value));
+    compute_context_->send_message(v.vertex(), std::move(value), tid_);
   }
 
   void vote_to_halt() { compute_context_->vote_to_halt(*this); }
@@ -169,12 +173,17 @@ class PregelPropertyVertex {
 
   void set_label_id(label_id_t label_id) { label_id_ = label_id; }
 
+  // the thread computing this vertex
+  int tid() const { return tid_; }
+  void set_tid(int tid) { tid_ = tid; }
+
  private:
   const fragment_t* fragment_;
   PregelPropertyComputeContext<fragment_t, VD_T, MD_T>* compute_context_;
 
   vertex_t vertex_;
   label_id_t label_id_;
+  int tid_ = 0;
 };
 
 /**
@@ -378,6 +387,89 @@ class PregelPropertyComputeContext {
     enable_combine_ = false;
     vertex_label_num_ = v_label_num;
     edge_label_num_ = e_label_num;
+    set_thread_num(1);
+  }
+
+  /**
+   * @brief Set the number of threads to run the vertex program. With more
+   * than one thread, the vertex program must only modify the vertex it is
+   * computing. Messages are buffered in per-thread outboxes which are
+   * bucketed by the destination, and merged by flush_messages().
+   */
+  void set_thread_num(int thread_num) {
+    thread_num_ = std::max(thread_num, 1);
+    outboxes_.clear();
+    if (thread_num_ > 1) {
+      outboxes_.resize(thread_num_);
+      for (auto& buckets : outboxes_) {
+        buckets.resize(thread_num_);
+      }
+    }
+  }
+
+  int thread_num() const { return thread_num_; }
+
+  /**
+   * @brief Apply func(tid, v) to every vertex in the range. Vertices are split
+   * into chunks claimed by threads dynamically.
+   */
+  template <typename FUNC_T>
+  void foreach_vertex(const typename fragment_t::vertex_range_t& range,
+                      const FUNC_T& func) {
+    static constexpr size_t kChunkSize = 1024;
+    if (thread_num_ <= 1) {
+      for (auto v : range) {
+        func(0, v);
+      }
+      return;
+    }
+    std::atomic<size_t> current(0);
+    size_t begin_value = range.begin().GetValue();
+    size_t vnum = range.size();
+    runThreads([&](int tid) {
+      while (true) {
+        size_t begin = current.fetch_add(kChunkSize, std::memory_order_relaxed);
+        if (begin >= vnum) {
+          break;
+        }
+        size_t end = std::min(begin + kChunkSize, vnum);
+        for (size_t i = begin; i < end; ++i) {
+          func(tid, vertex_t(begin_value + i));
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Move the messages buffered by threads to the outgoing messages of
+   * vertices. Each thread merges one bucket of destinations, thus no lock is
+   * needed. Messages to outer vertices without combining are sent by the
+   * message manager.
+   */
+  void flush_messages() {
+    if (thread_num_ <= 1) {
+      return;
+    }
+    std::vector<std::vector<std::pair<vertex_t, MD_T>>> remote(thread_num_);
+    runThreads([&](int bucket) {
+      for (auto& buckets : outboxes_) {
+        for (auto& msg : buckets[bucket]) {
+          if (!enable_combine_ && fragment_->IsOuterVertex(msg.first)) {
+            remote[bucket].emplace_back(std::move(msg));
+          } else {
+            label_id_t label = fragment_->vertex_label(msg.first);
+            messages_out_[label][msg.first].emplace_back(std::move(msg.second));
+          }
+        }
+        buckets[bucket].clear();
+      }
+    });
+    for (auto& msgs : remote) {
+      for (auto& msg : msgs) {
+        message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(
+            *fragment_, msg.first, msg.second);
+      }
+    }
   }
 
   void inc_step() { step_++; }
@@ -504,7 +596,11 @@ class PregelPropertyComputeContext {
     return schema_->GetEdgePropertyName(e_label_id, e_prop_id);
   }
 
-  void send_message(const vertex_t& v, const MD_T& value) {
+  void send_message(const vertex_t& v, const MD_T& value, int tid = 0) {
+    if (thread_num_ > 1) {
+      outboxes_[tid][bucketOf(v)].emplace_back(v, value);
+      return;
+    }
     if (enable_combine_) {
       label_id_t label = fragment_->vertex_label(v);
       messages_out_[label][v].emplace_back(value);
@@ -519,7 +615,11 @@ class PregelPropertyComputeContext {
     }
   }
 
-  void send_message(const vertex_t& v, MD_T&& value) {
+  void send_message(const vertex_t& v, MD_T&& value, int tid = 0) {
+    if (thread_num_ > 1) {
+      outboxes_[tid][bucketOf(v)].emplace_back(v, std::move(value));
+      return;
+    }
     if (enable_combine_) {
       label_id_t label = fragment_->vertex_label(v);
       messages_out_[label][v].emplace_back(std::move(value));
@@ -537,31 +637,22 @@ class PregelPropertyComputeContext {
   template <typename COMBINATOR_T>
   void apply_combine(COMBINATOR_T& cb) {
     for (int label_id = 0; label_id < vertex_label_num_; ++label_id) {
-      auto vertices = fragment_->Vertices(label_id);
-      for (auto v : vertices) {
-        auto& msgs = messages_out_[label_id][v];
-        if (!msgs.empty()) {
-          MD_T ret = cb.CombineMessages(grape::IteratorPair<MD_T*>(
-              &msgs[0], &msgs[0] + static_cast<ptrdiff_t>(msgs.size())));
-          msgs.clear();
-          msgs.emplace_back(std::move(ret));
-        }
-      }
+      auto& messages_out = messages_out_[label_id];
+      foreach_vertex(fragment_->Vertices(label_id),
+                     [&](int tid, const vertex_t& v) {
+                       auto& msgs = messages_out[v];
+                       if (!msgs.empty()) {
+                         MD_T ret = cb.CombineMessages(
+                             grape::IteratorPair<MD_T*>(
+                                 msgs.data(), msgs.data() + msgs.size()));
+                         msgs.clear();
+                         msgs.emplace_back(std::move(ret));
+                       }
+                     });
     }
   }
 
-  void before_comm() {
-    for (int label_id = 0; label_id < vertex_label_num_; ++label_id) {
-      auto inner_vertices = fragment_->InnerVertices(label_id);
-      for (auto v : inner_vertices) {
-        messages_in_[label_id][v].clear();
-        messages_in_[label_id][v].swap(messages_out_[label_id][v]);
-        if (!messages_in_[label_id][v].empty()) {
-          activate(v);
-        }
-      }
-    }
-  }
+  void before_comm() { swapInbox(); }
 
   bool active(const vertex_t& v) {
     int label = fragment_->vertex_label(v);
@@ -601,16 +692,7 @@ class PregelPropertyComputeContext {
 
   void clear_for_next_round() {
     if (!enable_combine_) {
-      for (int label_id = 0; label_id < vertex_label_num_; ++label_id) {
-        auto inner_vertices = fragment_->InnerVertices(label_id);
-        for (auto v : inner_vertices) {
-          messages_in_[label_id][v].clear();
-          messages_in_[label_id][v].swap(messages_out_[label_id][v]);
-          if (!messages_in_[label_id][v].empty()) {
-            activate(v);
-          }
-        }
-      }
+      swapInbox();
     }
   }
 
@@ -657,8 +739,14 @@ class PregelPropertyComputeContext {
   template <typename AGGR_TYPE>
   void aggregate(const std::string& name, AGGR_TYPE value) {
     if (aggregators_.find(name) != aggregators_.end()) {
-      std::dynamic_pointer_cast<Aggregator<AGGR_TYPE>>(aggregators_.at(name))
-          ->Aggregate(value);
+      auto aggregator = std::dynamic_pointer_cast<Aggregator<AGGR_TYPE>>(
+          aggregators_.at(name));
+      if (thread_num_ > 1) {
+        std::lock_guard<std::mutex> lock(aggregator_mutex_);
+        aggregator->Aggregate(value);
+      } else {
+        aggregator->Aggregate(value);
+      }
     }
   }
 
@@ -676,6 +764,38 @@ class PregelPropertyComputeContext {
   const vineyard::PropertyGraphSchema* schema() const { return schema_; }
 
  private:
+  // move the outgoing messages of inner vertices to the inbox, vertices with
+  // messages are activated
+  void swapInbox() {
+    for (int label_id = 0; label_id < vertex_label_num_; ++label_id) {
+      auto& messages_in = messages_in_[label_id];
+      auto& messages_out = messages_out_[label_id];
+      foreach_vertex(fragment_->InnerVertices(label_id),
+                     [&](int tid, const vertex_t& v) {
+                       messages_in[v].clear();
+                       messages_in[v].swap(messages_out[v]);
+                       if (!messages_in[v].empty()) {
+                         activate(v);
+                       }
+                     });
+    }
+  }
+
+  inline size_t bucketOf(const vertex_t& v) const {
+    return v.GetValue() % thread_num_;
+  }
+
+  template <typename FUNC_T>
+  void runThreads(const FUNC_T& func) {
+    std::vector<std::thread> threads(thread_num_);
+    for (int tid = 0; tid < thread_num_; ++tid) {
+      threads[tid] = std::thread([&func, tid]() { func(tid); });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
   const fragment_t* fragment_;
   grape::DefaultMessageManager* message_manager_;
 
@@ -684,7 +804,8 @@ class PregelPropertyComputeContext {
 
   std::vector<typename FRAG_T::template vertex_array_t<VD_T>>& vertex_data_;
 
-  size_t voted_to_halt_num_;
+  // updated by the threads computing vertices
+  std::atomic<size_t> voted_to_halt_num_;
   std::vector<typename FRAG_T::template vertex_array_t<bool>> halted_;
 
   std::vector<typename FRAG_T::template vertex_array_t<std::vector<MD_T>>>
@@ -701,6 +822,11 @@ class PregelPropertyComputeContext {
   int step_;
   std::unordered_map<std::string, std::string> config_;
   std::unordered_map<std::string, std::shared_ptr<IAggregator>> aggregators_;
+
+  int thread_num_ = 1;
+  // outboxes_[tid][bucket] buffers messages sent by thread tid
+  std::vector<std::vector<std::vector<std::pair<vertex_t, MD_T>>>> outboxes_;
+  std::mutex aggregator_mutex_;
 };
 
 }  // namespace gs
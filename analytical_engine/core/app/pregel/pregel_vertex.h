@@ -64,11 +64,11 @@ class PregelVertex {
   adj_list_t incoming_edges() { return fragment_->GetIncomingAdjList(vertex_); }
 
   void send(const vertex_t& v, const MD_T& value) {
-    compute_context_->send_message(v, value);
+    compute_context_->send_message(v, value, tid_);
   }
 
   void send(const vertex_t& v, MD_T&& value) {
-    compute_context_->send_message(v, std::move(value));
+    compute_context_->send_message(v, std::move(value), tid_);
   }
 
   void vote_to_halt() { compute_context_->vote_to_halt(*this); }
@@ -82,11 +82,16 @@ class PregelVertex {
 
   void set_vertex(vertex_t vertex) { vertex_ = vertex; }
 
+  // the thread computing this vertex
+  int tid() const { return tid_; }
+  void set_tid(int tid) { tid_ = tid; }
+
  protected:
   const fragment_t* fragment_;
   PregelComputeContext<fragment_t, VD_T, MD_T>* compute_context_;
 
   vertex_t vertex_;
+  int tid_ = 0;
 };
 
 }  // namespace gs
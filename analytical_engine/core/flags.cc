@@ -27,3 +27,9 @@ DEFINE_string(etcd_endpoint, "http://127.0.0.1:2379",
               "Etcd endpoint that will be used to launch vineyardd");
 
 DEFINE_string(dag_file, "", "Engine reads serialized dag proto from dag_file.");
+
+// for networkx
+DEFINE_int32(modify_thread_num, 0,
+             "threads of a worker to parse the lines of modifying vertices "
+             "and edges, 0 means the hardware concurrency divided by the "
+             "number of workers on the host");
@@ -23,6 +23,9 @@ DECLARE_int32(port);
 
 DECLARE_string(dag_file);
 
+// networkx
+DECLARE_int32(modify_thread_num);
+
 // vineyard
 DECLARE_string(vineyard_socket);
 DECLARE_string(etcd_endpoint);
@@ -17,7 +17,6 @@
 #define ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_FRAGMENT_H_
 
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -38,56 +37,54 @@ namespace gs {
 template <typename OID_T, typename VID_T>
 class AppendOnlyArrowFragmentBuilder;
 
+template <typename OID_T, typename VID_T>
+class AppendOnlyArrowFragmentCompactor;
+
 namespace append_only_fragment_impl {
 /**
  * @brief ExtraNbr is an internal representation for a later appended neighbor.
+ * The neighbors of a vertex are stored in at most two contiguous segments,
+ * i.e., the compacted run and the tail appended after the last compaction.
  * @see gs::AppendOnlyArrowFragment
  */
 template <typename VID_T, typename EID_T>
 struct ExtraNbr {
  private:
   using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
 
  public:
-  ExtraNbr() : nbr_(NULL), edata_table_(nullptr) {}
-
-  ExtraNbr(typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                        VID_T, EID_T>>::const_iterator nbr,
+  ExtraNbr()
+      : nbr_(NULL),
+        seg_end_(NULL),
+        next_(NULL),
+        next_end_(NULL),
+        edata_table_(nullptr),
+        vid_parser_(NULL),
+        ivnums_(NULL) {}
+
+  ExtraNbr(const nbr_unit_t* nbr, const nbr_unit_t* seg_end,
+           const nbr_unit_t* next, const nbr_unit_t* next_end,
            std::shared_ptr<AppendOnlyArrowTable> edata_table,
            const vineyard::IdParser<VID_T>* vid_parser, const VID_T* ivnums)
       : nbr_(nbr),
+        seg_end_(seg_end),
+        next_(next),
+        next_end_(next_end),
         edata_table_(std::move(edata_table)),
         vid_parser_(vid_parser),
         ivnums_(ivnums) {}
 
-  ExtraNbr(const ExtraNbr& rhs)
-      : nbr_(rhs.nbr_),
-        edata_table_(rhs.edata_table_),
-        vid_parser_(rhs.vid_parser_),
-        ivnums_(rhs.ivnums_) {}
+  ExtraNbr(const ExtraNbr& rhs) = default;
 
-  ExtraNbr(ExtraNbr&& rhs)
-      : nbr_(std::move(rhs.nbr_)),
-        edata_table_(std::move(rhs.edata_table_)),
-        vid_parser_(rhs.vid_parser_),
-        ivnums_(rhs.ivnums_) {}
+  ExtraNbr(ExtraNbr&& rhs) = default;
 
-  ExtraNbr& operator=(const ExtraNbr& rhs) {
-    nbr_ = rhs.nbr_;
-    edata_table_ = rhs.edata_table_;
-    vid_parser_ = rhs.vid_parser_;
-    ivnums_ = rhs.ivnums_;
-  }
+  ExtraNbr& operator=(const ExtraNbr& rhs) = default;
 
-  ExtraNbr& operator=(ExtraNbr&& rhs) {
-    nbr_ = std::move(rhs.nbr_);
-    edata_table_ = std::move(rhs.edata_table_);
-    vid_parser_ = rhs.vid_parser_;
-    ivnums_ = rhs.ivnums_;
-  }
+  ExtraNbr& operator=(ExtraNbr&& rhs) = default;
 
   grape::Vertex<VID_T> neighbor() const {
-    auto lid = nbr_->first;
+    auto lid = nbr_->vid;
     auto offset_mask = vid_parser_->offset_mask();
     auto offset = vid_parser_->GetOffset(lid);
     auto v_label = vid_parser_->GetLabelId(lid);
@@ -99,45 +96,39 @@ struct ExtraNbr {
     return grape::Vertex<VID_T>(vid);
   }
 
-  EID_T edge_id() const { return nbr_->second.eid; }
+  EID_T edge_id() const { return nbr_->eid; }
 
   template <typename T>
   T get_data(prop_id_t prop_id) const {
-    return edata_table_->GetValue<T>(prop_id, nbr_->second.eid);
+    return edata_table_->GetValue<T>(prop_id, nbr_->eid);
   }
 
   inline const ExtraNbr& operator++() const {
     ++nbr_;
+    if (nbr_ == seg_end_ && next_ != next_end_) {
+      nbr_ = next_;
+      seg_end_ = next_end_;
+      next_ = next_end_;
+    }
     return *this;
   }
 
   inline ExtraNbr operator++(int) const {
     ExtraNbr ret(*this);
-    ++ret;
-    return ret;
-  }
-
-  inline const ExtraNbr& operator--() const {
-    --nbr_;
-    return *this;
-  }
-
-  inline ExtraNbr operator--(int) const {
-    ExtraNbr ret(*this);
-    --ret;
+    ++(*this);
     return ret;
   }
 
   inline bool operator==(const ExtraNbr& rhs) const { return nbr_ == rhs.nbr_; }
   inline bool operator!=(const ExtraNbr& rhs) const { return nbr_ != rhs.nbr_; }
 
-  inline bool operator<(const ExtraNbr& rhs) const { return nbr_ < rhs.nbr_; }
-
   inline const ExtraNbr& operator*() const { return *this; }
 
  private:
-  mutable typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                       VID_T, EID_T>>::const_iterator nbr_;
+  mutable const nbr_unit_t* nbr_;
+  mutable const nbr_unit_t* seg_end_;
+  mutable const nbr_unit_t* next_;
+  mutable const nbr_unit_t* next_end_;
   std::shared_ptr<AppendOnlyArrowTable> edata_table_;
   const vineyard::IdParser<VID_T>* vid_parser_;
   const VID_T* ivnums_;
@@ -145,48 +136,67 @@ struct ExtraNbr {
 
 /**
  * @brief ExtraAdjList is an internal representation for the later appended
- * neighbors.
+ * neighbors, which are the compacted run [run_begin, run_end) followed by the
+ * tail [tail_begin, tail_end).
  * @see gs::AppendOnlyArrowFragment
  */
 template <typename VID_T, typename EID_T>
 class ExtraAdjList {
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
+
  public:
-  ExtraAdjList() = default;
-
-  ExtraAdjList(
-      typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                   VID_T, EID_T>>::const_iterator begin,
-      typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                   VID_T, EID_T>>::const_iterator end,
-      std::shared_ptr<AppendOnlyArrowTable> edata_table,
-      const vineyard::IdParser<VID_T>* vid_parser, const VID_T* ivnums)
-      : begin_(begin),
-        end_(end),
+  ExtraAdjList()
+      : run_begin_(NULL),
+        run_end_(NULL),
+        tail_begin_(NULL),
+        tail_end_(NULL),
+        vid_parser_(NULL),
+        ivnums_(NULL) {}
+
+  ExtraAdjList(const nbr_unit_t* run_begin, const nbr_unit_t* run_end,
+               const nbr_unit_t* tail_begin, const nbr_unit_t* tail_end,
+               std::shared_ptr<AppendOnlyArrowTable> edata_table,
+               const vineyard::IdParser<VID_T>* vid_parser, const VID_T* ivnums)
+      : run_begin_(run_begin),
+        run_end_(run_end),
+        tail_begin_(tail_begin),
+        tail_end_(tail_end),
         edata_table_(std::move(edata_table)),
         vid_parser_(vid_parser),
-        ivnums_(ivnums) {}
+        ivnums_(ivnums) {
+    if (run_begin_ == run_end_) {
+      run_begin_ = tail_begin_;
+      run_end_ = tail_end_;
+      tail_begin_ = tail_end_ = NULL;
+    }
+  }
 
   inline ExtraNbr<VID_T, EID_T> begin() const {
-    return ExtraNbr<VID_T, EID_T>(begin_, edata_table_, vid_parser_, ivnums_);
+    return ExtraNbr<VID_T, EID_T>(run_begin_, run_end_, tail_begin_, tail_end_,
+                                  edata_table_, vid_parser_, ivnums_);
   }
 
   inline ExtraNbr<VID_T, EID_T> end() const {
-    return ExtraNbr<VID_T, EID_T>(end_, edata_table_, vid_parser_, ivnums_);
+    const nbr_unit_t* last = tail_begin_ != tail_end_ ? tail_end_ : run_end_;
+    return ExtraNbr<VID_T, EID_T>(last, last, NULL, NULL, edata_table_,
+                                  vid_parser_, ivnums_);
   }
 
-  inline size_t Size() const { return end_ - begin_; }
+  inline size_t Size() const {
+    return (run_end_ - run_begin_) + (tail_end_ - tail_begin_);
+  }
 
-  inline bool Empty() const { return end_ == begin_; }
+  inline bool Empty() const { return Size() == 0; }
 
-  inline bool NotEmpty() const { return end_ != begin_; }
+  inline bool NotEmpty() const { return Size() != 0; }
 
-  size_t size() const { return end_ - begin_; }
+  size_t size() const { return Size(); }
 
  private:
-  typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                               VID_T, EID_T>>::const_iterator begin_;
-  typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                               VID_T, EID_T>>::const_iterator end_;
+  const nbr_unit_t* run_begin_;
+  const nbr_unit_t* run_end_;
+  const nbr_unit_t* tail_begin_;
+  const nbr_unit_t* tail_end_;
   std::shared_ptr<AppendOnlyArrowTable> edata_table_;
   const vineyard::IdParser<VID_T>* vid_parser_;
   const VID_T* ivnums_;
@@ -195,17 +205,15 @@ class ExtraAdjList {
 template <typename T>
 typename std::enable_if<!std::is_same<T, std::string>::value, T>::type
 get_from_arrow_array(const std::shared_ptr<arrow::Array>& arr, int64_t i) {
-  return std::dynamic_pointer_cast<
-             typename vineyard::ConvertToArrowType<T>::ArrayType>(arr)
-      ->Value(i);
+  using array_t = typename vineyard::ConvertToArrowType<T>::ArrayType;
+  return static_cast<const array_t*>(arr.get())->Value(i);
 }
 
 template <typename T>
 typename std::enable_if<std::is_same<T, std::string>::value, T>::type
 get_from_arrow_array(const std::shared_ptr<arrow::Array>& arr, int64_t i) {
-  return std::dynamic_pointer_cast<
-             typename vineyard::ConvertToArrowType<T>::ArrayType>(arr)
-      ->GetString(i);
+  using array_t = typename vineyard::ConvertToArrowType<T>::ArrayType;
+  return static_cast<const array_t*>(arr.get())->GetString(i);
 }
 }  // namespace append_only_fragment_impl
 
@@ -220,53 +228,121 @@ get_from_arrow_array(const std::shared_ptr<arrow::Array>& arr, int64_t i) {
 template <typename OID_T, typename VID_T>
 class AppendOnlyArrowFragment
     : public vineyard::Registered<AppendOnlyArrowFragment<OID_T, VID_T>> {
+  /**
+   * @brief NbrLogSpace stores the appended neighbors of vertices, each of
+   * which is located by a loc. The neighbors appended since the last
+   * compaction are kept in a per-loc tail, and Compact merges the tails into
+   * a CSR where the neighbors of a loc are sorted by vid. Thus the
+   * neighbors are always iterated in at most two contiguous segments.
+   */
   template <typename EID_T>
-  class NbrMapSpace {
+  class NbrLogSpace {
     using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
+    // tails are merged when they hold 1/compact_ratio of the compacted
+    // neighbors, thus each neighbor is compacted O(1) times amortized
+    static constexpr size_t compact_ratio = 8;
 
    public:
-    NbrMapSpace() : index_(0) {}
+    NbrLogSpace() : offsets_(1, 0), tail_size_(0) {}
 
-    // Create a new linked list
+    // Create a new loc
     inline size_t emplace(VID_T vid, EID_T eid) {
-      buffer_.resize(index_ + 1);
-      buffer_[index_] = new std::map<VID_T, nbr_unit_t>();
-      buffer_[index_]->operator[](vid) = nbr_unit_t(vid, eid);
-      return index_++;
+      tails_.emplace_back();
+      tails_.back().emplace_back(vid, eid);
+      ++tail_size_;
+      return tails_.size() - 1;
     }
 
-    // Insert the value to an existing linked list, or update the existing value
+    // Insert the value to an existing loc
     // N.B.: Append only frag does not support update existed value!!
     inline size_t emplace(size_t loc, VID_T vid, EID_T eid, bool& created) {
-      if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
+      if (exists(loc, vid)) {
         created = false;
       } else {
-        buffer_[loc]->operator[](vid) = nbr_unit_t(vid, eid);
+        tails_[loc].emplace_back(vid, eid);
+        ++tail_size_;
         created = true;
       }
       return loc;
     }
 
-    inline std::map<VID_T, nbr_unit_t>& operator[](size_t loc) {
-      return *buffer_[loc];
+    inline const nbr_unit_t* run_begin(size_t loc) const {
+      return loc + 1 < offsets_.size() ? csr_.data() + offsets_[loc] : NULL;
     }
 
-    inline const std::map<VID_T, nbr_unit_t>& operator[](size_t loc) const {
-      return *buffer_[loc];
+    inline const nbr_unit_t* run_end(size_t loc) const {
+      return loc + 1 < offsets_.size() ? csr_.data() + offsets_[loc + 1]
+                                       : NULL;
     }
 
-    void Clear() {
-      for (size_t i = 0; i < buffer_.size(); ++i) {
-        delete buffer_[i];
-        buffer_[i] = nullptr;
+    inline const nbr_unit_t* tail_begin(size_t loc) const {
+      return tails_[loc].data();
+    }
+
+    inline const nbr_unit_t* tail_end(size_t loc) const {
+      return tails_[loc].data() + tails_[loc].size();
+    }
+
+    /**
+     * @brief Merge the tails into the CSR. Unless forced, it is skipped if the
+     * tails are small compared with the CSR.
+     */
+    void Compact(bool force = false) {
+      if (tail_size_ == 0 ||
+          (!force && tail_size_ * compact_ratio < csr_.size())) {
+        return;
+      }
+      size_t loc_num = tails_.size();
+      std::vector<size_t> offsets(loc_num + 1, 0);
+      for (size_t loc = 0; loc < loc_num; ++loc) {
+        offsets[loc + 1] =
+            offsets[loc] + (run_end(loc) - run_begin(loc)) + tails_[loc].size();
       }
-      buffer_.clear();
-      index_ = 0;
+      std::vector<nbr_unit_t> csr(offsets[loc_num]);
+      auto cmp = [](const nbr_unit_t& l, const nbr_unit_t& r) {
+        return l.vid < r.vid;
+      };
+      for (size_t loc = 0; loc < loc_num; ++loc) {
+        auto& tail = tails_[loc];
+        std::sort(tail.begin(), tail.end(), cmp);
+        std::merge(run_begin(loc), run_end(loc), tail.begin(), tail.end(),
+                   csr.begin() + offsets[loc], cmp);
+        if (!tail.empty()) {
+          std::vector<nbr_unit_t>().swap(tail);
+        }
+      }
+      offsets_.swap(offsets);
+      csr_.swap(csr);
+      tail_size_ = 0;
+    }
+
+    void Clear() {
+      offsets_.assign(1, 0);
+      csr_.clear();
+      tails_.clear();
+      tail_size_ = 0;
     }
 
    private:
-    std::vector<std::map<VID_T, nbr_unit_t>*> buffer_;
-    size_t index_;
+    inline bool exists(size_t loc, VID_T vid) const {
+      if (std::binary_search(run_begin(loc), run_end(loc), nbr_unit_t(vid, 0),
+                             [](const nbr_unit_t& l, const nbr_unit_t& r) {
+                               return l.vid < r.vid;
+                             })) {
+        return true;
+      }
+      for (auto& nbr : tails_[loc]) {
+        if (nbr.vid == vid) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    std::vector<size_t> offsets_;
+    std::vector<nbr_unit_t> csr_;
+    std::vector<std::vector<nbr_unit_t>> tails_;
+    size_t tail_size_;
   };
 
  public:
@@ -540,7 +616,7 @@ class AppendOnlyArrowFragment
 
   inline bool OuterVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
     auto v_label = vid_parser_.GetLabelId(gid);
-    auto map = ovg2l_maps_[v_label];
+    auto& map = ovg2l_maps_[v_label];
     auto iter = map->find(gid);
     auto ivnum = curr_ivnums_[v_label];
 
@@ -548,7 +624,7 @@ class AppendOnlyArrowFragment
       v.SetValue(ivnum + (vid_parser_.offset_mask() - iter->second));
       return true;
     } else {
-      auto extra_map = extra_ovg2l_maps_[v_label];
+      auto& extra_map = extra_ovg2l_maps_[v_label];
       auto extra_iter = extra_map.find(gid);
 
       if (extra_iter != extra_map.end()) {
@@ -625,8 +701,10 @@ class AppendOnlyArrowFragment
       auto& edge_space = extra_edge_space_array_[e_label];
       auto& edge_table = extra_edge_tables_[e_label];
 
-      return extra_adj_list_t(edge_space[loc].begin(), edge_space[loc].end(),
-                              edge_table, &vid_parser_, curr_ivnums_.data());
+      return extra_adj_list_t(
+          edge_space.run_begin(loc), edge_space.run_end(loc),
+          edge_space.tail_begin(loc), edge_space.tail_end(loc), edge_table,
+          &vid_parser_, curr_ivnums_.data());
     }
     return extra_adj_list_t();
   }
@@ -786,6 +864,13 @@ class AppendOnlyArrowFragment
     return created;
   }
 
+  // merge the appended edges into the CSR of the extra edge spaces
+  void compactExtraEdges(bool force = false) {
+    for (auto& edge_space : extra_edge_space_array_) {
+      edge_space.Compact(force);
+    }
+  }
+
   bool ovg2l(const vid_t gid, vid_t& lid) {
     auto v_label = vid_parser_.GetLabelId(gid);
     auto& ovg2l_map = ovg2l_maps_[v_label];
@@ -864,7 +949,7 @@ class AppendOnlyArrowFragment
 
   // v_label->e_label->index
   std::vector<std::vector<std::vector<int64_t>>> extra_oe_indices_;
-  std::vector<NbrMapSpace<eid_t>> extra_edge_space_array_;
+  std::vector<NbrLogSpace<eid_t>> extra_edge_space_array_;
 
   std::vector<eid_t> extra_oe_nums_;
 
@@ -874,6 +959,9 @@ class AppendOnlyArrowFragment
   template <typename _OID_T, typename _VID_T>
   friend class ArrowFragmentAppender;
 
+  template <typename _OID_T, typename _VID_T>
+  friend class AppendOnlyArrowFragmentCompactor;
+
   template <typename _OID_T, typename _VID_T>
   friend class ExtraVertexMap;
 };
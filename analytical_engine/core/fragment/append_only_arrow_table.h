@@ -26,261 +26,377 @@
 
 namespace gs {
 namespace append_only_arrow_table_impl {
+
+/**
+ * @brief ChunkedValues stores values in chunks of a fixed size. A chunk never
+ * moves once allocated, thus the pointers to the values stay valid while
+ * appending, and a value is read by a pointer and an offset.
+ */
 template <typename T>
-struct ValueGetter {
-  static T get(const std::shared_ptr<arrow::ArrayBuilder>& builder) {
-    __builtin_unreachable();
+class ChunkedValues {
+  static constexpr int chunk_bits = 16;
+  static constexpr int64_t chunk_mask = (int64_t(1) << chunk_bits) - 1;
+
+ public:
+  static int64_t chunk_size() { return int64_t(1) << chunk_bits; }
+
+  inline const T& operator[](int64_t idx) const {
+    return chunks_[idx >> chunk_bits][idx & chunk_mask];
   }
-};
 
-template <>
-struct ValueGetter<uint64_t> {
-  static uint64_t get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                      int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::UInt64Builder>(builder)->GetValue(
-        idx);
+  inline void push_back(const T& value) {
+    if ((size_ & chunk_mask) == 0 &&
+        static_cast<size_t>(size_ >> chunk_bits) == chunks_.size()) {
+      chunks_.emplace_back(new T[chunk_size()]);
+    }
+    chunks_[size_ >> chunk_bits][size_ & chunk_mask] = value;
+    ++size_;
   }
-};
 
-template <>
-struct ValueGetter<int64_t> {
-  static int64_t get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                     int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::Int64Builder>(builder)->GetValue(
-        idx);
+  void reserve(int64_t size) {
+    while (static_cast<int64_t>(chunks_.size()) * chunk_size() < size) {
+      chunks_.emplace_back(new T[chunk_size()]);
+    }
   }
+
+  int64_t size() const { return size_; }
+
+  size_t chunk_num() const { return chunks_.size(); }
+
+  const T* chunk(size_t idx) const { return chunks_[idx].get(); }
+
+ private:
+  std::vector<std::unique_ptr<T[]>> chunks_;
+  int64_t size_ = 0;
 };
 
-template <>
-struct ValueGetter<uint32_t> {
-  static uint32_t get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                      int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::UInt32Builder>(builder)->GetValue(
-        idx);
-  }
+/**
+ * @brief A column of AppendOnlyArrowTable. The type of a column is checked
+ * once when the table is created, thus values are appended and read without
+ * casting.
+ */
+class IColumn {
+ public:
+  virtual ~IColumn() = default;
+
+  virtual int64_t size() const = 0;
+
+  // Append the rows [offset, offset + length) of array
+  virtual void AppendRange(const arrow::Array& array, int64_t offset,
+                           int64_t length) = 0;
+
+  // Append the given rows of array
+  virtual void AppendRows(const arrow::Array& array, const int64_t* rows,
+                          size_t row_num) = 0;
+
+  virtual bl::result<std::shared_ptr<arrow::Array>> Slice(
+      int64_t begin, int64_t end) const = 0;
 };
 
-template <>
-struct ValueGetter<int32_t> {
-  static int32_t get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                     int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::Int32Builder>(builder)->GetValue(
-        idx);
+template <typename T>
+class NumericColumn : public IColumn {
+  using array_t = typename vineyard::ConvertToArrowType<T>::ArrayType;
+  using builder_t = typename vineyard::ConvertToArrowType<T>::BuilderType;
+
+ public:
+  int64_t size() const override { return values_.size(); }
+
+  inline T Get(int64_t idx) const { return values_[idx]; }
+
+  inline void Append(T value) { values_.push_back(value); }
+
+  void AppendRange(const arrow::Array& array, int64_t offset,
+                   int64_t length) override {
+    const T* raw = static_cast<const array_t&>(array).raw_values();
+    values_.reserve(values_.size() + length);
+    for (int64_t i = offset; i < offset + length; i++) {
+      values_.push_back(raw[i]);
+    }
+  }
+
+  void AppendRows(const arrow::Array& array, const int64_t* rows,
+                  size_t row_num) override {
+    const T* raw = static_cast<const array_t&>(array).raw_values();
+    values_.reserve(values_.size() + row_num);
+    for (size_t i = 0; i < row_num; i++) {
+      values_.push_back(raw[rows[i]]);
+    }
+  }
+
+  bl::result<std::shared_ptr<arrow::Array>> Slice(int64_t begin,
+                                                  int64_t end) const override {
+    builder_t builder;
+    std::shared_ptr<arrow::Array> array;
+
+    ARROW_OK_OR_RAISE(builder.Reserve(end - begin));
+    for (int64_t i = begin; i < end; i++) {
+      builder.UnsafeAppend(values_[i]);
+    }
+    ARROW_OK_OR_RAISE(builder.Finish(&array));
+    return array;
   }
+
+  const ChunkedValues<T>& values() const { return values_; }
+
+ private:
+  ChunkedValues<T> values_;
 };
 
-template <>
-struct ValueGetter<double> {
-  static double get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                    int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::DoubleBuilder>(builder)->GetValue(
-        idx);
+class StringColumnBase : public IColumn {
+ public:
+  int64_t size() const override { return values_.size(); }
+
+  inline const std::string& Get(int64_t idx) const { return values_[idx]; }
+
+  inline void Append(const std::string& value) { values_.push_back(value); }
+
+ protected:
+  ChunkedValues<std::string> values_;
+};
+
+// ARRAY_T is either arrow::StringArray or arrow::LargeStringArray
+template <typename ARRAY_T, typename BUILDER_T>
+class StringColumn : public StringColumnBase {
+ public:
+  void AppendRange(const arrow::Array& array, int64_t offset,
+                   int64_t length) override {
+    auto& typed_array = static_cast<const ARRAY_T&>(array);
+    values_.reserve(values_.size() + length);
+    for (int64_t i = offset; i < offset + length; i++) {
+      values_.push_back(typed_array.GetString(i));
+    }
+  }
+
+  void AppendRows(const arrow::Array& array, const int64_t* rows,
+                  size_t row_num) override {
+    auto& typed_array = static_cast<const ARRAY_T&>(array);
+    values_.reserve(values_.size() + row_num);
+    for (size_t i = 0; i < row_num; i++) {
+      values_.push_back(typed_array.GetString(rows[i]));
+    }
+  }
+
+  bl::result<std::shared_ptr<arrow::Array>> Slice(int64_t begin,
+                                                  int64_t end) const override {
+    BUILDER_T builder;
+    std::shared_ptr<arrow::Array> array;
+
+    ARROW_OK_OR_RAISE(builder.Reserve(end - begin));
+    for (int64_t i = begin; i < end; i++) {
+      ARROW_OK_OR_RAISE(builder.Append(values_[i]));
+    }
+    ARROW_OK_OR_RAISE(builder.Finish(&array));
+    return array;
   }
 };
 
-template <>
-struct ValueGetter<float> {
-  static float get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                   int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::FloatBuilder>(builder)->GetValue(
-        idx);
+template <typename T>
+struct ValueGetter {
+  static T get(const IColumn& column, int64_t idx) {
+    return static_cast<const NumericColumn<T>&>(column).Get(idx);
   }
 };
 
 template <>
 struct ValueGetter<std::string> {
-  static std::string get(const std::shared_ptr<arrow::ArrayBuilder>& builder,
-                         int64_t idx) {
-    return std::dynamic_pointer_cast<arrow::LargeStringBuilder>(builder)
-        ->GetView(idx)
-        .to_string();
+  static std::string get(const IColumn& column, int64_t idx) {
+    return static_cast<const StringColumnBase&>(column).Get(idx);
   }
 };
 }  // namespace append_only_arrow_table_impl
 
 /**
- * @brief An arrow table composed by multiple arrow array builder
+ * @brief An arrow table that grows by appending rows. Each column keeps its
+ * values in typed chunks, which are resolved once from the schema of the
+ * first appended table. Thus appending and reading a value is a pointer and
+ * offset access, and rows can be appended in batches.
  */
 class AppendOnlyArrowTable {
+  using IColumn = append_only_arrow_table_impl::IColumn;
+  template <typename T>
+  using NumericColumn = append_only_arrow_table_impl::NumericColumn<T>;
+  using StringColumnBase = append_only_arrow_table_impl::StringColumnBase;
+
  public:
   bl::result<void> AppendValue(int col, uint64_t val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::UInt64Builder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<NumericColumn<uint64_t>&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(int col, int64_t val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::Int64Builder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<NumericColumn<int64_t>&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(int col, uint32_t val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::UInt32Builder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<NumericColumn<uint32_t>&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(int col, int32_t val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::Int32Builder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<NumericColumn<int32_t>&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(int col, double val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::DoubleBuilder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<NumericColumn<double>&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(int col, float val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::FloatBuilder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<NumericColumn<float>&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(int col, std::string& val) {
-    auto builder =
-        std::dynamic_pointer_cast<arrow::LargeStringBuilder>(builders_[col]);
-
-    ARROW_OK_OR_RAISE(builder->Append(val));
+    static_cast<StringColumnBase&>(*columns_[col]).Append(val);
     return {};
   }
 
   bl::result<void> AppendValue(const std::shared_ptr<arrow::Table>& table,
                                int row) {
     CHECK_LT(row, table->num_rows());
-    createBuildersIfNeeded(table);
+    BOOST_LEAF_CHECK(createColumnsIfNeeded(table->schema()));
 
     for (int64_t i = 0; i < table->num_columns(); i++) {
       auto column = table->column(i);
-      auto type = column->type();
 
       CHECK_EQ(column->num_chunks(), 1);
+      columns_[i]->AppendRange(*column->chunk(0), row, 1);
+    }
+    return {};
+  }
 
-      auto chunk = column->chunk(0);
-
-      if (type == arrow::uint64()) {
-        auto array = std::dynamic_pointer_cast<arrow::UInt64Array>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::UInt64Builder>(builders_[i]);
+  /**
+   * @brief Append all rows of the table.
+   */
+  bl::result<void> AppendRows(const std::shared_ptr<arrow::Table>& table) {
+    BOOST_LEAF_CHECK(createColumnsIfNeeded(table->schema()));
 
-        ARROW_OK_OR_RAISE(builder->Append(array->Value(row)));
-      } else if (type == arrow::int64()) {
-        auto array = std::dynamic_pointer_cast<arrow::Int64Array>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::Int64Builder>(builders_[i]);
-        ARROW_OK_OR_RAISE(builder->Append(array->Value(row)));
-      } else if (type == arrow::uint32()) {
-        auto array = std::dynamic_pointer_cast<arrow::UInt32Array>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::UInt32Builder>(builders_[i]);
-
-        ARROW_OK_OR_RAISE(builder->Append(array->Value(row)));
-      } else if (type == arrow::int32()) {
-        auto array = std::dynamic_pointer_cast<arrow::Int32Array>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::Int32Builder>(builders_[i]);
+    for (int64_t i = 0; i < table->num_columns(); i++) {
+      for (auto& chunk : table->column(i)->chunks()) {
+        columns_[i]->AppendRange(*chunk, 0, chunk->length());
+      }
+    }
+    return {};
+  }
 
-        ARROW_OK_OR_RAISE(builder->Append(array->Value(row)));
-      } else if (type == arrow::float64()) {
-        auto array = std::dynamic_pointer_cast<arrow::DoubleArray>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::DoubleBuilder>(builders_[i]);
+  /**
+   * @brief Append the given rows of the table, of which the columns have a
+   * single chunk.
+   */
+  bl::result<void> AppendRows(const std::shared_ptr<arrow::Table>& table,
+                              const std::vector<int64_t>& rows) {
+    if (rows.empty()) {
+      return {};
+    }
+    BOOST_LEAF_CHECK(createColumnsIfNeeded(table->schema()));
 
-        ARROW_OK_OR_RAISE(builder->Append(array->Value(row)));
-      } else if (type == arrow::float32()) {
-        auto array = std::dynamic_pointer_cast<arrow::FloatArray>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::FloatBuilder>(builders_[i]);
+    for (int64_t i = 0; i < table->num_columns(); i++) {
+      auto column = table->column(i);
 
-        ARROW_OK_OR_RAISE(builder->Append(array->Value(row)));
-      } else if (type == arrow::utf8()) {
-        auto array = std::dynamic_pointer_cast<arrow::StringArray>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::StringBuilder>(builders_[i]);
+      CHECK_EQ(column->num_chunks(), 1);
+      columns_[i]->AppendRows(*column->chunk(0), rows.data(), rows.size());
+    }
+    return {};
+  }
 
-        ARROW_OK_OR_RAISE(builder->Append(array->GetString(row)));
-      } else if (type == arrow::large_utf8()) {
-        auto array = std::dynamic_pointer_cast<arrow::LargeStringArray>(chunk);
-        auto builder =
-            std::dynamic_pointer_cast<arrow::LargeStringBuilder>(builders_[i]);
+  bl::result<void> AppendRecordBatch(
+      const std::shared_ptr<arrow::RecordBatch>& batch) {
+    BOOST_LEAF_CHECK(createColumnsIfNeeded(batch->schema()));
 
-        ARROW_OK_OR_RAISE(builder->Append(array->GetString(row)));
-      } else {
-        CHECK(false);
-      }
+    for (int i = 0; i < batch->num_columns(); i++) {
+      columns_[i]->AppendRange(*batch->column(i), 0, batch->num_rows());
     }
     return {};
   }
 
   template <typename T>
-  T GetValue(int column_id, int row_id) {
+  inline T GetValue(int column_id, int64_t row_id) const {
     return append_only_arrow_table_impl::ValueGetter<T>::get(
-        builders_[column_id], row_id);
+        *columns_[column_id], row_id);
   }
 
-  int64_t size() {
-    if (schema_->num_fields() == 0)
+  /**
+   * @brief The chunked values of a numeric column, the pointers to the chunks
+   * are stable while appending.
+   */
+  template <typename T>
+  const append_only_arrow_table_impl::ChunkedValues<T>& GetColumn(
+      int column_id) const {
+    return static_cast<const NumericColumn<T>&>(*columns_[column_id])
+        .values();
+  }
+
+  int64_t size() const {
+    if (columns_.empty())
       return 0;
-    return builders_[0]->length();
+    return columns_[0]->size();
   }
 
   std::shared_ptr<arrow::Schema> schema() { return schema_; }
 
+  /**
+   * @brief Copy the rows [begin, end) to an arrow table, each column of which
+   * has a single chunk.
+   */
+  bl::result<std::shared_ptr<arrow::Table>> Slice(int64_t begin,
+                                                  int64_t end) const {
+    CHECK(schema_ != nullptr);
+    CHECK_LE(begin, end);
+    CHECK_LE(end, size());
+    std::vector<std::shared_ptr<arrow::Array>> columns(columns_.size());
+
+    for (size_t i = 0; i < columns_.size(); i++) {
+      BOOST_LEAF_ASSIGN(columns[i], columns_[i]->Slice(begin, end));
+    }
+    return arrow::Table::Make(schema_, columns);
+  }
+
  private:
   std::shared_ptr<arrow::Schema> schema_;
-  std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders_;
+  std::vector<std::unique_ptr<IColumn>> columns_;
 
-  bl::result<void> createBuildersIfNeeded(
-      const std::shared_ptr<arrow::Table>& table) {
+  bl::result<void> createColumnsIfNeeded(
+      const std::shared_ptr<arrow::Schema>& schema) {
     if (schema_ == nullptr) {
-      schema_ = table->schema();
-      BOOST_LEAF_CHECK(createBuilders());
+      schema_ = schema;
+      BOOST_LEAF_CHECK(createColumns());
     } else {
-      if (!table->schema()->Equals(schema_)) {
+      if (!schema->Equals(schema_)) {
         auto msg = "Different schema compared with previous one. Prev: " +
-                   schema_->ToString() +
-                   " Curr: " + table->schema()->ToString();
+                   schema_->ToString() + " Curr: " + schema->ToString();
         RETURN_GS_ERROR(vineyard::ErrorCode::kArrowError, msg);
       }
     }
     return {};
   }
 
-  bl::result<void> createBuilders() {
+  bl::result<void> createColumns() {
+    using append_only_arrow_table_impl::StringColumn;
     auto& fields = schema_->fields();
     for (const auto& field : fields) {
       auto type = field->type();
 
       if (type == arrow::uint64()) {
-        builders_.push_back(std::make_shared<arrow::UInt64Builder>());
+        columns_.emplace_back(new NumericColumn<uint64_t>());
       } else if (type == arrow::int64()) {
-        builders_.push_back(std::make_shared<arrow::Int64Builder>());
+        columns_.emplace_back(new NumericColumn<int64_t>());
       } else if (type == arrow::uint32()) {
-        builders_.push_back(std::make_shared<arrow::UInt32Builder>());
+        columns_.emplace_back(new NumericColumn<uint32_t>());
       } else if (type == arrow::int32()) {
-        builders_.push_back(std::make_shared<arrow::Int32Builder>());
+        columns_.emplace_back(new NumericColumn<int32_t>());
       } else if (type == arrow::float32()) {
-        builders_.push_back(std::make_shared<arrow::FloatBuilder>());
+        columns_.emplace_back(new NumericColumn<float>());
       } else if (type == arrow::float64()) {
-        builders_.push_back(std::make_shared<arrow::DoubleBuilder>());
+        columns_.emplace_back(new NumericColumn<double>());
       } else if (type == arrow::utf8()) {
-        builders_.push_back(std::make_shared<arrow::StringBuilder>());
+        columns_.emplace_back(
+            new StringColumn<arrow::StringArray, arrow::StringBuilder>());
       } else if (type == arrow::large_utf8()) {
-        builders_.push_back(std::make_shared<arrow::LargeStringBuilder>());
+        columns_.emplace_back(
+            new StringColumn<arrow::LargeStringArray,
+                             arrow::LargeStringBuilder>());
       } else {
         RETURN_GS_ERROR(vineyard::ErrorCode::kArrowError,
                         "Unsupported type: " + type->ToString());
@@ -0,0 +1,1044 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arrow/array.h"
+
+#include "vineyard/basic/ds/arrow_utils.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+
+#include "core/fragment/arrow_projected_fragment.h"
+
+namespace gs {
+
+namespace arrow_flattened_fragment_impl {
+
+/**
+ * @brief VertexTranslator maps the vertices of ArrowFragment to the dense vid
+ * space of ArrowFlattenedFragment. The inner vertices of all projected labels
+ * come first, followed by the outer vertices ordered by fragment id.
+ *
+ * @tparam VID_T VID type
+ */
+template <typename VID_T>
+class VertexTranslator {
+ public:
+  using label_id_t = vineyard::property_graph_types::LABEL_ID_TYPE;
+
+  VID_T ToUnified(VID_T lid) const {
+    int index = label_index_[parser_.GetLabelId(lid)];
+    int64_t offset = parser_.GetOffset(lid);
+    return offset < static_cast<int64_t>(ivnums_[index])
+               ? inner_prefix_[index] + static_cast<VID_T>(offset)
+               : outer_index_[index][offset - ivnums_[index]];
+  }
+
+  bool Contains(VID_T lid) const {
+    label_id_t label = parser_.GetLabelId(lid);
+    return label < static_cast<label_id_t>(label_index_.size()) &&
+           label_index_[label] != -1;
+  }
+
+  vineyard::IdParser<VID_T> parser_;
+  // label_index_[label] is the index in the projection, or -1
+  std::vector<int> label_index_;
+  std::vector<VID_T> ivnums_;
+  std::vector<VID_T> inner_prefix_;
+  // outer_index_[index][offset - ivnum] is the unified vid of outer vertices
+  std::vector<std::vector<VID_T>> outer_index_;
+};
+
+/**
+ * @brief The part of the adjacent list of an inner vertex to iterate.
+ *
+ * @tparam VID_T VID type
+ */
+template <typename VID_T>
+struct AdjSlice {
+  // unified vid and original lid of the vertex
+  VID_T u;
+  VID_T original;
+  bool outgoing;
+  // index of the spliters where the part begins (ends), or kNoSplit for the
+  // beginning (end) of the whole list
+  int from;
+  int to;
+};
+
+static constexpr int kNoSplit = -1;
+
+/**
+ * @brief Neighbor iterator over the nbr units of the projected edge labels of
+ * a vertex. The units are those of the CSR of ArrowFragment, the ones whose
+ * neighbors are not of the projected vertex labels are skipped on the fly.
+ *
+ * @tparam FRAG_T ArrowFlattenedFragment
+ */
+template <typename FRAG_T>
+class Nbr {
+  using vid_t = typename FRAG_T::vid_t;
+  using eid_t = typename FRAG_T::eid_t;
+  using nbr_unit_t = typename FRAG_T::nbr_unit_t;
+  using edata_array_t =
+      arrow_projected_fragment_impl::TypedArray<typename FRAG_T::edata_t>;
+
+ public:
+  // the end of any adjacent list
+  Nbr()
+      : frag_(NULL), next_label_(0), filtered_(false), nbr_(NULL), end_(NULL) {}
+
+  Nbr(const FRAG_T* frag, const AdjSlice<vid_t>& slice)
+      : frag_(frag),
+        slice_(slice),
+        next_label_(0),
+        filtered_(false),
+        nbr_(NULL),
+        end_(NULL) {
+    seek();
+  }
+
+  Nbr(const Nbr& rhs) = default;
+
+  grape::Vertex<vid_t> neighbor() const {
+    return grape::Vertex<vid_t>(frag_->translator_.ToUnified(nbr_->vid));
+  }
+
+  grape::Vertex<vid_t> get_neighbor() const { return neighbor(); }
+
+  eid_t edge_id() const { return nbr_->eid; }
+
+  typename edata_array_t::value_type data() const { return get_data(); }
+
+  typename edata_array_t::value_type get_data() const {
+    return frag_->edata_arrays_[next_label_ - 1][nbr_->eid];
+  }
+
+  inline const Nbr& operator++() const {
+    ++nbr_;
+    seek();
+    return *this;
+  }
+
+  inline Nbr operator++(int) const {
+    Nbr ret(*this);
+    ++(*this);
+    return ret;
+  }
+
+  inline bool operator==(const Nbr& rhs) const { return nbr_ == rhs.nbr_; }
+
+  inline bool operator!=(const Nbr& rhs) const { return nbr_ != rhs.nbr_; }
+
+  inline const Nbr& operator*() const { return *this; }
+
+  inline const Nbr* operator->() const { return this; }
+
+ private:
+  // Moves to the first unit with a projected neighbor from the current one,
+  // going through the following edge labels if necessary.
+  inline void seek() const {
+    while (true) {
+      if (filtered_) {
+        while (nbr_ != end_ && !frag_->translator_.Contains(nbr_->vid)) {
+          ++nbr_;
+        }
+      }
+      if (nbr_ != end_) {
+        return;
+      }
+      if (next_label_ == frag_->e_labels_.size()) {
+        nbr_ = end_ = NULL;
+        return;
+      }
+      frag_->getUnits(slice_, next_label_++, nbr_, end_, filtered_);
+    }
+  }
+
+  const FRAG_T* frag_;
+  AdjSlice<vid_t> slice_;
+  // the index of the current edge label is next_label_ - 1
+  mutable size_t next_label_;
+  mutable bool filtered_;
+  mutable const nbr_unit_t* nbr_;
+  mutable const nbr_unit_t* end_;
+};
+
+/**
+ * @brief Neighbors of a vertex over all projected edge labels.
+ *
+ * @tparam FRAG_T ArrowFlattenedFragment
+ */
+template <typename FRAG_T>
+class AdjList {
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  AdjList() : frag_(NULL) {}
+
+  AdjList(const FRAG_T* frag, const AdjSlice<vid_t>& slice)
+      : frag_(frag), slice_(slice) {}
+
+  Nbr<FRAG_T> begin() const {
+    return frag_ == NULL ? Nbr<FRAG_T>() : Nbr<FRAG_T>(frag_, slice_);
+  }
+
+  Nbr<FRAG_T> end() const { return Nbr<FRAG_T>(); }
+
+  size_t Size() const {
+    return frag_ == NULL ? 0 : frag_->countUnits(slice_);
+  }
+
+  inline bool Empty() const { return begin() == end(); }
+
+  inline bool NotEmpty() const { return !Empty(); }
+
+ private:
+  const FRAG_T* frag_;
+  AdjSlice<vid_t> slice_;
+};
+
+/**
+ * @brief Builds a column of default values, the data of labels without the
+ * projected property.
+ */
+template <typename DATA_T>
+typename std::enable_if<!std::is_same<DATA_T, grape::EmptyType>::value,
+                        std::shared_ptr<arrow::Array>>::type
+default_column(int64_t length) {
+  typename vineyard::ConvertToArrowType<DATA_T>::BuilderType builder;
+  CHECK(builder.Reserve(length).ok());
+  for (int64_t i = 0; i < length; ++i) {
+    CHECK(builder.Append(DATA_T()).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  CHECK(builder.Finish(&array).ok());
+  return array;
+}
+
+template <typename DATA_T>
+typename std::enable_if<std::is_same<DATA_T, grape::EmptyType>::value,
+                        std::shared_ptr<arrow::Array>>::type
+default_column(int64_t) {
+  return nullptr;
+}
+
+}  // namespace arrow_flattened_fragment_impl
+
+/**
+ * @brief ArrowFlattenedFragment is a simple graph view which merges several
+ * vertex labels and edge labels of an ArrowFragment. Vertices of the projected
+ * labels are numbered in a unified dense vid space, and adjacent lists are
+ * iterated over the per-label CSR of ArrowFragment in place, thus neither the
+ * topology nor the property tables are copied.
+ *
+ * Edges of the projected edge labels whose endpoints are not of the projected
+ * vertex labels are skipped. Labels without the projected property have
+ * default data.
+ *
+ * @tparam OID_T OID type
+ * @tparam VID_T VID type
+ * @tparam VDATA_T The type of data attached with the vertex
+ * @tparam EDATA_T The type of data attached with the edge
+ */
+template <typename OID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class ArrowFlattenedFragment {
+ public:
+  using oid_t = OID_T;
+  using vid_t = VID_T;
+  using internal_oid_t = typename vineyard::InternalType<oid_t>::type;
+  using eid_t = vineyard::property_graph_types::EID_TYPE;
+  using vertex_range_t = grape::VertexRange<vid_t>;
+  using vertex_t = grape::Vertex<vid_t>;
+  using nbr_t = arrow_flattened_fragment_impl::Nbr<ArrowFlattenedFragment>;
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<vid_t, eid_t>;
+  using adj_list_t =
+      arrow_flattened_fragment_impl::AdjList<ArrowFlattenedFragment>;
+  using const_adj_list_t = adj_list_t;
+  using label_id_t = vineyard::property_graph_types::LABEL_ID_TYPE;
+  using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
+  using vdata_t = VDATA_T;
+  using edata_t = EDATA_T;
+  using property_graph_t = vineyard::ArrowFragment<oid_t, vid_t>;
+
+  template <typename DATA_T>
+  using vertex_array_t = grape::VertexArray<DATA_T, vid_t>;
+
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  /**
+   * @brief Project the given labels of an ArrowFragment into a simple graph.
+   *
+   * @param v_labels Vertex labels to merge.
+   * @param v_props Property of each vertex label as the vertex data, -1 for
+   * default data.
+   * @param e_labels Edge labels to merge.
+   * @param e_props Property of each edge label as the edge data, -1 for
+   * default data.
+   */
+  static std::shared_ptr<ArrowFlattenedFragment<oid_t, vid_t, vdata_t, edata_t>>
+  Project(std::shared_ptr<property_graph_t> fragment,
+          const std::vector<label_id_t>& v_labels,
+          const std::vector<prop_id_t>& v_props,
+          const std::vector<label_id_t>& e_labels,
+          const std::vector<prop_id_t>& e_props) {
+    if (v_labels.empty() || v_labels.size() != v_props.size() ||
+        e_labels.size() != e_props.size()) {
+      LOG(ERROR) << "Labels and properties of flattened fragment are not "
+                    "matched.";
+      return nullptr;
+    }
+    for (size_t i = 0; i < v_labels.size(); ++i) {
+      if (!checkPropertyType<vdata_t>(fragment->vertex_data_table(v_labels[i]),
+                                      v_props[i])) {
+        LOG(ERROR) << "Vertex data type of flattened fragment is not "
+                      "consistent with property of label "
+                   << v_labels[i];
+        return nullptr;
+      }
+    }
+    for (size_t i = 0; i < e_labels.size(); ++i) {
+      if (!checkPropertyType<edata_t>(fragment->edge_data_table(e_labels[i]),
+                                      e_props[i])) {
+        LOG(ERROR) << "Edge data type of flattened fragment is not "
+                      "consistent with property of label "
+                   << e_labels[i];
+        return nullptr;
+      }
+    }
+    auto flattened = std::make_shared<
+        ArrowFlattenedFragment<oid_t, vid_t, vdata_t, edata_t>>();
+    flattened->init(fragment, v_labels, v_props, e_labels, e_props);
+    return flattened;
+  }
+
+  /**
+   * @brief Splitting edges by the fragment of neighbors requires the nbr units
+   * of every edge label to be grouped by the fragment id of neighbors, with
+   * inner vertices first. ArrowFragment sorts the units by vid, thus the
+   * units of an edge label reaching several vertex labels are grouped by
+   * label first, and such lists are regrouped into a copy.
+   */
+  void PrepareToRunApp(grape::MessageStrategy strategy, bool need_split_edges) {
+    if (need_split_edges) {
+      initEdgeSpliters(true, oe_spliters_, oe_regrouped_);
+      if (directed_) {
+        initEdgeSpliters(false, ie_spliters_, ie_regrouped_);
+      }
+    }
+    if (strategy == grape::MessageStrategy::kAlongEdgeToOuterVertex) {
+      initDestFidList(true, true, iodst_, iodoffset_);
+    } else if (strategy ==
+               grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex) {
+      initDestFidList(true, false, idst_, idoffset_);
+    } else if (strategy ==
+               grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex) {
+      initDestFidList(false, true, odst_, odoffset_);
+    }
+    initMirrorInfo();
+  }
+
+  inline fid_t fid() const { return fid_; }
+
+  inline fid_t fnum() const { return fnum_; }
+
+  inline bool directed() const { return directed_; }
+
+  inline vertex_range_t Vertices() const { return vertex_range_t(0, tvnum_); }
+
+  inline vertex_range_t InnerVertices() const {
+    return vertex_range_t(0, ivnum_);
+  }
+
+  inline vertex_range_t OuterVertices() const {
+    return vertex_range_t(ivnum_, tvnum_);
+  }
+
+  inline vertex_range_t OuterVertices(fid_t fid) const {
+    return vertex_range_t(outer_vertex_offsets_[fid],
+                          outer_vertex_offsets_[fid + 1]);
+  }
+
+  inline const std::vector<vertex_t>& MirrorVertices(fid_t fid) const {
+    return mirrors_of_frag_[fid];
+  }
+
+  inline bool GetVertex(const oid_t& oid, vertex_t& v) const {
+    typename property_graph_t::vertex_t u;
+    for (auto label : v_labels_) {
+      if (fragment_->GetVertex(label, oid, u)) {
+        v.SetValue(translator_.ToUnified(u.GetValue()));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline oid_t GetId(const vertex_t& v) const {
+    return fragment_->GetId(toOriginal(v));
+  }
+
+  inline fid_t GetFragId(const vertex_t& v) const {
+    return IsInnerVertex(v) ? fid_
+                            : unified_parser_.GetFid(GetOuterVertexGid(v));
+  }
+
+  inline typename arrow_projected_fragment_impl::TypedArray<VDATA_T>::value_type
+  GetData(const vertex_t& v) const {
+    size_t index = innerLabelIndex(v.GetValue());
+    return vdata_arrays_[index][v.GetValue() -
+                                translator_.inner_prefix_[index]];
+  }
+
+  inline bool Gid2Vertex(const vid_t& gid, vertex_t& v) const {
+    return (unified_parser_.GetFid(gid) == fid_)
+               ? InnerVertexGid2Vertex(gid, v)
+               : OuterVertexGid2Vertex(gid, v);
+  }
+
+  inline vid_t Vertex2Gid(const vertex_t& v) const {
+    return IsInnerVertex(v) ? GetInnerVertexGid(v) : GetOuterVertexGid(v);
+  }
+
+  inline vid_t GetInnerVerticesNum() const { return ivnum_; }
+
+  inline vid_t GetOuterVerticesNum() const { return tvnum_ - ivnum_; }
+
+  inline vid_t GetVerticesNum() const { return tvnum_; }
+
+  inline size_t GetEdgeNum() const { return edge_num_; }
+
+  inline size_t GetTotalVerticesNum() const { return total_vertex_num_; }
+
+  inline bool IsInnerVertex(const vertex_t& v) const {
+    return v.GetValue() < ivnum_;
+  }
+
+  inline bool IsOuterVertex(const vertex_t& v) const {
+    return v.GetValue() >= ivnum_ && v.GetValue() < tvnum_;
+  }
+
+  inline bool GetInnerVertex(const oid_t& oid, vertex_t& v) const {
+    return GetVertex(oid, v) && IsInnerVertex(v);
+  }
+
+  inline bool GetOuterVertex(const oid_t& oid, vertex_t& v) const {
+    return GetVertex(oid, v) && IsOuterVertex(v);
+  }
+
+  inline oid_t GetInnerVertexId(const vertex_t& v) const { return GetId(v); }
+
+  inline oid_t GetOuterVertexId(const vertex_t& v) const { return GetId(v); }
+
+  inline oid_t Gid2Oid(const vid_t& gid) const {
+    return fragment_->Gid2Oid(toOriginalGid(gid));
+  }
+
+  inline bool Oid2Gid(const oid_t& oid, vid_t& gid) const {
+    vid_t original_gid;
+    for (auto label : v_labels_) {
+      if (fragment_->Oid2Gid(label, oid, original_gid)) {
+        gid = toUnifiedGid(original_gid);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline bool InnerVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    int64_t offset = unified_parser_.GetOffset(gid);
+    if (unified_parser_.GetFid(gid) != fid_ ||
+        unified_parser_.GetLabelId(gid) != 0 ||
+        offset >= static_cast<int64_t>(ivnum_)) {
+      return false;
+    }
+    v.SetValue(static_cast<vid_t>(offset));
+    return true;
+  }
+
+  inline bool OuterVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    typename property_graph_t::vertex_t u;
+    if (fragment_->OuterVertexGid2Vertex(toOriginalGid(gid), u)) {
+      v.SetValue(translator_.ToUnified(u.GetValue()));
+      return true;
+    }
+    return false;
+  }
+
+  inline vid_t GetOuterVertexGid(const vertex_t& v) const {
+    return outer_gids_[v.GetValue() - ivnum_];
+  }
+
+  inline vid_t GetInnerVertexGid(const vertex_t& v) const {
+    return unified_parser_.GenerateId(fid_, 0, v.GetValue());
+  }
+
+  inline adj_list_t GetIncomingAdjList(const vertex_t& v) const {
+    return makeAdjList(v, false, kNoSplit, kNoSplit);
+  }
+
+  inline adj_list_t GetOutgoingAdjList(const vertex_t& v) const {
+    return makeAdjList(v, true, kNoSplit, kNoSplit);
+  }
+
+  inline adj_list_t GetIncomingInnerVertexAdjList(const vertex_t& v) const {
+    return makeAdjList(v, false, kNoSplit, 0);
+  }
+
+  inline adj_list_t GetOutgoingInnerVertexAdjList(const vertex_t& v) const {
+    return makeAdjList(v, true, kNoSplit, 0);
+  }
+
+  inline adj_list_t GetIncomingOuterVertexAdjList(const vertex_t& v) const {
+    return makeAdjList(v, false, 0, kNoSplit);
+  }
+
+  inline adj_list_t GetOutgoingOuterVertexAdjList(const vertex_t& v) const {
+    return makeAdjList(v, true, 0, kNoSplit);
+  }
+
+  inline adj_list_t GetIncomingAdjList(const vertex_t& v, fid_t src_fid) const {
+    return makeAdjList(v, false, src_fid, src_fid + 1);
+  }
+
+  inline adj_list_t GetOutgoingAdjList(const vertex_t& v, fid_t dst_fid) const {
+    return makeAdjList(v, true, dst_fid, dst_fid + 1);
+  }
+
+  inline int GetLocalOutDegree(const vertex_t& v) const {
+    return GetOutgoingAdjList(v).Size();
+  }
+
+  inline int GetLocalInDegree(const vertex_t& v) const {
+    return GetIncomingAdjList(v).Size();
+  }
+
+  inline grape::DestList IEDests(const vertex_t& v) const {
+    assert(IsInnerVertex(v));
+    return grape::DestList(idoffset_[v.GetValue()],
+                           idoffset_[v.GetValue() + 1]);
+  }
+
+  inline grape::DestList OEDests(const vertex_t& v) const {
+    assert(IsInnerVertex(v));
+    return grape::DestList(odoffset_[v.GetValue()],
+                           odoffset_[v.GetValue() + 1]);
+  }
+
+  inline grape::DestList IOEDests(const vertex_t& v) const {
+    assert(IsInnerVertex(v));
+    return grape::DestList(iodoffset_[v.GetValue()],
+                           iodoffset_[v.GetValue() + 1]);
+  }
+
+ private:
+  using original_vertex_t = typename property_graph_t::vertex_t;
+  using slice_t = arrow_flattened_fragment_impl::AdjSlice<vid_t>;
+
+  // nbr units of an edge label regrouped by the fragment of neighbors, the
+  // units of inner vertex u are units[offsets[u], offsets[u + 1])
+  struct RegroupedUnits {
+    std::vector<size_t> offsets;
+    std::vector<nbr_unit_t> units;
+  };
+
+  friend class arrow_flattened_fragment_impl::Nbr<ArrowFlattenedFragment>;
+  friend class arrow_flattened_fragment_impl::AdjList<ArrowFlattenedFragment>;
+
+  static constexpr int kNoSplit = arrow_flattened_fragment_impl::kNoSplit;
+
+  template <typename DATA_T>
+  static bool checkPropertyType(std::shared_ptr<arrow::Table> table,
+                                prop_id_t prop) {
+    if (prop == -1 || std::is_same<DATA_T, grape::EmptyType>::value) {
+      return prop == -1;
+    }
+    return table->field(prop)->type()->Equals(
+        vineyard::ConvertToArrowType<DATA_T>::TypeValue());
+  }
+
+  // Returns the column of the property, or a column of default values for
+  // labels without the property. The columns are kept alive by the fragment.
+  template <typename DATA_T>
+  std::shared_ptr<arrow::Array> getColumn(std::shared_ptr<arrow::Table> table,
+                                          prop_id_t prop) {
+    std::shared_ptr<arrow::Array> column;
+    if (prop == -1) {
+      column = arrow_flattened_fragment_impl::default_column<DATA_T>(
+          table->num_rows());
+    } else if (table->num_rows() != 0) {
+      column = table->column(prop)->chunk(0);
+    }
+    if (column != nullptr) {
+      columns_.push_back(column);
+    }
+    return column;
+  }
+
+  void init(std::shared_ptr<property_graph_t> fragment,
+            const std::vector<label_id_t>& v_labels,
+            const std::vector<prop_id_t>& v_props,
+            const std::vector<label_id_t>& e_labels,
+            const std::vector<prop_id_t>& e_props) {
+    fragment_ = fragment;
+    v_labels_ = v_labels;
+    e_labels_ = e_labels;
+    fid_ = fragment->fid();
+    fnum_ = fragment->fnum();
+    directed_ = fragment->directed();
+
+    size_t label_num = v_labels.size();
+    translator_.parser_.Init(fnum_, fragment->vertex_label_num());
+    unified_parser_.Init(fnum_, 1);
+    translator_.label_index_.clear();
+    translator_.label_index_.resize(fragment->vertex_label_num(), -1);
+    translator_.ivnums_.resize(label_num);
+    translator_.inner_prefix_.resize(label_num + 1, 0);
+    for (size_t i = 0; i < label_num; ++i) {
+      translator_.label_index_[v_labels[i]] = static_cast<int>(i);
+      translator_.ivnums_[i] = fragment->GetInnerVerticesNum(v_labels[i]);
+      translator_.inner_prefix_[i + 1] =
+          translator_.inner_prefix_[i] + translator_.ivnums_[i];
+    }
+    ivnum_ = translator_.inner_prefix_[label_num];
+
+    // inner vertex prefix of every fragment, to generate unified gids
+    auto vm_ptr = fragment->GetVertexMap();
+    total_vertex_num_ = 0;
+    remote_inner_prefix_.resize(fnum_);
+    for (fid_t fid = 0; fid < fnum_; ++fid) {
+      auto& prefix = remote_inner_prefix_[fid];
+      prefix.resize(label_num + 1, 0);
+      for (size_t i = 0; i < label_num; ++i) {
+        prefix[i + 1] =
+            prefix[i] + vm_ptr->GetInnerVertexSize(fid, v_labels[i]);
+      }
+      total_vertex_num_ += prefix[label_num];
+    }
+
+    initOuterVertices();
+
+    for (size_t i = 0; i < label_num; ++i) {
+      vdata_arrays_.emplace_back(getColumn<vdata_t>(
+          fragment->vertex_data_table(v_labels[i]), v_props[i]));
+    }
+    for (size_t i = 0; i < e_labels.size(); ++i) {
+      edata_arrays_.emplace_back(getColumn<edata_t>(
+          fragment->edge_data_table(e_labels[i]), e_props[i]));
+    }
+
+    initEdgeLabels();
+  }
+
+  // number the outer vertices of all projected labels by fragment id
+  void initOuterVertices() {
+    size_t label_num = v_labels_.size();
+    std::vector<std::vector<original_vertex_t>> outer_of_frag(fnum_);
+    for (size_t i = 0; i < label_num; ++i) {
+      for (auto v : fragment_->OuterVertices(v_labels_[i])) {
+        outer_of_frag[fragment_->GetFragId(v)].push_back(v);
+      }
+    }
+    translator_.outer_index_.resize(label_num);
+    for (size_t i = 0; i < label_num; ++i) {
+      translator_.outer_index_[i].resize(
+          fragment_->GetOuterVerticesNum(v_labels_[i]));
+    }
+    outer_lids_.clear();
+    outer_gids_.clear();
+    outer_vertex_offsets_.resize(fnum_ + 1);
+    vid_t cur = ivnum_;
+    for (fid_t fid = 0; fid < fnum_; ++fid) {
+      outer_vertex_offsets_[fid] = cur;
+      for (auto& v : outer_of_frag[fid]) {
+        vid_t lid = v.GetValue();
+        int index =
+            translator_.label_index_[translator_.parser_.GetLabelId(lid)];
+        int64_t offset = translator_.parser_.GetOffset(lid);
+        translator_.outer_index_[index][offset - translator_.ivnums_[index]] =
+            cur++;
+        outer_lids_.push_back(lid);
+        outer_gids_.push_back(toUnifiedGid(fragment_->GetOuterVertexGid(v)));
+      }
+    }
+    outer_vertex_offsets_[fnum_] = cur;
+    tvnum_ = cur;
+  }
+
+  // Finds out the edge labels having neighbors not of the projected vertex
+  // labels, which must be checked when iterating, and counts the edges kept.
+  void initEdgeLabels() {
+    size_t label_num = e_labels_.size();
+    oe_filtered_.assign(label_num, false);
+    ie_filtered_.assign(label_num, false);
+    edge_num_ = 0;
+    for (size_t i = 0; i < label_num; ++i) {
+      // an edge between inner vertices appears in lists of both endpoints
+      std::vector<bool> counted(
+          fragment_->edge_data_table(e_labels_[i])->num_rows(), false);
+      oe_filtered_[i] = scanUnits(true, i, counted);
+      ie_filtered_[i] = directed_ ? scanUnits(false, i, counted) : false;
+    }
+  }
+
+  bool scanUnits(bool outgoing, size_t index, std::vector<bool>& counted) {
+    bool filtered = false;
+    for (vid_t u = 0; u < ivnum_; ++u) {
+      auto v = toOriginal(vertex_t(u));
+      auto adj_list = outgoing
+                          ? fragment_->GetOutgoingAdjList(v, e_labels_[index])
+                          : fragment_->GetIncomingAdjList(v, e_labels_[index]);
+      for (const nbr_unit_t* nbr = adj_list.begin_unit();
+           nbr != adj_list.end_unit(); ++nbr) {
+        if (!translator_.Contains(nbr->vid)) {
+          filtered = true;
+        } else if (!counted[nbr->eid]) {
+          counted[nbr->eid] = true;
+          ++edge_num_;
+        }
+      }
+    }
+    return filtered;
+  }
+
+  // ArrowFragment keeps no edges of outer vertices
+  inline adj_list_t makeAdjList(const vertex_t& v, bool outgoing, int from,
+                                int to) const {
+    if (!IsInnerVertex(v)) {
+      return adj_list_t();
+    }
+    return adj_list_t(this, slice_t{v.GetValue(), toOriginal(v).GetValue(),
+                                    outgoing || !directed_, from, to});
+  }
+
+  // Units of the index-th projected edge label in the list of the original
+  // vertex, as ArrowFragment stores them.
+  inline void getOriginalUnits(vid_t original, bool outgoing, size_t index,
+                               const nbr_unit_t*& begin,
+                               const nbr_unit_t*& end) const {
+    original_vertex_t v(original);
+    auto adj_list = outgoing
+                        ? fragment_->GetOutgoingAdjList(v, e_labels_[index])
+                        : fragment_->GetIncomingAdjList(v, e_labels_[index]);
+    begin = adj_list.begin_unit();
+    end = adj_list.end_unit();
+  }
+
+  // Units of the index-th projected edge label in the slice, filtered is set
+  // if some of them have neighbors not of the projected vertex labels. The
+  // regrouped copy is used if the units of the label are regrouped.
+  inline void getUnits(const slice_t& slice, size_t index,
+                       const nbr_unit_t*& begin, const nbr_unit_t*& end,
+                       bool& filtered) const {
+    auto& regrouped = slice.outgoing ? oe_regrouped_ : ie_regrouped_;
+    if (index < regrouped.size() && !regrouped[index].offsets.empty()) {
+      auto& units = regrouped[index];
+      begin = units.units.data() + units.offsets[slice.u];
+      end = units.units.data() + units.offsets[slice.u + 1];
+    } else {
+      getOriginalUnits(slice.original, slice.outgoing, index, begin, end);
+    }
+    const nbr_unit_t* first = begin;
+    if (slice.from != kNoSplit || slice.to != kNoSplit) {
+      auto& spliters = slice.outgoing ? oe_spliters_ : ie_spliters_;
+      size_t pos = slice.u * e_labels_.size() + index;
+      if (slice.from != kNoSplit) {
+        begin = first + spliters[slice.from][pos];
+      }
+      if (slice.to != kNoSplit) {
+        end = first + spliters[slice.to][pos];
+      }
+    }
+    filtered = slice.outgoing ? oe_filtered_[index] : ie_filtered_[index];
+  }
+
+  size_t countUnits(const slice_t& slice) const {
+    size_t size = 0;
+    const nbr_unit_t *begin, *end;
+    bool filtered;
+    for (size_t i = 0; i < e_labels_.size(); ++i) {
+      getUnits(slice, i, begin, end, filtered);
+      if (!filtered) {
+        size += end - begin;
+        continue;
+      }
+      for (; begin != end; ++begin) {
+        size += translator_.Contains(begin->vid);
+      }
+    }
+    return size;
+  }
+
+  // Neighbors are grouped in the order of inner ones, then ones of fragment
+  // 0, 1, ... except this fragment.
+  inline fid_t groupOf(const nbr_unit_t& nbr) const {
+    fid_t fid = fragment_->GetFragId(original_vertex_t(nbr.vid));
+    return fid == fid_ ? 0 : fid + 1;
+  }
+
+  // Whether the units of the index-th edge label in every list are grouped
+  // by the fragment of neighbors.
+  bool isGrouped(bool outgoing, size_t index) const {
+    const nbr_unit_t *begin, *end;
+    for (vid_t u = 0; u < ivnum_; ++u) {
+      getOriginalUnits(toOriginal(vertex_t(u)).GetValue(), outgoing, index,
+                       begin, end);
+      for (const nbr_unit_t* nbr = begin; nbr != end && nbr + 1 != end;
+           ++nbr) {
+        if (groupOf(*nbr) > groupOf(*(nbr + 1))) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Copies the units of the index-th edge label of all inner vertices, with
+  // the units of every list stably sorted by the group of neighbors.
+  void regroupUnits(bool outgoing, size_t index, RegroupedUnits& regrouped) {
+    regrouped.offsets.resize(static_cast<size_t>(ivnum_) + 1);
+    regrouped.offsets[0] = 0;
+    const nbr_unit_t *begin, *end;
+    for (vid_t u = 0; u < ivnum_; ++u) {
+      getOriginalUnits(toOriginal(vertex_t(u)).GetValue(), outgoing, index,
+                       begin, end);
+      regrouped.offsets[u + 1] = regrouped.offsets[u] + (end - begin);
+    }
+    regrouped.units.resize(regrouped.offsets[ivnum_]);
+    for (vid_t u = 0; u < ivnum_; ++u) {
+      getOriginalUnits(toOriginal(vertex_t(u)).GetValue(), outgoing, index,
+                       begin, end);
+      auto first = regrouped.units.begin() + regrouped.offsets[u];
+      std::copy(begin, end, first);
+      std::stable_sort(first, first + (end - begin),
+                       [this](const nbr_unit_t& lhs, const nbr_unit_t& rhs) {
+                         return groupOf(lhs) < groupOf(rhs);
+                       });
+    }
+  }
+
+  // spliters[0][pos] is the end of inner neighbors, and spliters[fid + 1][pos]
+  // is the end of neighbors in fragment fid, relative to the beginning of the
+  // list, where pos = u * e_labels_.size() + index of the edge label. The
+  // lists of edge labels whose units are not grouped by fragment are
+  // regrouped first.
+  void initEdgeSpliters(bool outgoing,
+                        std::vector<std::vector<uint32_t>>& spliters,
+                        std::vector<RegroupedUnits>& regrouped) {
+    if (!spliters.empty()) {
+      return;
+    }
+    size_t label_num = e_labels_.size();
+    regrouped.resize(label_num);
+    for (size_t i = 0; i < label_num; ++i) {
+      if (!isGrouped(outgoing, i)) {
+        VLOG(1) << "[frag-" << fid_ << "] Regroup the "
+                << (outgoing ? "outgoing" : "incoming") << " edges of label "
+                << e_labels_[i] << " by fragment";
+        regroupUnits(outgoing, i, regrouped[i]);
+      }
+    }
+
+    spliters.resize(fnum_ + 1);
+    for (auto& vec : spliters) {
+      vec.resize(static_cast<size_t>(ivnum_) * label_num);
+    }
+    std::vector<uint32_t> frag_count(fnum_);
+    const nbr_unit_t *begin, *end;
+    bool filtered;
+    for (vid_t u = 0; u < ivnum_; ++u) {
+      vertex_t v(u);
+      slice_t slice{u, toOriginal(v).GetValue(), outgoing, kNoSplit, kNoSplit};
+      for (size_t i = 0; i < label_num; ++i) {
+        getUnits(slice, i, begin, end, filtered);
+        std::fill(frag_count.begin(), frag_count.end(), 0);
+        fid_t last_group = 0;
+        for (const nbr_unit_t* nbr = begin; nbr != end; ++nbr) {
+          fid_t group = groupOf(*nbr);
+          CHECK_LE(last_group, group);
+          last_group = group;
+          ++frag_count[fragment_->GetFragId(original_vertex_t(nbr->vid))];
+        }
+        size_t pos = u * label_num + i;
+        uint32_t offset = frag_count[fid_];
+        frag_count[fid_] = 0;
+        spliters[0][pos] = offset;
+        for (fid_t j = 0; j < fnum_; ++j) {
+          offset += frag_count[j];
+          spliters[j + 1][pos] = offset;
+        }
+        CHECK_EQ(static_cast<ptrdiff_t>(offset), end - begin);
+      }
+    }
+  }
+
+  inline size_t innerLabelIndex(vid_t u) const {
+    auto& prefix = translator_.inner_prefix_;
+    return std::upper_bound(prefix.begin(), prefix.end(), u) - prefix.begin() -
+           1;
+  }
+
+  inline original_vertex_t toOriginal(const vertex_t& v) const {
+    vid_t u = v.GetValue();
+    if (u < ivnum_) {
+      size_t index = innerLabelIndex(u);
+      return original_vertex_t(translator_.parser_.GenerateId(
+          0, v_labels_[index], u - translator_.inner_prefix_[index]));
+    }
+    return original_vertex_t(outer_lids_[u - ivnum_]);
+  }
+
+  inline vid_t toUnifiedGid(vid_t original_gid) const {
+    fid_t fid = translator_.parser_.GetFid(original_gid);
+    int index = translator_.label_index_[translator_.parser_.GetLabelId(
+        original_gid)];
+    return unified_parser_.GenerateId(
+        fid, 0,
+        remote_inner_prefix_[fid][index] +
+            translator_.parser_.GetOffset(original_gid));
+  }
+
+  inline vid_t toOriginalGid(vid_t gid) const {
+    fid_t fid = unified_parser_.GetFid(gid);
+    int64_t offset = unified_parser_.GetOffset(gid);
+    auto& prefix = remote_inner_prefix_[fid];
+    size_t index = std::upper_bound(prefix.begin(), prefix.end(), offset) -
+                   prefix.begin() - 1;
+    return translator_.parser_.GenerateId(fid, v_labels_[index],
+                                          offset - prefix[index]);
+  }
+
+  void initDestFidList(bool in_edge, bool out_edge,
+                       std::vector<fid_t>& fid_list,
+                       std::vector<fid_t*>& fid_list_offset) {
+    if (!fid_list_offset.empty()) {
+      return;
+    }
+
+    fid_list_offset.resize(ivnum_ + 1, NULL);
+
+    std::set<fid_t> dstset;
+    std::vector<int> id_num(ivnum_, 0);
+
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      vertex_t v(i);
+      dstset.clear();
+      if (in_edge) {
+        for (auto& e : GetIncomingAdjList(v)) {
+          fid_t f = GetFragId(e.neighbor());
+          if (f != fid_) {
+            dstset.insert(f);
+          }
+        }
+      }
+      if (out_edge) {
+        for (auto& e : GetOutgoingAdjList(v)) {
+          fid_t f = GetFragId(e.neighbor());
+          if (f != fid_) {
+            dstset.insert(f);
+          }
+        }
+      }
+      id_num[i] = dstset.size();
+      for (auto fid : dstset) {
+        fid_list.push_back(fid);
+      }
+    }
+
+    fid_list.shrink_to_fit();
+    fid_list_offset[0] = fid_list.data();
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      fid_list_offset[i + 1] = fid_list_offset[i] + id_num[i];
+    }
+  }
+
+  void initMirrorInfo() {
+    if (!mirrors_of_frag_.empty()) {
+      return;
+    }
+
+    mirrors_of_frag_.resize(fnum_);
+
+    std::vector<bool> bm(fnum_, false);
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      vertex_t v(i);
+      for (auto& e : GetOutgoingAdjList(v)) {
+        bm[GetFragId(e.get_neighbor())] = true;
+      }
+      for (auto& e : GetIncomingAdjList(v)) {
+        bm[GetFragId(e.get_neighbor())] = true;
+      }
+
+      for (fid_t j = 0; j != fnum_; ++j) {
+        if ((j != fid_) && bm[j]) {
+          mirrors_of_frag_[j].push_back(v);
+          bm[j] = false;
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<property_graph_t> fragment_;
+  std::vector<label_id_t> v_labels_, e_labels_;
+
+  fid_t fid_, fnum_;
+  bool directed_;
+  vid_t ivnum_, tvnum_;
+  size_t edge_num_;
+  size_t total_vertex_num_;
+
+  arrow_flattened_fragment_impl::VertexTranslator<vid_t> translator_;
+  // parser of unified gids, in which every fragment has a single label
+  vineyard::IdParser<vid_t> unified_parser_;
+  // remote_inner_prefix_[fid][index] is the first unified offset of the
+  // inner vertices of v_labels_[index] in fragment fid
+  std::vector<std::vector<vid_t>> remote_inner_prefix_;
+  // original lids and unified gids of outer vertices
+  std::vector<vid_t> outer_lids_;
+  std::vector<vid_t> outer_gids_;
+  std::vector<vid_t> outer_vertex_offsets_;
+
+  std::vector<arrow_projected_fragment_impl::TypedArray<VDATA_T>> vdata_arrays_;
+  std::vector<arrow_projected_fragment_impl::TypedArray<EDATA_T>> edata_arrays_;
+  // the columns viewed by the typed arrays above
+  std::vector<std::shared_ptr<arrow::Array>> columns_;
+
+  // whether the edge labels have neighbors to skip, incoming lists are not
+  // used if the fragment is undirected
+  std::vector<bool> oe_filtered_, ie_filtered_;
+  // built if edges are split, see initEdgeSpliters
+  std::vector<std::vector<uint32_t>> oe_spliters_, ie_spliters_;
+  // empty for the edge labels whose units are grouped by fragment already
+  std::vector<RegroupedUnits> oe_regrouped_, ie_regrouped_;
+
+  std::vector<fid_t> idst_, odst_, iodst_;
+  std::vector<fid_t*> idoffset_, odoffset_, iodoffset_;
+
+  std::vector<std::vector<vertex_t>> mirrors_of_frag_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
@@ -111,6 +111,166 @@ struct TypedArray<std::string> {
   arrow::LargeStringArray* array_;
 };
 
+/**
+ * @brief InlineEdgeData materializes the edge data in the order of nbr units,
+ * which are co-located with the CSR, thus apps read the edge data
+ * sequentially instead of random access by eid. Only fixed-width edge data is
+ * supported, and it is inlined when the projection asks for it.
+ *
+ * @tparam EDATA_T Edge data type
+ */
+template <typename EDATA_T, typename Enable = void>
+struct InlineEdgeData {
+  static constexpr bool supported = false;
+
+  template <typename NBR_UNIT_T>
+  static std::shared_ptr<arrow::Array> Materialize(
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      std::shared_ptr<arrow::Array> edata_array) {
+    return nullptr;
+  }
+
+  template <typename NBR_UNIT_T>
+  static std::shared_ptr<vineyard::Object> Build(
+      vineyard::Client& client,
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      std::shared_ptr<arrow::Array> edata_array) {
+    return nullptr;
+  }
+
+  static std::shared_ptr<arrow::Array> Resolve(
+      const vineyard::ObjectMeta& meta) {
+    return nullptr;
+  }
+
+  static const EDATA_T* RawValues(std::shared_ptr<arrow::Array> array) {
+    return NULL;
+  }
+};
+
+template <typename EDATA_T>
+struct InlineEdgeData<EDATA_T, typename std::enable_if<
+                                   std::is_arithmetic<EDATA_T>::value>::type> {
+  using array_t = typename vineyard::ConvertToArrowType<EDATA_T>::ArrayType;
+  using builder_t = typename vineyard::ConvertToArrowType<EDATA_T>::BuilderType;
+
+  static constexpr bool supported = true;
+
+  template <typename NBR_UNIT_T>
+  static std::shared_ptr<arrow::Array> Materialize(
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      std::shared_ptr<arrow::Array> edata_array) {
+    builder_t builder;
+    int64_t length = nbr_list->length();
+    ARROW_CHECK_OK(builder.Reserve(length));
+    if (length > 0) {
+      const EDATA_T* edata =
+          std::dynamic_pointer_cast<array_t>(edata_array)->raw_values();
+      const NBR_UNIT_T* nbrs =
+          reinterpret_cast<const NBR_UNIT_T*>(nbr_list->GetValue(0));
+      for (int64_t i = 0; i < length; ++i) {
+        builder.UnsafeAppend(edata[nbrs[i].eid]);
+      }
+    }
+    std::shared_ptr<array_t> array;
+    ARROW_CHECK_OK(builder.Finish(&array));
+    return array;
+  }
+
+  template <typename NBR_UNIT_T>
+  static std::shared_ptr<vineyard::Object> Build(
+      vineyard::Client& client,
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      std::shared_ptr<arrow::Array> edata_array) {
+    vineyard::NumericArrayBuilder<EDATA_T> array_builder(
+        client, std::dynamic_pointer_cast<array_t>(
+                    Materialize<NBR_UNIT_T>(nbr_list, edata_array)));
+    return array_builder.Seal(client);
+  }
+
+  static std::shared_ptr<arrow::Array> Resolve(
+      const vineyard::ObjectMeta& meta) {
+    vineyard::NumericArray<EDATA_T> inline_edata;
+    inline_edata.Construct(meta);
+    return inline_edata.GetArray();
+  }
+
+  static const EDATA_T* RawValues(std::shared_ptr<arrow::Array> array) {
+    return array == nullptr
+               ? NULL
+               : std::dynamic_pointer_cast<array_t>(array)->raw_values();
+  }
+};
+
+/**
+ * @brief EdgeDataCursor reads the edge data of a nbr from the edge table by
+ * eid. Fixed-width edge data may be inlined, then the cursor moves along with
+ * the nbr instead.
+ *
+ * @tparam EDATA_T Edge data type
+ */
+template <typename EDATA_T, typename Enable = void>
+class EdgeDataCursor {
+ public:
+  using value_type = typename TypedArray<EDATA_T>::value_type;
+
+  EdgeDataCursor() {}
+
+  EdgeDataCursor(const TypedArray<EDATA_T>& edata_array, const EDATA_T*,
+                 const EDATA_T*, int64_t)
+      : edata_array_(edata_array) {}
+
+  template <typename NBR_UNIT_T>
+  inline value_type Get(const NBR_UNIT_T* nbr) const {
+    return edata_array_[nbr->eid];
+  }
+
+  inline void Advance(int64_t) {}
+
+ private:
+  TypedArray<EDATA_T> edata_array_;
+};
+
+/**
+ * @brief The cursor of fixed-width edge data reads either the inlined array at
+ * the position of the nbr, or the raw values of the edge table at the eid. The
+ * two modes only differ in the masks applied to the eid and to the step, thus
+ * no branch is left in get_data.
+ */
+template <typename EDATA_T>
+class EdgeDataCursor<EDATA_T, typename std::enable_if<
+                                  InlineEdgeData<EDATA_T>::supported>::type> {
+ public:
+  using value_type = EDATA_T;
+
+  EdgeDataCursor() : edata_(NULL), eid_mask_(0), step_mask_(0) {}
+
+  EdgeDataCursor(const TypedArray<EDATA_T>&, const EDATA_T* edge_table,
+                 const EDATA_T* inline_edata, int64_t offset) {
+    if (inline_edata != NULL) {
+      edata_ = inline_edata + offset;
+      eid_mask_ = 0;
+      step_mask_ = ~static_cast<int64_t>(0);
+    } else {
+      edata_ = edge_table;
+      eid_mask_ = ~static_cast<uint64_t>(0);
+      step_mask_ = 0;
+    }
+  }
+
+  template <typename NBR_UNIT_T>
+  inline value_type Get(const NBR_UNIT_T* nbr) const {
+    return edata_[static_cast<uint64_t>(nbr->eid) & eid_mask_];
+  }
+
+  inline void Advance(int64_t n) { edata_ += (n & step_mask_); }
+
+ private:
+  const EDATA_T* edata_;
+  uint64_t eid_mask_;
+  int64_t step_mask_;
+};
+
 /**
  * @brief This is the internal representation of a neighbor vertex
  *
@@ -123,12 +283,13 @@ class Nbr {
   using vid_t = VID_T;
   using eid_t = EID_T;
   using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
+  using cursor_t = EdgeDataCursor<EDATA_T>;
 
  public:
-  Nbr(const nbr_unit_t* nbr, TypedArray<EDATA_T> edata_array)
-      : nbr_(nbr), edata_array_(edata_array) {}
+  Nbr(const nbr_unit_t* nbr, const cursor_t& edata)
+      : nbr_(nbr), edata_(edata) {}
 
-  Nbr(const Nbr& rhs) : nbr_(rhs.nbr_), edata_array_(rhs.edata_array_) {}
+  Nbr(const Nbr& rhs) : nbr_(rhs.nbr_), edata_(rhs.edata_) {}
 
   grape::Vertex<vid_t> neighbor() const {
     return grape::Vertex<vid_t>(nbr_->vid);
@@ -140,16 +301,13 @@ class Nbr {
 
   eid_t edge_id() const { return nbr_->eid; }
 
-  typename TypedArray<EDATA_T>::value_type data() const {
-    return edata_array_[nbr_->eid];
-  }
+  typename cursor_t::value_type data() const { return get_data(); }
 
-  typename TypedArray<EDATA_T>::value_type get_data() const {
-    return edata_array_[nbr_->eid];
-  }
+  typename cursor_t::value_type get_data() const { return edata_.Get(nbr_); }
 
   inline const Nbr& operator++() const {
     ++nbr_;
+    edata_.Advance(1);
     return *this;
   }
 
@@ -161,6 +319,7 @@ class Nbr {
 
   inline const Nbr& operator--() const {
     --nbr_;
+    edata_.Advance(-1);
     return *this;
   }
 
@@ -182,7 +341,7 @@ class Nbr {
 
  private:
   const mutable nbr_unit_t* nbr_;
-  TypedArray<EDATA_T> edata_array_;
+  mutable cursor_t edata_;
 };
 
 /**
@@ -262,20 +421,23 @@ class AdjList {
   using vid_t = VID_T;
   using eid_t = EID_T;
   using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<vid_t, eid_t>;
+  using cursor_t = EdgeDataCursor<EDATA_T>;
 
  public:
   AdjList() : begin_(NULL), end_(NULL) {}
 
   AdjList(const nbr_unit_t* begin, const nbr_unit_t* end,
-          TypedArray<EDATA_T> edata_array)
-      : begin_(begin), end_(end), edata_array_(edata_array) {}
+          const cursor_t& edata)
+      : begin_(begin), end_(end), edata_(edata) {}
 
   Nbr<VID_T, EID_T, EDATA_T> begin() const {
-    return Nbr<VID_T, EID_T, EDATA_T>(begin_, edata_array_);
+    return Nbr<VID_T, EID_T, EDATA_T>(begin_, edata_);
   }
 
   Nbr<VID_T, EID_T, EDATA_T> end() const {
-    return Nbr<VID_T, EID_T, EDATA_T>(end_, edata_array_);
+    cursor_t edata(edata_);
+    edata.Advance(end_ - begin_);
+    return Nbr<VID_T, EID_T, EDATA_T>(end_, edata);
   }
 
   size_t Size() const { return end_ - begin_; }
@@ -287,7 +449,7 @@ class AdjList {
  private:
   const nbr_unit_t* begin_;
   const nbr_unit_t* end_;
-  TypedArray<EDATA_T> edata_array_;
+  cursor_t edata_;
 };
 
 template <typename VID_T, typename EID_T>
@@ -300,7 +462,7 @@ class AdjList<VID_T, EID_T, grape::EmptyType> {
   AdjList() : begin_(NULL), end_(NULL) {}
 
   AdjList(const nbr_unit_t* begin, const nbr_unit_t* end,
-          TypedArray<grape::EmptyType>)
+          const EdgeDataCursor<grape::EmptyType>&)
       : begin_(begin), end_(end) {}
 
   Nbr<VID_T, EID_T, grape::EmptyType> begin() const {
@@ -351,6 +513,8 @@ class ArrowProjectedFragment
       arrow_projected_fragment_impl::AdjList<vid_t, eid_t, EDATA_T>;
   using const_adj_list_t =
       arrow_projected_fragment_impl::AdjList<vid_t, eid_t, EDATA_T>;
+  using edata_cursor_t = arrow_projected_fragment_impl::EdgeDataCursor<EDATA_T>;
+  using inline_edata_t = arrow_projected_fragment_impl::InlineEdgeData<EDATA_T>;
   using vertex_map_t = ArrowProjectedVertexMap<internal_oid_t, vid_t>;
   using label_id_t = vineyard::property_graph_types::LABEL_ID_TYPE;
   using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
@@ -388,7 +552,8 @@ class ArrowProjectedFragment
   static std::shared_ptr<ArrowProjectedFragment<oid_t, vid_t, vdata_t, edata_t>>
   Project(std::shared_ptr<vineyard::ArrowFragment<oid_t, vid_t>> fragment,
           const std::string& v_label_str, const std::string& v_prop_str,
-          const std::string& e_label_str, const std::string& e_prop_str) {
+          const std::string& e_label_str, const std::string& e_prop_str,
+          bool inline_edata = false) {
     label_id_t v_label = boost::lexical_cast<label_id_t>(v_label_str);
     label_id_t e_label = boost::lexical_cast<label_id_t>(e_label_str);
     prop_id_t v_prop = boost::lexical_cast<label_id_t>(v_prop_str);
@@ -436,14 +601,26 @@ class ArrowProjectedFragment
     meta.AddKeyValue("projected_e_label", e_label);
     meta.AddKeyValue("projected_e_property", e_prop);
 
+    if (inline_edata && !inline_edata_t::supported) {
+      LOG(WARNING) << "Only fixed-width edge data can be inlined, the edge "
+                      "data is read from the edge table.";
+      inline_edata = false;
+    }
+    meta.AddKeyValue("inline_edata", inline_edata ? 1 : 0);
+
     meta.AddMember("arrow_fragment", fragment->meta());
     meta.AddMember("arrow_projected_vertex_map", vm->meta());
 
+    // with a single vertex label, every neighbor is of v_label and the offsets
+    // of the parent fragment are used as is
+    bool reuse_offsets = (fragment->vertex_label_num_ == 1);
+    meta.AddKeyValue("reuse_parent_offsets", reuse_offsets ? 1 : 0);
+
     std::shared_ptr<vineyard::NumericArray<int64_t>> ie_offsets_begin,
         ie_offsets_end;
 
     size_t nbytes = 0;
-    if (fragment->directed()) {
+    if (fragment->directed() && !reuse_offsets) {
       std::shared_ptr<arrow::Int64Array> ie_offsets_begin_arrow,
           ie_offsets_end_arrow;
       selectEdgeByNeighborLabel(fragment, v_label,
@@ -467,7 +644,7 @@ class ArrowProjectedFragment
 
     std::shared_ptr<vineyard::NumericArray<int64_t>> oe_offsets_begin,
         oe_offsets_end;
-    {
+    if (!reuse_offsets) {
       std::shared_ptr<arrow::Int64Array> oe_offsets_begin_arrow,
           oe_offsets_end_arrow;
       selectEdgeByNeighborLabel(fragment, v_label,
@@ -488,12 +665,31 @@ class ArrowProjectedFragment
       nbytes += oe_offsets_end->nbytes();
     }
 
-    if (fragment->directed()) {
-      meta.AddMember("ie_offsets_begin", ie_offsets_begin->meta());
-      meta.AddMember("ie_offsets_end", ie_offsets_end->meta());
+    if (!reuse_offsets) {
+      if (fragment->directed()) {
+        meta.AddMember("ie_offsets_begin", ie_offsets_begin->meta());
+        meta.AddMember("ie_offsets_end", ie_offsets_end->meta());
+      }
+      meta.AddMember("oe_offsets_begin", oe_offsets_begin->meta());
+      meta.AddMember("oe_offsets_end", oe_offsets_end->meta());
+    }
+
+    if (inline_edata) {
+      std::shared_ptr<arrow::Array> edata_array;
+      if (fragment->edge_tables_[e_label]->num_rows() != 0) {
+        edata_array = fragment->edge_tables_[e_label]->column(e_prop)->chunk(0);
+      }
+      if (fragment->directed()) {
+        auto ie_edata = inline_edata_t::template Build<nbr_unit_t>(
+            client, fragment->ie_lists_[v_label][e_label], edata_array);
+        meta.AddMember("ie_edata", ie_edata->meta());
+        nbytes += ie_edata->nbytes();
+      }
+      auto oe_edata = inline_edata_t::template Build<nbr_unit_t>(
+          client, fragment->oe_lists_[v_label][e_label], edata_array);
+      meta.AddMember("oe_edata", oe_edata->meta());
+      nbytes += oe_edata->nbytes();
     }
-    meta.AddMember("oe_offsets_begin", oe_offsets_begin->meta());
-    meta.AddMember("oe_offsets_end", oe_offsets_end->meta());
 
     meta.SetNBytes(nbytes);
 
@@ -521,22 +717,32 @@ class ArrowProjectedFragment
     fnum_ = fragment_->fnum_;
     directed_ = fragment_->directed_;
 
-    if (directed_) {
-      vineyard::NumericArray<int64_t> ie_offsets_begin;
-      ie_offsets_begin.Construct(meta.GetMemberMeta("ie_offsets_begin"));
-      ie_offsets_begin_ = ie_offsets_begin.GetArray();
-    }
-    if (directed_) {
-      vineyard::NumericArray<int64_t> ie_offsets_end;
-      ie_offsets_end.Construct(meta.GetMemberMeta("ie_offsets_end"));
-      ie_offsets_end_ = ie_offsets_end.GetArray();
-    }
-    {
+    // objects projected before reusing offsets was supported have no such key
+    if (meta.HasKey("reuse_parent_offsets") &&
+        meta.GetKeyValue<int>("reuse_parent_offsets") != 0) {
+      int64_t tvnum = fragment_->tvnums_[vertex_label_];
+      if (directed_) {
+        auto& ie_offsets =
+            fragment_->ie_offsets_lists_[vertex_label_][edge_label_];
+        ie_offsets_begin_ = sliceOffsets(ie_offsets, 0, tvnum);
+        ie_offsets_end_ = sliceOffsets(ie_offsets, 1, tvnum);
+      }
+      auto& oe_offsets =
+          fragment_->oe_offsets_lists_[vertex_label_][edge_label_];
+      oe_offsets_begin_ = sliceOffsets(oe_offsets, 0, tvnum);
+      oe_offsets_end_ = sliceOffsets(oe_offsets, 1, tvnum);
+    } else {
+      if (directed_) {
+        vineyard::NumericArray<int64_t> ie_offsets_begin;
+        ie_offsets_begin.Construct(meta.GetMemberMeta("ie_offsets_begin"));
+        ie_offsets_begin_ = ie_offsets_begin.GetArray();
+        vineyard::NumericArray<int64_t> ie_offsets_end;
+        ie_offsets_end.Construct(meta.GetMemberMeta("ie_offsets_end"));
+        ie_offsets_end_ = ie_offsets_end.GetArray();
+      }
       vineyard::NumericArray<int64_t> oe_offsets_begin;
       oe_offsets_begin.Construct(meta.GetMemberMeta("oe_offsets_begin"));
       oe_offsets_begin_ = oe_offsets_begin.GetArray();
-    }
-    {
       vineyard::NumericArray<int64_t> oe_offsets_end;
       oe_offsets_end.Construct(meta.GetMemberMeta("oe_offsets_end"));
       oe_offsets_end_ = oe_offsets_end.GetArray();
@@ -580,6 +786,14 @@ class ArrowProjectedFragment
     }
     oe_ = fragment_->oe_lists_[vertex_label_][edge_label_];
 
+    if (meta.HasKey("inline_edata") &&
+        meta.GetKeyValue<int>("inline_edata") != 0) {
+      if (directed_) {
+        ie_edata_ = inline_edata_t::Resolve(meta.GetMemberMeta("ie_edata"));
+      }
+      oe_edata_ = inline_edata_t::Resolve(meta.GetMemberMeta("oe_edata"));
+    }
+
     vm_ptr_ = std::make_shared<vertex_map_t>();
     vm_ptr_->Construct(meta.GetMemberMeta("arrow_projected_vertex_map"));
 
@@ -771,69 +985,61 @@ class ArrowProjectedFragment
 
   inline adj_list_t GetIncomingAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
-    return adj_list_t(&ie_ptr_[ie_offsets_begin_ptr_[offset]],
-                      &ie_ptr_[ie_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+    return makeIncomingAdjList(ie_offsets_begin_ptr_[offset],
+                               ie_offsets_end_ptr_[offset]);
   }
 
   inline adj_list_t GetOutgoingAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
-    return adj_list_t(&oe_ptr_[oe_offsets_begin_ptr_[offset]],
-                      &oe_ptr_[oe_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+    return makeOutgoingAdjList(oe_offsets_begin_ptr_[offset],
+                               oe_offsets_end_ptr_[offset]);
   }
 
   inline adj_list_t GetIncomingInnerVertexAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
-    return adj_list_t(&ie_ptr_[ie_offsets_begin_ptr_[offset]],
-                      &ie_ptr_[offset < static_cast<int64_t>(ivnum_)
+    return makeIncomingAdjList(ie_offsets_begin_ptr_[offset],
+                               offset < static_cast<int64_t>(ivnum_)
                                    ? ie_spliters_ptr_[0][offset]
-                                   : ie_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+                                   : ie_offsets_end_ptr_[offset]);
   }
 
   inline adj_list_t GetOutgoingInnerVertexAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
-    return adj_list_t(&oe_ptr_[oe_offsets_begin_ptr_[offset]],
-                      &oe_ptr_[offset < static_cast<int64_t>(ivnum_)
+    return makeOutgoingAdjList(oe_offsets_begin_ptr_[offset],
+                               offset < static_cast<int64_t>(ivnum_)
                                    ? oe_spliters_ptr_[0][offset]
-                                   : oe_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+                                   : oe_offsets_end_ptr_[offset]);
   }
 
   inline adj_list_t GetIncomingOuterVertexAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     return offset < static_cast<int64_t>(ivnum_)
-               ? adj_list_t(&ie_ptr_[ie_spliters_ptr_[0][offset]],
-                            &ie_ptr_[ie_offsets_end_ptr_[offset]],
-                            edge_data_array_accessor_)
+               ? makeIncomingAdjList(ie_spliters_ptr_[0][offset],
+                                     ie_offsets_end_ptr_[offset])
                : adj_list_t();
   }
 
   inline adj_list_t GetOutgoingOuterVertexAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     return offset < static_cast<int64_t>(ivnum_)
-               ? adj_list_t(&oe_ptr_[oe_spliters_ptr_[0][offset]],
-                            &oe_ptr_[oe_offsets_end_ptr_[offset]],
-                            edge_data_array_accessor_)
+               ? makeOutgoingAdjList(oe_spliters_ptr_[0][offset],
+                                     oe_offsets_end_ptr_[offset])
                : adj_list_t();
   }
 
   inline adj_list_t GetIncomingAdjList(const vertex_t& v, fid_t src_fid) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     return offset < static_cast<int64_t>(ivnum_)
-               ? adj_list_t(&ie_ptr_[ie_spliters_ptr_[src_fid][offset]],
-                            &ie_ptr_[ie_spliters_ptr_[src_fid + 1][offset]],
-                            edge_data_array_accessor_)
+               ? makeIncomingAdjList(ie_spliters_ptr_[src_fid][offset],
+                                     ie_spliters_ptr_[src_fid + 1][offset])
                : (src_fid == fid_ ? GetIncomingAdjList(v) : adj_list_t());
   }
 
   inline adj_list_t GetOutgoingAdjList(const vertex_t& v, fid_t dst_fid) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     return offset < static_cast<int64_t>(ivnum_)
-               ? adj_list_t(&oe_ptr_[oe_spliters_ptr_[dst_fid][offset]],
-                            &oe_ptr_[oe_spliters_ptr_[dst_fid + 1][offset]],
-                            edge_data_array_accessor_)
+               ? makeOutgoingAdjList(oe_spliters_ptr_[dst_fid][offset],
+                                     oe_spliters_ptr_[dst_fid + 1][offset])
                : (dst_fid == fid_ ? GetOutgoingAdjList(v) : adj_list_t());
   }
 
@@ -864,6 +1070,20 @@ class ArrowProjectedFragment
   }
 
  private:
+  inline adj_list_t makeIncomingAdjList(int64_t begin, int64_t end) const {
+    return adj_list_t(
+        &ie_ptr_[begin], &ie_ptr_[end],
+        edata_cursor_t(edge_data_array_accessor_, edge_data_ptr_,
+                       ie_edata_ptr_, begin));
+  }
+
+  inline adj_list_t makeOutgoingAdjList(int64_t begin, int64_t end) const {
+    return adj_list_t(
+        &oe_ptr_[begin], &oe_ptr_[end],
+        edata_cursor_t(edge_data_array_accessor_, edge_data_ptr_,
+                       oe_edata_ptr_, begin));
+  }
+
   inline static std::pair<int64_t, int64_t> getRangeOfLabel(
       std::shared_ptr<property_graph_t> fragment, label_id_t v_label,
       std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list, int64_t begin,
@@ -886,6 +1106,14 @@ class ArrowProjectedFragment
     return std::make_pair(i, j);
   }
 
+  // a zero-copy view of [offset, offset + length) of the offsets
+  static std::shared_ptr<arrow::Int64Array> sliceOffsets(
+      const std::shared_ptr<arrow::Int64Array>& offsets, int64_t offset,
+      int64_t length) {
+    return std::dynamic_pointer_cast<arrow::Int64Array>(
+        offsets->Slice(offset, length));
+  }
+
   static bl::result<void> selectEdgeByNeighborLabel(
       std::shared_ptr<property_graph_t> fragment, label_id_t v_label,
       std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
@@ -1048,6 +1276,7 @@ class ArrowProjectedFragment
     vertex_data_array_accessor_.Init(vertex_data_array_);
     ovgid_list_ptr_ = ovgid_list_->raw_values();
     edge_data_array_accessor_.Init(edge_data_array_);
+    edge_data_ptr_ = inline_edata_t::RawValues(edge_data_array_);
 
     if (directed_) {
       ie_ptr_ = reinterpret_cast<const nbr_unit_t*>(ie_->GetValue(0));
@@ -1055,6 +1284,9 @@ class ArrowProjectedFragment
       ie_ptr_ = reinterpret_cast<const nbr_unit_t*>(oe_->GetValue(0));
     }
     oe_ptr_ = reinterpret_cast<const nbr_unit_t*>(oe_->GetValue(0));
+    ie_edata_ptr_ =
+        inline_edata_t::RawValues(directed_ ? ie_edata_ : oe_edata_);
+    oe_edata_ptr_ = inline_edata_t::RawValues(oe_edata_);
   }
 
   vertex_range_t inner_vertices_;
@@ -1093,6 +1325,13 @@ class ArrowProjectedFragment
   const nbr_unit_t* ie_ptr_;
   const nbr_unit_t* oe_ptr_;
 
+  // edge data in the order of ie_ and oe_, only for fixed-width edge data
+  const edata_t* edge_data_ptr_;
+  // only for projections with inlined edge data
+  std::shared_ptr<arrow::Array> ie_edata_, oe_edata_;
+  const edata_t* ie_edata_ptr_;
+  const edata_t* oe_edata_ptr_;
+
   std::shared_ptr<vertex_map_t> vm_ptr_;
 
   vineyard::IdParser<vid_t> vid_parser_;
@@ -22,11 +22,13 @@
 
 #include <algorithm>
 #include <iosfwd>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -35,6 +37,7 @@
 #include "folly/dynamic.h"
 #include "folly/json.h"
 
+#include "grape/communication/sync_comm.h"
 #include "grape/config.h"
 #include "grape/fragment/immutable_edgecut_fragment.h"
 #include "grape/graph/edge.h"
@@ -49,6 +52,7 @@
 #include "vineyard/graph/utils/partitioner.h"
 
 #include "core/error.h"
+#include "core/fragment/dynamic_property_columns.h"
 #include "core/io/dynamic_line_parser.h"
 #include "core/utils/mpi_utils.h"
 #include "core/vertex_map/global_vertex_map.h"
@@ -152,6 +156,124 @@ class SparseVertexArray : public grape::Array<T, grape::Allocator<T>> {
   T* fake_start_;
 };
 
+/**
+ * @brief Write a folly::dynamic to the archive in a compact binary form: the
+ * type as one byte followed by the payload, arrays and objects are written
+ * recursively with their sizes.
+ */
+inline void SerializeDynamic(grape::InArchive& arc, const folly::dynamic& d) {
+  arc << static_cast<uint8_t>(d.type());
+  switch (d.type()) {
+  case folly::dynamic::Type::NULLT:
+    break;
+  case folly::dynamic::Type::BOOL:
+    arc << d.getBool();
+    break;
+  case folly::dynamic::Type::INT64:
+    arc << d.getInt();
+    break;
+  case folly::dynamic::Type::DOUBLE:
+    arc << d.getDouble();
+    break;
+  case folly::dynamic::Type::STRING:
+    arc << d.getString();
+    break;
+  case folly::dynamic::Type::ARRAY:
+    arc << static_cast<size_t>(d.size());
+    for (auto& item : d) {
+      SerializeDynamic(arc, item);
+    }
+    break;
+  case folly::dynamic::Type::OBJECT:
+    arc << static_cast<size_t>(d.size());
+    for (auto& kv : d.items()) {
+      SerializeDynamic(arc, kv.first);
+      SerializeDynamic(arc, kv.second);
+    }
+    break;
+  default:
+    LOG(FATAL) << "Unsupported dynamic type: " << d.typeName();
+  }
+}
+
+/**
+ * @brief Read a folly::dynamic written by SerializeDynamic.
+ */
+inline void DeserializeDynamic(grape::OutArchive& arc, folly::dynamic& d) {
+  uint8_t type;
+  arc >> type;
+  switch (static_cast<folly::dynamic::Type>(type)) {
+  case folly::dynamic::Type::NULLT:
+    d = nullptr;
+    break;
+  case folly::dynamic::Type::BOOL: {
+    bool val;
+    arc >> val;
+    d = val;
+    break;
+  }
+  case folly::dynamic::Type::INT64: {
+    int64_t val;
+    arc >> val;
+    d = val;
+    break;
+  }
+  case folly::dynamic::Type::DOUBLE: {
+    double val;
+    arc >> val;
+    d = val;
+    break;
+  }
+  case folly::dynamic::Type::STRING: {
+    std::string val;
+    arc >> val;
+    d = std::move(val);
+    break;
+  }
+  case folly::dynamic::Type::ARRAY: {
+    size_t size;
+    arc >> size;
+    d = folly::dynamic::array;
+    d.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      DeserializeDynamic(arc, d[i]);
+    }
+    break;
+  }
+  case folly::dynamic::Type::OBJECT: {
+    size_t size;
+    arc >> size;
+    d = folly::dynamic::object;
+    folly::dynamic key;
+    for (size_t i = 0; i < size; ++i) {
+      DeserializeDynamic(arc, key);
+      DeserializeDynamic(arc, d[key]);
+    }
+    break;
+  }
+  default:
+    LOG(FATAL) << "Unsupported dynamic type: " << static_cast<int>(type);
+  }
+}
+
+}  // namespace dynamic_fragment_impl
+}  // namespace gs
+
+namespace grape {
+// folly::dynamic oids in the archives of GlobalVertexMap
+inline InArchive& operator<<(InArchive& arc, const folly::dynamic& d) {
+  gs::dynamic_fragment_impl::SerializeDynamic(arc, d);
+  return arc;
+}
+
+inline OutArchive& operator>>(OutArchive& arc, folly::dynamic& d) {
+  gs::dynamic_fragment_impl::DeserializeDynamic(arc, d);
+  return arc;
+}
+}  // namespace grape
+
+namespace gs {
+namespace dynamic_fragment_impl {
 /**
  * @brief A neighbor of a vertex in the graph.
  *
@@ -189,7 +311,7 @@ class Nbr {
 
   grape::Vertex<VID_T>& get_neighbor() { return neighbor_; }
 
-  void set_neighbor(grape::Vertex<VID_T>& neighbor) {
+  void set_neighbor(const grape::Vertex<VID_T>& neighbor) {
     this->neighbor_ = neighbor;
   }
 
@@ -201,7 +323,7 @@ class Nbr {
 
   EDATA_T& get_data() { return data_; }
 
-  void set_data(EDATA_T data) { this->data_ = data; }
+  void set_data(EDATA_T data) { this->data_ = std::move(data); }
 
   void update_data(const EDATA_T& data) {
     if (data_.isNull()) {
@@ -217,33 +339,372 @@ class Nbr {
 };
 
 /**
- * This is an internal representation of neighbor vertices using std::map.
+ * @brief A neighbor stored in the edge space of DynamicFragment. The data of
+ * the edge is not kept in the neighbor, it lives in the property columns of
+ * the edge space at the row eid.
+ */
+class IndexedNbr {
+  using VID_T = vineyard::property_graph_types::VID_TYPE;
+
+ public:
+  IndexedNbr() = default;
+  explicit IndexedNbr(const VID_T& nbr) : neighbor_(nbr) {}
+
+  const grape::Vertex<VID_T>& neighbor() const { return neighbor_; }
+
+  grape::Vertex<VID_T>& neighbor() { return neighbor_; }
+
+  const grape::Vertex<VID_T>& get_neighbor() const { return neighbor_; }
+
+  grape::Vertex<VID_T>& get_neighbor() { return neighbor_; }
+
+  void set_neighbor(const grape::Vertex<VID_T>& neighbor) {
+    this->neighbor_ = neighbor;
+  }
+
+  size_t eid() const { return eid_; }
+
+  void set_eid(size_t eid) { eid_ = eid; }
+
+ private:
+  grape::Vertex<VID_T> neighbor_;
+  size_t eid_{};
+};
+
+/**
+ * @brief The neighbor yielded by the adjacent lists of DynamicFragment. The
+ * data of the edge is materialized from the property columns only when it is
+ * read, and is kept until the iterator moves to another edge, thus traversals
+ * which only visit the neighbors do not allocate. A single property can be
+ * read by GetProperty, or by a TypedPropertyView of the edge columns indexed
+ * by eid(), without materializing the row.
+ */
+class ColumnNbr {
+  using VID_T = vineyard::property_graph_types::VID_TYPE;
+
+ public:
+  ColumnNbr() = default;
+
+  const grape::Vertex<VID_T>& neighbor() const { return neighbor_; }
+
+  const grape::Vertex<VID_T>& get_neighbor() const { return neighbor_; }
+
+  size_t eid() const { return eid_; }
+
+  const folly::dynamic& data() const { return row(); }
+
+  folly::dynamic& data() { return row(); }
+
+  const folly::dynamic& get_data() const { return row(); }
+
+  folly::dynamic& get_data() { return row(); }
+
+  folly::dynamic GetProperty(const std::string& key) const {
+    return columns_->GetProperty(eid_, key);
+  }
+
+  void Reset(const grape::Vertex<VID_T>& neighbor, size_t eid,
+             const PropertyColumns* columns) {
+    neighbor_ = neighbor;
+    if (eid != eid_ || columns != columns_) {
+      eid_ = eid;
+      columns_ = columns;
+      materialized_ = false;
+    }
+  }
+
+ private:
+  folly::dynamic& row() const {
+    if (!materialized_) {
+      data_ = columns_->GetRow(eid_);
+      materialized_ = true;
+    }
+    return data_;
+  }
+
+  grape::Vertex<VID_T> neighbor_;
+  size_t eid_{};
+  const PropertyColumns* columns_ = nullptr;
+  mutable folly::dynamic data_;
+  mutable bool materialized_ = false;
+};
+
+/**
+ * @brief A light-weight view over a contiguous range of neighbors.
+ *
+ * @tparam NBR_T Neighbor type, may be const qualified
+ */
+template <typename NBR_T>
+class NbrSlice {
+ public:
+  NbrSlice() = default;
+  NbrSlice(NBR_T* begin, NBR_T* end) : begin_(begin), end_(end) {}
+
+  inline NBR_T* begin() const { return begin_; }
+  inline NBR_T* end() const { return end_; }
+  inline const NBR_T* cbegin() const { return begin_; }
+  inline const NBR_T* cend() const { return end_; }
+  inline size_t size() const { return end_ - begin_; }
+  inline bool empty() const { return begin_ == end_; }
+
+ private:
+  NBR_T* begin_ = nullptr;
+  NBR_T* end_ = nullptr;
+};
+
+/**
+ * @brief The neighbors of a single vertex.
+ *
+ * Neighbors are kept in an array sorted by the internal lid of the neighbor,
+ * so traversals read contiguous memory and lookups are binary searches.
+ * Insertions of new neighbors go to an unsorted delta area first, which is
+ * merged into the sorted array by Compact(). Iteration only covers the sorted
+ * array, the owner is responsible for compacting the list before exposing it
+ * to readers.
+ */
+class NbrList {
+  using VID_T = vineyard::property_graph_types::VID_TYPE;
+  using NbrT = IndexedNbr;
+
+  // the delta area is scanned linearly until it exceeds this size, then a
+  // hash index is built for it.
+  static constexpr size_t kDeltaLinearScanLimit = 16;
+  // the delta area is merged eagerly once it grows beyond
+  // max(kMinDeltaCapacity, size of the sorted array).
+  static constexpr size_t kMinDeltaCapacity = 64;
+
+  struct Delta {
+    std::vector<NbrT> nbrs;
+    ska::flat_hash_map<VID_T, size_t> index;
+  };
+
+ public:
+  NbrList() = default;
+  NbrList(NbrList&& rhs) noexcept = default;
+  NbrList& operator=(NbrList&& rhs) noexcept = default;
+
+  NbrList(const NbrList& rhs) : nbrs_(rhs.nbrs_) {
+    if (rhs.delta_ != nullptr) {
+      delta_.reset(new Delta(*rhs.delta_));
+    }
+  }
+
+  NbrList& operator=(const NbrList& rhs) {
+    if (this != &rhs) {
+      nbrs_ = rhs.nbrs_;
+      delta_.reset(rhs.delta_ == nullptr ? nullptr : new Delta(*rhs.delta_));
+    }
+    return *this;
+  }
+
+  ~NbrList() = default;
+
+  inline size_t size() const {
+    return nbrs_.size() + (delta_ == nullptr ? 0 : delta_->nbrs.size());
+  }
+
+  inline bool empty() const { return size() == 0; }
+
+  inline bool dirty() const { return delta_ != nullptr; }
+
+  inline NbrT* begin() { return nbrs_.data(); }
+  inline NbrT* end() { return nbrs_.data() + nbrs_.size(); }
+  inline const NbrT* begin() const { return nbrs_.data(); }
+  inline const NbrT* end() const { return nbrs_.data() + nbrs_.size(); }
+  inline const NbrT* cbegin() const { return nbrs_.data(); }
+  inline const NbrT* cend() const { return nbrs_.data() + nbrs_.size(); }
+
+  /**
+   * @brief Returns the first neighbor in the sorted array whose lid is not
+   * less than the given lid.
+   */
+  inline NbrT* lower_bound(VID_T vid) {
+    return std::lower_bound(
+        begin(), end(), vid,
+        [](const NbrT& nbr, VID_T v) { return nbr.neighbor().GetValue() < v; });
+  }
+
+  inline const NbrT* lower_bound(VID_T vid) const {
+    return const_cast<NbrList*>(this)->lower_bound(vid);
+  }
+
+  /**
+   * @brief Find the neighbor with the given internal lid.
+   *
+   * @return Pointer to the neighbor, or nullptr if it does not exist.
+   */
+  inline NbrT* find(VID_T vid) {
+    auto iter = lower_bound(vid);
+    if (iter != end() && iter->neighbor().GetValue() == vid) {
+      return iter;
+    }
+    if (delta_ != nullptr) {
+      auto idx = findInDelta(vid);
+      if (idx != delta_->nbrs.size()) {
+        return &delta_->nbrs[idx];
+      }
+    }
+    return nullptr;
+  }
+
+  inline const NbrT* find(VID_T vid) const {
+    return const_cast<NbrList*>(this)->find(vid);
+  }
+
+  /**
+   * @brief Insert a neighbor if it does not exist, the eid of a created
+   * neighbor is left for the caller to assign.
+   *
+   * @return Pointer to the neighbor, which is valid until the next
+   * modification of the list.
+   */
+  inline NbrT* emplace(VID_T vid, bool& created) {
+    auto* nbr = find(vid);
+    if (nbr != nullptr) {
+      created = false;
+      return nbr;
+    }
+    created = true;
+    if (nbrs_.empty() || nbrs_.back().neighbor().GetValue() < vid) {
+      // appending in order, e.g., loading sorted edges, keeps the array sorted
+      if (delta_ == nullptr) {
+        nbrs_.emplace_back(vid);
+        return &nbrs_.back();
+      }
+    }
+    if (delta_ == nullptr) {
+      delta_.reset(new Delta());
+    }
+    delta_->nbrs.emplace_back(vid);
+    if (!delta_->index.empty() ||
+        delta_->nbrs.size() > kDeltaLinearScanLimit) {
+      if (delta_->index.empty()) {
+        for (size_t i = 0; i < delta_->nbrs.size(); ++i) {
+          delta_->index.emplace(delta_->nbrs[i].neighbor().GetValue(), i);
+        }
+      } else {
+        delta_->index.emplace(vid, delta_->nbrs.size() - 1);
+      }
+    }
+    return &delta_->nbrs.back();
+  }
+
+  /**
+   * @brief Merge the delta area eagerly once it outgrows the sorted array,
+   * which keeps lookups and merges amortized.
+   */
+  inline void MaybeCompact() {
+    size_t delta_capacity = kMinDeltaCapacity;
+    if (delta_ != nullptr &&
+        delta_->nbrs.size() > std::max(delta_capacity, nbrs_.size())) {
+      Compact();
+    }
+  }
+
+  /**
+   * @brief Remove the neighbor with the given internal lid.
+   *
+   * @return The number of removed neighbors, 0 or 1.
+   */
+  inline size_t erase(VID_T vid) {
+    auto iter = lower_bound(vid);
+    if (iter != end() && iter->neighbor().GetValue() == vid) {
+      nbrs_.erase(nbrs_.begin() + (iter - begin()));
+      return 1;
+    }
+    if (delta_ != nullptr) {
+      auto idx = findInDelta(vid);
+      auto& nbrs = delta_->nbrs;
+      if (idx != nbrs.size()) {
+        if (!delta_->index.empty()) {
+          delta_->index.erase(vid);
+          if (idx != nbrs.size() - 1) {
+            delta_->index[nbrs.back().neighbor().GetValue()] = idx;
+          }
+        }
+        std::swap(nbrs[idx], nbrs.back());
+        nbrs.pop_back();
+        if (nbrs.empty()) {
+          delta_.reset();
+        }
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Merge the delta area into the sorted array.
+   */
+  void Compact() {
+    if (delta_ == nullptr) {
+      return;
+    }
+    auto& delta = delta_->nbrs;
+    auto cmp = [](const NbrT& lhs, const NbrT& rhs) {
+      return lhs.neighbor().GetValue() < rhs.neighbor().GetValue();
+    };
+    std::sort(delta.begin(), delta.end(), cmp);
+    size_t sorted_num = nbrs_.size();
+    nbrs_.reserve(sorted_num + delta.size());
+    std::move(delta.begin(), delta.end(), std::back_inserter(nbrs_));
+    std::inplace_merge(nbrs_.begin(), nbrs_.begin() + sorted_num, nbrs_.end(),
+                       cmp);
+    delta_.reset();
+  }
+
+  void Clear() {
+    std::vector<NbrT>().swap(nbrs_);
+    delta_.reset();
+  }
+
+ private:
+  inline size_t findInDelta(VID_T vid) const {
+    auto& nbrs = delta_->nbrs;
+    if (!delta_->index.empty()) {
+      auto iter = delta_->index.find(vid);
+      return iter == delta_->index.end() ? nbrs.size() : iter->second;
+    }
+    for (size_t i = 0; i < nbrs.size(); ++i) {
+      if (nbrs[i].neighbor().GetValue() == vid) {
+        return i;
+      }
+    }
+    return nbrs.size();
+  }
+
+  std::vector<NbrT> nbrs_;
+  std::unique_ptr<Delta> delta_;
+};
+
+/**
+ * @brief Adjacency list of a vertex which iterates over a contiguous range of
+ * neighbors. The data of a neighbor is materialized from the property columns
+ * of the edge space when it is read, see ColumnNbr.
  *
  * @tparam EDATA_T Data type of edge
  */
 template <typename EDATA_T>
 class AdjList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
-  using NbrT = Nbr<EDATA_T>;
+  using NbrT = ColumnNbr;
 
  public:
   AdjList() = default;
-  AdjList(VID_T id_mask, VID_T ivnum,
-          typename std::map<VID_T, NbrT>::iterator map_iter_begin,
-          typename std::map<VID_T, NbrT>::iterator map_iter_end)
+  AdjList(VID_T id_mask, VID_T ivnum, const PropertyColumns* columns,
+          IndexedNbr* begin, IndexedNbr* end)
       : id_mask_(id_mask),
         ivnum_(ivnum),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        columns_(columns),
+        begin_(begin),
+        end_(end) {}
   ~AdjList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return begin_ == end_; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
-  inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
-  }
+  inline size_t Size() const { return end_ - begin_; }
 
   class iterator {
     using pointer_type = NbrT*;
@@ -251,9 +712,12 @@ class AdjList {
 
    public:
     iterator() = default;
-    iterator(VID_T id_mask, VID_T ivnum,
-             typename std::map<VID_T, NbrT>::iterator map_current) noexcept
-        : id_mask_(id_mask), ivnum_(ivnum), map_current_(map_current) {}
+    iterator(VID_T id_mask, VID_T ivnum, const PropertyColumns* columns,
+             IndexedNbr* current) noexcept
+        : id_mask_(id_mask),
+          ivnum_(ivnum),
+          columns_(columns),
+          current_(current) {}
 
     reference_type operator*() noexcept {
       set_nbr();
@@ -266,53 +730,50 @@ class AdjList {
     }
 
     iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     iterator operator++(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_++);
+      return iterator(id_mask_, ivnum_, columns_, current_++);
     }
 
     iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     iterator operator--(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_--);
+      return iterator(id_mask_, ivnum_, columns_, current_--);
     }
 
     iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return iterator(id_mask_, ivnum_, curr);
+      return iterator(id_mask_, ivnum_, columns_, current_ + offset);
     }
 
     bool operator==(const iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
 
     bool operator!=(const iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
     void set_nbr() {
-      internal_nbr = map_current_->second;
-      auto v = internal_nbr.neighbor();
+      auto v = current_->neighbor();
       // convert internal lid to external lid
       if (v.GetValue() >= ivnum_) {
         v.SetValue(ivnum_ + id_mask_ - v.GetValue());
       }
-      internal_nbr.set_neighbor(v);
+      internal_nbr.Reset(v, current_->eid(), columns_);
     }
 
     VID_T id_mask_{};
     VID_T ivnum_{};
+    const PropertyColumns* columns_ = nullptr;
     NbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::iterator map_current_;
+    IndexedNbr* current_ = nullptr;
   };
 
   class const_iterator {
@@ -321,10 +782,12 @@ class AdjList {
 
    public:
     const_iterator() = default;
-    const_iterator(
-        VID_T id_mask, VID_T ivnum,
-        typename std::map<VID_T, NbrT>::iterator map_current) noexcept
-        : id_mask_(id_mask), ivnum_(ivnum), map_current_(map_current) {}
+    const_iterator(VID_T id_mask, VID_T ivnum, const PropertyColumns* columns,
+                   const IndexedNbr* current) noexcept
+        : id_mask_(id_mask),
+          ivnum_(ivnum),
+          columns_(columns),
+          current_(current) {}
 
     reference_type operator*() const noexcept {
       const_cast<const_iterator*>(this)->set_nbr();
@@ -337,93 +800,100 @@ class AdjList {
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      return const_iterator(id_mask_, ivnum_, columns_, current_++);
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      return const_iterator(id_mask_, ivnum_, columns_, current_--);
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      return const_iterator(id_mask_, ivnum_, columns_, current_ + offset);
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
-    VID_T id_mask_;
-    VID_T ivnum_;
+    void set_nbr() {
+      auto v = current_->neighbor();
+      // convert internal lid to external lid
+      if (v.GetValue() >= ivnum_) {
+        v.SetValue(ivnum_ + id_mask_ - v.GetValue());
+      }
+      internal_nbr.Reset(v, current_->eid(), columns_);
+    }
+
+    VID_T id_mask_{};
+    VID_T ivnum_{};
+    const PropertyColumns* columns_ = nullptr;
     NbrT internal_nbr;
-    typename std::map<VID_T, const NbrT>::iterator map_current_;
+    const IndexedNbr* current_ = nullptr;
   };
 
-  iterator begin() { return iterator(id_mask_, ivnum_, map_iter_begin_); }
+  iterator begin() { return iterator(id_mask_, ivnum_, columns_, begin_); }
 
-  iterator end() { return iterator(id_mask_, ivnum_, map_iter_end_); }
+  iterator end() { return iterator(id_mask_, ivnum_, columns_, end_); }
 
   const_iterator begin() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_begin_);
+    return const_iterator(id_mask_, ivnum_, columns_, begin_);
   }
   const_iterator end() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_end_);
+    return const_iterator(id_mask_, ivnum_, columns_, end_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return begin_ == end_; }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
-  typename std::map<VID_T, NbrT>::iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::iterator map_iter_end_;
+  const PropertyColumns* columns_ = nullptr;
+  IndexedNbr* begin_ = nullptr;
+  IndexedNbr* end_ = nullptr;
 };
 
 /**
- * @brief This is an internal representation of neighbor vertices using
- * std::map.
+ * @brief Const adjacency list of a vertex which iterates over a contiguous
+ * range of neighbors. The data of a neighbor is materialized from the property
+ * columns of the edge space when it is read, see ColumnNbr.
  *
  * @tparam EDATA_T Data type of edge
  */
 template <typename EDATA_T>
 class ConstAdjList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
-  using NbrT = Nbr<EDATA_T>;
+  using NbrT = ColumnNbr;
 
  public:
   ConstAdjList() = default;
-  ConstAdjList(VID_T id_mask, VID_T ivnum,
-               typename std::map<VID_T, NbrT>::const_iterator map_iter_begin,
-               typename std::map<VID_T, NbrT>::const_iterator map_iter_end)
+  ConstAdjList(VID_T id_mask, VID_T ivnum, const PropertyColumns* columns,
+               const IndexedNbr* begin, const IndexedNbr* end)
       : id_mask_(id_mask),
         ivnum_(ivnum),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        columns_(columns),
+        begin_(begin),
+        end_(end) {}
   ~ConstAdjList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return begin_ == end_; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
-  inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
-  }
+  inline size_t Size() const { return end_ - begin_; }
 
   class const_iterator {
     using pointer_type = const NbrT*;
@@ -431,10 +901,12 @@ class ConstAdjList {
 
    public:
     const_iterator() = default;
-    const_iterator(
-        VID_T id_mask, VID_T ivnum,
-        typename std::map<VID_T, NbrT>::const_iterator map_current) noexcept
-        : id_mask_(id_mask), ivnum_(ivnum), map_current_(map_current) {}
+    const_iterator(VID_T id_mask, VID_T ivnum, const PropertyColumns* columns,
+                   const IndexedNbr* current) noexcept
+        : id_mask_(id_mask),
+          ivnum_(ivnum),
+          columns_(columns),
+          current_(current) {}
 
     reference_type operator*() const noexcept {
       const_cast<const_iterator*>(this)->set_nbr();
@@ -447,230 +919,322 @@ class ConstAdjList {
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      return const_iterator(id_mask_, ivnum_, columns_, current_++);
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      return const_iterator(id_mask_, ivnum_, columns_, current_--);
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      return const_iterator(id_mask_, ivnum_, columns_, current_ + offset);
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
 
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
     void set_nbr() {
-      internal_nbr = map_current_->second;
-      auto v = internal_nbr.neighbor();
+      auto v = current_->neighbor();
       // convert internal lid to external lid
       if (v.GetValue() >= ivnum_) {
         v.SetValue(ivnum_ + id_mask_ - v.GetValue());
       }
-      internal_nbr.set_neighbor(v);
+      internal_nbr.Reset(v, current_->eid(), columns_);
     }
 
     VID_T id_mask_{};
     VID_T ivnum_{};
+    const PropertyColumns* columns_ = nullptr;
     NbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::const_iterator map_current_;
+    const IndexedNbr* current_ = nullptr;
   };
 
   const_iterator begin() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_begin_);
+    return const_iterator(id_mask_, ivnum_, columns_, begin_);
   }
   const_iterator end() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_end_);
+    return const_iterator(id_mask_, ivnum_, columns_, end_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return begin_ == end_; }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_end_;
+  const PropertyColumns* columns_ = nullptr;
+  const IndexedNbr* begin_ = nullptr;
+  const IndexedNbr* end_ = nullptr;
 };
 
 /**
  * @brief A container to store edges.
  *
+ * Every slot holds the neighbors of one vertex in a NbrList. Slots touched by
+ * insertions are recorded and merged by Compact(), which is invoked after
+ * every batch of modifications and before running an app, so readers always
+ * see sorted contiguous neighbors. Since neighbors are sorted by internal lid
+ * and internal lids of outer vertices are larger than those of inner vertices,
+ * the inner and outer neighbors of a vertex are two consecutive slices of its
+ * list and no extra copy is needed to split them.
+ *
+ * The data of edges are stored in typed property columns, a neighbor only
+ * keeps the eid of its row. Rows of removed edges are recycled by new edges.
+ *
  * @tparam EDATA_T The type of data attached with the edge
  */
 template <typename EDATA_T>
-class NbrMapSpace {
+class NbrSpace {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
-  using NbrT = Nbr<EDATA_T>;
+  using NbrT = IndexedNbr;
+  using nbr_list_t = NbrList;
 
  public:
-  NbrMapSpace() : index_(0) {}
+  NbrSpace() = default;
 
-  size_t size() { return buffer_.size(); }
+  size_t size() const { return buffer_.size(); }
 
-  // Create a new linked list
+  // Create a new neighbor list
   inline size_t emplace(VID_T vid, const EDATA_T& edata) {
-    buffer_.resize(index_ + 1);
-    buffer_[index_] = new std::map<VID_T, NbrT>();
-    buffer_[index_]->operator[](vid) = NbrT(vid, edata);
-    return index_++;
+    bool created = false;
+    buffer_.emplace_back();
+    newEdge(*buffer_.back().emplace(vid, created), edata);
+    return buffer_.size() - 1;
   }
 
-  // Insert the value to an existing linked list, or update the existing value
+  // Insert the value to an existing neighbor list, or update the existing
+  // value
   inline size_t emplace(size_t loc, VID_T vid, const EDATA_T& edata,
                         bool& created) {
-    if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
-      buffer_[loc]->operator[](vid).update_data(edata);
-      created = false;
-      return loc;
+    auto& nbrs = buffer_[loc];
+    bool was_dirty = nbrs.dirty();
+    auto* nbr = nbrs.emplace(vid, created);
+    if (created) {
+      newEdge(*nbr, edata);
     } else {
-      buffer_[loc]->operator[](vid) = NbrT(vid, edata);
-      created = true;
-      return loc;
+      edge_columns_.Update(nbr->eid(), edata);
     }
+    nbrs.MaybeCompact();
+    if (!was_dirty && nbrs.dirty()) {
+      dirty_locs_.push_back(loc);
+    }
+    return loc;
   }
 
   inline void update(size_t loc, VID_T vid, const EDATA_T& edata) {
-    if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
-      buffer_[loc]->operator[](vid).update_data(edata);
+    auto* nbr = buffer_[loc].find(vid);
+    if (nbr != nullptr) {
+      edge_columns_.Update(nbr->eid(), edata);
     }
   }
 
   inline void set_data(size_t loc, VID_T vid, const EDATA_T& edata) {
-    if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
-      buffer_[loc]->operator[](vid) = NbrT(vid, edata);
+    auto* nbr = buffer_[loc].find(vid);
+    if (nbr != nullptr) {
+      edge_columns_.Set(nbr->eid(), edata);
     }
   }
 
   inline void remove_edges(size_t loc) {
-    delete buffer_[loc];
-    buffer_[loc] = nullptr;
+    auto& nbrs = buffer_[loc];
+    nbrs.Compact();
+    for (auto& nbr : nbrs) {
+      freeEdge(nbr);
+    }
+    nbrs.Clear();
   }
 
   inline size_t remove_edge(size_t loc, VID_T vid) {
-    return buffer_[loc]->erase(vid);
+    auto& nbrs = buffer_[loc];
+    auto* nbr = nbrs.find(vid);
+    if (nbr == nullptr) {
+      return 0;
+    }
+    freeEdge(*nbr);
+    return nbrs.erase(vid);
   }
 
-  inline std::map<VID_T, NbrT>& operator[](size_t loc) { return *buffer_[loc]; }
+  inline nbr_list_t& operator[](size_t loc) { return buffer_[loc]; }
 
-  inline const std::map<VID_T, NbrT>& operator[](size_t loc) const {
-    return *buffer_[loc];
+  inline const nbr_list_t& operator[](size_t loc) const {
+    return buffer_[loc];
   }
 
-  inline std::map<VID_T, NbrT>& InnerNbr(size_t loc) {
-    return split_buffer_[loc][0];
+  inline NbrSlice<NbrT> InnerNbr(size_t loc) {
+    auto& nbrs = buffer_[loc];
+    return NbrSlice<NbrT>(nbrs.begin(), nbrs.lower_bound(split_ivnum_));
   }
 
-  inline const std::map<VID_T, NbrT>& InnerNbr(size_t loc) const {
-    return split_buffer_[loc][0];
+  inline NbrSlice<const NbrT> InnerNbr(size_t loc) const {
+    auto& nbrs = buffer_[loc];
+    return NbrSlice<const NbrT>(nbrs.begin(), nbrs.lower_bound(split_ivnum_));
   }
 
-  inline std::map<VID_T, NbrT>& OuterNbr(size_t loc) {
-    return split_buffer_[loc][1];
+  inline NbrSlice<NbrT> OuterNbr(size_t loc) {
+    auto& nbrs = buffer_[loc];
+    return NbrSlice<NbrT>(nbrs.lower_bound(split_ivnum_), nbrs.end());
   }
 
-  inline const std::map<VID_T, NbrT>& OuterNbr(size_t loc) const {
-    return split_buffer_[loc][1];
+  inline NbrSlice<const NbrT> OuterNbr(size_t loc) const {
+    auto& nbrs = buffer_[loc];
+    return NbrSlice<const NbrT>(nbrs.lower_bound(split_ivnum_), nbrs.end());
   }
 
-  void copy(const NbrMapSpace<EDATA_T>& other) {
-    index_ = other.index_;
-    buffer_.resize(other.buffer_.size());
-    for (size_t i = 0; i < other.buffer_.size(); ++i) {
-      if (other.buffer_[i] != nullptr) {
-        buffer_[i] = new std::map<VID_T, NbrT>();
-        for (auto& item : *(other.buffer_[i])) {
-          buffer_[i]->operator[](item.first) = item.second;
-        }
-      } else {
-        buffer_[i] = nullptr;
-      }
-    }
+  void copy(const NbrSpace<EDATA_T>& other) {
+    buffer_ = other.buffer_;
+    dirty_locs_ = other.dirty_locs_;
+    split_ivnum_ = other.split_ivnum_;
+    edge_columns_ = other.edge_columns_;
+    free_eids_ = other.free_eids_;
+    eid_num_ = other.eid_num_;
   }
 
   // copy the edge space double size, use for undirected graph to directed
   // graph.
-  void double_copy(const NbrMapSpace<EDATA_T>& other) {
-    index_ = other.index_ * 2;
-    size_t old_index = other.index_;
-    buffer_.resize(other.buffer_.size() * 2);
-    for (size_t i = 0; i < other.buffer_.size(); ++i) {
-      if (other.buffer_[i] != nullptr) {
-        buffer_[i] = new std::map<VID_T, NbrT>();
-        buffer_[i + old_index] = new std::map<VID_T, NbrT>();
-        for (auto& item : *(other.buffer_[i])) {
-          buffer_[i]->operator[](item.first) = item.second;
-          buffer_[i + old_index]->operator[](item.first) = item.second;
-        }
-      } else {
-        buffer_[i] = nullptr;
-        buffer_[i + old_index] = nullptr;
+  void double_copy(const NbrSpace<EDATA_T>& other) {
+    size_t old_size = other.buffer_.size();
+    buffer_.clear();
+    buffer_.reserve(old_size * 2);
+    buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+    buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+    dirty_locs_.clear();
+    for (auto loc : other.dirty_locs_) {
+      dirty_locs_.push_back(loc);
+      dirty_locs_.push_back(loc + old_size);
+    }
+    split_ivnum_ = other.split_ivnum_;
+    edge_columns_ = other.edge_columns_;
+    free_eids_ = other.free_eids_;
+    eid_num_ = other.eid_num_;
+    // the copied edges may be modified independently, give them own rows
+    for (size_t loc = old_size; loc < buffer_.size(); ++loc) {
+      buffer_[loc].Compact();
+      for (auto& nbr : buffer_[loc]) {
+        newEdge(nbr, edge_columns_.GetRow(nbr.eid()));
       }
     }
   }
 
   void Clear() {
-    for (size_t i = 0; i < buffer_.size(); ++i) {
-      delete buffer_[i];
-      buffer_[i] = nullptr;
-    }
-    buffer_.clear();
-    index_ = 0;
+    std::vector<nbr_list_t>().swap(buffer_);
+    dirty_locs_.clear();
+    edge_columns_.Clear();
+    std::vector<size_t>().swap(free_eids_);
+    eid_num_ = 0;
   }
 
-  void BuildSplitEdges(VID_T ivnum) {
-    // free existed buffer
-    for (size_t loc = 0; loc < split_buffer_.size(); loc++) {
-      delete[] split_buffer_[loc];
+  /**
+   * @brief Merge the delta area of every modified neighbor list into its
+   * sorted array.
+   */
+  void Compact() {
+    for (auto loc : dirty_locs_) {
+      buffer_[loc].Compact();
     }
+    dirty_locs_.clear();
+  }
 
-    // copy all existed edges and distinguish inner/outer neighbors
-    split_buffer_.resize(buffer_.size());
-    for (size_t loc = 0; loc < buffer_.size(); loc++) {
-      auto& maps = *buffer_[loc];
+  void BuildSplitEdges(VID_T ivnum) {
+    Compact();
+    split_ivnum_ = ivnum;
+  }
 
-      split_buffer_[loc] = new std::map<VID_T, NbrT>[2];
-      for (const auto& iter : maps) {
-        auto lid = iter.first;
-        auto& nbr = iter.second;
-        auto idx = lid < ivnum ? 0 : 1;
+  /**
+   * @brief Write all neighbor lists in the sorted order. Eids are not
+   * written, the rows are compacted when reading.
+   */
+  void Serialize(grape::InArchive& arc) {
+    Compact();
+    arc << buffer_.size() << split_ivnum_;
+    for (auto& nbrs : buffer_) {
+      arc << nbrs.size();
+      for (auto& nbr : nbrs) {
+        arc << nbr.neighbor().GetValue();
+        SerializeDynamic(arc, edge_columns_.GetRow(nbr.eid()));
+      }
+    }
+  }
 
-        split_buffer_[loc][idx][lid] = nbr;
+  void Deserialize(grape::OutArchive& arc) {
+    Clear();
+    size_t buffer_size;
+    arc >> buffer_size >> split_ivnum_;
+    buffer_.resize(buffer_size);
+    VID_T vid;
+    EDATA_T edata;
+    bool created;
+    for (auto& nbrs : buffer_) {
+      size_t nbr_num;
+      arc >> nbr_num;
+      for (size_t i = 0; i < nbr_num; ++i) {
+        arc >> vid;
+        DeserializeDynamic(arc, edata);
+        // neighbors are sorted, thus appended to the sorted array directly
+        newEdge(*nbrs.emplace(vid, created), edata);
       }
     }
   }
 
+  /**
+   * @brief The data of the edge to a neighbor in this space.
+   */
+  inline EDATA_T GetData(const NbrT& nbr) const {
+    return edge_columns_.GetRow(nbr.eid());
+  }
+
+  /**
+   * @brief The typed columns of edge properties, indexed by the eid of
+   * neighbors.
+   */
+  inline const PropertyColumns& edge_columns() const { return edge_columns_; }
+
  private:
-  std::vector<std::map<VID_T, NbrT>*> buffer_;
-  // split_buffer_[i][0] represents inner neighbors, split_buffer_[i][1]
-  // represents outer neighbors
-  std::vector<std::map<VID_T, NbrT>*> split_buffer_;
-  size_t index_;
+  inline void newEdge(NbrT& nbr, const EDATA_T& edata) {
+    if (free_eids_.empty()) {
+      nbr.set_eid(eid_num_++);
+    } else {
+      nbr.set_eid(free_eids_.back());
+      free_eids_.pop_back();
+    }
+    edge_columns_.Set(nbr.eid(), edata);
+  }
+
+  inline void freeEdge(const NbrT& nbr) {
+    edge_columns_.Reset(nbr.eid());
+    free_eids_.push_back(nbr.eid());
+  }
+
+  std::vector<nbr_list_t> buffer_;
+  // slots whose delta area has not been merged yet
+  std::vector<size_t> dirty_locs_;
+  // the inner/outer boundary of internal lids used by InnerNbr/OuterNbr
+  VID_T split_ivnum_{};
+  // the only storage of edge data, indexed by eid
+  PropertyColumns edge_columns_;
+  // rows of removed edges, which are reused before growing the columns
+  std::vector<size_t> free_eids_;
+  size_t eid_num_{};
 };
 }  // namespace dynamic_fragment_impl
 
 /**
  * @brief A mutable non-labeled fragment. The data attached with vertex or edge
- * are represented by folly::dynamic.
+ * are represented by folly::dynamic, and stored as typed property columns.
  *
  * DynamicFragment support two type of graph storage mode.
  *
@@ -840,13 +1404,13 @@ class DynamicFragment {
     inner_oe_pos_.resize(ivnum_, -1);
     inner_vertex_alive_.resize(ivnum_, false);
 
-    ivdata_.clear();
-    ivdata_.resize(ivnum_);
+    ivdata_.Clear();
 
     duplicated_ ? induceDuplicated(origin, induced_vertices, induced_edges)
                 : induceDist(origin, induced_vertices, induced_edges);
     tvnum_ = ivnum_ + ovnum_;
     alive_ovnum_ = ovnum_;
+    invalidCache();
   }
 
   void ClearGraph(std::shared_ptr<vertex_map_t> vm_ptr) {
@@ -887,27 +1451,146 @@ class DynamicFragment {
     invalidCache();
   }
 
+  /**
+   * @brief Write a snapshot of the fragment to prefix/frag_<fid>, every worker
+   * writes its own fragment. The vertex map is replicated on workers and
+   * written to a fixed file under prefix, thus only worker 0 writes it, and
+   * prefix must be on storage shared by all hosts. Edges and vertices are
+   * encoded concurrently.
+   */
   template <typename IOADAPTOR_T>
-  void Serialize(const std::string& prefix) {}
+  void Serialize(const std::string& prefix) {
+    if (vm_ptr_->GetCommSpec().worker_id() == 0) {
+      vm_ptr_->template Serialize<IOADAPTOR_T>(prefix);
+    }
+
+    char fbuf[1024];
+    snprintf(fbuf, sizeof(fbuf), grape::kSerializationFilenameFormat,
+             prefix.c_str(), fid_);
+
+    grape::InArchive edge_arc;
+    std::thread edge_thread([this, &edge_arc]() {
+      edge_space_.Serialize(edge_arc);
+      serializeArray(edge_arc, inner_ie_pos_);
+      serializeArray(edge_arc, inner_oe_pos_);
+      serializeArray(edge_arc, outer_ie_pos_);
+      serializeArray(edge_arc, outer_oe_pos_);
+    });
+
+    grape::InArchive ia;
+    ia << static_cast<int>(kSnapshotVersion);
+    ia << fid_ << fnum_ << directed_ << duplicated_ << load_strategy_
+       << message_strategy_;
+    ia << ivnum_ << ovnum_ << tvnum_ << alive_ivnum_ << alive_ovnum_;
+    ia << ienum_ << oenum_ << selfloops_num_;
+    ia << std::vector<vid_t>(selfloops_vertices_.begin(),
+                             selfloops_vertices_.end());
+    serializeArray(ia, ovgid_);
+    serializeArray(ia, inner_vertex_alive_);
+    serializeArray(ia, outer_vertex_alive_);
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      dynamic_fragment_impl::SerializeDynamic(ia, ivdata_.GetRow(i));
+    }
+    edge_thread.join();
+
+    auto io_adaptor =
+        std::unique_ptr<IOADAPTOR_T>(new IOADAPTOR_T(std::string(fbuf)));
+    io_adaptor->Open("wb");
+    CHECK(io_adaptor->WriteArchive(ia));
+    CHECK(io_adaptor->WriteArchive(edge_arc));
+    CHECK(io_adaptor->Close());
+  }
 
+  /**
+   * @brief Restore the fragment written by Serialize, including the vertex
+   * map passed to the constructor.
+   */
   template <typename IOADAPTOR_T>
-  void Deserialize(const std::string& prefix, const fid_t fid) {}
+  void Deserialize(const std::string& prefix, const fid_t fid) {
+    vm_ptr_->template Deserialize<IOADAPTOR_T>(prefix);
+
+    char fbuf[1024];
+    snprintf(fbuf, sizeof(fbuf), grape::kSerializationFilenameFormat,
+             prefix.c_str(), fid);
+
+    auto io_adaptor =
+        std::unique_ptr<IOADAPTOR_T>(new IOADAPTOR_T(std::string(fbuf)));
+    io_adaptor->Open();
+    grape::OutArchive oa, edge_oa;
+    CHECK(io_adaptor->ReadArchive(oa));
+    CHECK(io_adaptor->ReadArchive(edge_oa));
+    CHECK(io_adaptor->Close());
+
+    std::thread edge_thread([this, &edge_oa]() {
+      edge_space_.Deserialize(edge_oa);
+      deserializeArray(edge_oa, inner_ie_pos_);
+      deserializeArray(edge_oa, inner_oe_pos_);
+      deserializeArray(edge_oa, outer_ie_pos_);
+      deserializeArray(edge_oa, outer_oe_pos_);
+    });
+
+    int version;
+    oa >> version;
+    CHECK(version == kSnapshotVersion) << "Unsupported snapshot: " << fbuf;
+    oa >> fid_ >> fnum_ >> directed_ >> duplicated_ >> load_strategy_ >>
+        message_strategy_;
+    CHECK_EQ(fid_, fid);
+    CHECK_EQ(fnum_, vm_ptr_->GetFragmentNum());
+    calcFidBitWidth(fnum_, id_mask_, fid_offset_);
+    oa >> ivnum_ >> ovnum_ >> tvnum_ >> alive_ivnum_ >> alive_ovnum_;
+    oa >> ienum_ >> oenum_ >> selfloops_num_;
+    std::vector<vid_t> selfloops_vertices;
+    oa >> selfloops_vertices;
+    selfloops_vertices_ = std::set<vid_t>(selfloops_vertices.begin(),
+                                          selfloops_vertices.end());
+    deserializeArray(oa, ovgid_);
+    deserializeArray(oa, inner_vertex_alive_);
+    deserializeArray(oa, outer_vertex_alive_);
+    ovg2i_.clear();
+    ovg2i_.reserve(ovnum_);
+    for (vid_t i = 0; i < ovnum_; ++i) {
+      ovg2i_.emplace(ovgid_[i], i);
+    }
+    ivdata_.Clear();
+    vdata_t vdata;
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      dynamic_fragment_impl::DeserializeDynamic(oa, vdata);
+      ivdata_.Set(i, vdata);
+    }
+    edge_thread.join();
+
+    mirrors_of_frag_.clear();
+    mirrors_of_frag_.resize(fnum_);
+    invalidCache();
+  }
 
   virtual void PrepareToRunApp(grape::MessageStrategy strategy,
                                bool need_split_edges) {
     message_strategy_ = strategy;
+    // merge pending neighbors into the sorted arrays, apps only traverse
+    // contiguous neighbors.
+    edge_space_.Compact();
     if (strategy == grape::MessageStrategy::kAlongEdgeToOuterVertex ||
         strategy == grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex ||
         strategy == grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex) {
       initMessageDestination(strategy);
     }
 
-    // a naive implementation by copy edges
+    // inner and outer neighbors are consecutive slices of the sorted
+    // neighbors, only the boundary is recorded.
     if (need_split_edges) {
       edge_space_.BuildSplitEdges(ivnum_);
     }
   }
 
+  /**
+   * @brief The modification version of the fragment. It is bumped whenever
+   * vertices, edges or edge data are modified, thus data derived from the
+   * fragment, e.g., the typed snapshots of projected fragments, can be reused
+   * as long as the version is unchanged. SetData is not counted.
+   */
+  inline virtual size_t version() const { return version_; }
+
   inline virtual fid_t fid() const { return fid_; }
 
   inline virtual fid_t fnum() const { return fnum_; }
@@ -920,6 +1603,11 @@ class DynamicFragment {
 
   inline virtual size_t selfloops_num() const { return selfloops_num_; }
 
+  inline bool HasSelfLoop(const vertex_t& v) const {
+    return IsInnerVertex(v) &&
+           selfloops_vertices_.find(v.GetValue()) != selfloops_vertices_.end();
+  }
+
   inline virtual bool duplicated() const { return duplicated_; }
 
   inline virtual const vid_t* GetOuterVerticesGid() const { return &ovgid_[0]; }
@@ -1013,14 +1701,18 @@ class DynamicFragment {
                : (fid_t)(ovgid_[u.GetValue() - ivnum_] >> fid_offset_);
   }
 
-  inline virtual const vdata_t& GetData(const vertex_t& v) const {
+  /**
+   * @brief The data of an inner vertex, which is materialized from the
+   * property columns.
+   */
+  inline virtual vdata_t GetData(const vertex_t& v) const {
     assert(IsInnerVertex(v));
-    return ivdata_[v.GetValue()];
+    return ivdata_.GetRow(v.GetValue());
   }
 
   inline virtual void SetData(const vertex_t& v, const vdata_t& val) {
     assert(IsInnerVertex(v));
-    ivdata_[v.GetValue()] = val;
+    ivdata_.Set(v.GetValue(), val);
   }
 
   inline virtual bool HasChild(const vertex_t& v) const {
@@ -1232,8 +1924,8 @@ class DynamicFragment {
     if (ie_pos == -1) {
       return adj_list_t();
     }
-    return adj_list_t(id_mask_, ivnum_, edge_space_[ie_pos].begin(),
-                      edge_space_[ie_pos].end());
+    return adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                      edge_space_[ie_pos].begin(), edge_space_[ie_pos].end());
   }
   /**
    * @brief Returns the incoming adjacent vertices of v.
@@ -1254,7 +1946,8 @@ class DynamicFragment {
     if (ie_pos == -1) {
       return const_adj_list_t();
     }
-    return const_adj_list_t(id_mask_, ivnum_, edge_space_[ie_pos].cbegin(),
+    return const_adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                            edge_space_[ie_pos].cbegin(),
                             edge_space_[ie_pos].cend());
   }
 
@@ -1263,7 +1956,8 @@ class DynamicFragment {
     if (ie_pos == -1) {
       return adj_list_t();
     }
-    return adj_list_t(id_mask_, ivnum_, edge_space_.InnerNbr(ie_pos).begin(),
+    return adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                      edge_space_.InnerNbr(ie_pos).begin(),
                       edge_space_.InnerNbr(ie_pos).end());
   }
 
@@ -1273,7 +1967,7 @@ class DynamicFragment {
     if (ie_pos == -1) {
       return const_adj_list_t();
     }
-    return const_adj_list_t(id_mask_, ivnum_,
+    return const_adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
                             edge_space_.InnerNbr(ie_pos).begin(),
                             edge_space_.InnerNbr(ie_pos).end());
   }
@@ -1283,7 +1977,8 @@ class DynamicFragment {
     if (ie_pos == -1) {
       return adj_list_t();
     }
-    return adj_list_t(id_mask_, ivnum_, edge_space_.OuterNbr(ie_pos).begin(),
+    return adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                      edge_space_.OuterNbr(ie_pos).begin(),
                       edge_space_.OuterNbr(ie_pos).end());
   }
 
@@ -1293,7 +1988,7 @@ class DynamicFragment {
     if (ie_pos == -1) {
       return const_adj_list_t();
     }
-    return const_adj_list_t(id_mask_, ivnum_,
+    return const_adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
                             edge_space_.OuterNbr(ie_pos).begin(),
                             edge_space_.OuterNbr(ie_pos).end());
   }
@@ -1318,8 +2013,8 @@ class DynamicFragment {
     if (oe_pos == -1) {
       return adj_list_t();
     }
-    return adj_list_t(id_mask_, ivnum_, edge_space_[oe_pos].begin(),
-                      edge_space_[oe_pos].end());
+    return adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                      edge_space_[oe_pos].begin(), edge_space_[oe_pos].end());
   }
   /**
    * @brief Returns the outgoing adjacent vertices of v.
@@ -1340,7 +2035,8 @@ class DynamicFragment {
     if (oe_pos == -1) {
       return const_adj_list_t();
     }
-    return const_adj_list_t(id_mask_, ivnum_, edge_space_[oe_pos].cbegin(),
+    return const_adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                            edge_space_[oe_pos].cbegin(),
                             edge_space_[oe_pos].cend());
   }
 
@@ -1349,7 +2045,8 @@ class DynamicFragment {
     if (oe_pos == -1) {
       return adj_list_t();
     }
-    return adj_list_t(id_mask_, ivnum_, edge_space_.InnerNbr(oe_pos).begin(),
+    return adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                      edge_space_.InnerNbr(oe_pos).begin(),
                       edge_space_.InnerNbr(oe_pos).end());
   }
 
@@ -1359,7 +2056,7 @@ class DynamicFragment {
     if (oe_pos == -1) {
       return const_adj_list_t();
     }
-    return const_adj_list_t(id_mask_, ivnum_,
+    return const_adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
                             edge_space_.InnerNbr(oe_pos).begin(),
                             edge_space_.InnerNbr(oe_pos).end());
   }
@@ -1369,7 +2066,8 @@ class DynamicFragment {
     if (oe_pos == -1) {
       return adj_list_t();
     }
-    return adj_list_t(id_mask_, ivnum_, edge_space_.OuterNbr(oe_pos).begin(),
+    return adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
+                      edge_space_.OuterNbr(oe_pos).begin(),
                       edge_space_.OuterNbr(oe_pos).end());
   }
 
@@ -1379,7 +2077,7 @@ class DynamicFragment {
     if (oe_pos == -1) {
       return const_adj_list_t();
     }
-    return const_adj_list_t(id_mask_, ivnum_,
+    return const_adj_list_t(id_mask_, ivnum_, &edge_space_.edge_columns(),
                             edge_space_.OuterNbr(oe_pos).begin(),
                             edge_space_.OuterNbr(oe_pos).end());
   }
@@ -1410,8 +2108,7 @@ class DynamicFragment {
           Gid2Lid(vid, vlid) && isAlive(ulid)) {
         auto pos = inner_oe_pos_[ulid];
         if (pos != -1) {
-          auto& oe = edge_space_[pos];
-          if (oe.find(vlid) != oe.end()) {
+          if (edge_space_[pos].find(vlid) != nullptr) {
             return true;
           }
         }
@@ -1420,8 +2117,7 @@ class DynamicFragment {
         int32_t pos;
         directed() ? pos = inner_ie_pos_[vlid] : pos = inner_oe_pos_[vlid];
         if (pos != -1) {
-          auto& es = edge_space_[pos];
-          if (es.find(ulid) != es.end()) {
+          if (edge_space_[pos].find(ulid) != nullptr) {
             return true;
           }
         }
@@ -1430,8 +2126,7 @@ class DynamicFragment {
                  isAlive(id_mask_ - vlid + ivnum_)) {
         auto pos = outer_oe_pos_[id_mask_ - ulid];
         if (pos != -1) {
-          auto& es = edge_space_[pos];
-          if (es.find(vlid) != es.end()) {
+          if (edge_space_[pos].find(vlid) != nullptr) {
             return true;
           }
         }
@@ -1458,9 +2153,9 @@ class DynamicFragment {
           Gid2Lid(vid, vlid) && isAlive(ulid)) {
         auto pos = inner_oe_pos_[ulid];
         if (pos != -1) {
-          auto& oe = edge_space_[pos];
-          if (oe.find(vlid) != oe.end()) {
-            ret = folly::toJson(oe[vlid].data());
+          auto* nbr = edge_space_[pos].find(vlid);
+          if (nbr != nullptr) {
+            ret = folly::toJson(edge_space_.GetData(*nbr));
             return true;
           }
         }
@@ -1477,9 +2172,9 @@ class DynamicFragment {
           Gid2Lid(vid, vlid) && isAlive(ulid)) {
         auto pos = inner_oe_pos_[ulid];
         if (pos != -1) {
-          auto& oe = edge_space_[pos];
-          if (oe.find(vlid) != oe.end()) {
-            data = oe[vlid].data();
+          auto* nbr = edge_space_[pos].find(vlid);
+          if (nbr != nullptr) {
+            data = edge_space_.GetData(*nbr);
             return true;
           }
         }
@@ -1488,9 +2183,9 @@ class DynamicFragment {
         int32_t pos;
         directed() ? pos = inner_ie_pos_[vlid] : pos = inner_oe_pos_[vlid];
         if (pos != -1) {
-          auto& es = edge_space_[pos];
-          if (es.find(ulid) != es.end()) {
-            data = es[ulid].data();
+          auto* nbr = edge_space_[pos].find(ulid);
+          if (nbr != nullptr) {
+            data = edge_space_.GetData(*nbr);
             return true;
           }
         }
@@ -1499,58 +2194,110 @@ class DynamicFragment {
     return false;
   }
 
+  /**
+   * @brief Modify the edges given by JSON lines. Every worker receives the
+   * whole batch, parses its own block of lines, and shuffles the parsed
+   * edges to the other workers. It must be invoked by all workers together.
+   *
+   * @param thread_num Number of threads to parse lines, 0 means the hardware
+   * concurrency divided by the number of workers on the host.
+   */
   void ModifyEdges(const std::vector<std::string>& edges_to_modify,
-                   const rpc::ModifyType modify_type) {
+                   const rpc::ModifyType modify_type,
+                   const grape::CommSpec& comm_spec, int thread_num = 0) {
     std::vector<internal_vertex_t> vertices;
     std::vector<edge_t> edges;
 
     edges.reserve(edges_to_modify.size());
     invalidCache();
+    double start_time = grape::GetCurrentTime();
+    double parse_time, shuffle_time;
+    size_t shuffled_bytes;
     {
-      edata_t e_data = folly::dynamic::object;
-      vdata_t fake_data = folly::dynamic::object;
-      oid_t src, dst;
-      vid_t src_gid, dst_gid;
-      fid_t src_fid, dst_fid;
+      // stage 1: parse the block of lines of this worker and locate the
+      // endpoints in parallel
       partitioner_t partitioner;
       partitioner.Init(fnum_);
-      auto line_parser_ptr = std::make_unique<DynamicLineParser>();
-      for (auto& line : edges_to_modify) {
-        if (line.empty() || line[0] == '#') {
-          continue;
-        }
-        try {
-          line_parser_ptr->LineParserForEFile(line, src, dst, e_data);
-        } catch (std::exception& e) {
-          LOG(ERROR) << e.what() << " line: " << line;
-          continue;
-        }
-        src_fid = partitioner.GetPartitionId(src);
-        dst_fid = partitioner.GetPartitionId(dst);
-        if (modify_type == rpc::NX_ADD_EDGES) {
-          vm_ptr_->AddVertex(src_fid, src, src_gid);
-          vm_ptr_->AddVertex(dst_fid, dst, dst_gid);
-          if (src_fid == fid_ || duplicated()) {
-            vertices.emplace_back(src_gid, fake_data);
-          }
-          if (dst_fid == fid_ || duplicated()) {
-            vertices.emplace_back(dst_gid, fake_data);
-          }
-        } else {
-          if (!vm_ptr_->GetGid(src_fid, src, src_gid) ||
-              !vm_ptr_->GetGid(dst_fid, dst, dst_gid)) {
-            continue;
-          }
-        }
-        if (src_fid == fid_ || dst_fid == fid_ || duplicated()) {
-          edges.emplace_back(src_gid, dst_gid, e_data);
-          if (!directed_ && src_gid != dst_gid) {
-            edges.emplace_back(dst_gid, src_gid, e_data);
-          }
-        }
-      }
+      auto block = lineBlock(edges_to_modify.size(), comm_spec);
+      std::vector<parsed_edge_t> parsed(block.second - block.first);
+      ParallelParseLines(
+          edges_to_modify, block.first, block.second,
+          [&](DynamicLineParser& parser, const std::string& line, size_t idx) {
+            auto& e = parsed[idx - block.first];
+            try {
+              parser.LineParserForEFile(line, e.src, e.dst, e.data);
+            } catch (std::exception& ex) {
+              LOG(ERROR) << ex.what() << " line: " << line;
+              return;
+            }
+            e.src_fid = partitioner.GetPartitionId(e.src);
+            e.dst_fid = partitioner.GetPartitionId(e.dst);
+            e.valid = true;
+          },
+          parseThreadNum(comm_spec, thread_num));
+      parse_time = grape::GetCurrentTime();
+
+      // stage 2: shuffle the parsed edges. Every worker resolves the gids of
+      // the lines of all blocks in the same order, thus the replicated
+      // vertex maps stay identical, the data is only sent to the workers
+      // holding the edge.
+      shuffled_bytes = shuffleParsed(
+          parsed, comm_spec,
+          [&](const parsed_edge_t& e, int worker, grape::InArchive& arc) {
+            bool related = duplicated() ||
+                           comm_spec.FragToWorker(e.src_fid) == worker ||
+                           comm_spec.FragToWorker(e.dst_fid) == worker;
+            if (!related && modify_type != rpc::NX_ADD_EDGES) {
+              return;
+            }
+            bool with_data = related && modify_type != rpc::NX_DEL_EDGES;
+            arc << with_data << e.src_fid << e.dst_fid;
+            SerializeDynamic(arc, e.src);
+            SerializeDynamic(arc, e.dst);
+            if (with_data) {
+              SerializeDynamic(arc, e.data);
+            }
+          },
+          [](grape::OutArchive& arc, parsed_edge_t& e) {
+            bool with_data;
+            arc >> with_data >> e.src_fid >> e.dst_fid;
+            DeserializeDynamic(arc, e.src);
+            DeserializeDynamic(arc, e.dst);
+            if (with_data) {
+              DeserializeDynamic(arc, e.data);
+            } else {
+              e.data = folly::dynamic::object;
+            }
+          },
+          [&](parsed_edge_t& e) {
+            vdata_t fake_data = folly::dynamic::object;
+            vid_t src_gid, dst_gid;
+            if (modify_type == rpc::NX_ADD_EDGES) {
+              vm_ptr_->AddVertex(e.src_fid, e.src, src_gid);
+              vm_ptr_->AddVertex(e.dst_fid, e.dst, dst_gid);
+              if (e.src_fid == fid_ || duplicated()) {
+                vertices.emplace_back(src_gid, fake_data);
+              }
+              if (e.dst_fid == fid_ || duplicated()) {
+                vertices.emplace_back(dst_gid, fake_data);
+              }
+            } else {
+              if (!vm_ptr_->GetGid(e.src_fid, e.src, src_gid) ||
+                  !vm_ptr_->GetGid(e.dst_fid, e.dst, dst_gid)) {
+                return;
+              }
+            }
+            if (e.src_fid == fid_ || e.dst_fid == fid_ || duplicated()) {
+              if (!directed_ && src_gid != dst_gid) {
+                edges.emplace_back(dst_gid, src_gid, e.data);
+              }
+              edges.emplace_back(src_gid, dst_gid, std::move(e.data));
+            }
+          });
+      shuffle_time = grape::GetCurrentTime();
     }
 
+    // stage 3: apply the modification to the fragment
     switch (modify_type) {
     case rpc::NX_ADD_EDGES:
       Insert(vertices, edges);
@@ -1564,53 +2311,102 @@ class DynamicFragment {
     default:
       CHECK(false);
     }
+    VLOG(1) << "[frag-" << fid_ << "] ModifyEdges " << edges_to_modify.size()
+            << " lines, parse: " << parse_time - start_time
+            << "s, shuffle: " << shuffle_time - parse_time << "s ("
+            << shuffled_bytes << " bytes sent), modify: "
+            << grape::GetCurrentTime() - shuffle_time << "s";
   }
 
+  /**
+   * @brief Modify the vertices given by JSON lines, in the same way as
+   * ModifyEdges. It must be invoked by all workers together.
+   */
   void ModifyVertices(const std::vector<std::string>& vertices_to_modify,
-                      const rpc::ModifyType& modify_type) {
+                      const rpc::ModifyType& modify_type,
+                      const grape::CommSpec& comm_spec, int thread_num = 0) {
     std::vector<internal_vertex_t> vertices;
     std::vector<edge_t> empty_edges;
 
     vertices.reserve(vertices_to_modify.size());
     invalidCache();
+    double start_time = grape::GetCurrentTime();
+    double parse_time, shuffle_time;
+    size_t shuffled_bytes;
     {
+      // stage 1: parse the block of lines of this worker and locate the
+      // vertices in parallel
       partitioner_t partitioner;
       partitioner.Init(fnum_);
-      oid_t oid;
-      vid_t gid;
-      vdata_t v_data = folly::dynamic::object;
-      fid_t v_fid;
-      auto line_parser_ptr = std::make_unique<DynamicLineParser>();
-      for (auto& line : vertices_to_modify) {
-        if (line.empty() || line[0] == '#') {
-          continue;
-        }
-        try {
-          line_parser_ptr->LineParserForVFile(line, oid, v_data);
-        } catch (std::exception& e) {
-          LOG(ERROR) << e.what();
-          continue;
-        }
-        v_fid = partitioner.GetPartitionId(oid);
-        if (modify_type == rpc::NX_ADD_NODES) {
-          vm_ptr_->AddVertex(v_fid, oid, gid);
-        } else {
-          // UPDATE or DELETE, if not exist the node, continue.
-          if (!vm_ptr_->GetGid(v_fid, oid, gid)) {
-            continue;
-          }
-        }
-        if (v_fid == fid_ ||
-            (modify_type == rpc::NX_DEL_NODES &&
-             ovg2i_.find(gid) != ovg2i_.end()) ||
-            duplicated()) {
-          vertices.emplace_back(gid, v_data);
-        }
-      }
+      auto block = lineBlock(vertices_to_modify.size(), comm_spec);
+      std::vector<parsed_vertex_t> parsed(block.second - block.first);
+      ParallelParseLines(
+          vertices_to_modify, block.first, block.second,
+          [&](DynamicLineParser& parser, const std::string& line, size_t idx) {
+            auto& v = parsed[idx - block.first];
+            try {
+              parser.LineParserForVFile(line, v.oid, v.data);
+            } catch (std::exception& ex) {
+              LOG(ERROR) << ex.what();
+              return;
+            }
+            v.fid = partitioner.GetPartitionId(v.oid);
+            v.valid = true;
+          },
+          parseThreadNum(comm_spec, thread_num));
+      parse_time = grape::GetCurrentTime();
+
+      // stage 2: shuffle the parsed vertices and resolve gids in the order of
+      // lines. Adding and deleting touch the vertex maps or the outer
+      // vertices of every worker, updating only touches the owner.
+      shuffled_bytes = shuffleParsed(
+          parsed, comm_spec,
+          [&](const parsed_vertex_t& v, int worker, grape::InArchive& arc) {
+            bool related =
+                duplicated() || comm_spec.FragToWorker(v.fid) == worker;
+            if (!related && modify_type == rpc::NX_UPDATE_NODES) {
+              return;
+            }
+            bool with_data = related && modify_type != rpc::NX_DEL_NODES;
+            arc << with_data << v.fid;
+            SerializeDynamic(arc, v.oid);
+            if (with_data) {
+              SerializeDynamic(arc, v.data);
+            }
+          },
+          [](grape::OutArchive& arc, parsed_vertex_t& v) {
+            bool with_data;
+            arc >> with_data >> v.fid;
+            DeserializeDynamic(arc, v.oid);
+            if (with_data) {
+              DeserializeDynamic(arc, v.data);
+            } else {
+              v.data = folly::dynamic::object;
+            }
+          },
+          [&](parsed_vertex_t& v) {
+            vid_t gid;
+            if (modify_type == rpc::NX_ADD_NODES) {
+              vm_ptr_->AddVertex(v.fid, v.oid, gid);
+            } else {
+              // UPDATE or DELETE, if not exist the node, continue.
+              if (!vm_ptr_->GetGid(v.fid, v.oid, gid)) {
+                return;
+              }
+            }
+            if (v.fid == fid_ ||
+                (modify_type == rpc::NX_DEL_NODES &&
+                 ovg2i_.find(gid) != ovg2i_.end()) ||
+                duplicated()) {
+              vertices.emplace_back(gid, std::move(v.data));
+            }
+          });
+      shuffle_time = grape::GetCurrentTime();
     }
     if (vertices.empty())
       return;
 
+    // stage 3: apply the modification to the fragment
     switch (modify_type) {
     case rpc::NX_ADD_NODES:
       Insert(vertices, empty_edges);
@@ -1624,6 +2420,12 @@ class DynamicFragment {
     default:
       CHECK(false);
     }
+    VLOG(1) << "[frag-" << fid_ << "] ModifyVertices "
+            << vertices_to_modify.size()
+            << " lines, parse: " << parse_time - start_time
+            << "s, shuffle: " << shuffle_time - parse_time << "s ("
+            << shuffled_bytes << " bytes sent), modify: "
+            << grape::GetCurrentTime() - shuffle_time << "s";
   }
 
   /**
@@ -1639,7 +2441,7 @@ class DynamicFragment {
 
     for (auto v : inner_vertices) {
       if (IsAliveInnerVertex(v)) {
-        auto data = ivdata_[v.GetValue()];
+        auto data = ivdata_.GetRow(v.GetValue());
 
         CHECK(data.isObject());
         for (auto& k : data.keys()) {
@@ -1676,9 +2478,8 @@ class DynamicFragment {
                             size_t edge_pos) -> bl::result<void> {
       auto& adj_list = edge_space_[edge_pos];
 
-      for (auto& e : adj_list) {
-        auto& nbr = e.second;
-        auto data = nbr.data();
+      for (auto& nbr : adj_list) {
+        auto data = edge_space_.GetData(nbr);
 
         CHECK(data.isObject());
         for (auto& k : data.keys()) {
@@ -1792,14 +2593,107 @@ class DynamicFragment {
   }
 
  private:
-  inline virtual vid_t ivnum() { return ivnum_; }
+  // a parsed line of ModifyEdges
+  struct parsed_edge_t {
+    oid_t src, dst;
+    edata_t data = folly::dynamic::object;
+    fid_t src_fid{}, dst_fid{};
+    bool valid = false;
+  };
 
-  inline virtual vid_t tvnum() { return tvnum_; }
+  // a parsed line of ModifyVertices
+  struct parsed_vertex_t {
+    oid_t oid;
+    vdata_t data = folly::dynamic::object;
+    fid_t fid{};
+    bool valid = false;
+  };
 
-  inline virtual Array<vdata_t, grape::Allocator<vdata_t>>& vdata() {
-    return ivdata_;
+  // the block of lines parsed by this worker, blocks are in the order of
+  // worker ids
+  static std::pair<size_t, size_t> lineBlock(size_t line_num,
+                                             const grape::CommSpec& comm_spec) {
+    size_t worker_num = comm_spec.worker_num();
+    size_t block_size = (line_num + worker_num - 1) / worker_num;
+    size_t begin = std::min(line_num, block_size * comm_spec.worker_id());
+    return std::make_pair(begin, std::min(line_num, begin + block_size));
+  }
+
+  // workers on the same host share the cores
+  static int parseThreadNum(const grape::CommSpec& comm_spec, int thread_num) {
+    if (thread_num > 0) {
+      return thread_num;
+    }
+    return std::max(1, static_cast<int>((std::thread::hardware_concurrency() +
+                                         comm_spec.local_num() - 1) /
+                                        comm_spec.local_num()));
+  }
+
+  /**
+   * @brief Send the valid parsed lines of this worker to the other workers,
+   * then apply func to the parsed lines of all workers in the order of
+   * blocks, i.e., in the order of lines.
+   *
+   * @param serialize serialize(parsed, worker, arc) writes what the worker
+   * needs of a parsed line, or nothing to skip it.
+   * @param deserialize deserialize(arc, parsed) reads a parsed line.
+   * @return The number of bytes sent.
+   */
+  template <typename PARSED_T, typename SER_FUNC_T, typename DE_FUNC_T,
+            typename FUNC_T>
+  static size_t shuffleParsed(std::vector<PARSED_T>& parsed,
+                              const grape::CommSpec& comm_spec,
+                              const SER_FUNC_T& serialize,
+                              const DE_FUNC_T& deserialize,
+                              const FUNC_T& func) {
+    int worker_num = comm_spec.worker_num();
+    int worker_id = comm_spec.worker_id();
+    size_t sent = 0;
+    std::vector<std::vector<char>> buffers(worker_num);
+    if (worker_num > 1) {
+      grape::InArchive arc;
+      for (int worker = 0; worker < worker_num; ++worker) {
+        if (worker == worker_id) {
+          continue;
+        }
+        arc.Clear();
+        for (auto& item : parsed) {
+          if (item.valid) {
+            serialize(item, worker, arc);
+          }
+        }
+        buffers[worker].assign(arc.GetBuffer(),
+                               arc.GetBuffer() + arc.GetSize());
+        sent += arc.GetSize();
+      }
+      grape::AllToAll(buffers, comm_spec.comm());
+    }
+
+    for (int worker = 0; worker < worker_num; ++worker) {
+      if (worker == worker_id) {
+        for (auto& item : parsed) {
+          if (item.valid) {
+            func(item);
+          }
+        }
+        continue;
+      }
+      grape::OutArchive arc;
+      arc.SetSlice(buffers[worker].data(), buffers[worker].size());
+      PARSED_T item;
+      while (!arc.Empty()) {
+        deserialize(arc, item);
+        func(item);
+      }
+      std::vector<char>().swap(buffers[worker]);
+    }
+    return sent;
   }
 
+  inline virtual vid_t ivnum() { return ivnum_; }
+
+  inline virtual vid_t tvnum() { return tvnum_; }
+
   inline virtual Array<int32_t, grape::Allocator<int32_t>>& inner_ie_pos() {
     return inner_ie_pos_;
   }
@@ -1816,10 +2710,18 @@ class DynamicFragment {
     return outer_oe_pos_;
   }
 
-  virtual dynamic_fragment_impl::NbrMapSpace<edata_t>& inner_edge_space() {
+  virtual dynamic_fragment_impl::NbrSpace<edata_t>& inner_edge_space() {
     return edge_space_;
   }
 
+  virtual dynamic_fragment_impl::PropertyColumns& vertex_columns() {
+    return ivdata_;
+  }
+
+  inline const dynamic_fragment_impl::PropertyColumns& edge_columns() {
+    return inner_edge_space().edge_columns();
+  }
+
   inline bool isAlive(vid_t lid) const {
     if (lid < ivnum_) {
       return inner_vertex_alive_[lid];
@@ -1852,13 +2754,12 @@ class DynamicFragment {
       ++ovnum_;
     }
 
-    ivdata_.clear();
-    ivdata_.resize(ivnum_);
+    ivdata_.Clear();
     if (sizeof(internal_vertex_t) > sizeof(vid_t)) {
       for (auto& v : vertices) {
         vid_t gid = v.vid();
         if (is_iv_gid(gid)) {
-          ivdata_[(gid & id_mask_)] = v.vdata();
+          ivdata_.Set((gid & id_mask_), v.vdata());
         }
       }
     }
@@ -1867,13 +2768,12 @@ class DynamicFragment {
   void initVerticesDuplicated(std::vector<internal_vertex_t>& vertices,
                               std::vector<edge_t>& edges) {
     std::vector<vid_t> outer_vertices;
-    ivdata_.clear();
-    ivdata_.resize(ivnum_);
+    ivdata_.Clear();
     if (sizeof(internal_vertex_t) > sizeof(vid_t)) {
       for (auto& v : vertices) {
         vid_t gid = v.vid();
         if (is_iv_gid(gid)) {
-          ivdata_[(gid & id_mask_)] = v.vdata();
+          ivdata_.Set((gid & id_mask_), v.vdata());
         } else {
           auto iter = ovg2i_.find(gid);
           if (iter == ovg2i_.end()) {
@@ -1914,7 +2814,7 @@ class DynamicFragment {
     for (auto& v : vertices) {
       // the vertex exist
       if (is_iv_gid(v.vid())) {
-        ivdata_[(v.vid() & id_mask_)] = v.vdata();
+        ivdata_.Set((v.vid() & id_mask_), v.vdata());
       }
     }
 
@@ -2134,12 +3034,11 @@ class DynamicFragment {
     ovnum_ = new_ovnum;
     tvnum_ = ivnum_ + ovnum_;
 
-    ivdata_.resize(ivnum_, folly::dynamic::object);
     if (sizeof(internal_vertex_t) > sizeof(vid_t)) {
       for (auto& v : vertices) {
         vid_t gid = v.vid();
         if (gid >> fid_offset_ == fid_) {
-          ivdata_[(gid & id_mask_)].update(v.vdata());
+          ivdata_.Update((gid & id_mask_), v.vdata());
         }
       }
     }
@@ -2152,12 +3051,11 @@ class DynamicFragment {
     vid_t new_ovnum = ovnum_;
     alive_ivnum_ += new_ivnum - ivnum_;
     ivnum_ = new_ivnum;
-    ivdata_.resize(ivnum_, folly::dynamic::object);
     if (sizeof(internal_vertex_t) > sizeof(vid_t)) {
       for (auto& v : vertices) {
         vid_t gid = v.vid();
         if (is_iv_gid(gid)) {
-          ivdata_[(gid & id_mask_)].update(v.vdata());
+          ivdata_.Update((gid & id_mask_), v.vdata());
         } else {
           auto iter = ovg2i_.find(gid);
           if (iter == ovg2i_.end()) {
@@ -2270,6 +3168,7 @@ class DynamicFragment {
     default:
       assert(false);
     }
+    edge_space_.Compact();
   }
 
   void addEdgesDuplicated(std::vector<edge_t>& edges) {
@@ -2337,6 +3236,7 @@ class DynamicFragment {
     default:
       CHECK(false);
     }
+    edge_space_.Compact();
   }
 
   void initDestFidList(
@@ -2354,7 +3254,7 @@ class DynamicFragment {
 
         if (inner_vertex_alive_[i] && pos != -1) {
           for (auto& e : edge_space_[pos]) {
-            vid_t src = e.first;
+            vid_t src = e.neighbor().GetValue();
             if (src >= ivnum_) {
               fid_t f = ovgid_[id_mask_ - src] >> fid_offset_;
               dstset.insert(f);
@@ -2368,7 +3268,7 @@ class DynamicFragment {
 
         if (inner_vertex_alive_[i] && pos != -1) {
           for (auto& e : edge_space_[pos]) {
-            vid_t dst = e.first;
+            vid_t dst = e.neighbor().GetValue();
             if (dst >= ivnum_) {
               fid_t f = ovgid_[id_mask_ - dst] >> fid_offset_;
               dstset.insert(f);
@@ -2520,6 +3420,7 @@ class DynamicFragment {
             deleteSelfLoop(lid);
           }
           inner_vertex_alive_[lid] = false;
+          ivdata_.Reset(lid);
           to_remove_lid_set.insert(lid);
           alive_ivnum_--;
         }
@@ -2763,11 +3664,7 @@ class DynamicFragment {
     memcpy(&ovgid_[0], &(other->ovgid_[0]),
            other->ovgid_.size() * sizeof(vid_t));
 
-    ivdata_.clear();
-    ivdata_.resize(other->ivdata_.size());
-    for (size_t i = 0; i < ivnum_; ++i) {
-      ivdata_[i] = other->ivdata_[i];
-    }
+    ivdata_ = other->ivdata_;
 
     inner_vertex_alive_.resize(other->inner_vertex_alive_.size());
     memcpy(&inner_vertex_alive_[0], &(other->inner_vertex_alive_[0]),
@@ -2874,7 +3771,8 @@ class DynamicFragment {
         continue;
       }
       for (auto& e : origin->edge_space_[ie_pos]) {
-        if (addInnerOutgoingEdge(lid, e.first, e.second.data())) {
+        if (addInnerOutgoingEdge(lid, e.neighbor().GetValue(),
+                                 origin->edge_space_.GetData(e))) {
           ++oenum_;
         }
       }
@@ -2895,10 +3793,12 @@ class DynamicFragment {
           continue;
         }
         for (auto& e : origin->edge_space_[ie_pos]) {
-          addOuterOutgoingEdge(id_mask_ - ov_index, e.first, e.second.data());
+          addOuterOutgoingEdge(id_mask_ - ov_index, e.neighbor().GetValue(),
+                               origin->edge_space_.GetData(e));
         }
       }
     }
+    edge_space_.Compact();
   }
 
   void induceDist(std::shared_ptr<DynamicFragment> origin,
@@ -2983,7 +3883,7 @@ class DynamicFragment {
           // store the vertex data
           CHECK(vm_ptr_->GetGid(fid_, oid, gid));
           auto lid = iv_gid_to_lid(gid);
-          ivdata_[lid] = origin->GetData(vertex);
+          ivdata_.Set(lid, origin->GetData(vertex));
           inner_vertex_alive_[lid] = true;
         } else {
           if (duplicated_) {
@@ -3035,7 +3935,7 @@ class DynamicFragment {
           // src is inner vertex
           auto lid = iv_gid_to_lid(gid);
           CHECK(origin->GetVertex(src_oid, vertex));
-          ivdata_[lid] = origin->GetData(vertex);
+          ivdata_.Set(lid, origin->GetData(vertex));
           inner_vertex_alive_[lid] = true;
           CHECK(vm_ptr_->GetGid(dst_oid, dst_gid));
           CHECK(origin->GetEdgeData(src_oid, dst_oid, edata));
@@ -3043,7 +3943,7 @@ class DynamicFragment {
           if ((dst_gid >> fid_offset_) == fid_ && gid != dst_gid) {
             // dst is inner vertex too
             CHECK(origin->GetVertex(dst_oid, vertex));
-            ivdata_[(dst_gid & id_mask_)] = origin->GetData(vertex);
+            ivdata_.Set((dst_gid & id_mask_), origin->GetData(vertex));
             inner_vertex_alive_[(dst_gid & id_mask_)] = true;
             if (!directed_) {
               edges.emplace_back(dst_gid, gid, edata);
@@ -3054,7 +3954,7 @@ class DynamicFragment {
         } else if (vm_ptr_->GetGid(fid_, dst_oid, dst_gid)) {
           // dst is inner vertex but src is outer vertex
           CHECK(origin->GetVertex(dst_oid, vertex));
-          ivdata_[(dst_gid & id_mask_)] = origin->GetData(vertex);
+          ivdata_.Set((dst_gid & id_mask_), origin->GetData(vertex));
           inner_vertex_alive_[(dst_gid & id_mask_)] = true;
           CHECK(vm_ptr_->GetGid(src_oid, gid));
           origin->GetEdgeData(src_oid, dst_oid, edata);
@@ -3085,6 +3985,7 @@ class DynamicFragment {
   }
 
   void invalidCache() {
+    ++version_;
     alive_inner_vertices_.first = false;
     alive_outer_vertices_.first = false;
     alive_vertices_.first = false;
@@ -3130,19 +4031,20 @@ class DynamicFragment {
       ovg2i_;  // <outer vertex gid, idx of outer vertex>
   Array<vid_t, grape::Allocator<vid_t>>
       ovgid_;  // idx is index of outer vertex, the content is gid
-  Array<vdata_t, grape::Allocator<vdata_t>> ivdata_;
+  // the data of inner vertices, indexed by lid
+  dynamic_fragment_impl::PropertyColumns ivdata_;
   Array<vdata_t, grape::Allocator<vdata_t>> ovdata_;
   Array<bool> inner_vertex_alive_;
   Array<bool> outer_vertex_alive_;
 
   // ie_pos_[lid]/oe_pos_[lid] stores the inner index representation of
-  // NbrMapSpace DO NOT use unsigned type, because negative numbers have
+  // NbrSpace DO NOT use unsigned type, because negative numbers have
   // internal meaning
   Array<int32_t, grape::Allocator<int32_t>> inner_ie_pos_;
   Array<int32_t, grape::Allocator<int32_t>> inner_oe_pos_;
   Array<int32_t, grape::Allocator<int32_t>> outer_ie_pos_;
   Array<int32_t, grape::Allocator<int32_t>> outer_oe_pos_;
-  dynamic_fragment_impl::NbrMapSpace<edata_t> edge_space_;
+  dynamic_fragment_impl::NbrSpace<edata_t> edge_space_;
 
   size_t selfloops_num_{};
   std::set<vid_t> selfloops_vertices_;
@@ -3159,6 +4061,10 @@ class DynamicFragment {
   Array<fid_t*, grape::Allocator<fid_t*>> idoffset_, odoffset_, iodoffset_;
 
   const vid_t invalid_vid = std::numeric_limits<vid_t>::max();
+  // bumped by invalidCache, i.e., whenever the graph is modified
+  size_t version_{};
+  // bumped whenever the layout written by Serialize changes
+  static constexpr int kSnapshotVersion = 1;
 
   inline bool is_iv_gid(vid_t id) const { return (id >> fid_offset_) == fid_; }
 
@@ -3167,6 +4073,27 @@ class DynamicFragment {
                                           : (id_mask_ - ovg2i_.at(gid));
   }
 
+  template <typename T, typename ALLOC_T>
+  static void serializeArray(grape::InArchive& arc,
+                             const Array<T, ALLOC_T>& array) {
+    arc << array.size();
+    if (array.size() > 0) {
+      arc.AddBytes(&array[0], array.size() * sizeof(T));
+    }
+  }
+
+  template <typename T, typename ALLOC_T>
+  static void deserializeArray(grape::OutArchive& arc,
+                               Array<T, ALLOC_T>& array) {
+    size_t size;
+    arc >> size;
+    array.clear();
+    array.resize(size);
+    if (size > 0) {
+      memcpy(&array[0], arc.GetBytes(size * sizeof(T)), size * sizeof(T));
+    }
+  }
+
   inline vid_t iv_gid_to_lid(vid_t gid) const { return gid & id_mask_; }
   inline vid_t ov_gid_to_lid(vid_t gid) const {
     return id_mask_ - ovg2i_.at(gid);
@@ -18,10 +18,14 @@
 
 #ifdef NETWORKX
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "boost/lexical_cast.hpp"
 #include "folly/dynamic.h"
@@ -37,6 +41,13 @@ namespace gs {
 /**
  * @brief DynamicGraphReporter is used to query the vertex and edge information
  * of DynamicFragment.
+ *
+ * The report types ending with _BY_NODES take a list of nodes (or edges for
+ * HAS_EDGES), every worker answers the nodes it owns, and the answers are
+ * gathered on the coordinator. The result is columnar, i.e.,
+ * [[node, ...], [value, ...]] in the order of the request, and the value of a
+ * node absent in the graph is null (false for HAS_NODES and HAS_EDGES). The
+ * ALL_ report types return the columns of all nodes in the same way.
  */
 class DynamicGraphReporter : public grape::Communicator {
   using fragment_t = DynamicFragment;
@@ -126,6 +137,31 @@ class DynamicGraphReporter : public grape::Communicator {
       BOOST_LEAF_AUTO(lid, params.Get<int64_t>(rpc::LID));
       return batchGetNodes(fragment, fid, lid);
     }
+    case rpc::HAS_NODES:
+    case rpc::NODES_DATA:
+    case rpc::DEG_BY_NODES:
+    case rpc::IN_DEG_BY_NODES:
+    case rpc::OUT_DEG_BY_NODES:
+    case rpc::NEIGHBORS_BY_NODES:
+    case rpc::SUCCS_BY_NODES:
+    case rpc::PREDS_BY_NODES: {
+      BOOST_LEAF_AUTO(nodes_in_json, params.Get<std::string>(rpc::NODE));
+      BOOST_LEAF_AUTO(edge_key, params.Get<std::string>(rpc::EDGE_KEY));
+      auto nodes = folly::parseJson(nodes_in_json, json_opts_);
+      return getByNodes(fragment, nodes, report_type, edge_key);
+    }
+    case rpc::HAS_EDGES: {
+      BOOST_LEAF_AUTO(edges_in_json, params.Get<std::string>(rpc::EDGE));
+      auto edges = folly::parseJson(edges_in_json, json_opts_);
+      return hasEdges(fragment, edges);
+    }
+    case rpc::ALL_NODES_DATA:
+    case rpc::ALL_DEG:
+    case rpc::ALL_IN_DEG:
+    case rpc::ALL_OUT_DEG: {
+      BOOST_LEAF_AUTO(edge_key, params.Get<std::string>(rpc::EDGE_KEY));
+      return getAll(fragment, report_type, edge_key);
+    }
     default:
       CHECK(false);
     }
@@ -340,29 +376,245 @@ class DynamicGraphReporter : public grape::Communicator {
     return ret;
   }
 
+  /**
+   * @brief Answer a list of nodes, values of the nodes owned by the fragment
+   * are computed by multiple threads.
+   */
+  std::string getByNodes(std::shared_ptr<fragment_t>& fragment,
+                         const folly::dynamic& nodes,
+                         const rpc::ReportType& type,
+                         const std::string& weight) {
+    size_t size = nodes.size();
+    std::vector<char> found(size, false);
+    std::vector<folly::dynamic> values(size);
+    parallelFor(size, [&](size_t i) {
+      vertex_t v;
+      if (fragment->GetInnerVertex(nodes[i], v) &&
+          fragment->IsAliveInnerVertex(v)) {
+        found[i] = true;
+        values[i] = getNodeValue(fragment, v, type, weight);
+      }
+    });
+
+    folly::dynamic default_value = nullptr;
+    if (type == rpc::HAS_NODES) {
+      default_value = false;
+    }
+    return gatherByIndex(nodes, found, values, default_value);
+  }
+
+  std::string hasEdges(std::shared_ptr<fragment_t>& fragment,
+                       const folly::dynamic& edges) {
+    size_t size = edges.size();
+    std::vector<char> found(size, false);
+    std::vector<folly::dynamic> values(size);
+    parallelFor(size, [&](size_t i) {
+      auto& edge = edges[i];
+      if (fragment->HasEdge(edge[0], edge[1])) {
+        found[i] = true;
+        values[i] = true;
+      }
+    });
+    return gatherByIndex(edges, found, values, false);
+  }
+
+  /**
+   * @brief Report the columns of all alive nodes, the inner vertices are
+   * scanned by multiple threads.
+   */
+  std::string getAll(std::shared_ptr<fragment_t>& fragment,
+                     const rpc::ReportType& type, const std::string& weight) {
+    vid_t ivnum = fragment->GetInnerVerticesNum();
+    std::vector<char> alive(ivnum, false);
+    std::vector<folly::dynamic> values(ivnum);
+    parallelFor(ivnum, [&](size_t i) {
+      vertex_t v(static_cast<vid_t>(i));
+      if (fragment->IsAliveInnerVertex(v)) {
+        alive[i] = true;
+        values[i] = getNodeValue(fragment, v, type, weight);
+      }
+    });
+
+    folly::dynamic columns =
+        folly::dynamic::array(folly::dynamic::array, folly::dynamic::array);
+    for (vid_t i = 0; i < ivnum; ++i) {
+      if (alive[i]) {
+        columns[0].push_back(fragment->GetId(vertex_t(i)));
+        columns[1].push_back(std::move(values[i]));
+      }
+    }
+
+    std::vector<std::string> partials;
+    AllGather(folly::json::serialize(columns, json_opts_), partials);
+    std::string ret;
+    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      folly::dynamic all =
+          folly::dynamic::array(folly::dynamic::array, folly::dynamic::array);
+      for (auto& partial : partials) {
+        auto part = folly::parseJson(partial, json_opts_);
+        for (size_t i = 0; i < part[0].size(); ++i) {
+          all[0].push_back(std::move(part[0][i]));
+          all[1].push_back(std::move(part[1][i]));
+        }
+      }
+      ret = folly::json::serialize(all, json_opts_);
+    }
+    return ret;
+  }
+
+  folly::dynamic getNodeValue(std::shared_ptr<fragment_t>& fragment,
+                              vertex_t& v, const rpc::ReportType& type,
+                              const std::string& weight) {
+    switch (type) {
+    case rpc::HAS_NODES:
+      return true;
+    case rpc::NODES_DATA:
+    case rpc::ALL_NODES_DATA:
+      return fragment->GetData(v);
+    case rpc::NEIGHBORS_BY_NODES:
+    case rpc::SUCCS_BY_NODES:
+    case rpc::PREDS_BY_NODES: {
+      folly::dynamic nbrs =
+          folly::dynamic::array(folly::dynamic::array, folly::dynamic::array);
+      if (type != rpc::PREDS_BY_NODES) {
+        for (auto& e : fragment->GetOutgoingAdjList(v)) {
+          nbrs[0].push_back(fragment->GetId(e.neighbor()));
+          nbrs[1].push_back(e.data());
+        }
+      }
+      if (type != rpc::SUCCS_BY_NODES) {
+        for (auto& e : fragment->GetIncomingAdjList(v)) {
+          nbrs[0].push_back(fragment->GetId(e.neighbor()));
+          nbrs[1].push_back(e.data());
+        }
+      }
+      return nbrs;
+    }
+    default:
+      return getGraphDegree(fragment, v, type, weight);
+    }
+  }
+
+  /**
+   * @brief Gather the values found by workers on the coordinator, and put
+   * them in the order of keys. Others return an empty string.
+   */
+  std::string gatherByIndex(const folly::dynamic& keys,
+                            const std::vector<char>& found,
+                            std::vector<folly::dynamic>& values,
+                            const folly::dynamic& default_value) {
+    folly::dynamic partial =
+        folly::dynamic::array(folly::dynamic::array, folly::dynamic::array);
+    for (size_t i = 0; i < found.size(); ++i) {
+      if (found[i]) {
+        partial[0].push_back(static_cast<int64_t>(i));
+        partial[1].push_back(std::move(values[i]));
+      }
+    }
+
+    std::vector<std::string> partials;
+    AllGather(folly::json::serialize(partial, json_opts_), partials);
+    std::string ret;
+    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      folly::dynamic column = folly::dynamic::array;
+      column.resize(keys.size(), default_value);
+      for (auto& partial_in_json : partials) {
+        auto part = folly::parseJson(partial_in_json, json_opts_);
+        for (size_t i = 0; i < part[0].size(); ++i) {
+          column[part[0][i].asInt()] = std::move(part[1][i]);
+        }
+      }
+      ret = folly::json::serialize(folly::dynamic::array(keys, column),
+                                   json_opts_);
+    }
+    return ret;
+  }
+
+  /**
+   * @brief Call func(i) for i in [0, size) with the threads of the worker,
+   * small requests are answered by the calling thread.
+   */
+  template <typename FUNC_T>
+  void parallelFor(size_t size, const FUNC_T& func) {
+    if (size <= parallel_chunk_size_) {
+      for (size_t i = 0; i < size; ++i) {
+        func(i);
+      }
+      return;
+    }
+    int thread_num =
+        (std::thread::hardware_concurrency() + comm_spec_.local_num() - 1) /
+        comm_spec_.local_num();
+    thread_num = std::max(
+        1, std::min(thread_num, static_cast<int>(size / parallel_chunk_size_)));
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads(thread_num);
+    for (int tid = 0; tid < thread_num; ++tid) {
+      threads[tid] = std::thread([&]() {
+        while (true) {
+          size_t begin = next.fetch_add(parallel_chunk_size_);
+          if (begin >= size) {
+            break;
+          }
+          size_t end = std::min(size, begin + parallel_chunk_size_);
+          for (size_t i = begin; i < end; ++i) {
+            func(i);
+          }
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  // reads the weight from the edge columns without materializing the row
+  template <typename NBR_T>
+  static double edgeWeight(const NBR_T& e, const std::string& weight) {
+    auto value = e.GetProperty(weight);
+    return value.isNull() ? 1 : value.asDouble();
+  }
+
   double getGraphDegree(std::shared_ptr<fragment_t>& fragment, vertex_t& v,
                         const rpc::ReportType& type,
                         const std::string& weight) {
     double degree = 0;
     if (type == rpc::IN_DEG_BY_NODE || type == rpc::DEG_BY_NODE ||
-        type == rpc::IN_DEG_BY_LOC || type == rpc::DEG_BY_LOC) {
+        type == rpc::IN_DEG_BY_LOC || type == rpc::DEG_BY_LOC ||
+        type == rpc::IN_DEG_BY_NODES || type == rpc::DEG_BY_NODES ||
+        type == rpc::ALL_IN_DEG || type == rpc::ALL_DEG) {
       if (weight.empty()) {
         degree += static_cast<double>(fragment->GetLocalInDegree(v));
       } else {
         auto ie = fragment->GetIncomingAdjList(v);
         for (auto& e : ie) {
-          degree += e.data().getDefault(weight, 1).asDouble();
+          degree += edgeWeight(e, weight);
         }
       }
     }
     if (type == rpc::OUT_DEG_BY_NODE || type == rpc::DEG_BY_NODE ||
-        type == rpc::OUT_DEG_BY_LOC || type == rpc::DEG_BY_LOC) {
+        type == rpc::OUT_DEG_BY_LOC || type == rpc::DEG_BY_LOC ||
+        type == rpc::OUT_DEG_BY_NODES || type == rpc::DEG_BY_NODES ||
+        type == rpc::ALL_OUT_DEG || type == rpc::ALL_DEG) {
       if (weight.empty()) {
         degree += static_cast<double>(fragment->GetLocalOutDegree(v));
       } else {
         auto oe = fragment->GetOutgoingAdjList(v);
         for (auto& e : oe) {
-          degree += e.data().getDefault(weight, 1).asDouble();
+          degree += edgeWeight(e, weight);
+        }
+      }
+    }
+    // a self loop is stored once in the adjacent list of an undirected graph,
+    // but counted twice in the degree, as networkx does
+    if (!fragment->directed() && fragment->HasSelfLoop(v)) {
+      if (weight.empty()) {
+        degree += 1;
+      } else {
+        for (auto& e : fragment->GetOutgoingAdjList(v)) {
+          if (e.neighbor() == v) {
+            degree += edgeWeight(e, weight);
+          }
         }
       }
     }
@@ -371,6 +623,7 @@ class DynamicGraphReporter : public grape::Communicator {
 
   grape::CommSpec comm_spec_;
   static const int batch_num_ = 100;
+  static const size_t parallel_chunk_size_ = 1024;
   folly::json::serialization_opts json_opts_;
 };
 }  // namespace gs
@@ -62,6 +62,8 @@ class DynamicFragmentView : public DynamicFragment {
 
   virtual ~DynamicFragmentView() = default;
 
+  inline size_t version() const { return fragment_->version(); }
+
   inline fid_t fid() const { return fragment_->fid(); }
 
   inline fid_t fnum() const { return fragment_->fnum(); }
@@ -121,7 +123,7 @@ class DynamicFragmentView : public DynamicFragment {
     return fragment_->GetFragId(u);
   }
 
-  inline const vdata_t& GetData(const vertex_t& v) const {
+  inline vdata_t GetData(const vertex_t& v) const {
     return fragment_->GetData(v);
   }
 
@@ -293,10 +295,6 @@ class DynamicFragmentView : public DynamicFragment {
  private:
   inline vid_t ivnum() { return fragment_->ivnum(); }
 
-  inline Array<vdata_t, grape::Allocator<vdata_t>>& vdata() {
-    return fragment_->vdata();
-  }
-
   inline Array<int32_t, grape::Allocator<int32_t>>& inner_ie_pos() {
     if (view_type_ == FragmentViewType::REVERSED ||
         view_type_ == FragmentViewType::DIRECTED) {
@@ -312,10 +310,14 @@ class DynamicFragmentView : public DynamicFragment {
     return fragment_->inner_oe_pos();
   }
 
-  dynamic_fragment_impl::NbrMapSpace<edata_t>& inner_edge_space() {
+  dynamic_fragment_impl::NbrSpace<edata_t>& inner_edge_space() {
     return fragment_->inner_edge_space();
   }
 
+  dynamic_fragment_impl::PropertyColumns& vertex_columns() {
+    return fragment_->vertex_columns();
+  }
+
  private:
   fragment_t* fragment_;
   FragmentViewType view_type_;
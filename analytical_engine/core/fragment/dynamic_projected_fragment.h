@@ -18,9 +18,12 @@
 
 #ifdef NETWORKX
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -44,56 +47,61 @@ pack_dynamic(folly::dynamic& d, const T& val) {
 }
 
 /**
- * @brief A specialized UnpackDynamicVData for int32_t type
+ * @brief Unpack the value of the projected vertex property, the value is null
+ * if the vertex does not have the property.
  */
 template <typename T>
 typename std::enable_if<std::is_integral<T>::value, T>::type unpack_dynamic(
-    const folly::dynamic& data, const std::string& v_prop_key) {
-  if (data.count(v_prop_key) == 0) {
+    const folly::dynamic& value, const std::string& v_prop_key) {
+  if (value.isNull()) {
     LOG(ERROR) << "vertex not contains property " << v_prop_key;
   }
-  return data[v_prop_key].asInt();
+  return value.asInt();
 }
 
 template <typename T>
 typename std::enable_if<std::is_floating_point<T>::value, T>::type
-unpack_dynamic(const folly::dynamic& data, const std::string& v_prop_key) {
-  if (data.count(v_prop_key) == 0) {
+unpack_dynamic(const folly::dynamic& value, const std::string& v_prop_key) {
+  if (value.isNull()) {
     LOG(ERROR) << "vertex not contains property " << v_prop_key;
   }
-  return data[v_prop_key].asDouble();
+  return value.asDouble();
 }
 
 template <typename T>
 typename std::enable_if<std::is_same<T, bool>::value, T>::type unpack_dynamic(
-    const folly::dynamic& data, const std::string& v_prop_key) {
-  if (data.count(v_prop_key) == 0) {
+    const folly::dynamic& value, const std::string& v_prop_key) {
+  if (value.isNull()) {
     LOG(ERROR) << "vertex not contains property " << v_prop_key;
   }
-  return data[v_prop_key].asBool();
+  return value.asBool();
 }
 
 template <typename T>
 typename std::enable_if<std::is_same<T, std::string>::value, T>::type
-unpack_dynamic(const folly::dynamic& data, const std::string& v_prop_key) {
-  if (data.count(v_prop_key) == 0) {
+unpack_dynamic(const folly::dynamic& value, const std::string& v_prop_key) {
+  if (value.isNull()) {
     LOG(ERROR) << "vertex not contains property " << v_prop_key;
   }
-  return data[v_prop_key].asString();
+  return value.asString();
 }
 
 template <typename T>
 typename std::enable_if<std::is_same<T, grape::EmptyType>::value, T>::type
-unpack_dynamic(const folly::dynamic& data, const std::string& v_prop_key) {
+unpack_dynamic(const folly::dynamic& value, const std::string& v_prop_key) {
   return grape::EmptyType();
 }
 
+/**
+ * @brief Unpack the value of the projected edge property into the neighbor,
+ * the value is null if the edge does not have the property.
+ */
 template <typename T>
 typename std::enable_if<std::is_integral<T>::value>::type unpack_nbr(
-    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& d,
+    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& value,
     const std::string& key) {
-  if (d.count(key)) {
-    nbr.set_data(d[key].asInt());
+  if (!value.isNull()) {
+    nbr.set_data(value.asInt());
   } else {
     LOG(ERROR) << "edge not contains property " << key;
   }
@@ -101,10 +109,10 @@ typename std::enable_if<std::is_integral<T>::value>::type unpack_nbr(
 
 template <typename T>
 typename std::enable_if<std::is_floating_point<T>::value>::type unpack_nbr(
-    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& d,
+    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& value,
     const std::string& key) {
-  if (d.count(key)) {
-    nbr.set_data(d[key].asDouble());
+  if (!value.isNull()) {
+    nbr.set_data(value.asDouble());
   } else {
     LOG(ERROR) << "edge not contains property " << key;
   }
@@ -112,10 +120,10 @@ typename std::enable_if<std::is_floating_point<T>::value>::type unpack_nbr(
 
 template <typename T>
 typename std::enable_if<std::is_same<std::string, T>::value>::type unpack_nbr(
-    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& d,
+    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& value,
     const std::string& key) {
-  if (d.count(key)) {
-    nbr.set_data(d[key].asString());
+  if (!value.isNull()) {
+    nbr.set_data(value.asString());
   } else {
     LOG(ERROR) << "edge not contains property " << key;
   }
@@ -123,10 +131,10 @@ typename std::enable_if<std::is_same<std::string, T>::value>::type unpack_nbr(
 
 template <typename T>
 typename std::enable_if<std::is_same<bool, T>::value>::type unpack_nbr(
-    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& d,
+    dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& value,
     const std::string& key) {
-  if (d.count(key)) {
-    nbr.set_data(d[key].asBool());
+  if (!value.isNull()) {
+    nbr.set_data(value.asBool());
   } else {
     LOG(ERROR) << "edge not contains property " << key;
   }
@@ -134,56 +142,218 @@ typename std::enable_if<std::is_same<bool, T>::value>::type unpack_nbr(
 
 template <typename T>
 typename std::enable_if<std::is_same<grape::EmptyType, T>::value>::type
-unpack_nbr(dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& d,
+unpack_nbr(dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& value,
            const std::string& key) {
   nbr.set_data(grape::EmptyType());
 }
 
-#define SET_PROJECTED_NBR                               \
-  void set_nbr() {                                      \
-    auto original_nbr = map_current_->second;           \
-    auto& data = original_nbr.data();                   \
-                                                        \
-    unpack_nbr<EDATA_T>(internal_nbr, data, prop_key_); \
-    internal_nbr.set_neighbor(original_nbr.neighbor()); \
-    auto v = internal_nbr.neighbor();                   \
-    if (v.GetValue() >= ivnum_) {                       \
-      v.SetValue(ivnum_ + id_mask_ - v.GetValue());     \
-    }                                                   \
-    internal_nbr.set_neighbor(v);                       \
+/**
+ * @brief Project a neighbor of DynamicFragment to EDATA_T, the internal lid of
+ * an outer neighbor is mapped to ivnum + (id_mask - lid). Rows which are not
+ * readable from the raw view are read through the columns owning the view.
+ */
+template <typename EDATA_T>
+inline void project_nbr(
+    const dynamic_fragment_impl::IndexedNbr& original_nbr,
+    dynamic_fragment_impl::Nbr<EDATA_T>& nbr,
+    vineyard::property_graph_types::VID_TYPE id_mask,
+    vineyard::property_graph_types::VID_TYPE ivnum,
+    const dynamic_fragment_impl::TypedPropertyView<EDATA_T>& view,
+    const std::string& prop_key) {
+  if (view.Has(original_nbr.eid())) {
+    nbr.set_data(view[original_nbr.eid()]);
+  } else if (!std::is_same<EDATA_T, grape::EmptyType>::value) {
+    unpack_nbr<EDATA_T>(
+        nbr, view.owner()->GetProperty(original_nbr.eid(), prop_key),
+        prop_key);
+  }
+  auto v = original_nbr.neighbor();
+  if (v.GetValue() >= ivnum) {
+    v.SetValue(ivnum + id_mask - v.GetValue());
+  }
+  nbr.set_neighbor(v);
+}
+
+#define SET_PROJECTED_NBR                                                   \
+  void set_nbr() {                                                          \
+    project_nbr<EDATA_T>(*current_, internal_nbr, id_mask_, ivnum_, view_, \
+                         prop_key_);                                        \
   }
 
 /**
- * @brief This is an internal representation of neighbor vertices using
- * std::map.
+ * @brief A CSR snapshot of the neighbors of a DynamicFragment whose edge data
+ * are projected to EDATA_T. The neighbor lists are indexed by their positions
+ * in the edge space, thus the ie_pos/oe_pos of vertices are used as is.
+ *
+ * A snapshot is built for a version of the fragment and is stale once the
+ * version changes.
+ *
+ * @tparam EDATA_T Data type of edge
+ */
+template <typename EDATA_T>
+class ProjectedNbrSnapshot {
+  using VID_T = vineyard::property_graph_types::VID_TYPE;
+  using ProjectedNbrT = dynamic_fragment_impl::Nbr<EDATA_T>;
+  using ViewT = dynamic_fragment_impl::TypedPropertyView<EDATA_T>;
+
+ public:
+  ProjectedNbrSnapshot() = default;
+
+  /**
+   * @brief Only numeric edge data are materialized, copying strings costs
+   * more than unpacking them during the iteration.
+   */
+  static bool Supported() { return std::is_arithmetic<EDATA_T>::value; }
+
+  inline bool IsValid(size_t version) const {
+    return built_ && version_ == version;
+  }
+
+  /**
+   * @brief Build the snapshot from the edge space, which must be compacted.
+   * The neighbor lists are counted and then projected by thread_num threads,
+   * the previous snapshot is released first.
+   */
+  void Build(const dynamic_fragment_impl::NbrSpace<folly::dynamic>& space,
+             VID_T id_mask, VID_T ivnum, const ViewT& view,
+             const std::string& prop_key, size_t version, int thread_num) {
+    Clear();
+    size_t loc_num = space.size();
+    offsets_.resize(loc_num + 1, 0);
+    splits_.resize(loc_num, 0);
+    parallelFor(loc_num, thread_num, [&](size_t loc) {
+      auto& nbrs = space[loc];
+      offsets_[loc + 1] = nbrs.cend() - nbrs.cbegin();
+      splits_[loc] = nbrs.lower_bound(ivnum) - nbrs.cbegin();
+    });
+    for (size_t loc = 0; loc < loc_num; ++loc) {
+      offsets_[loc + 1] += offsets_[loc];
+      splits_[loc] += offsets_[loc];
+    }
+    nbrs_.resize(offsets_[loc_num]);
+    parallelFor(loc_num, thread_num, [&](size_t loc) {
+      auto* nbr = &nbrs_[offsets_[loc]];
+      for (auto& original_nbr : space[loc]) {
+        project_nbr<EDATA_T>(original_nbr, *nbr++, id_mask, ivnum, view,
+                             prop_key);
+      }
+    });
+    version_ = version;
+    built_ = true;
+  }
+
+  // Release the memory of the snapshot, the getters fall back to projecting
+  // the neighbors on the fly until it is built again.
+  void Clear() {
+    std::vector<size_t>().swap(offsets_);
+    std::vector<size_t>().swap(splits_);
+    std::vector<ProjectedNbrT>().swap(nbrs_);
+    built_ = false;
+  }
+
+  // all neighbors of the list at loc are [Begin, End), the inner neighbors
+  // are [Begin, Split) and the outer neighbors are [Split, End).
+  inline ProjectedNbrT* Begin(size_t loc) { return at(offsets_[loc]); }
+
+  inline ProjectedNbrT* Split(size_t loc) { return at(splits_[loc]); }
+
+  inline ProjectedNbrT* End(size_t loc) { return at(offsets_[loc + 1]); }
+
+  inline const ProjectedNbrT* Begin(size_t loc) const {
+    return at(offsets_[loc]);
+  }
+
+  inline const ProjectedNbrT* Split(size_t loc) const {
+    return at(splits_[loc]);
+  }
+
+  inline const ProjectedNbrT* End(size_t loc) const {
+    return at(offsets_[loc + 1]);
+  }
+
+ private:
+  inline ProjectedNbrT* at(size_t offset) { return nbrs_.data() + offset; }
+
+  inline const ProjectedNbrT* at(size_t offset) const {
+    return nbrs_.data() + offset;
+  }
+
+  // lists are claimed by threads in chunks, as the sizes of them are skewed
+  template <typename FUNC_T>
+  static void parallelFor(size_t size, int thread_num, const FUNC_T& func) {
+    thread_num = std::max(
+        1, std::min(thread_num, static_cast<int>(size / kChunkSize)));
+    if (thread_num == 1) {
+      for (size_t i = 0; i < size; ++i) {
+        func(i);
+      }
+      return;
+    }
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads(thread_num);
+    for (int tid = 0; tid < thread_num; ++tid) {
+      threads[tid] = std::thread([&]() {
+        while (true) {
+          size_t begin = next.fetch_add(kChunkSize);
+          if (begin >= size) {
+            break;
+          }
+          size_t end = std::min(size, begin + kChunkSize);
+          for (size_t i = begin; i < end; ++i) {
+            func(i);
+          }
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  static constexpr size_t kChunkSize = 4096;
+
+  std::vector<size_t> offsets_;
+  std::vector<size_t> splits_;
+  std::vector<ProjectedNbrT> nbrs_;
+  size_t version_{};
+  bool built_ = false;
+};
+
+/**
+ * @brief Adjacency list of a vertex which projects the edge data of a
+ * contiguous range of neighbors to EDATA_T, or iterates a range of a
+ * ProjectedNbrSnapshot directly.
  *
  * @tparam EDATA_T Data type of edge
  */
 template <typename EDATA_T>
 class ProjectedAdjLinkedList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
-  using NbrT = dynamic_fragment_impl::Nbr<folly::dynamic>;
+  using NbrT = dynamic_fragment_impl::IndexedNbr;
   using ProjectedNbrT = dynamic_fragment_impl::Nbr<EDATA_T>;
+  using ViewT = dynamic_fragment_impl::TypedPropertyView<EDATA_T>;
 
  public:
   ProjectedAdjLinkedList() = default;
-  ProjectedAdjLinkedList(
-      VID_T id_mask, VID_T ivnum, std::string prop_key,
-      typename std::map<VID_T, NbrT>::iterator map_iter_begin,
-      typename std::map<VID_T, NbrT>::iterator map_iter_end)
+  ProjectedAdjLinkedList(VID_T id_mask, VID_T ivnum, std::string prop_key,
+                         const ViewT& view, NbrT* begin, NbrT* end)
       : id_mask_(id_mask),
         ivnum_(ivnum),
         prop_key_(std::move(prop_key)),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        view_(view),
+        begin_(begin),
+        end_(end) {}
+  ProjectedAdjLinkedList(ProjectedNbrT* begin, ProjectedNbrT* end)
+      : nbr_begin_(begin), nbr_end_(end) {}
   ~ProjectedAdjLinkedList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return Size() == 0; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
+  // at most one of the ranges is not empty
   inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
+    return (end_ - begin_) + (nbr_end_ - nbr_begin_);
   }
 
   class iterator {
@@ -195,61 +365,84 @@ class ProjectedAdjLinkedList {
    public:
     iterator() = default;
     iterator(VID_T id_mask, VID_T ivnum, std::string prop_key,
-             typename std::map<VID_T, NbrT>::iterator map_current) noexcept
+             const ViewT& view, NbrT* current) noexcept
         : id_mask_(id_mask),
           ivnum_(ivnum),
           prop_key_(std::move(prop_key)),
-          map_current_(map_current) {}
+          view_(view),
+          current_(current) {}
+    explicit iterator(ProjectedNbrT* nbr) noexcept : nbr_(nbr) {}
 
     reference_type operator*() noexcept {
+      if (nbr_ != nullptr) {
+        return *nbr_;
+      }
       set_nbr();
       return internal_nbr;
     }
 
     pointer_type operator->() noexcept {
+      if (nbr_ != nullptr) {
+        return nbr_;
+      }
       set_nbr();
       return &internal_nbr;
     }
 
     iterator& operator++() noexcept {
-      ++map_current_;
+      if (nbr_ != nullptr) {
+        ++nbr_;
+      } else {
+        ++current_;
+      }
       return *this;
     }
 
     iterator operator++(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_++);
+      iterator ret(*this);
+      ++(*this);
+      return ret;
     }
 
     iterator& operator--() noexcept {
-      --map_current_;
+      if (nbr_ != nullptr) {
+        --nbr_;
+      } else {
+        --current_;
+      }
       return *this;
     }
 
     iterator operator--(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_--);
+      iterator ret(*this);
+      --(*this);
+      return ret;
     }
 
     iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return iterator(id_mask_, ivnum_, curr);
+      iterator ret(*this);
+      if (nbr_ != nullptr) {
+        ret.nbr_ += offset;
+      } else {
+        ret.current_ += offset;
+      }
+      return ret;
     }
 
     bool operator==(const iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_ && nbr_ == rhs.nbr_;
     }
 
-    bool operator!=(const iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
-    }
+    bool operator!=(const iterator& rhs) noexcept { return !(*this == rhs); }
 
    private:
-    VID_T id_mask_;
-    VID_T ivnum_;
+    VID_T id_mask_{};
+    VID_T ivnum_{};
     std::string prop_key_;
+    ViewT view_;
     ProjectedNbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::iterator map_current_;
+    NbrT* current_ = nullptr;
+    ProjectedNbrT* nbr_ = nullptr;
   };
 
   class const_iterator {
@@ -260,87 +453,129 @@ class ProjectedAdjLinkedList {
 
    public:
     const_iterator() = default;
-    const_iterator(
-        VID_T id_mask, VID_T ivnum, std::string prop_key,
-        typename std::map<VID_T, NbrT>::iterator map_current) noexcept
+    const_iterator(VID_T id_mask, VID_T ivnum, std::string prop_key,
+                   const ViewT& view, const NbrT* current) noexcept
         : id_mask_(id_mask),
           ivnum_(ivnum),
           prop_key_(std::move(prop_key)),
-          map_current_(map_current) {}
+          view_(view),
+          current_(current) {}
+    explicit const_iterator(const ProjectedNbrT* nbr) noexcept : nbr_(nbr) {}
 
     reference_type operator*() const noexcept {
+      if (nbr_ != nullptr) {
+        return *nbr_;
+      }
       const_cast<const_iterator*>(this)->set_nbr();
       return internal_nbr;
     }
 
     pointer_type operator->() const noexcept {
+      if (nbr_ != nullptr) {
+        return nbr_;
+      }
       const_cast<const_iterator*>(this)->set_nbr();
       return &internal_nbr;
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      if (nbr_ != nullptr) {
+        ++nbr_;
+      } else {
+        ++current_;
+      }
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      const_iterator ret(*this);
+      ++(*this);
+      return ret;
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      if (nbr_ != nullptr) {
+        --nbr_;
+      } else {
+        --current_;
+      }
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      const_iterator ret(*this);
+      --(*this);
+      return ret;
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      const_iterator ret(*this);
+      if (nbr_ != nullptr) {
+        ret.nbr_ += offset;
+      } else {
+        ret.current_ += offset;
+      }
+      return ret;
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_ && nbr_ == rhs.nbr_;
     }
+
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return !(*this == rhs);
     }
 
    private:
-    VID_T id_mask_;
-    VID_T ivnum_;
+    VID_T id_mask_{};
+    VID_T ivnum_{};
     std::string prop_key_;
+    ViewT view_;
     ProjectedNbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::iterator map_current_;
+    const NbrT* current_ = nullptr;
+    const ProjectedNbrT* nbr_ = nullptr;
   };
 
   iterator begin() {
-    return iterator(id_mask_, ivnum_, prop_key_, map_iter_begin_);
+    if (nbr_begin_ != nullptr) {
+      return iterator(nbr_begin_);
+    }
+    return iterator(id_mask_, ivnum_, prop_key_, view_, begin_);
   }
 
   iterator end() {
-    return iterator(id_mask_, ivnum_, prop_key_, map_iter_end_);
+    if (nbr_end_ != nullptr) {
+      return iterator(nbr_end_);
+    }
+    return iterator(id_mask_, ivnum_, prop_key_, view_, end_);
   }
 
   const_iterator cbegin() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_begin_);
+    if (nbr_begin_ != nullptr) {
+      return const_iterator(nbr_begin_);
+    }
+    return const_iterator(id_mask_, ivnum_, prop_key_, view_, begin_);
   }
+
   const_iterator cend() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_end_);
+    if (nbr_end_ != nullptr) {
+      return const_iterator(nbr_end_);
+    }
+    return const_iterator(id_mask_, ivnum_, prop_key_, view_, end_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return Empty(); }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
   std::string prop_key_;
-  typename std::map<VID_T, NbrT>::iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::iterator map_iter_end_;
+  ViewT view_;
+  NbrT* begin_ = nullptr;
+  NbrT* end_ = nullptr;
+  // the range of a snapshot
+  ProjectedNbrT* nbr_begin_ = nullptr;
+  ProjectedNbrT* nbr_end_ = nullptr;
 };
 
 /**
@@ -350,112 +585,64 @@ class ProjectedAdjLinkedList {
 template <typename EDATA_T>
 class ConstProjectedAdjLinkedList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
-  using NbrT = dynamic_fragment_impl::Nbr<folly::dynamic>;
+  using NbrT = dynamic_fragment_impl::IndexedNbr;
   using ProjectedNbrT = dynamic_fragment_impl::Nbr<EDATA_T>;
+  using ViewT = dynamic_fragment_impl::TypedPropertyView<EDATA_T>;
 
  public:
   ConstProjectedAdjLinkedList() = default;
-  ConstProjectedAdjLinkedList(
-      VID_T id_mask, VID_T ivnum, std::string prop_key,
-      typename std::map<VID_T, NbrT>::const_iterator map_iter_begin,
-      typename std::map<VID_T, NbrT>::const_iterator map_iter_end)
+  ConstProjectedAdjLinkedList(VID_T id_mask, VID_T ivnum,
+                              std::string prop_key, const ViewT& view,
+                              const NbrT* begin, const NbrT* end)
       : id_mask_(id_mask),
         ivnum_(ivnum),
         prop_key_(std::move(prop_key)),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        view_(view),
+        begin_(begin),
+        end_(end) {}
+  ConstProjectedAdjLinkedList(const ProjectedNbrT* begin,
+                              const ProjectedNbrT* end)
+      : nbr_begin_(begin), nbr_end_(end) {}
   ~ConstProjectedAdjLinkedList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return Size() == 0; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
+  // at most one of the ranges is not empty
   inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
+    return (end_ - begin_) + (nbr_end_ - nbr_begin_);
   }
 
-  class const_iterator {
-    using pointer_type = const ProjectedNbrT*;
-    using reference_type = const ProjectedNbrT&;
-
-    SET_PROJECTED_NBR
-
-   public:
-    const_iterator() = default;
-    const_iterator(
-        VID_T id_mask, VID_T ivnum, std::string prop_key,
-        typename std::map<VID_T, NbrT>::const_iterator map_current) noexcept
-        : id_mask_(id_mask),
-          ivnum_(ivnum),
-          prop_key_(std::move(prop_key)),
-          map_current_(map_current) {}
-
-    reference_type operator*() const noexcept {
-      const_cast<const_iterator*>(this)->set_nbr();
-      return internal_nbr;
-    }
-
-    pointer_type operator->() const noexcept {
-      const_cast<const_iterator*>(this)->set_nbr();
-      return &internal_nbr;
-    }
-
-    const_iterator& operator++() noexcept {
-      ++map_current_;
-      return *this;
-    }
-
-    const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
-    }
-
-    const_iterator& operator--() noexcept {
-      --map_current_;
-      return *this;
-    }
-
-    const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
-    }
-
-    const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
-    }
-
-    bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
-    }
-
-    bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
-    }
-
-   private:
-    VID_T id_mask_{};
-    VID_T ivnum_{};
-    std::string prop_key_;
-    ProjectedNbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::const_iterator map_current_;
-  };
+  using const_iterator =
+      typename ProjectedAdjLinkedList<EDATA_T>::const_iterator;
 
   const_iterator begin() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_begin_);
+    if (nbr_begin_ != nullptr) {
+      return const_iterator(nbr_begin_);
+    }
+    return const_iterator(id_mask_, ivnum_, prop_key_, view_, begin_);
   }
+
   const_iterator end() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_end_);
+    if (nbr_end_ != nullptr) {
+      return const_iterator(nbr_end_);
+    }
+    return const_iterator(id_mask_, ivnum_, prop_key_, view_, end_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return Empty(); }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
   std::string prop_key_;
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_end_;
+  ViewT view_;
+  const NbrT* begin_ = nullptr;
+  const NbrT* end_ = nullptr;
+  // the range of a snapshot
+  const ProjectedNbrT* nbr_begin_ = nullptr;
+  const ProjectedNbrT* nbr_end_ = nullptr;
 };
 
 }  // namespace dynamic_projected_fragment_impl
@@ -482,6 +669,8 @@ class DynamicProjectedFragment {
       dynamic_projected_fragment_impl::ProjectedAdjLinkedList<edata_t>;
   using const_projected_adj_linked_list_t =
       dynamic_projected_fragment_impl::ConstProjectedAdjLinkedList<edata_t>;
+  using snapshot_t =
+      dynamic_projected_fragment_impl::ProjectedNbrSnapshot<edata_t>;
   using vertex_range_t = typename fragment_t::vertex_range_t;
   template <typename DATA_T>
   using vertex_array_t = typename fragment_t::vertex_array_t<DATA_T>;
@@ -493,7 +682,9 @@ class DynamicProjectedFragment {
                            std::string e_prop_key)
       : fragment_(frag),
         v_prop_key_(std::move(v_prop_key)),
-        e_prop_key_(std::move(e_prop_key)) {}
+        e_prop_key_(std::move(e_prop_key)) {
+    resolveViews();
+  }
 
   static std::shared_ptr<DynamicProjectedFragment<VDATA_T, EDATA_T>> Project(
       const std::shared_ptr<DynamicFragment>& frag, const std::string& v_prop,
@@ -512,8 +703,12 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return projected_adj_linked_list_t(snapshot_.Begin(ie_pos),
+                                         snapshot_.End(ie_pos));
+    }
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space()[ie_pos].begin(),
         fragment_->inner_edge_space()[ie_pos].end());
   }
@@ -529,8 +724,12 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return const_projected_adj_linked_list_t(snapshot_.Begin(ie_pos),
+                                               snapshot_.End(ie_pos));
+    }
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space()[ie_pos].cbegin(),
         fragment_->inner_edge_space()[ie_pos].cend());
   }
@@ -541,8 +740,12 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return projected_adj_linked_list_t(snapshot_.Begin(ie_pos),
+                                         snapshot_.Split(ie_pos));
+    }
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().InnerNbr(ie_pos).begin(),
         fragment_->inner_edge_space().InnerNbr(ie_pos).end());
   }
@@ -553,8 +756,12 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return const_projected_adj_linked_list_t(snapshot_.Begin(ie_pos),
+                                               snapshot_.Split(ie_pos));
+    }
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().InnerNbr(ie_pos).cbegin(),
         fragment_->inner_edge_space().InnerNbr(ie_pos).cend());
   }
@@ -565,8 +772,12 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return projected_adj_linked_list_t(snapshot_.Split(ie_pos),
+                                         snapshot_.End(ie_pos));
+    }
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().OuterNbr(ie_pos).begin(),
         fragment_->inner_edge_space().OuterNbr(ie_pos).end());
   }
@@ -577,8 +788,12 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return const_projected_adj_linked_list_t(snapshot_.Split(ie_pos),
+                                               snapshot_.End(ie_pos));
+    }
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().OuterNbr(ie_pos).cbegin(),
         fragment_->inner_edge_space().OuterNbr(ie_pos).cend());
   }
@@ -593,8 +808,12 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return projected_adj_linked_list_t(snapshot_.Begin(oe_pos),
+                                         snapshot_.End(oe_pos));
+    }
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space()[oe_pos].begin(),
         fragment_->inner_edge_space()[oe_pos].end());
   }
@@ -610,8 +829,12 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return const_projected_adj_linked_list_t(snapshot_.Begin(oe_pos),
+                                               snapshot_.End(oe_pos));
+    }
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space()[oe_pos].cbegin(),
         fragment_->inner_edge_space()[oe_pos].cend());
   }
@@ -622,8 +845,12 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return projected_adj_linked_list_t(snapshot_.Begin(oe_pos),
+                                         snapshot_.Split(oe_pos));
+    }
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().InnerNbr(oe_pos).begin(),
         fragment_->inner_edge_space().InnerNbr(oe_pos).end());
   }
@@ -634,8 +861,12 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return const_projected_adj_linked_list_t(snapshot_.Begin(oe_pos),
+                                               snapshot_.Split(oe_pos));
+    }
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().InnerNbr(oe_pos).cbegin(),
         fragment_->inner_edge_space().InnerNbr(oe_pos).cend());
   }
@@ -646,8 +877,12 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return projected_adj_linked_list_t(snapshot_.Split(oe_pos),
+                                         snapshot_.End(oe_pos));
+    }
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().OuterNbr(oe_pos).begin(),
         fragment_->inner_edge_space().OuterNbr(oe_pos).end());
   }
@@ -658,8 +893,12 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    if (snapshot_.IsValid(fragment_->version())) {
+      return const_projected_adj_linked_list_t(snapshot_.Split(oe_pos),
+                                               snapshot_.End(oe_pos));
+    }
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, e_view_,
         fragment_->inner_edge_space().OuterNbr(oe_pos).cbegin(),
         fragment_->inner_edge_space().OuterNbr(oe_pos).cend());
   }
@@ -708,15 +947,21 @@ class DynamicProjectedFragment {
 
   inline vdata_t GetData(const vertex_t& v) const {
     assert(fragment_->IsInnerVertex(v));
-    auto data = fragment_->vdata()[v.GetValue()];
+    if (v_view_.Has(v.GetValue())) {
+      return v_view_[v.GetValue()];
+    }
     return dynamic_projected_fragment_impl::unpack_dynamic<vdata_t>(
-        data, v_prop_key_);
+        fragment_->vertex_columns().GetProperty(v.GetValue(), v_prop_key_),
+        v_prop_key_);
   }
 
   inline void SetData(const vertex_t& v, const vdata_t& val) {
     assert(fragment_->IsInnerVertex(v));
-    dynamic_projected_fragment_impl::pack_dynamic(
-        fragment_->vdata()[v.GetValue()][v_prop_key_], val);
+    folly::dynamic data;
+    dynamic_projected_fragment_impl::pack_dynamic(data, val);
+    fragment_->vertex_columns().SetProperty(v.GetValue(), v_prop_key_, data);
+    // the column may be reallocated, which makes the view stale
+    fragment_->vertex_columns().GetTypedView(v_prop_key_, v_view_);
   }
 
   inline bool HasChild(const vertex_t& v) const {
@@ -829,6 +1074,8 @@ class DynamicProjectedFragment {
 
   void PrepareToRunApp(grape::MessageStrategy strategy, bool need_split_edges) {
     fragment_->PrepareToRunApp(strategy, need_split_edges);
+    resolveViews();
+    buildSnapshot();
   }
 
   bl::result<folly::dynamic::Type> GetOidType(
@@ -840,10 +1087,57 @@ class DynamicProjectedFragment {
     return fragment_->HasNode(node);
   }
 
+  /**
+   * @brief Release the snapshot of the projected neighbors, e.g., when the
+   * projected graph is unloaded while contexts still refer to it. It is
+   * rebuilt by the next PrepareToRunApp.
+   */
+  void ReleaseSnapshot() { snapshot_.Clear(); }
+
+  const snapshot_t& snapshot() const { return snapshot_; }
+
  private:
+  // Resolve the typed columns of the projected properties. Reading a view is
+  // a plain array access. Rows whose value is not stored as the projected
+  // type, or all rows once the columns are modified, are read through the
+  // columns until the views are resolved again.
+  void resolveViews() {
+    fragment_->vertex_columns().GetTypedView(v_prop_key_, v_view_);
+    fragment_->edge_columns().GetTypedView(e_prop_key_, e_view_);
+  }
+
+  // Materialize the projected neighbors once per version of the fragment,
+  // thus repeated runs of apps on the projected fragment iterate flat arrays
+  // until the fragment is modified. Must be called after the edge space is
+  // compacted, i.e., in PrepareToRunApp.
+  void buildSnapshot() {
+    if (!snapshot_t::Supported()) {
+      return;
+    }
+    size_t version = fragment_->version();
+    if (snapshot_.IsValid(version)) {
+      return;
+    }
+    // workers on the same host share the cores
+    auto& comm_spec = fragment_->GetVertexMap()->GetCommSpec();
+    int thread_num =
+        (std::thread::hardware_concurrency() + comm_spec.local_num() - 1) /
+        comm_spec.local_num();
+    double start = grape::GetCurrentTime();
+    snapshot_.Build(fragment_->inner_edge_space(), fragment_->id_mask(),
+                    fragment_->ivnum(), e_view_, e_prop_key_, version,
+                    thread_num);
+    VLOG(1) << "[frag-" << fragment_->fid() << "] Built the snapshot of "
+            << e_prop_key_ << " in " << grape::GetCurrentTime() - start
+            << "s";
+  }
+
   fragment_t* fragment_;
   std::string v_prop_key_;
   std::string e_prop_key_;
+  dynamic_fragment_impl::TypedPropertyView<vdata_t> v_view_;
+  dynamic_fragment_impl::TypedPropertyView<edata_t> e_view_;
+  snapshot_t snapshot_;
 
   static_assert(std::is_same<int, VDATA_T>::value ||
                     std::is_same<int64_t, VDATA_T>::value ||
@@ -0,0 +1,473 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_DYNAMIC_PROPERTY_COLUMNS_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_DYNAMIC_PROPERTY_COLUMNS_H_
+
+#ifdef NETWORKX
+
+#include <cstdint>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map/flat_hash_map.hpp"
+#include "folly/dynamic.h"
+
+namespace gs {
+
+namespace dynamic_fragment_impl {
+
+/**
+ * @brief PropertyColumnTrait describes how a value of folly::dynamic is stored
+ * in a typed column. Only int64_t, double and std::string have typed columns,
+ * other values are stored in a column of folly::dynamic.
+ */
+template <typename T>
+struct PropertyColumnTrait {
+  static constexpr bool supported = false;
+};
+
+template <>
+struct PropertyColumnTrait<int64_t> {
+  static constexpr bool supported = true;
+  static bool Accept(const folly::dynamic& value) { return value.isInt(); }
+  static int64_t Cast(const folly::dynamic& value) { return value.getInt(); }
+};
+
+template <>
+struct PropertyColumnTrait<double> {
+  static constexpr bool supported = true;
+  static bool Accept(const folly::dynamic& value) { return value.isDouble(); }
+  static double Cast(const folly::dynamic& value) { return value.getDouble(); }
+};
+
+template <>
+struct PropertyColumnTrait<std::string> {
+  static constexpr bool supported = true;
+  static bool Accept(const folly::dynamic& value) { return value.isString(); }
+  static std::string Cast(const folly::dynamic& value) {
+    return value.getString();
+  }
+};
+
+/**
+ * @brief IPropertyColumn is the base class of a column which stores one
+ * property of the vertices or edges of a DynamicFragment. Rows without the
+ * property are marked as invalid.
+ */
+class IPropertyColumn {
+ public:
+  IPropertyColumn() = default;
+  virtual ~IPropertyColumn() = default;
+
+  virtual folly::dynamic::Type type() const = 0;
+
+  virtual std::unique_ptr<IPropertyColumn> Clone() const = 0;
+
+  /**
+   * @brief Set the value of a row.
+   *
+   * @return false if the value can not be stored in this column.
+   */
+  virtual bool Set(size_t idx, const folly::dynamic& value) = 0;
+
+  virtual folly::dynamic Get(size_t idx) const = 0;
+
+  /**
+   * @brief Mark a row as invalid, and release the value it holds.
+   */
+  virtual void Reset(size_t idx) = 0;
+
+  inline bool IsValid(size_t idx) const {
+    return idx < valid_.size() && valid_[idx];
+  }
+
+  inline size_t size() const { return valid_.size(); }
+
+  inline const uint8_t* valid() const { return valid_.data(); }
+
+ protected:
+  // grow the column geometrically to hold row idx
+  template <typename T>
+  void ensureRow(std::vector<T>& values, size_t idx) {
+    if (idx >= valid_.size()) {
+      size_t new_size = std::max(idx + 1, valid_.size() * 2);
+      values.resize(new_size);
+      valid_.resize(new_size, 0);
+    }
+  }
+
+  std::vector<uint8_t> valid_;
+};
+
+/**
+ * @brief A column stores values of type T contiguously.
+ *
+ * @tparam T int64_t, double or std::string
+ */
+template <typename T>
+class TypedPropertyColumn : public IPropertyColumn {
+  static_assert(PropertyColumnTrait<T>::supported, "unsupported type");
+
+ public:
+  TypedPropertyColumn() = default;
+
+  folly::dynamic::Type type() const override {
+    return std::is_same<T, int64_t>::value
+               ? folly::dynamic::Type::INT64
+               : std::is_same<T, double>::value ? folly::dynamic::Type::DOUBLE
+                                                : folly::dynamic::Type::STRING;
+  }
+
+  std::unique_ptr<IPropertyColumn> Clone() const override {
+    return std::unique_ptr<IPropertyColumn>(new TypedPropertyColumn(*this));
+  }
+
+  bool Set(size_t idx, const folly::dynamic& value) override {
+    if (!PropertyColumnTrait<T>::Accept(value)) {
+      return false;
+    }
+    ensureRow(values_, idx);
+    values_[idx] = PropertyColumnTrait<T>::Cast(value);
+    valid_[idx] = 1;
+    return true;
+  }
+
+  folly::dynamic Get(size_t idx) const override {
+    return IsValid(idx) ? folly::dynamic(values_[idx])
+                        : folly::dynamic(nullptr);
+  }
+
+  void Reset(size_t idx) override {
+    if (idx < valid_.size()) {
+      values_[idx] = T();
+      valid_[idx] = 0;
+    }
+  }
+
+  inline const T& at(size_t idx) const { return values_[idx]; }
+
+  inline const T* data() const { return values_.data(); }
+
+ private:
+  std::vector<T> values_;
+};
+
+/**
+ * @brief The fallback column for heterogeneous or non-scalar values.
+ */
+class DynamicPropertyColumn : public IPropertyColumn {
+ public:
+  DynamicPropertyColumn() = default;
+
+  folly::dynamic::Type type() const override {
+    return folly::dynamic::Type::OBJECT;
+  }
+
+  std::unique_ptr<IPropertyColumn> Clone() const override {
+    return std::unique_ptr<IPropertyColumn>(new DynamicPropertyColumn(*this));
+  }
+
+  bool Set(size_t idx, const folly::dynamic& value) override {
+    ensureRow(values_, idx);
+    values_[idx] = value;
+    valid_[idx] = 1;
+    return true;
+  }
+
+  folly::dynamic Get(size_t idx) const override {
+    return IsValid(idx) ? values_[idx] : folly::dynamic(nullptr);
+  }
+
+  void Reset(size_t idx) override {
+    if (idx < valid_.size()) {
+      values_[idx] = nullptr;
+      valid_[idx] = 0;
+    }
+  }
+
+ private:
+  std::vector<folly::dynamic> values_;
+};
+
+template <typename T>
+class TypedPropertyView;
+
+/**
+ * @brief PropertyColumns stores the key-value objects attached with vertices
+ * or edges as one typed column per key, and it is the only storage of these
+ * objects: a row is materialized as a folly::dynamic object on demand. The
+ * type of a column is inferred from the first value of the key, and a column
+ * falls back to folly::dynamic values when the values of the key are
+ * heterogeneous, including ints mixed with doubles, thus a value is always
+ * read back as the type it is written.
+ *
+ * Row indices are lids for vertices and eids for edges.
+ *
+ * The version is bumped whenever the arrays of a column may be reallocated or
+ * replaced, which invalidates the raw arrays held by TypedPropertyView.
+ */
+class PropertyColumns {
+ public:
+  PropertyColumns() = default;
+
+  PropertyColumns(PropertyColumns&& rhs) noexcept
+      : keys_(std::move(rhs.keys_)),
+        key_index_(std::move(rhs.key_index_)),
+        columns_(std::move(rhs.columns_)) {
+    ++rhs.version_;
+  }
+
+  PropertyColumns& operator=(PropertyColumns&& rhs) noexcept {
+    if (this != &rhs) {
+      keys_ = std::move(rhs.keys_);
+      key_index_ = std::move(rhs.key_index_);
+      columns_ = std::move(rhs.columns_);
+      ++version_;
+      ++rhs.version_;
+    }
+    return *this;
+  }
+
+  PropertyColumns(const PropertyColumns& rhs) { *this = rhs; }
+
+  PropertyColumns& operator=(const PropertyColumns& rhs) {
+    if (this != &rhs) {
+      keys_ = rhs.keys_;
+      key_index_ = rhs.key_index_;
+      columns_.clear();
+      for (auto& column : rhs.columns_) {
+        columns_.emplace_back(column->Clone());
+      }
+      ++version_;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Merge the key-values of an object into a row, as
+   * folly::dynamic::update does.
+   */
+  void Update(size_t idx, const folly::dynamic& obj) {
+    if (!obj.isObject()) {
+      return;
+    }
+    for (auto& kv : obj.items()) {
+      SetProperty(idx, kv.first.asString(), kv.second);
+    }
+  }
+
+  /**
+   * @brief Replace a row with the key-values of an object.
+   */
+  void Set(size_t idx, const folly::dynamic& obj) {
+    Reset(idx);
+    Update(idx, obj);
+  }
+
+  void Reset(size_t idx) {
+    for (auto& column : columns_) {
+      column->Reset(idx);
+    }
+  }
+
+  void SetProperty(size_t idx, const std::string& key,
+                   const folly::dynamic& value) {
+    auto iter = key_index_.find(key);
+    if (iter == key_index_.end()) {
+      key_index_.emplace(key, columns_.size());
+      keys_.push_back(key);
+      columns_.emplace_back(createColumn(value));
+      columns_.back()->Set(idx, value);
+      ++version_;
+      return;
+    }
+    auto& column = columns_[iter->second];
+    size_t old_size = column->size();
+    if (!column->Set(idx, value)) {
+      column = convertColumn(*column, value);
+      column->Set(idx, value);
+      ++version_;
+    } else if (column->size() != old_size) {
+      ++version_;
+    }
+  }
+
+  /**
+   * @brief Materialize a row as a folly::dynamic object.
+   */
+  folly::dynamic GetRow(size_t idx) const {
+    folly::dynamic obj = folly::dynamic::object;
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      if (columns_[i]->IsValid(idx)) {
+        obj.insert(keys_[i], columns_[i]->Get(idx));
+      }
+    }
+    return obj;
+  }
+
+  /**
+   * @brief Get the value of key in a row, or null if the row does not have
+   * the key.
+   */
+  folly::dynamic GetProperty(size_t idx, const std::string& key) const {
+    auto* column = GetColumn(key);
+    return column == nullptr ? folly::dynamic(nullptr) : column->Get(idx);
+  }
+
+  void Clear() {
+    keys_.clear();
+    key_index_.clear();
+    columns_.clear();
+    ++version_;
+  }
+
+  const std::vector<std::string>& keys() const { return keys_; }
+
+  inline size_t version() const { return version_; }
+
+  const IPropertyColumn* GetColumn(const std::string& key) const {
+    auto iter = key_index_.find(key);
+    return iter == key_index_.end() ? nullptr : columns_[iter->second].get();
+  }
+
+  /**
+   * @brief Returns the column of key if its values are stored as T, otherwise
+   * nullptr.
+   */
+  template <typename T>
+  typename std::enable_if<PropertyColumnTrait<T>::supported,
+                          const TypedPropertyColumn<T>*>::type
+  GetTypedColumn(const std::string& key) const {
+    return dynamic_cast<const TypedPropertyColumn<T>*>(GetColumn(key));
+  }
+
+  /**
+   * @brief Get the raw view of the column of key, which is valid until the
+   * version of the columns changes.
+   *
+   * @return false if the values of key are not stored as T, and the view is
+   * bound to the columns without raw arrays.
+   */
+  template <typename T>
+  typename std::enable_if<PropertyColumnTrait<T>::supported, bool>::type
+  GetTypedView(const std::string& key, TypedPropertyView<T>& view) const {
+    auto* column = GetTypedColumn<T>(key);
+    if (column == nullptr) {
+      view = TypedPropertyView<T>(this);
+      return false;
+    }
+    view = TypedPropertyView<T>(this, column->data(), column->valid(),
+                                column->size());
+    return true;
+  }
+
+  template <typename T>
+  typename std::enable_if<!PropertyColumnTrait<T>::supported, bool>::type
+  GetTypedView(const std::string& key, TypedPropertyView<T>& view) const {
+    view = TypedPropertyView<T>(this);
+    return false;
+  }
+
+ private:
+  static std::unique_ptr<IPropertyColumn> createColumn(
+      const folly::dynamic& value) {
+    switch (value.type()) {
+    case folly::dynamic::Type::INT64:
+      return std::unique_ptr<IPropertyColumn>(
+          new TypedPropertyColumn<int64_t>());
+    case folly::dynamic::Type::DOUBLE:
+      return std::unique_ptr<IPropertyColumn>(
+          new TypedPropertyColumn<double>());
+    case folly::dynamic::Type::STRING:
+      return std::unique_ptr<IPropertyColumn>(
+          new TypedPropertyColumn<std::string>());
+    default:
+      return std::unique_ptr<IPropertyColumn>(new DynamicPropertyColumn());
+    }
+  }
+
+  static std::unique_ptr<IPropertyColumn> convertColumn(
+      const IPropertyColumn& column, const folly::dynamic& value) {
+    std::unique_ptr<IPropertyColumn> ret(new DynamicPropertyColumn());
+    for (size_t i = 0; i < column.size(); ++i) {
+      if (column.IsValid(i)) {
+        ret->Set(i, column.Get(i));
+      }
+    }
+    return ret;
+  }
+
+  std::vector<std::string> keys_;
+  ska::flat_hash_map<std::string, size_t> key_index_;
+  std::vector<std::unique_ptr<IPropertyColumn>> columns_;
+  size_t version_{};
+};
+
+/**
+ * @brief A raw view of a typed column. The view remembers the version of the
+ * columns it is resolved from, and reports no row once the columns are
+ * modified in a way that may reallocate the arrays, thus readers fall back to
+ * reading the value through the owner. Re-resolve the view by
+ * PropertyColumns::GetTypedView to get back to the raw arrays.
+ *
+ * @tparam T Data type
+ */
+template <typename T>
+class TypedPropertyView {
+ public:
+  TypedPropertyView() = default;
+  explicit TypedPropertyView(const PropertyColumns* owner)
+      : owner_(owner), version_(owner->version()) {}
+  TypedPropertyView(const PropertyColumns* owner, const T* values,
+                    const uint8_t* valid, size_t size)
+      : owner_(owner),
+        version_(owner->version()),
+        values_(values),
+        valid_(valid),
+        size_(size) {}
+
+  inline bool Has(size_t idx) const {
+    return values_ != nullptr && owner_->version() == version_ &&
+           idx < size_ && valid_[idx];
+  }
+
+  inline const T& operator[](size_t idx) const { return values_[idx]; }
+
+  /**
+   * @brief The columns which the view is resolved from, nullptr if the view
+   * is not resolved.
+   */
+  inline const PropertyColumns* owner() const { return owner_; }
+
+ private:
+  const PropertyColumns* owner_ = nullptr;
+  size_t version_{};
+  const T* values_ = nullptr;
+  const uint8_t* valid_ = nullptr;
+  size_t size_{};
+};
+
+}  // namespace dynamic_fragment_impl
+
+}  // namespace gs
+
+#endif  // NETWORKX
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_DYNAMIC_PROPERTY_COLUMNS_H_
@@ -21,6 +21,7 @@
 #include "core/context/tensor_context.h"
 #include "core/context/vertex_data_context.h"
 #include "core/context/vertex_property_context.h"
+#include "core/flags.h"
 #include "core/fragment/dynamic_fragment.h"
 #include "core/fragment/dynamic_fragment_reporter.h"
 #include "core/grape_instance.h"
@@ -144,6 +145,13 @@ bl::result<void> GrapeInstance::unloadGraph(const rpc::GSParams& params) {
       }
     }
   }
+  if (object_manager_.HasObject(graph_name)) {
+    BOOST_LEAF_AUTO(obj, object_manager_.GetObject(graph_name));
+    auto wrapper = std::dynamic_pointer_cast<IFragmentWrapper>(obj);
+    if (wrapper != nullptr) {
+      wrapper->ReleaseCaches();
+    }
+  }
   return object_manager_.RemoveObject(graph_name);
 }
 
@@ -183,6 +191,7 @@ bl::result<rpc::graph::GraphDefPb> GrapeInstance::projectGraph(
                   frag_wrapper->Project(comm_spec_, dst_graph_name,
                                         project_infos[0], project_infos[1]));
   BOOST_LEAF_CHECK(object_manager_.PutObject(new_frag_wrapper));
+  object_manager_.PutSource(dst_graph_name, graph_name);
   return new_frag_wrapper->graph_def();
 }
 
@@ -197,10 +206,37 @@ bl::result<rpc::graph::GraphDefPb> GrapeInstance::projectToSimple(
 
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
+
+  // projections of immutable arrow fragments are cached, a repeated projection
+  // gets an alias of the cached one
+  bool cacheable =
+      wrapper->graph_def().graph_type() == rpc::graph::ARROW_PROPERTY;
+  std::string cache_key =
+      type_sig + "/" +
+      params.Fingerprint({rpc::V_LABEL_ID, rpc::E_LABEL_ID, rpc::V_PROP_ID,
+                          rpc::E_PROP_ID, rpc::INLINE_EDGE_DATA,
+                          rpc::V_LABEL_IDS, rpc::E_LABEL_IDS, rpc::V_PROP_IDS,
+                          rpc::E_PROP_IDS});
+  if (cacheable) {
+    auto cached = std::dynamic_pointer_cast<IFragmentWrapper>(
+        object_manager_.GetProjection(graph_name, cache_key));
+    if (cached != nullptr) {
+      VLOG(1) << "Reuse projection " << cached->id() << " of " << graph_name;
+      auto alias = std::make_shared<FragmentWrapperAlias>(projected_id, cached);
+      BOOST_LEAF_CHECK(object_manager_.PutObject(alias));
+      object_manager_.PutSource(projected_id, graph_name);
+      return alias->graph_def();
+    }
+  }
+
   BOOST_LEAF_AUTO(projector, object_manager_.GetObject<Projector>(type_sig));
   BOOST_LEAF_AUTO(projected_wrapper,
                   projector->Project(wrapper, projected_id, params));
   BOOST_LEAF_CHECK(object_manager_.PutObject(projected_wrapper));
+  object_manager_.PutSource(projected_id, graph_name);
+  if (cacheable) {
+    object_manager_.PutProjection(graph_name, cache_key, projected_wrapper);
+  }
 
   return projected_wrapper->graph_def();
 }
@@ -226,6 +262,7 @@ bl::result<std::string> GrapeInstance::query(const rpc::GSParams& params,
     context_type = ctx_wrapper->context_type();
     context_schema = ctx_wrapper->schema();
     BOOST_LEAF_CHECK(object_manager_.PutObject(ctx_wrapper));
+    object_manager_.PutSource(context_key, graph_name);
   }
   return toJson({{"context_type", context_type},
                  {"context_key", context_key},
@@ -233,7 +270,7 @@ bl::result<std::string> GrapeInstance::query(const rpc::GSParams& params,
 }
 
 bl::result<std::string> GrapeInstance::reportGraph(
-    const rpc::GSParams& params) {
+    const rpc::GSParams& params, const grape::CommSpec& comm_spec) {
 #ifdef NETWORKX
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
   BOOST_LEAF_AUTO(wrapper,
@@ -247,7 +284,7 @@ bl::result<std::string> GrapeInstance::reportGraph(
   }
   auto fragment =
       std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
-  DynamicGraphReporter reporter(comm_spec_);
+  DynamicGraphReporter reporter(comm_spec);
   return reporter.Report(fragment, params);
 #else
   RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
@@ -272,7 +309,8 @@ bl::result<void> GrapeInstance::modifyVertices(
 
   auto fragment =
       std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
-  fragment->ModifyVertices(vertices, modify_type);
+  fragment->ModifyVertices(vertices, modify_type, comm_spec_,
+                           FLAGS_modify_thread_num);
   return {};
 #else
   RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
@@ -297,7 +335,8 @@ bl::result<void> GrapeInstance::modifyEdges(
 
   auto fragment =
       std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
-  fragment->ModifyEdges(edges, modify_type);
+  fragment->ModifyEdges(edges, modify_type, comm_spec_,
+                        FLAGS_modify_thread_num);
 #else
   RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
                   "GS is compiled without folly");
@@ -306,7 +345,7 @@ bl::result<void> GrapeInstance::modifyEdges(
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
-    const rpc::GSParams& params) {
+    const rpc::GSParams& params, const grape::CommSpec& comm_spec) {
   std::pair<std::string, std::string> range;
   std::string s_selector;
 
@@ -330,32 +369,32 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
     BOOST_LEAF_AUTO(axis, params.Get<int64_t>(rpc::AXIS));
 
-    return wrapper->ToNdArray(comm_spec_, axis);
+    return wrapper->ToNdArray(comm_spec, axis);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
             base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   }
   RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
                   "Unsupported context type: " + std::string(ctx_type));
@@ -373,7 +412,7 @@ bl::result<std::string> GrapeInstance::getContextData(
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
-    const rpc::GSParams& params) {
+    const rpc::GSParams& params, const grape::CommSpec& comm_spec) {
   std::pair<std::string, std::string> range;
   std::string s_selectors;
 
@@ -396,32 +435,32 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
     auto wrapper =
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
 
-    return wrapper->ToDataframe(comm_spec_);
+    return wrapper->ToDataframe(comm_spec);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
             base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   }
   RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
                   "Unsupported context type: " + std::string(ctx_type));
@@ -787,6 +826,7 @@ bl::result<rpc::graph::GraphDefPb> GrapeInstance::createGraphView(
   BOOST_LEAF_AUTO(view_wrapper,
                   wrapper->CreateGraphView(comm_spec_, view_id, view_type));
   BOOST_LEAF_CHECK(object_manager_.PutObject(view_wrapper));
+  object_manager_.PutSource(view_id, graph_name);
 
   return view_wrapper->graph_def();
 #else
@@ -821,7 +861,7 @@ bl::result<rpc::graph::GraphDefPb> GrapeInstance::addLabelsToGraph(
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToNumpy(
-    const rpc::GSParams& params) {
+    const rpc::GSParams& params, const grape::CommSpec& comm_spec) {
   std::pair<std::string, std::string> range;
 
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
@@ -835,11 +875,11 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToNumpy(
   }
   BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
 
-  return wrapper->ToNdArray(comm_spec_, selector, range);
+  return wrapper->ToNdArray(comm_spec, selector, range);
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToDataframe(
-    const rpc::GSParams& params) {
+    const rpc::GSParams& params, const grape::CommSpec& comm_spec) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
 
   BOOST_LEAF_AUTO(
@@ -855,7 +895,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToDataframe(
   BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
   BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
 
-  return wrapper->ToDataframe(comm_spec_, selectors, range);
+  return wrapper->ToDataframe(comm_spec, selectors, range);
 }
 
 bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
@@ -877,6 +917,7 @@ bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
     BOOST_LEAF_CHECK(utils->Init());
     return object_manager_.PutObject(utils);
   } else if (graph_type == rpc::graph::ARROW_PROJECTED ||
+             graph_type == rpc::graph::ARROW_FLATTENED ||
              graph_type == rpc::graph::DYNAMIC_PROJECTED) {
     auto projector = std::make_shared<Projector>(type_sig, lib_path);
     BOOST_LEAF_CHECK(projector->Init());
@@ -884,12 +925,23 @@ bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
   } else {
     RETURN_GS_ERROR(
         vineyard::ErrorCode::kInvalidValueError,
-        "Only ArrowProperty/ArrowProjected/DynamicProjected are accepted");
+        "Only ArrowProperty/ArrowProjected/ArrowFlattened/DynamicProjected are "
+        "accepted");
+  }
+}
+
+std::vector<std::string> GrapeInstance::ResolveObjects(
+    const std::vector<std::string>& objects) {
+  std::vector<std::string> resolved;
+  for (auto& id : objects) {
+    auto ids = object_manager_.ResolveSources(id);
+    resolved.insert(resolved.end(), ids.begin(), ids.end());
   }
+  return resolved;
 }
 
 bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
-    const CommandDetail& cmd) {
+    const CommandDetail& cmd, const grape::CommSpec& comm_spec) {
   auto r = std::make_shared<DispatchResult>(comm_spec_.worker_id());
   rpc::GSParams params(cmd.params);
 
@@ -922,7 +974,7 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     break;
   }
   case rpc::REPORT_GRAPH: {
-    BOOST_LEAF_AUTO(report_in_json, reportGraph(params));
+    BOOST_LEAF_AUTO(report_in_json, reportGraph(params, comm_spec));
     r->set_data(report_in_json,
                 DispatchResult::AggregatePolicy::kPickFirstNonEmpty);
     break;
@@ -1076,12 +1128,12 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     break;
   }
   case rpc::CONTEXT_TO_NUMPY: {
-    BOOST_LEAF_AUTO(arc, contextToNumpy(params));
+    BOOST_LEAF_AUTO(arc, contextToNumpy(params, comm_spec));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
     break;
   }
   case rpc::CONTEXT_TO_DATAFRAME: {
-    BOOST_LEAF_AUTO(arc, contextToDataframe(params));
+    BOOST_LEAF_AUTO(arc, contextToDataframe(params, comm_spec));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
     break;
   }
@@ -1107,12 +1159,12 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     break;
   }
   case rpc::GRAPH_TO_NUMPY: {
-    BOOST_LEAF_AUTO(arc, graphToNumpy(params));
+    BOOST_LEAF_AUTO(arc, graphToNumpy(params, comm_spec));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
     break;
   }
   case rpc::GRAPH_TO_DATAFRAME: {
-    BOOST_LEAF_AUTO(arc, graphToDataframe(params));
+    BOOST_LEAF_AUTO(arc, graphToDataframe(params, comm_spec));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
     break;
   }
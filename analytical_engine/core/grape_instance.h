@@ -77,7 +77,10 @@ class GrapeInstance : public Subscriber {
   void Init(const std::string& vineyard_socket);
 
   bl::result<std::shared_ptr<DispatchResult>> OnReceive(
-      const CommandDetail& cmd) override;
+      const CommandDetail& cmd, const grape::CommSpec& comm_spec) override;
+
+  std::vector<std::string> ResolveObjects(
+      const std::vector<std::string>& objects) override;
 
  private:
   bl::result<rpc::graph::GraphDefPb> loadGraph(const rpc::GSParams& params);
@@ -91,7 +94,8 @@ class GrapeInstance : public Subscriber {
   bl::result<std::string> query(const rpc::GSParams& params,
                                 const rpc::QueryArgs& query_args);
 
-  bl::result<std::string> reportGraph(const rpc::GSParams& params);
+  bl::result<std::string> reportGraph(const rpc::GSParams& params,
+                                      const grape::CommSpec& comm_spec);
 
   bl::result<rpc::graph::GraphDefPb> projectGraph(const rpc::GSParams& params);
 
@@ -109,10 +113,10 @@ class GrapeInstance : public Subscriber {
   bl::result<void> clearGraph(const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> contextToNumpy(
-      const rpc::GSParams& params);
+      const rpc::GSParams& params, const grape::CommSpec& comm_spec);
 
   bl::result<std::shared_ptr<grape::InArchive>> contextToDataframe(
-      const rpc::GSParams& params);
+      const rpc::GSParams& params, const grape::CommSpec& comm_spec);
 
   bl::result<std::string> contextToVineyardTensor(const rpc::GSParams& params);
 
@@ -147,10 +151,10 @@ class GrapeInstance : public Subscriber {
   bl::result<std::string> getContextData(const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> graphToNumpy(
-      const rpc::GSParams& params);
+      const rpc::GSParams& params, const grape::CommSpec& comm_spec);
 
   bl::result<std::shared_ptr<grape::InArchive>> graphToDataframe(
-      const rpc::GSParams& params);
+      const rpc::GSParams& params, const grape::CommSpec& comm_spec);
 
   bl::result<void> registerGraphType(const rpc::GSParams& params);
 
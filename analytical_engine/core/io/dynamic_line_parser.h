@@ -20,8 +20,11 @@
 
 #include <cctype>
 
+#include <algorithm>
+#include <atomic>
 #include <regex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -68,6 +71,65 @@ class DynamicLineParser
     }
   }
 };
+
+/**
+ * @brief Parse lines[begin, end) with multiple threads. Lines are split into
+ * chunks which are claimed by threads dynamically, and every thread owns a
+ * parser. func is invoked as func(parser, line, index) for every line except
+ * empty ones and comments, so the results can be written into a
+ * pre-allocated buffer by index without synchronization.
+ *
+ * @param lines Lines to parse.
+ * @param begin Index of the first line to parse.
+ * @param end Index after the last line to parse.
+ * @param func Function to parse a line.
+ * @param thread_num Number of threads, 0 means the hardware concurrency.
+ */
+template <typename FUNC_T>
+void ParallelParseLines(const std::vector<std::string>& lines, size_t begin,
+                        size_t end, const FUNC_T& func, int thread_num = 0) {
+  static constexpr size_t kChunkSize = 4096;
+  end = std::min(end, lines.size());
+  begin = std::min(begin, end);
+  size_t chunk_num = (end - begin + kChunkSize - 1) / kChunkSize;
+  if (thread_num <= 0) {
+    thread_num = std::max(1u, std::thread::hardware_concurrency());
+  }
+  thread_num = static_cast<int>(
+      std::min(static_cast<size_t>(thread_num), chunk_num));
+
+  auto parse_chunks = [&](std::atomic<size_t>& current_chunk) {
+    DynamicLineParser parser;
+    while (true) {
+      size_t chunk = current_chunk.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunk_num) {
+        break;
+      }
+      size_t chunk_begin = begin + chunk * kChunkSize;
+      size_t chunk_end = std::min(chunk_begin + kChunkSize, end);
+      for (size_t i = chunk_begin; i < chunk_end; ++i) {
+        auto& line = lines[i];
+        if (line.empty() || line[0] == '#') {
+          continue;
+        }
+        func(parser, line, i);
+      }
+    }
+  };
+
+  std::atomic<size_t> current_chunk(0);
+  if (thread_num <= 1) {
+    parse_chunks(current_chunk);
+    return;
+  }
+  std::vector<std::thread> threads(thread_num);
+  for (int tid = 0; tid < thread_num; ++tid) {
+    threads[tid] = std::thread([&]() { parse_chunks(current_chunk); });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
 }  // namespace gs
 
 #endif  // NETWORKX
@@ -0,0 +1,578 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_LOADER_APPEND_ONLY_ARROW_FRAGMENT_COMPACTOR_H_
+#define ANALYTICAL_ENGINE_CORE_LOADER_APPEND_ONLY_ARROW_FRAGMENT_COMPACTOR_H_
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/util/config.h"
+#include "glog/logging.h"
+
+#include "grape/util.h"
+#include "grape/worker/comm_spec.h"
+#include "vineyard/client/client.h"
+#include "vineyard/graph/vertex_map/arrow_vertex_map.h"
+
+#include "core/fragment/append_only_arrow_fragment.h"
+#include "core/loader/arrow_fragment_appender.h"
+#include "core/utils/mpi_utils.h"
+
+namespace gs {
+
+/**
+ * @brief AppendOnlyArrowFragmentCompactor folds the vertices and edges
+ * appended to an AppendOnlyArrowFragment into a new sealed fragment with a new
+ * ArrowVertexMap, thus the appended data is stored in CSR again.
+ *
+ * The compaction is asynchronous. StartCompaction takes a snapshot of the
+ * appended data, which must be invoked by all workers together between two
+ * ExtendFragment, then the new fragment is sealed by a background thread
+ * while the appender keeps extending the current one. Once Ready,
+ * FinishCompaction replays the data appended after the snapshot to the new
+ * fragment, switches the appender to it and publishes it atomically by
+ * Current(). Readers holding the previous version keep it alive until they
+ * are done with it, then the previous fragment and its vertex map are deleted
+ * from vineyard by the next StartCompaction, FinishCompaction or the
+ * destructor.
+ *
+ * The gids are kept in the new version, the offset of an appended vertex is
+ * preserved by placing the appended oids after the base ones in the vertex
+ * map. Thus workers are free to switch at different times.
+ *
+ * The background thread seals the new fragment by a client of its own,
+ * connected to the same vineyard server as the given one, which is only used
+ * by the calling thread.
+ *
+ * @tparam OID_T
+ * @tparam VID_T
+ */
+template <typename OID_T, typename VID_T>
+class AppendOnlyArrowFragmentCompactor {
+  using oid_t = OID_T;
+  using vid_t = VID_T;
+  using internal_oid_t = typename vineyard::InternalType<oid_t>::type;
+  using eid_t = vineyard::property_graph_types::EID_TYPE;
+  using label_id_t = vineyard::property_graph_types::LABEL_ID_TYPE;
+  using fragment_t = AppendOnlyArrowFragment<oid_t, vid_t>;
+  using vertex_map_t = vineyard::ArrowVertexMap<internal_oid_t, vid_t>;
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<vid_t, eid_t>;
+  using oid_array_t = typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
+  using oid_builder_t =
+      typename vineyard::ConvertToArrowType<oid_t>::BuilderType;
+  using vid_builder_t =
+      typename vineyard::ConvertToArrowType<vid_t>::BuilderType;
+
+  // the appended data at the beginning of a compaction
+  struct Snapshot {
+    // v_label -> appended vertex properties
+    std::vector<std::shared_ptr<arrow::Table>> vertex_tables;
+    // fid -> v_label -> appended oids
+    std::vector<std::vector<std::vector<oid_t>>> oids;
+    // e_label -> appended edges
+    std::vector<std::vector<vid_t>> edge_src, edge_dst;
+    std::vector<std::shared_ptr<arrow::Table>> edge_tables;
+    std::vector<eid_t> edge_nums;
+  };
+
+ public:
+  AppendOnlyArrowFragmentCompactor(vineyard::Client& client,
+                                   const grape::CommSpec& comm_spec,
+                                   std::shared_ptr<fragment_t> fragment)
+      : client_(client), comm_spec_(comm_spec), current_(fragment) {}
+
+  ~AppendOnlyArrowFragmentCompactor() {
+    if (future_.valid()) {
+      future_.wait();
+    }
+    releaseRetired();
+  }
+
+  /**
+   * @brief The latest version of the fragment, safe to be invoked by any
+   * thread.
+   */
+  std::shared_ptr<fragment_t> Current() const {
+    return std::atomic_load(&current_);
+  }
+
+  bool InProgress() const { return future_.valid(); }
+
+  // Whether the new fragment is sealed and FinishCompaction will not block.
+  bool Ready() const {
+    return future_.valid() && future_.wait_for(std::chrono::seconds(0)) ==
+                                  std::future_status::ready;
+  }
+
+  /**
+   * @brief Take a snapshot of the appended data and seal the new fragment in
+   * the background. It must be invoked by all workers together.
+   */
+  bl::result<void> StartCompaction() {
+    if (future_.valid()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                      "A compaction is in progress");
+    }
+    if (!seal_client_.Connected()) {
+      VY_OK_OR_RAISE(seal_client_.Connect(client_.IPCSocket()));
+    }
+    releaseRetired();
+    auto begin = grape::GetCurrentTime();
+    auto frag = Current();
+    BOOST_LEAF_CHECK(takeSnapshot(*frag));
+    VLOG(1) << "[worker-" << comm_spec_.worker_id()
+            << "] Compaction snapshot time: "
+            << grape::GetCurrentTime() - begin;
+
+    error_msg_.clear();
+    future_ = std::async(std::launch::async, [this, frag]() {
+      auto begin = grape::GetCurrentTime();
+      auto id = boost::leaf::try_handle_all(
+          [&]() { return sealFragment(*frag); },
+          [this](const vineyard::GSError& e) {
+            error_msg_ = e.error_msg;
+            return vineyard::InvalidObjectID();
+          },
+          [this](const boost::leaf::error_info& unmatched) {
+            error_msg_ = "Unknown failure in sealing the fragment";
+            return vineyard::InvalidObjectID();
+          });
+      VLOG(1) << "[worker-" << comm_spec_.worker_id()
+              << "] Compaction seal time: " << grape::GetCurrentTime() - begin;
+      return id;
+    });
+    return {};
+  }
+
+  /**
+   * @brief Wait for the new fragment, then replay the data appended after
+   * the snapshot to it and switch the appender and readers to it. Each
+   * worker invokes it on its own, but not concurrently with ExtendFragment.
+   */
+  bl::result<std::shared_ptr<fragment_t>> FinishCompaction(
+      ArrowFragmentAppender<oid_t, vid_t>& appender) {
+    if (!future_.valid()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                      "No compaction is in progress");
+    }
+    auto id = future_.get();
+    if (id == vineyard::InvalidObjectID()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
+                      "Failed to compact the fragment: " + error_msg_);
+    }
+    auto begin = grape::GetCurrentTime();
+    auto prev = Current();
+    auto frag = std::dynamic_pointer_cast<fragment_t>(client_.GetObject(id));
+    CHECK(frag != nullptr);
+
+    appender.SwitchFragment(frag);
+    BOOST_LEAF_CHECK(replayVertices(*prev, *frag));
+    BOOST_LEAF_CHECK(replayEdges(*prev, *frag, appender));
+    snapshot_ = Snapshot();
+
+    std::atomic_store(&current_, frag);
+    retired_.push_back(std::move(prev));
+    releaseRetired();
+    VLOG(1) << "[worker-" << comm_spec_.worker_id()
+            << "] Compaction replay time: " << grape::GetCurrentTime() - begin;
+    return frag;
+  }
+
+ private:
+  // Deletes the superseded fragments, with their vertex maps, which are not
+  // held by readers any more.
+  void releaseRetired() {
+    auto end = std::remove_if(
+        retired_.begin(), retired_.end(),
+        [this](std::shared_ptr<fragment_t>& frag) {
+          if (frag.use_count() > 1) {
+            return false;
+          }
+          std::vector<vineyard::ObjectID> ids = {frag->id(),
+                                                 frag->vm_ptr_->id()};
+          frag.reset();
+          auto status = client_.DelData(ids, false, true);
+          if (!status.ok()) {
+            LOG(WARNING) << "[worker-" << comm_spec_.worker_id()
+                         << "] Failed to delete the superseded fragment "
+                         << vineyard::ObjectIDToString(ids[0]) << ": "
+                         << status.ToString();
+          }
+          return true;
+        });
+    retired_.erase(end, retired_.end());
+  }
+
+  bl::result<void> takeSnapshot(const fragment_t& frag) {
+    fid_t fid = frag.fid_;
+    label_id_t v_label_num = frag.vertex_label_num_;
+    label_id_t e_label_num = frag.edge_label_num_;
+    auto& extra_vm = *frag.extra_vm_ptr_;
+
+    snapshot_ = Snapshot();
+    snapshot_.vertex_tables.resize(v_label_num);
+    std::vector<std::vector<oid_t>> local_oids(v_label_num);
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      auto& table = frag.extra_vertex_tables_[v_label];
+      if (table->size() > 0) {
+        BOOST_LEAF_ASSIGN(snapshot_.vertex_tables[v_label],
+                          table->Slice(0, table->size()));
+      }
+      local_oids[v_label] = extra_vm.GetOids(fid, v_label);
+    }
+
+    std::vector<std::vector<std::vector<oid_t>>> all_oids;
+    vineyard::GlobalAllGatherv(local_oids, all_oids, comm_spec_);
+    snapshot_.oids.resize(comm_spec_.fnum());
+    for (int worker = 0; worker < comm_spec_.worker_num(); ++worker) {
+      snapshot_.oids[comm_spec_.WorkerToFrag(worker)] =
+          std::move(all_oids[worker]);
+    }
+
+    snapshot_.edge_src.resize(e_label_num);
+    snapshot_.edge_dst.resize(e_label_num);
+    snapshot_.edge_tables.resize(e_label_num);
+    snapshot_.edge_nums.resize(e_label_num);
+    for (label_id_t e_label = 0; e_label < e_label_num; e_label++) {
+      auto& table = frag.extra_edge_tables_[e_label];
+      snapshot_.edge_nums[e_label] = frag.extra_oe_nums_[e_label];
+      collectExtraEdges(frag, e_label, 0, snapshot_.edge_src[e_label],
+                        snapshot_.edge_dst[e_label]);
+      if (table->size() > 0) {
+        BOOST_LEAF_ASSIGN(snapshot_.edge_tables[e_label],
+                          table->Slice(0, table->size()));
+      }
+    }
+    return {};
+  }
+
+  // runs in the background, only the immutable part of frag and the seal
+  // client are accessed
+  bl::result<vineyard::ObjectID> sealFragment(const fragment_t& frag) {
+    fid_t fnum = frag.fnum_;
+    label_id_t v_label_num = frag.vertex_label_num_;
+    label_id_t e_label_num = frag.edge_label_num_;
+    auto& vid_parser = frag.vid_parser_;
+    auto& base_vm = *frag.vm_ptr_;
+
+    // label id -> frag id -> oid array, the appended oids follow the base
+    // ones to keep the gids
+    std::vector<std::vector<std::shared_ptr<oid_array_t>>> oid_lists(
+        v_label_num, std::vector<std::shared_ptr<oid_array_t>>(fnum));
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      for (fid_t fid = 0; fid < fnum; fid++) {
+        auto& extra_oids = snapshot_.oids[fid][v_label];
+        vid_t base_num = base_vm.GetInnerVertexSize(fid, v_label);
+        oid_builder_t builder;
+
+        ARROW_OK_OR_RAISE(builder.Reserve(base_num + extra_oids.size()));
+        for (vid_t offset = 0; offset < base_num; offset++) {
+          internal_oid_t oid;
+          CHECK(base_vm.GetOid(vid_parser.GenerateId(fid, v_label, offset),
+                               oid));
+          ARROW_OK_OR_RAISE(builder.Append(oid));
+        }
+        for (auto& oid : extra_oids) {
+          ARROW_OK_OR_RAISE(builder.Append(oid));
+        }
+        ARROW_OK_OR_RAISE(builder.Finish(&oid_lists[v_label][fid]));
+      }
+    }
+    vineyard::BasicArrowVertexMapBuilder<internal_oid_t, vid_t> vm_builder(
+        seal_client_, fnum, v_label_num, oid_lists);
+    auto vm = vm_builder.Seal(seal_client_);
+    auto vm_ptr = std::dynamic_pointer_cast<vertex_map_t>(
+        seal_client_.GetObject(vm->id()));
+
+    std::vector<std::shared_ptr<arrow::Table>> v_tables(v_label_num);
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      BOOST_LEAF_ASSIGN(v_tables[v_label],
+                        concatTables(frag.vertex_tables_[v_label],
+                                     snapshot_.vertex_tables[v_label]));
+    }
+
+    std::vector<std::shared_ptr<arrow::Table>> e_tables(e_label_num);
+    for (label_id_t e_label = 0; e_label < e_label_num; e_label++) {
+      std::vector<vid_t> src, dst;
+      collectBaseEdges(frag, e_label, src, dst);
+      auto& extra_src = snapshot_.edge_src[e_label];
+      auto& extra_dst = snapshot_.edge_dst[e_label];
+      src.insert(src.end(), extra_src.begin(), extra_src.end());
+      dst.insert(dst.end(), extra_dst.begin(), extra_dst.end());
+
+      std::shared_ptr<arrow::Table> prop_table;
+      BOOST_LEAF_ASSIGN(prop_table,
+                        concatTables(frag.edge_tables_[e_label],
+                                     snapshot_.edge_tables[e_label]));
+      BOOST_LEAF_ASSIGN(e_tables[e_label],
+                        withEndpoints(src, dst, prop_table->schema(),
+                                      prop_table->columns()));
+    }
+
+    BasicAppendOnlyArrowFragmentBuilder<oid_t, vid_t> frag_builder(
+        seal_client_, vm_ptr);
+    BOOST_LEAF_CHECK(frag_builder.Init(frag.fid_, fnum, std::move(v_tables),
+                                       std::move(e_tables), frag.directed_));
+    return frag_builder.Seal(seal_client_)->id();
+  }
+
+  bl::result<void> replayVertices(const fragment_t& prev, fragment_t& frag) {
+    fid_t fid = frag.fid_;
+    auto& prev_vm = *prev.extra_vm_ptr_;
+    auto& extra_vm = *frag.extra_vm_ptr_;
+
+    for (label_id_t v_label = 0; v_label < frag.vertex_label_num_;
+         v_label++) {
+      auto& oids = prev_vm.GetOids(fid, v_label);
+      size_t begin = snapshot_.oids[fid][v_label].size();
+
+      if (oids.size() > begin) {
+        auto& prev_table = prev.extra_vertex_tables_[v_label];
+        std::shared_ptr<arrow::Table> table;
+        BOOST_LEAF_ASSIGN(table, prev_table->Slice(begin, oids.size()));
+
+        for (size_t i = begin; i < oids.size(); i++) {
+          vid_t prev_gid, gid;
+          CHECK(prev_vm.GetGid(fid, oids[i], prev_gid));
+          CHECK(extra_vm.AddVertex(fid, v_label, oids[i], gid));
+          CHECK_EQ(gid, prev_gid);
+          frag.curr_ivnums_[v_label]++;
+        }
+        BOOST_LEAF_CHECK(frag.extra_vertex_tables_[v_label]->AppendRows(table));
+      }
+      for (label_id_t e_label = 0; e_label < frag.edge_label_num_; e_label++) {
+        frag.extra_oe_indices_[v_label][e_label].resize(
+            frag.curr_ivnums_[v_label], -1);
+      }
+      frag.curr_tvnums_[v_label] =
+          frag.curr_ivnums_[v_label] + frag.curr_ovnums_[v_label];
+
+      for (fid_t remote = 0; remote < frag.fnum_; remote++) {
+        if (remote != fid) {
+          extra_vm.SetVertexNum(remote, v_label,
+                                prev_vm.GetVertexNum(remote, v_label) -
+                                    snapshot_.oids[remote][v_label].size());
+        }
+      }
+    }
+    extra_vm.InheritRemoteVertices(prev_vm);
+    return {};
+  }
+
+  bl::result<void> replayEdges(const fragment_t& prev, fragment_t& frag,
+                               ArrowFragmentAppender<oid_t, vid_t>& appender) {
+    label_id_t e_label_num = frag.edge_label_num_;
+    std::vector<std::shared_ptr<arrow::Table>> e_tables(e_label_num);
+    bool replayed = false;
+
+    for (label_id_t e_label = 0; e_label < e_label_num; e_label++) {
+      eid_t begin = snapshot_.edge_nums[e_label];
+      eid_t end = prev.extra_oe_nums_[e_label];
+      std::vector<vid_t> src, dst;
+      std::shared_ptr<arrow::Schema> schema;
+      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+
+      if (end > begin) {
+        std::shared_ptr<arrow::Table> table;
+        collectExtraEdges(prev, e_label, begin, src, dst);
+        BOOST_LEAF_ASSIGN(
+            table, prev.extra_edge_tables_[e_label]->Slice(begin, end));
+        schema = table->schema();
+        columns = table->columns();
+        replayed = true;
+      } else {
+        // single chunked empty columns, as required by AddLocalEdges
+        schema = frag.edge_tables_[e_label]->schema();
+        for (auto& field : schema->fields()) {
+          std::unique_ptr<arrow::ArrayBuilder> builder;
+          std::shared_ptr<arrow::Array> array;
+          ARROW_OK_OR_RAISE(arrow::MakeBuilder(arrow::default_memory_pool(),
+                                               field->type(), &builder));
+          ARROW_OK_OR_RAISE(builder->Finish(&array));
+          columns.push_back(std::make_shared<arrow::ChunkedArray>(
+              std::vector<std::shared_ptr<arrow::Array>>{array}));
+        }
+      }
+      BOOST_LEAF_ASSIGN(e_tables[e_label],
+                        withEndpoints(src, dst, schema, columns));
+    }
+    if (replayed) {
+      BOOST_LEAF_CHECK(appender.AddLocalEdges(e_tables, frag.directed_));
+    }
+    return {};
+  }
+
+  // The endpoints of the base edges, indexed by eids.
+  void collectBaseEdges(const fragment_t& frag, label_id_t e_label,
+                        std::vector<vid_t>& src, std::vector<vid_t>& dst) {
+    auto& vid_parser = frag.vid_parser_;
+    size_t edge_num = frag.edge_tables_[e_label]->num_rows();
+    auto lid2gid = [&](vid_t lid) -> vid_t {
+      auto v_label = vid_parser.GetLabelId(lid);
+      auto offset = vid_parser.GetOffset(lid);
+      if (offset < static_cast<int64_t>(frag.ivnums_[v_label])) {
+        return vid_parser.GenerateId(frag.fid_, v_label, offset);
+      }
+      return frag.ovgid_lists_[v_label]->Value(vid_parser.offset_mask() -
+                                               offset);
+    };
+
+    src.resize(edge_num);
+    dst.resize(edge_num);
+    for (label_id_t v_label = 0; v_label < frag.vertex_label_num_; v_label++) {
+      const int64_t* oe_offsets = frag.oe_offsets_ptr_lists_[v_label][e_label];
+      const nbr_unit_t* oe = frag.oe_ptr_lists_[v_label][e_label];
+      const int64_t* ie_offsets = frag.ie_offsets_ptr_lists_[v_label][e_label];
+      const nbr_unit_t* ie = frag.ie_ptr_lists_[v_label][e_label];
+
+      for (vid_t offset = 0; offset < frag.ivnums_[v_label]; offset++) {
+        vid_t gid = vid_parser.GenerateId(frag.fid_, v_label, offset);
+        for (int64_t i = oe_offsets[offset]; i < oe_offsets[offset + 1]; i++) {
+          src[oe[i].eid] = gid;
+          dst[oe[i].eid] = lid2gid(oe[i].vid);
+        }
+        if (frag.directed_) {
+          for (int64_t i = ie_offsets[offset]; i < ie_offsets[offset + 1];
+               i++) {
+            src[ie[i].eid] = lid2gid(ie[i].vid);
+            dst[ie[i].eid] = gid;
+          }
+        }
+      }
+    }
+  }
+
+  // The endpoints of the appended edges with eids in [begin, extra_oe_num).
+  void collectExtraEdges(const fragment_t& frag, label_id_t e_label,
+                         eid_t begin, std::vector<vid_t>& src,
+                         std::vector<vid_t>& dst) {
+    auto& vid_parser = frag.vid_parser_;
+    auto& edge_space = frag.extra_edge_space_array_[e_label];
+    auto lid2gid = [&](vid_t lid) -> vid_t {
+      auto v_label = vid_parser.GetLabelId(lid);
+      auto offset = vid_parser.GetOffset(lid);
+      if (offset < static_cast<int64_t>(frag.curr_ivnums_[v_label])) {
+        return vid_parser.GenerateId(frag.fid_, v_label, offset);
+      }
+      vid_t idx = vid_parser.offset_mask() - offset;
+      if (idx < frag.ovnums_[v_label]) {
+        return frag.ovgid_lists_[v_label]->Value(idx);
+      }
+      return frag.extra_ovgid_lists_[v_label][idx - frag.ovnums_[v_label]];
+    };
+
+    src.resize(frag.extra_oe_nums_[e_label] - begin);
+    dst.resize(frag.extra_oe_nums_[e_label] - begin);
+    for (label_id_t v_label = 0; v_label < frag.vertex_label_num_; v_label++) {
+      auto& oe_index = frag.extra_oe_indices_[v_label][e_label];
+      for (size_t offset = 0; offset < oe_index.size(); offset++) {
+        int64_t loc = oe_index[offset];
+        if (loc < 0) {
+          continue;
+        }
+        vid_t gid = vid_parser.GenerateId(frag.fid_, v_label, offset);
+        auto visit = [&](const nbr_unit_t* ptr, const nbr_unit_t* end) {
+          for (; ptr != end; ++ptr) {
+            if (ptr->eid >= begin) {
+              // an undirected edge may be visited twice, in either direction
+              src[ptr->eid - begin] = gid;
+              dst[ptr->eid - begin] = lid2gid(ptr->vid);
+            }
+          }
+        };
+        visit(edge_space.run_begin(loc), edge_space.run_end(loc));
+        visit(edge_space.tail_begin(loc), edge_space.tail_end(loc));
+      }
+    }
+  }
+
+  // Append the rows of extra to base, with the schema of base.
+  bl::result<std::shared_ptr<arrow::Table>> concatTables(
+      const std::shared_ptr<arrow::Table>& base,
+      const std::shared_ptr<arrow::Table>& extra) {
+    if (extra == nullptr || extra->num_rows() == 0) {
+      return base;
+    }
+    auto schema = base->schema();
+    if (extra->num_columns() != base->num_columns()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                      "Appended columns mismatch: " + schema->ToString() +
+                          " vs " + extra->schema()->ToString());
+    }
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int i = 0; i < base->num_columns(); i++) {
+      if (!extra->column(i)->type()->Equals(schema->field(i)->type())) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                        "Appended column type mismatch: " +
+                            schema->field(i)->ToString() + " vs " +
+                            extra->schema()->field(i)->ToString());
+      }
+      auto chunks = base->column(i)->chunks();
+      auto& extra_chunks = extra->column(i)->chunks();
+      chunks.insert(chunks.end(), extra_chunks.begin(), extra_chunks.end());
+      columns.push_back(std::make_shared<arrow::ChunkedArray>(
+          chunks, schema->field(i)->type()));
+    }
+    return arrow::Table::Make(schema, columns);
+  }
+
+  // | src gid | dst gid | prop_0 | prop_1 | ... |
+  bl::result<std::shared_ptr<arrow::Table>> withEndpoints(
+      const std::vector<vid_t>& src, const std::vector<vid_t>& dst,
+      const std::shared_ptr<arrow::Schema>& prop_schema,
+      const std::vector<std::shared_ptr<arrow::ChunkedArray>>& props) {
+    std::vector<std::shared_ptr<arrow::Field>> fields = {
+        arrow::field("src", vineyard::ConvertToArrowType<vid_t>::TypeValue()),
+        arrow::field("dst", vineyard::ConvertToArrowType<vid_t>::TypeValue())};
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+
+    for (auto* gids : {&src, &dst}) {
+      vid_builder_t builder;
+      std::shared_ptr<arrow::Array> array;
+      ARROW_OK_OR_RAISE(builder.AppendValues(*gids));
+      ARROW_OK_OR_RAISE(builder.Finish(&array));
+      columns.push_back(std::make_shared<arrow::ChunkedArray>(
+          std::vector<std::shared_ptr<arrow::Array>>{array}));
+    }
+    for (int i = 0; i < prop_schema->num_fields(); i++) {
+      fields.push_back(prop_schema->field(i));
+      columns.push_back(props[i]);
+    }
+    return arrow::Table::Make(arrow::schema(fields), columns);
+  }
+
+  vineyard::Client& client_;
+  // only used by the background thread
+  vineyard::Client seal_client_;
+  grape::CommSpec comm_spec_;
+  std::shared_ptr<fragment_t> current_;
+  // the superseded versions, deleted once readers are done with them
+  std::vector<std::shared_ptr<fragment_t>> retired_;
+
+  Snapshot snapshot_;
+  std::future<vineyard::ObjectID> future_;
+  std::string error_msg_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_LOADER_APPEND_ONLY_ARROW_FRAGMENT_COMPACTOR_H_
@@ -17,6 +17,7 @@
 #define ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_APPENDER_H_
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,90 +33,22 @@
 #include "vineyard/graph/loader/basic_arrow_fragment_loader.h"
 #include "vineyard/graph/utils/table_shuffler.h"
 
+#include "grape/communication/sync_comm.h"
+
 #include "core/fragment/append_only_arrow_fragment.h"
+#include "core/utils/mpi_utils.h"
 
 namespace gs {
 
-/**
- * @brief BroadcastOIDs is a utility to broadcast oids
- * @tparam OID_T
- */
-template <typename OID_T>
-typename std::enable_if<!std::is_same<OID_T, std::string>::value,
-                        std::vector<std::vector<OID_T>>>::type
-bcast_oids(std::vector<std::shared_ptr<arrow::Table>>& v_tables,
-           vineyard::property_graph_types::LABEL_ID_TYPE vertex_label_num,
-           grape::CommSpec& comm_spec) {
-  using oid_t = OID_T;
-  using oid_array_t = typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
-
-  std::vector<std::vector<oid_t>> oids_list;
-
-  for (auto v_label_id = 0; v_label_id < vertex_label_num; v_label_id++) {
-    if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-      auto& v_table = v_tables[v_label_id];
-
-      CHECK_EQ(v_table->field(0)->type(), arrow::int64());
-      CHECK_EQ(v_table->column(0)->num_chunks(), 1);
-      auto array =
-          std::dynamic_pointer_cast<oid_array_t>(v_table->column(0)->chunk(0));
-
-      std::vector<oid_t> oids(array->raw_values(),
-                              array->raw_values() + array->length());
-
-      grape::BcastSend(oids, comm_spec.comm());
-      oids_list.push_back(oids);
-    } else {
-      std::vector<oid_t> oids;
-      grape::BcastRecv(oids, comm_spec.comm(), grape::kCoordinatorRank);
-      oids_list.push_back(oids);
-    }
-  }
-  return oids_list;
-}
-
-/**
- * @brief This is a specialized BroadcastOIDs for string type
- */
-template <typename OID_T>
-typename std::enable_if<std::is_same<OID_T, std::string>::value,
-                        std::vector<std::vector<OID_T>>>::type
-bcast_oids(std::vector<std::shared_ptr<arrow::Table>>& v_tables,
-           vineyard::property_graph_types::LABEL_ID_TYPE vertex_label_num,
-           grape::CommSpec& comm_spec) {
-  using oid_t = std::string;
-  using oid_array_t = typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
-
-  std::vector<std::vector<oid_t>> oids_list;
-
-  for (auto v_label_id = 0; v_label_id < vertex_label_num; v_label_id++) {
-    if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-      auto& v_table = v_tables[v_label_id];
-
-      CHECK_EQ(v_table->field(0)->type(), arrow::large_utf8());
-      CHECK_EQ(v_table->column(0)->num_chunks(), 1);
-      auto array =
-          std::dynamic_pointer_cast<oid_array_t>(v_table->column(0)->chunk(0));
-      std::vector<oid_t> oids(array->length());
-
-      for (int64_t i = 0; i < array->length(); i++) {
-        oids[i] = array->GetString(i);
-      }
-
-      grape::BcastSend(oids, comm_spec.comm());
-      oids_list.push_back(oids);
-    } else {
-      std::vector<oid_t> oids;
-      grape::BcastRecv(oids, comm_spec.comm(), grape::kCoordinatorRank);
-      oids_list.push_back(oids);
-    }
-  }
-  return oids_list;
-}
-
 /**
  * @brief ArrowFragmentAppender is a utility to modify AppendOnlyArrowFragment
  * in append fashion.
+ *
+ * Every worker accepts a slice of the appended vertices and edges. The
+ * vertices are shuffled to their owners, which assign the gids of the new
+ * ones. The gids of remote oids in the edges, and the oids of remote outer
+ * vertices, are resolved from the owners by all-to-all exchanges.
+ *
  * @tparam OID_T
  * @tparam VID_T
  */
@@ -145,7 +78,8 @@ class ArrowFragmentAppender {
   }
 
   /**
-   * Only should be invoked on Coordinator process
+   * Should be invoked on all workers together, each worker provides its own
+   * slice of messages, which is either empty or indexed by labels.
    *
    * @param vertex_messages
    * @param edge_messages
@@ -157,45 +91,40 @@ class ArrowFragmentAppender {
       char delimiter, bool directed) {
     std::vector<std::shared_ptr<arrow::Table>> v_tables(vertex_label_num_);
 
-    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
-      CHECK_EQ(vertex_messages.size(), fragment_->vertex_label_num());
-      CHECK_EQ(edge_messages.size(), fragment_->edge_label_num());
-    } else {
-      CHECK_EQ(vertex_messages.size(), 0);
-      CHECK_EQ(edge_messages.size(), 0);
-    }
+    CHECK(vertex_messages.empty() ||
+          vertex_messages.size() ==
+              static_cast<size_t>(fragment_->vertex_label_num()));
+    CHECK(edge_messages.empty() ||
+          edge_messages.size() ==
+              static_cast<size_t>(fragment_->edge_label_num()));
 
     // parse vertex message and convert it into arrow::table
     for (auto v_label = 0; v_label < vertex_label_num_; v_label++) {
       auto existed_schema = fragment_->vertex_data_table(v_label)->schema();
+      bool has_msgs = !vertex_messages.empty() &&
+                      !(vertex_messages[v_label].empty() ||
+                        (header_row && vertex_messages[v_label].size() == 1));
 
-      if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      if (has_msgs) {
         auto& msgs = vertex_messages[v_label];
+        BOOST_LEAF_AUTO(tmp_v_table, ReadTable(msgs, header_row, delimiter));
 
-        if (msgs.empty() || (header_row && msgs.size() == 1)) {
-          VY_OK_OR_RAISE(vineyard::EmptyTableBuilder::Build(existed_schema,
-                                                            v_tables[v_label]));
-        } else {
-          BOOST_LEAF_AUTO(tmp_v_table, ReadTable(msgs, header_row, delimiter));
+        if (header_row) {
+          std::shared_ptr<arrow::Schema> schema_without_id;
 
-          if (header_row) {
-            std::shared_ptr<arrow::Schema> schema_without_id;
-
-            // make sure later append schema is the same with the existed one
+          // make sure later append schema is the same with the existed one
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-            ARROW_OK_OR_RAISE(tmp_v_table->schema()->RemoveField(
-                id_column, &schema_without_id));
+          ARROW_OK_OR_RAISE(tmp_v_table->schema()->RemoveField(
+              id_column, &schema_without_id));
 #else
-            ARROW_OK_ASSIGN_OR_RAISE(
-                schema_without_id,
-                tmp_v_table->schema()->RemoveField(id_column));
+          ARROW_OK_ASSIGN_OR_RAISE(
+              schema_without_id, tmp_v_table->schema()->RemoveField(id_column));
 #endif
-            CHECK(schema_without_id->Equals(existed_schema, false));
-          }
-          v_tables[v_label] = tmp_v_table;
+          CHECK(schema_without_id->Equals(existed_schema, false));
         }
+        v_tables[v_label] = tmp_v_table;
       } else {
-        // build an empty table on other workers
+        // build an empty table with the id column
         std::shared_ptr<arrow::Schema> schema_with_id;
         auto id_field = std::make_shared<arrow::Field>(
             "id", vineyard::ConvertToArrowType<oid_t>::TypeValue());
@@ -214,6 +143,20 @@ class ArrowFragmentAppender {
 
     BOOST_LEAF_CHECK(updateVertices(v_tables));
 
+    // tables with oids of the parsed edge messages, null if there is none
+    std::vector<std::shared_ptr<arrow::Table>> oid_e_tables(edge_label_num_);
+    for (auto e_label = 0; e_label < edge_label_num_; e_label++) {
+      if (!edge_messages.empty()) {
+        auto& msgs = edge_messages[e_label];
+        if (!msgs.empty() && !(header_row && msgs.size() == 1)) {
+          BOOST_LEAF_ASSIGN(oid_e_tables[e_label],
+                            ReadTable(msgs, header_row, delimiter));
+        }
+      }
+    }
+    // the gids of oids in remote fragments are assigned by the owners
+    resolveRemoteGids(oid_e_tables);
+
     std::vector<std::shared_ptr<arrow::Table>> e_tables(edge_label_num_);
 
     auto src_gid_field = std::make_shared<arrow::Field>(
@@ -224,42 +167,33 @@ class ArrowFragmentAppender {
     for (auto e_label = 0; e_label < edge_label_num_; e_label++) {
       auto existed_schema = fragment_->edge_data_table(e_label)->schema();
 
-      if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
-        auto& msgs = edge_messages[e_label];
-
-        if (msgs.empty() || (header_row && msgs.size() == 1)) {
-          VY_OK_OR_RAISE(vineyard::EmptyTableBuilder::Build(existed_schema,
-                                                            e_tables[e_label]));
-        } else {
-          auto meta = std::make_shared<arrow::KeyValueMetadata>();
-          BOOST_LEAF_AUTO(tmp_table, ReadTable(msgs, header_row, delimiter));
-          BOOST_LEAF_AUTO(src_gid_array,
-                          parseOidChunkedArray(tmp_table->column(src_column)));
-          BOOST_LEAF_AUTO(dst_gid_array,
-                          parseOidChunkedArray(tmp_table->column(dst_column)));
+      if (oid_e_tables[e_label] != nullptr) {
+        auto tmp_table = oid_e_tables[e_label];
+        BOOST_LEAF_AUTO(src_gid_array,
+                        parseOidChunkedArray(tmp_table->column(src_column)));
+        BOOST_LEAF_AUTO(dst_gid_array,
+                        parseOidChunkedArray(tmp_table->column(dst_column)));
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-          ARROW_OK_OR_RAISE(tmp_table->SetColumn(src_column, src_gid_field,
-                                                 src_gid_array, &tmp_table));
-          ARROW_OK_OR_RAISE(tmp_table->SetColumn(dst_column, dst_gid_field,
-                                                 dst_gid_array, &tmp_table));
+        ARROW_OK_OR_RAISE(tmp_table->SetColumn(src_column, src_gid_field,
+                                               src_gid_array, &tmp_table));
+        ARROW_OK_OR_RAISE(tmp_table->SetColumn(dst_column, dst_gid_field,
+                                               dst_gid_array, &tmp_table));
 #else
-          ARROW_OK_ASSIGN_OR_RAISE(
-              tmp_table,
-              tmp_table->SetColumn(src_column, src_gid_field, src_gid_array));
-          ARROW_OK_ASSIGN_OR_RAISE(
-              tmp_table,
-              tmp_table->SetColumn(dst_column, dst_gid_field, dst_gid_array));
+        ARROW_OK_ASSIGN_OR_RAISE(
+            tmp_table,
+            tmp_table->SetColumn(src_column, src_gid_field, src_gid_array));
+        ARROW_OK_ASSIGN_OR_RAISE(
+            tmp_table,
+            tmp_table->SetColumn(dst_column, dst_gid_field, dst_gid_array));
 #endif
 
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-          ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(3, &tmp_table));
-          ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(2, &e_tables[e_label]));
+        ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(3, &tmp_table));
+        ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(2, &e_tables[e_label]));
 #else
-          ARROW_OK_ASSIGN_OR_RAISE(tmp_table, tmp_table->RemoveColumn(3));
-          ARROW_OK_ASSIGN_OR_RAISE(e_tables[e_label],
-                                   tmp_table->RemoveColumn(2));
+        ARROW_OK_ASSIGN_OR_RAISE(tmp_table, tmp_table->RemoveColumn(3));
+        ARROW_OK_ASSIGN_OR_RAISE(e_tables[e_label], tmp_table->RemoveColumn(2));
 #endif
-        }
       } else {
         VY_OK_OR_RAISE(vineyard::EmptyTableBuilder::Build(existed_schema,
                                                           e_tables[e_label]));
@@ -269,6 +203,30 @@ class ArrowFragmentAppender {
     return updateEdges(e_tables, directed);
   }
 
+  /**
+   * @brief Append to another version of the fragment from now on, e.g., the
+   * one produced by AppendOnlyArrowFragmentCompactor. The gids must be the
+   * same in both versions.
+   */
+  void SwitchFragment(
+      std::shared_ptr<AppendOnlyArrowFragment<OID_T, VID_T>> fragment) {
+    CHECK_EQ(fragment->fid(), fragment_->fid());
+    fragment_ = fragment;
+    vm_ptr_ = fragment->GetVertexMap();
+    extra_vm_ptr_ = fragment->GetExtraVertexMap();
+  }
+
+  /**
+   * @brief Add edges that are already local to this fragment, the first two
+   * columns of the tables are the gids of the endpoints. Unlike
+   * ExtendFragment, it is invoked by a single worker.
+   */
+  bl::result<uint64_t> AddLocalEdges(
+      const std::vector<std::shared_ptr<arrow::Table>>& edge_tables,
+      bool directed) {
+    return addExtraEdges(edge_tables, directed);
+  }
+
  private:
   bl::result<std::shared_ptr<arrow::Table>> ReadTable(
       std::vector<std::string>& lines, bool header_row, char delimiter) {
@@ -353,54 +311,15 @@ class ArrowFragmentAppender {
 
   bl::result<void> updateVertices(
       std::vector<std::shared_ptr<arrow::Table>>& v_tables) {
-    // every worker got a copy of oids
-    auto oids_list = bcast_oids<oid_t>(v_tables, vertex_label_num_, comm_spec_);
-    std::vector<ska::flat_hash_set<oid_t>> appended_oid_list;
     auto vid_parser = fragment_->vid_parser_;
+    fid_t fid = fragment_->fid_;
 
-    appended_oid_list.resize(vertex_label_num_);
-    // maintain vertex map & ivnum
     for (auto v_label = 0; v_label < vertex_label_num_; v_label++) {
-      auto& oids = oids_list[v_label];
-      auto& curr_ivnum = fragment_->curr_ivnums_[v_label];
-
-      for (auto oid : oids) {
-        auto fid = partitioner_.GetPartitionId(oid);
-        vid_t gid;
-
-        if (vm_ptr_->GetGid(fid, 0, oid, gid)) {
-          auto existed_v_label = vid_parser.GetLabelId(gid);
-
-          CHECK_EQ(existed_v_label, v_label);
-        } else if (extra_vm_ptr_->GetGid(fid, oid, gid)) {
-          auto existed_v_label = vid_parser.GetLabelId(gid);
-
-          CHECK_EQ(existed_v_label, v_label);
-        } else {
-          CHECK(extra_vm_ptr_->AddVertex(fid, v_label, oid, gid));
-
-          if (fid == fragment_->fid_) {
-            curr_ivnum++;
-            appended_oid_list[v_label].emplace(oid);
-          }
-        }
-      }
-
-      for (auto e_label = 0; e_label < edge_label_num_; e_label++) {
-        fragment_->extra_oe_indices_[v_label][e_label].resize(
-            fragment_->GetInnerVerticesNum(v_label), -1);
-      }
-      fragment_->curr_tvnums_[v_label] =
-          fragment_->curr_ivnums_[v_label] + fragment_->curr_ovnums_[v_label];
-    }
-
-    // update extra vertex table
-    for (auto v_label_id = 0; v_label_id < vertex_label_num_; v_label_id++) {
-      ska::flat_hash_set<oid_t>& appended_oids = appended_oid_list[v_label_id];
+      // shuffle the vertices to their owners
       std::shared_ptr<arrow::Table> local_v_table;
       std::shared_ptr<arrow::Table> tmp_table;
       VY_OK_OR_RAISE(::vineyard::ShufflePropertyVertexTable<partitioner_t>(
-          comm_spec_, partitioner_, v_tables[v_label_id], tmp_table));
+          comm_spec_, partitioner_, v_tables[v_label], tmp_table));
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
       ARROW_OK_OR_RAISE(
           tmp_table->CombineChunks(arrow::default_memory_pool(), &tmp_table));
@@ -408,8 +327,6 @@ class ArrowFragmentAppender {
       ARROW_OK_ASSIGN_OR_RAISE(
           tmp_table, tmp_table->CombineChunks(arrow::default_memory_pool()));
 #endif
-      auto oid_array = std::dynamic_pointer_cast<oid_array_t>(
-          tmp_table->column(id_column)->chunk(0));
       // remove oid column
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
       ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(id_column, &local_v_table));
@@ -418,18 +335,170 @@ class ArrowFragmentAppender {
                                tmp_table->RemoveColumn(id_column));
 #endif
 
-      for (int64_t row = 0; row < oid_array->length(); row++) {
-        auto oid = oid_array->GetView(row);
-
-        if (appended_oids.find(oid_t(oid)) != appended_oids.end()) {
-          fragment_->extra_vertex_tables_[v_label_id]->AppendValue(
-              local_v_table, row);
+      // maintain vertex map & ivnum, only oids owned by this fragment
+      auto& curr_ivnum = fragment_->curr_ivnums_[v_label];
+      if (tmp_table->num_rows() > 0) {
+        auto oid_array = std::dynamic_pointer_cast<oid_array_t>(
+            tmp_table->column(id_column)->chunk(0));
+        std::vector<int64_t> appended_rows;
+
+        for (int64_t row = 0; row < oid_array->length(); row++) {
+          oid_t oid = oid_t(oid_array->GetView(row));
+          vid_t gid;
+
+          CHECK_EQ(partitioner_.GetPartitionId(oid), fid);
+          if (vm_ptr_->GetGid(fid, 0, oid, gid) ||
+              extra_vm_ptr_->GetGid(fid, oid, gid)) {
+            auto existed_v_label = vid_parser.GetLabelId(gid);
+
+            CHECK_EQ(existed_v_label, v_label);
+          } else if (extra_vm_ptr_->AddVertex(fid, v_label, oid, gid)) {
+            curr_ivnum++;
+            appended_rows.push_back(row);
+          }
         }
+        BOOST_LEAF_CHECK(fragment_->extra_vertex_tables_[v_label]->AppendRows(
+            local_v_table, appended_rows));
+      }
+
+      for (auto e_label = 0; e_label < edge_label_num_; e_label++) {
+        fragment_->extra_oe_indices_[v_label][e_label].resize(
+            fragment_->GetInnerVerticesNum(v_label), -1);
+      }
+      fragment_->curr_tvnums_[v_label] =
+          fragment_->curr_ivnums_[v_label] + fragment_->curr_ovnums_[v_label];
+    }
+
+    // every worker learns the number of vertices appended to the others
+    std::vector<size_t> vertex_nums(vertex_label_num_);
+    for (auto v_label = 0; v_label < vertex_label_num_; v_label++) {
+      vertex_nums[v_label] = extra_vm_ptr_->GetVertexNum(fid, v_label);
+    }
+    std::vector<std::vector<size_t>> all_vertex_nums;
+    vineyard::GlobalAllGatherv(vertex_nums, all_vertex_nums, comm_spec_);
+    for (int worker = 0; worker < comm_spec_.worker_num(); ++worker) {
+      fid_t worker_fid = comm_spec_.WorkerToFrag(worker);
+      for (auto v_label = 0; v_label < vertex_label_num_; v_label++) {
+        extra_vm_ptr_->SetVertexNum(worker_fid, v_label,
+                                    all_vertex_nums[worker][v_label]);
       }
     }
     return {};
   }
 
+  /**
+   * @brief Fetch the gids of the oids in the edge tables, which are appended
+   * to remote fragments and not resolved yet. It must be invoked by all
+   * workers together.
+   */
+  void resolveRemoteGids(
+      const std::vector<std::shared_ptr<arrow::Table>>& oid_e_tables) {
+    int worker_num = comm_spec_.worker_num();
+    std::vector<std::vector<oid_t>> queries(worker_num);
+    ska::flat_hash_set<oid_t> queried;
+
+    auto collect = [&](const std::shared_ptr<arrow::ChunkedArray>& column) {
+      for (int chunk_i = 0; chunk_i < column->num_chunks(); ++chunk_i) {
+        auto oid_array =
+            std::dynamic_pointer_cast<oid_array_t>(column->chunk(chunk_i));
+        for (int64_t i = 0; i < oid_array->length(); ++i) {
+          oid_t oid = oid_t(oid_array->GetView(i));
+          fid_t fid = partitioner_.GetPartitionId(oid);
+          vid_t gid;
+          if (fid == fragment_->fid_ || vm_ptr_->GetGid(fid, 0, oid, gid) ||
+              extra_vm_ptr_->GetGid(fid, oid, gid)) {
+            continue;
+          }
+          if (queried.insert(oid).second) {
+            queries[comm_spec_.FragToWorker(fid)].push_back(oid);
+          }
+        }
+      }
+    };
+    for (auto& table : oid_e_tables) {
+      if (table != nullptr) {
+        collect(table->column(src_column));
+        collect(table->column(dst_column));
+      }
+    }
+
+    auto received = queries;
+    grape::AllToAll(received, comm_spec_.comm());
+    // absent oids are answered with an invalid gid
+    std::vector<std::vector<vid_t>> answers(worker_num);
+    for (int worker = 0; worker < worker_num; ++worker) {
+      for (auto& oid : received[worker]) {
+        vid_t gid;
+        if (!extra_vm_ptr_->GetGid(fragment_->fid_, oid, gid)) {
+          gid = std::numeric_limits<vid_t>::max();
+        }
+        answers[worker].push_back(gid);
+      }
+    }
+    grape::AllToAll(answers, comm_spec_.comm());
+
+    for (int worker = 0; worker < worker_num; ++worker) {
+      for (size_t i = 0; i < queries[worker].size(); ++i) {
+        if (answers[worker][i] != std::numeric_limits<vid_t>::max()) {
+          extra_vm_ptr_->AddRemoteVertex(queries[worker][i],
+                                         answers[worker][i]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Fetch the oids of the remote vertices in the local edge tables
+   * from their owners, which are required by the outer vertices. It must be
+   * invoked by all workers together.
+   */
+  void resolveRemoteOids(
+      const std::vector<std::shared_ptr<arrow::Table>>& edge_tables) {
+    int worker_num = comm_spec_.worker_num();
+    auto& vid_parser = fragment_->vid_parser_;
+    std::vector<std::vector<vid_t>> queries(worker_num);
+    ska::flat_hash_set<vid_t> queried;
+
+    for (auto& e_table : edge_tables) {
+      for (int column : {src_column, dst_column}) {
+        CHECK_LE(e_table->column(column)->num_chunks(), 1);
+        if (e_table->column(column)->num_chunks() == 0) {
+          continue;
+        }
+        auto gids = std::dynamic_pointer_cast<
+            typename vineyard::ConvertToArrowType<vid_t>::ArrayType>(
+            e_table->column(column)->chunk(0));
+        for (int64_t i = 0; i < gids->length(); ++i) {
+          vid_t gid = gids->Value(i);
+          fid_t fid = vid_parser.GetFid(gid);
+          oid_t oid;
+          if (fid != fragment_->fid_ && !fragment_->getOid(gid, oid) &&
+              queried.insert(gid).second) {
+            queries[comm_spec_.FragToWorker(fid)].push_back(gid);
+          }
+        }
+      }
+    }
+
+    auto received = queries;
+    grape::AllToAll(received, comm_spec_.comm());
+    std::vector<std::vector<oid_t>> answers(worker_num);
+    for (int worker = 0; worker < worker_num; ++worker) {
+      for (auto gid : received[worker]) {
+        oid_t oid;
+        CHECK(fragment_->getOid(gid, oid));
+        answers[worker].push_back(oid);
+      }
+    }
+    grape::AllToAll(answers, comm_spec_.comm());
+
+    for (int worker = 0; worker < worker_num; ++worker) {
+      for (size_t i = 0; i < queries[worker].size(); ++i) {
+        extra_vm_ptr_->AddRemoteVertex(answers[worker][i], queries[worker][i]);
+      }
+    }
+  }
+
   bl::result<uint64_t> updateEdges(
       std::vector<std::shared_ptr<arrow::Table>>& e_tables, bool directed) {
     std::vector<std::shared_ptr<arrow::Table>> local_e_table(edge_label_num_);
@@ -448,6 +517,7 @@ class ArrowFragmentAppender {
           tmp_table->CombineChunks(arrow::default_memory_pool()));
 #endif
     }
+    resolveRemoteOids(local_e_table);
 
     return addExtraEdges(local_e_table, directed);
   }
@@ -538,13 +608,14 @@ class ArrowFragmentAppender {
       ARROW_OK_ASSIGN_OR_RAISE(tmp_table, tmp_table->RemoveColumn(src_column));
 #endif
 
+      std::vector<int64_t> appended_rows;
+      auto& eid = fragment_->extra_oe_nums_[e_label];
       for (int64_t row = 0; row < e_table->num_rows(); row++) {
         auto src_gid = src_gids->Value(row), dst_gid = dst_gids->Value(row);
         auto src_v_label = vid_parser.GetLabelId(src_gid),
              dst_v_label = vid_parser.GetLabelId(dst_gid);
         vid_t src_lid, dst_lid;
         oid_t src_oid, dst_oid;
-        auto& eid = fragment_->extra_oe_nums_[e_label];
         uint32_t added_enum = 0;
 
         CHECK(fragment_->getOid(src_gid, src_oid));
@@ -574,13 +645,15 @@ class ArrowFragmentAppender {
               fragment_->addOutgoingEdge(dst_lid, src_lid, e_label, eid);
         }
         if (added_enum > 0) {
-          internal_e_table->AppendValue(tmp_table, row);
+          appended_rows.push_back(row);
           eid++;
-          CHECK_EQ(eid, internal_e_table->size());
           total_added_enum += added_enum;
         }
       }
+      BOOST_LEAF_CHECK(internal_e_table->AppendRows(tmp_table, appended_rows));
+      CHECK_EQ(eid, internal_e_table->size());
     }
+    fragment_->compactExtraEdges();
     return total_added_enum;
   }
 
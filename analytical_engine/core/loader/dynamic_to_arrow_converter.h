@@ -51,7 +51,7 @@ struct VertexArrayBuilder<arrow::Int64Builder> {
     std::shared_ptr<arrow::Array> array;
 
     for (const auto& u : src_frag->InnerVertices()) {
-      auto& data = src_frag->GetData(u);
+      auto data = src_frag->GetData(u);
 
       if (data.count(prop_key) == 0) {
         ARROW_OK_OR_RAISE(builder.AppendNull());
@@ -76,7 +76,7 @@ struct VertexArrayBuilder<arrow::DoubleBuilder> {
     std::shared_ptr<arrow::Array> array;
 
     for (const auto& u : src_frag->InnerVertices()) {
-      auto& data = src_frag->GetData(u);
+      auto data = src_frag->GetData(u);
 
       if (data.count(prop_key) == 0) {
         ARROW_OK_OR_RAISE(builder.AppendNull());
@@ -101,7 +101,7 @@ struct VertexArrayBuilder<arrow::LargeStringBuilder> {
     std::shared_ptr<arrow::Array> array;
 
     for (const auto& u : src_frag->InnerVertices()) {
-      auto& data = src_frag->GetData(u);
+      auto data = src_frag->GetData(u);
 
       if (data.count(prop_key) == 0) {
         ARROW_OK_OR_RAISE(builder.AppendNull());
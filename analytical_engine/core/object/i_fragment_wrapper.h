@@ -58,11 +58,70 @@ class IFragmentWrapper : public GSObject {
       const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
       const std::string& view_type) = 0;
 
+  /**
+   * @brief Release the data derived from the fragment, which are rebuilt on
+   * demand. Invoked when the graph is unloaded, as contexts may still hold
+   * the wrapper.
+   */
+  virtual void ReleaseCaches() {}
+
  protected:
   explicit IFragmentWrapper(std::string id, ObjectType type)
       : GSObject(std::move(id), type) {}
 };
 
+/**
+ * @brief FragmentWrapperAlias is another name of a fragment wrapper, which
+ * shares the fragment with the wrapper. Removing the alias does not release
+ * the wrapper.
+ */
+class FragmentWrapperAlias : public IFragmentWrapper {
+ public:
+  FragmentWrapperAlias(const std::string& id,
+                       std::shared_ptr<IFragmentWrapper> wrapper)
+      : IFragmentWrapper(id),
+        graph_def_(wrapper->graph_def()),
+        wrapper_(std::move(wrapper)) {
+    graph_def_.set_key(id);
+  }
+
+  const rpc::graph::GraphDefPb& graph_def() const override {
+    return graph_def_;
+  }
+
+  std::shared_ptr<void> fragment() const override {
+    return wrapper_->fragment();
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& copy_type) override {
+    return wrapper_->CopyGraph(comm_spec, dst_graph_name, copy_type);
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> ToDirected(
+      const grape::CommSpec& comm_spec,
+      const std::string& dst_graph_name) override {
+    return wrapper_->ToDirected(comm_spec, dst_graph_name);
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> ToUnDirected(
+      const grape::CommSpec& comm_spec,
+      const std::string& dst_graph_name) override {
+    return wrapper_->ToUnDirected(comm_spec, dst_graph_name);
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> CreateGraphView(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& view_type) override {
+    return wrapper_->CreateGraphView(comm_spec, dst_graph_name, view_type);
+  }
+
+ private:
+  rpc::graph::GraphDefPb graph_def_;
+  std::shared_ptr<IFragmentWrapper> wrapper_;
+};
+
 /**
  * @brief This is the base class of labeled fragment wrapper
  */
@@ -18,8 +18,10 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "core/error.h"
 #include "core/object/gs_object.h"
@@ -32,6 +34,7 @@ namespace gs {
 class ObjectManager {
  public:
   bl::result<void> PutObject(std::shared_ptr<GSObject> obj) {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto& id = obj->id();
 
     if (objects.find(id) != objects.end()) {
@@ -47,15 +50,46 @@ class ObjectManager {
   }
 
   bl::result<void> RemoveObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (objects.find(id) == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
     }
     objects.erase(id);
+    sources.erase(id);
+    // projections are released along with the object they are projected
+    // from, and a removed projection is never handed out from the cache
+    for (auto iter = projections.begin(); iter != projections.end();) {
+      if (iter->second.first == id || iter->second.second->id() == id) {
+        iter = projections.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
     return {};
   }
 
+  /**
+   * @brief Cache the projection of object src_id, the projection is kept
+   * until either src_id or the projection itself is removed.
+   *
+   * @param key Identifies the projection, e.g. the labels and properties.
+   */
+  void PutProjection(const std::string& src_id, const std::string& key,
+                     std::shared_ptr<GSObject> obj) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    projections[src_id + "/" + key] = std::make_pair(src_id, std::move(obj));
+  }
+
+  std::shared_ptr<GSObject> GetProjection(const std::string& src_id,
+                                          const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = projections.find(src_id + "/" + key);
+    return iter == projections.end() ? nullptr : iter->second.second;
+  }
+
   bl::result<std::shared_ptr<GSObject>> GetObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (objects.find(id) == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
@@ -65,6 +99,7 @@ class ObjectManager {
 
   template <typename T>
   bl::result<std::shared_ptr<T>> GetObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (objects.find(id) == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
@@ -78,12 +113,44 @@ class ObjectManager {
     return obj;
   }
 
+  /**
+   * @brief Record that object id shares data with src_id, e.g., a projection,
+   * a view or a context of src_id. The record is dropped along with id.
+   */
+  void PutSource(const std::string& id, const std::string& src_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources[id] = src_id;
+  }
+
+  /**
+   * @brief Returns id and the objects it shares data with transitively, i.e.,
+   * up to the root fragment.
+   */
+  std::vector<std::string> ResolveSources(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> ids{id};
+    auto iter = sources.find(id);
+    while (iter != sources.end() && ids.size() <= sources.size()) {
+      ids.push_back(iter->second);
+      iter = sources.find(iter->second);
+    }
+    return ids;
+  }
+
   bool HasObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     return objects.find(id) != objects.end();
   }
 
  private:
+  // commands on the read lane of the dispatcher look up objects concurrently
+  std::mutex mutex_;
   std::map<std::string, std::shared_ptr<GSObject>> objects;
+  // sources[id] is the object id shares data with
+  std::map<std::string, std::string> sources;
+  // projections[src_id/key] is (src_id, projection of src_id)
+  std::map<std::string, std::pair<std::string, std::shared_ptr<GSObject>>>
+      projections;
 };
 }  // namespace gs
 #endif  // ANALYTICAL_ENGINE_CORE_OBJECT_OBJECT_MANAGER_H_
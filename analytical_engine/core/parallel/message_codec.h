@@ -0,0 +1,227 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_MESSAGE_CODEC_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_MESSAGE_CODEC_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arrow/util/compression.h"
+#include "arrow/util/config.h"
+#include "glog/logging.h"
+
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+
+namespace gs {
+
+namespace message_codec_impl {
+
+inline size_t varint_encode(uint64_t value, uint8_t* buf) {
+  size_t len = 0;
+  while (value >= 0x80) {
+    buf[len++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  buf[len++] = static_cast<uint8_t>(value);
+  return len;
+}
+
+inline uint64_t varint_decode(const uint8_t*& ptr) {
+  uint64_t value = 0;
+  int shift = 0;
+  while (*ptr & 0x80) {
+    value |= static_cast<uint64_t>(*ptr++ & 0x7f) << shift;
+    shift += 7;
+  }
+  value |= static_cast<uint64_t>(*ptr++) << shift;
+  return value;
+}
+
+}  // namespace message_codec_impl
+
+/**
+ * @brief DeltaVarintList is a message of sorted ids, e.g., gids of neighbors.
+ * It is serialized as the differences of adjacent ids in varint, thus a list
+ * of close ids takes about one or two bytes per id instead of sizeof(T).
+ *
+ * The values must be sorted in ascending order before being sent.
+ *
+ * @tparam T Unsigned integral type of ids.
+ */
+template <typename T>
+struct DeltaVarintList {
+  static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                "DeltaVarintList only supports unsigned integers");
+
+  DeltaVarintList() = default;
+  explicit DeltaVarintList(std::vector<T>&& ids) : values(std::move(ids)) {}
+
+  void Sort() { std::sort(values.begin(), values.end()); }
+
+  std::vector<T> values;
+};
+
+template <typename T>
+inline grape::InArchive& operator<<(grape::InArchive& arc,
+                                    const DeltaVarintList<T>& list) {
+  assert(std::is_sorted(list.values.begin(), list.values.end()));
+  // at most 10 bytes per varint of 64 bits, the buffer of the thread is
+  // reused by the following messages
+  static thread_local std::vector<uint8_t> buf;
+  buf.resize((list.values.size() + 1) * 10);
+  size_t len =
+      message_codec_impl::varint_encode(list.values.size(), buf.data());
+  T prev = 0;
+  for (auto value : list.values) {
+    len += message_codec_impl::varint_encode(value - prev, buf.data() + len);
+    prev = value;
+  }
+  arc << len;
+  arc.AddBytes(buf.data(), len);
+  return arc;
+}
+
+template <typename T>
+inline grape::OutArchive& operator>>(grape::OutArchive& arc,
+                                     DeltaVarintList<T>& list) {
+  size_t len;
+  arc >> len;
+  auto* ptr = static_cast<const uint8_t*>(arc.GetBytes(len));
+  size_t size = message_codec_impl::varint_decode(ptr);
+  list.values.resize(size);
+  T prev = 0;
+  for (size_t i = 0; i < size; ++i) {
+    prev += static_cast<T>(message_codec_impl::varint_decode(ptr));
+    list.values[i] = prev;
+  }
+  return arc;
+}
+
+/**
+ * @brief BlockCompressor compresses message buffers with a codec of arrow,
+ * e.g., LZ4 or ZSTD. The size of the raw buffer is appended to the
+ * compressed bytes. Each instance must be used by a single thread.
+ */
+class BlockCompressor {
+ public:
+  BlockCompressor() = default;
+
+  /**
+   * @brief Initialize the codec.
+   * @return false if the codec is not available in the arrow library.
+   */
+  bool Init(arrow::Compression::type type) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    auto status = arrow::util::Codec::Create(type, &codec_);
+    if (!status.ok()) {
+      LOG(WARNING) << "Message compression is disabled: " << status.ToString();
+      codec_ = nullptr;
+    }
+#else
+    auto result = arrow::util::Codec::Create(type);
+    if (result.ok()) {
+      codec_ = std::move(result).ValueOrDie();
+    } else {
+      LOG(WARNING) << "Message compression is disabled: "
+                   << result.status().ToString();
+      codec_ = nullptr;
+    }
+#endif
+    return codec_ != nullptr;
+  }
+
+  /**
+   * @brief Compress the buffer into out.
+   * @return false if the buffer can not be compressed to a smaller one, and
+   * the buffer should be sent as is.
+   */
+  bool Compress(const grape::InArchive& in, grape::InArchive& out) {
+    if (codec_ == nullptr) {
+      return false;
+    }
+    int64_t raw_size = static_cast<int64_t>(in.GetSize());
+    auto* input = reinterpret_cast<const uint8_t*>(in.GetBuffer());
+    int64_t max_len = codec_->MaxCompressedLen(raw_size, input);
+    buffer_.resize(max_len);
+    int64_t len = 0;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    if (!codec_->Compress(raw_size, input, max_len, buffer_.data(), &len)
+             .ok()) {
+      return false;
+    }
+#else
+    auto result = codec_->Compress(raw_size, input, max_len, buffer_.data());
+    if (!result.ok()) {
+      return false;
+    }
+    len = result.ValueOrDie();
+#endif
+    if (len + static_cast<int64_t>(sizeof(int64_t)) >= raw_size) {
+      return false;
+    }
+    out.Clear();
+    out.AddBytes(buffer_.data(), len);
+    out << raw_size;
+    return true;
+  }
+
+  /**
+   * @brief Size of the raw buffer of bytes produced by Compress.
+   */
+  static size_t RawSize(const char* data, size_t size) {
+    CHECK_GE(size, sizeof(int64_t));
+    int64_t raw_size;
+    memcpy(&raw_size, data + size - sizeof(int64_t), sizeof(int64_t));
+    return static_cast<size_t>(raw_size);
+  }
+
+  /**
+   * @brief Decompress bytes produced by Compress into output, which holds at
+   * least RawSize(data, size) bytes.
+   */
+  void Decompress(const char* data, size_t size, char* output) {
+    CHECK(codec_ != nullptr);
+    int64_t raw_size = static_cast<int64_t>(RawSize(data, size));
+    int64_t len = static_cast<int64_t>(size - sizeof(int64_t));
+    auto* input = reinterpret_cast<const uint8_t*>(data);
+    auto* out = reinterpret_cast<uint8_t*>(output);
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    int64_t decompressed = 0;
+    CHECK(codec_->Decompress(len, input, raw_size, out, &decompressed).ok());
+#else
+    auto result = codec_->Decompress(len, input, raw_size, out);
+    CHECK(result.ok());
+    int64_t decompressed = result.ValueOrDie();
+#endif
+    CHECK_EQ(decompressed, raw_size);
+  }
+
+ private:
+  std::unique_ptr<arrow::util::Codec> codec_;
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_MESSAGE_CODEC_H_
@@ -20,7 +20,9 @@
 
 #include <array>
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
@@ -30,12 +32,43 @@
 #include "grape/parallel/message_manager_base.h"
 #include "grape/serialization/in_archive.h"
 #include "grape/serialization/out_archive.h"
+#include "grape/util.h"
 #include "grape/utils/concurrent_queue.h"
 #include "grape/worker/comm_spec.h"
 
+#include "core/parallel/message_codec.h"
 #include "core/parallel/thread_local_property_message_buffer.h"
 
 namespace gs {
+
+/**
+ * @brief Communication statistics of a round on a worker, to measure how much
+ * of the communication overlaps with the computation.
+ */
+struct MessageRoundStat {
+  // messages sent in the round, including the messages to self
+  size_t sent_bytes = 0;
+  size_t sent_buffers = 0;
+  // messages processed in the round
+  size_t recv_bytes = 0;
+  size_t recv_buffers = 0;
+  // buffers processed by ProcessEarlyArrivals during the computation
+  size_t early_buffers = 0;
+  // seconds blocked at the synchronization points, i.e., waiting for the
+  // sending of the last round and the termination check
+  double idle_time = 0;
+
+  MessageRoundStat& operator+=(const MessageRoundStat& rhs) {
+    sent_bytes += rhs.sent_bytes;
+    sent_buffers += rhs.sent_buffers;
+    recv_bytes += rhs.recv_bytes;
+    recv_buffers += rhs.recv_buffers;
+    early_buffers += rhs.early_buffers;
+    idle_time += rhs.idle_time;
+    return *this;
+  }
+};
+
 /**
  * @brief A kind of parallel message manager.
  *
@@ -49,10 +82,18 @@ namespace gs {
  * After a round of evaluation, there is a global barrier to determine whether
  * the fixed point is reached.
  *
+ * For apps whose messages can be processed in any order and in any round,
+ * the incoming buffers are also available to ProcessEarlyArrivals as soon as
+ * they are received, see EnableEagerProcessing.
+ *
+ * Buffers sent to other workers may be compressed, see EnableCompression. The
+ * lowest bit of the MPI tag tells whether a buffer is compressed, and the
+ * other bits are the round, wrapped to fit in MPI_TAG_UB.
  */
 class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   static constexpr size_t default_msg_send_block_size = 2 * 1023 * 1024;
   static constexpr size_t default_msg_send_block_capacity = 2 * 1023 * 1024;
+  static constexpr size_t default_compress_threshold = 64 * 1024;
 
  public:
   ParallelPropertyMessageManager() : comm_(NULL_COMM) {}
@@ -79,9 +120,41 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
 
     round_ = 0;
 
+    // the tags of an even number of rounds fit in MPI_TAG_UB, thus the
+    // parity of a wrapped round is the same as the original one
+    int* tag_ub = NULL;
+    int flag = 0;
+    MPI_Comm_get_attr(comm_, MPI_TAG_UB, &tag_ub, &flag);
+    round_tag_num_ = (flag ? (*tag_ub - 1) / 2 + 1 : 16384) & ~1;
+
     sent_size_ = 0;
+    eager_ = false;
+    compress_ = false;
+    resetStat();
   }
 
+  /**
+   * @brief Compress the buffers to other workers which are larger than
+   * threshold. Must be invoked before Start.
+   *
+   * @param type Codec of arrow, e.g., LZ4 or ZSTD.
+   * @param threshold Buffers smaller than it are sent as is.
+   */
+  void EnableCompression(
+      arrow::Compression::type type = arrow::Compression::LZ4,
+      size_t threshold = default_compress_threshold) {
+    compress_ = send_compressor_.Init(type) && recv_compressor_.Init(type);
+    compress_threshold_ = threshold;
+  }
+
+  /**
+   * @brief Deliver the incoming buffers as soon as they are received, which
+   * may be processed by ProcessEarlyArrivals in the computation, or by
+   * ParallelProcess of the current round. Only for apps which are insensitive
+   * to the order and the round of messages.
+   */
+  void EnableEagerProcessing(bool eager) { eager_ = eager; }
+
   /**
    * @brief Inherit
    */
@@ -92,7 +165,9 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    */
   void StartARound() override {
     if (round_ != 0) {
+      double begin = grape::GetCurrentTime();
       waitSend();
+      idle_time_ += grape::GetCurrentTime() - begin;
       auto& rq = recv_queues_[round_ % 2];
       if (!to_self_.empty()) {
         for (auto& iarc : to_self_) {
@@ -113,6 +188,14 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   void FinishARound() override {
     sent_size_ = finishMsgFilling();
     resetRecvQueue();
+    collectStat();
+    VLOG(2) << "[Worker " << comm_spec_.worker_id() << "] round " << round_
+            << ": sent " << last_round_stat_.sent_bytes << " bytes in "
+            << last_round_stat_.sent_buffers << " buffers, processed "
+            << last_round_stat_.recv_bytes << " bytes in "
+            << last_round_stat_.recv_buffers << " buffers ("
+            << last_round_stat_.early_buffers << " early), idle "
+            << last_round_stat_.idle_time << "s";
     round_++;
   }
 
@@ -127,7 +210,9 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     }
     flag[1] = force_terminate_ ? 1 : 0;
     int ret[2];
+    double begin = grape::GetCurrentTime();
     MPI_Allreduce(&flag[0], &ret[0], 2, MPI_INT, MPI_SUM, comm_);
+    idle_time_ += grape::GetCurrentTime() - begin;
     if (ret[1] > 0) {
       terminate_info_.success = false;
       grape::AllToAll(terminate_info_.info, comm_);
@@ -143,6 +228,7 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     waitSend();
     MPI_Barrier(comm_);
     stopRecvThread();
+    early_arrivals_.clear();
 
     MPI_Comm_free(&comm_);
     comm_ = NULL_COMM;
@@ -173,6 +259,11 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    */
   size_t GetMsgSize() const override { return sent_size_; }
 
+  /**
+   * @brief Statistics of the last finished round.
+   */
+  const MessageRoundStat& LastRoundStat() const { return last_round_stat_; }
+
   /**
    * @brief Init a set of channels, each channel is a thread local message
    * buffer.
@@ -202,6 +293,8 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    * @param arc Message buffer.
    */
   inline void SendRawMsgByFid(grape::fid_t fid, grape::InArchive&& arc) {
+    sent_bytes_.fetch_add(arc.GetSize(), std::memory_order_relaxed);
+    sent_buffers_.fetch_add(1, std::memory_order_relaxed);
     std::pair<grape::fid_t, grape::InArchive> item;
     item.first = fid;
     item.second = std::move(arc);
@@ -315,6 +408,16 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
             auto& que = recv_queues_[round_ % 2];
             grape::OutArchive arc;
             while (que.Get(arc)) {
+              countRecv(arc);
+              while (!arc.Empty()) {
+                arc >> id >> msg;
+                frag.Gid2Vertex(id, vertex);
+                func(tid, vertex, msg);
+              }
+            }
+            // all the buffers of the round have been received at this time
+            while (popEarlyArrival(arc)) {
+              countRecv(arc);
               while (!arc.Empty()) {
                 arc >> id >> msg;
                 frag.Gid2Vertex(id, vertex);
@@ -352,6 +455,14 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
             auto& que = recv_queues_[round_ % 2];
             grape::OutArchive arc;
             while (que.Get(arc)) {
+              countRecv(arc);
+              while (!arc.Empty()) {
+                arc >> msg;
+                func(tid, msg);
+              }
+            }
+            while (popEarlyArrival(arc)) {
+              countRecv(arc);
               while (!arc.Empty()) {
                 arc >> msg;
                 func(tid, msg);
@@ -366,7 +477,100 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     }
   }
 
+  /**
+   * @brief Process the buffers received so far without blocking, which is
+   * invoked by the computing threads to overlap the computation and the
+   * communication. Requires EnableEagerProcessing.
+   *
+   * @tparam GRAPH_T Graph type.
+   * @tparam MESSAGE_T Message type.
+   * @tparam FUNC_T Function type.
+   * @param tid Id of the calling thread, passed to func.
+   * @param frag
+   * @param func
+   * @return Number of processed buffers.
+   */
+  template <typename GRAPH_T, typename MESSAGE_T, typename FUNC_T>
+  inline size_t ProcessEarlyArrivals(int tid, const GRAPH_T& frag,
+                                     const FUNC_T& func) {
+    typename GRAPH_T::vid_t id;
+    typename GRAPH_T::vertex_t vertex(0);
+    MESSAGE_T msg;
+    grape::OutArchive arc;
+    size_t processed = 0;
+    while (popEarlyArrival(arc)) {
+      countRecv(arc);
+      while (!arc.Empty()) {
+        arc >> id >> msg;
+        frag.Gid2Vertex(id, vertex);
+        func(tid, vertex, msg);
+      }
+      ++processed;
+    }
+    early_buffers_.fetch_add(processed, std::memory_order_relaxed);
+    return processed;
+  }
+
+  template <typename MESSAGE_T, typename FUNC_T>
+  inline size_t ProcessEarlyArrivals(int tid, const FUNC_T& func) {
+    MESSAGE_T msg;
+    grape::OutArchive arc;
+    size_t processed = 0;
+    while (popEarlyArrival(arc)) {
+      countRecv(arc);
+      while (!arc.Empty()) {
+        arc >> msg;
+        func(tid, msg);
+      }
+      ++processed;
+    }
+    early_buffers_.fetch_add(processed, std::memory_order_relaxed);
+    return processed;
+  }
+
  private:
+  inline bool popEarlyArrival(grape::OutArchive& arc) {
+    if (!eager_) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(early_mutex_);
+    if (early_arrivals_.empty()) {
+      return false;
+    }
+    arc = std::move(early_arrivals_.front());
+    early_arrivals_.pop_front();
+    return true;
+  }
+
+  inline void countRecv(const grape::OutArchive& arc) {
+    recv_bytes_.fetch_add(arc.GetSize(), std::memory_order_relaxed);
+    recv_buffers_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void resetStat() {
+    sent_bytes_ = 0;
+    sent_buffers_ = 0;
+    recv_bytes_ = 0;
+    recv_buffers_ = 0;
+    early_buffers_ = 0;
+    idle_time_ = 0;
+  }
+
+  void collectStat() {
+    last_round_stat_.sent_bytes = sent_bytes_;
+    last_round_stat_.sent_buffers = sent_buffers_;
+    last_round_stat_.recv_bytes = recv_bytes_;
+    last_round_stat_.recv_buffers = recv_buffers_;
+    last_round_stat_.early_buffers = early_buffers_;
+    last_round_stat_.idle_time = idle_time_;
+    resetStat();
+  }
+
+  // The lowest bit is left for the compression flag.
+  inline int roundTag(int msg_round) const {
+    return (msg_round % round_tag_num_) << 1;
+  }
+
   void startSendThread() {
     force_continue_ = false;
     int round = round_;
@@ -377,6 +581,7 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
         [this](int msg_round) {
           std::vector<MPI_Request> reqs;
           std::pair<grape::fid_t, grape::InArchive> item;
+          grape::InArchive compressed;
           while (sending_queue_.Get(item)) {
             if (item.second.GetSize() == 0) {
               continue;
@@ -384,10 +589,16 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
             if (item.first == fid_) {
               to_self_.emplace_back(std::move(item.second));
             } else {
+              int tag = roundTag(msg_round);
+              if (compress_ && item.second.GetSize() >= compress_threshold_ &&
+                  send_compressor_.Compress(item.second, compressed)) {
+                std::swap(item.second, compressed);
+                tag |= 1;
+              }
               MPI_Request req;
               MPI_Isend(item.second.GetBuffer(), item.second.GetSize(),
-                        MPI_CHAR, comm_spec_.FragToWorker(item.first),
-                        msg_round, comm_, &req);
+                        MPI_CHAR, comm_spec_.FragToWorker(item.first), tag,
+                        comm_, &req);
               reqs.push_back(req);
               to_others_.emplace_back(std::move(item.second));
             }
@@ -397,8 +608,8 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
               continue;
             }
             MPI_Request req;
-            MPI_Isend(NULL, 0, MPI_CHAR, comm_spec_.FragToWorker(i), msg_round,
-                      comm_, &req);
+            MPI_Isend(NULL, 0, MPI_CHAR, comm_spec_.FragToWorker(i),
+                      roundTag(msg_round), comm_, &req);
             reqs.push_back(req);
           }
           MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
@@ -417,17 +628,31 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
         return;
       }
       int tag = status.MPI_TAG;
+      int round = tag >> 1;
       int count;
       MPI_Get_count(&status, MPI_CHAR, &count);
       if (count == 0) {
         MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, tag, comm_,
                  MPI_STATUS_IGNORE);
-        recv_queues_[tag % 2].DecProducerNum();
+        recv_queues_[round % 2].DecProducerNum();
       } else {
         grape::OutArchive arc(count);
         MPI_Recv(arc.GetBuffer(), count, MPI_CHAR, status.MPI_SOURCE, tag,
                  comm_, MPI_STATUS_IGNORE);
-        recv_queues_[tag % 2].Put(std::move(arc));
+        if (tag & 1) {
+          grape::OutArchive raw(
+              BlockCompressor::RawSize(arc.GetBuffer(), count));
+          recv_compressor_.Decompress(arc.GetBuffer(), count, raw.GetBuffer());
+          arc = std::move(raw);
+        }
+        if (eager_) {
+          // the buffer arrives before the end of its round, thus it is always
+          // consumed by ParallelProcess of that round at the latest
+          std::lock_guard<std::mutex> lock(early_mutex_);
+          early_arrivals_.emplace_back(std::move(arc));
+        } else {
+          recv_queues_[round % 2].Put(std::move(arc));
+        }
       }
     }
   }
@@ -486,6 +711,23 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   bool force_continue_;
   size_t sent_size_;
 
+  std::atomic<bool> eager_;
+
+  int round_tag_num_;
+
+  bool compress_;
+  size_t compress_threshold_;
+  // used by the send thread and the recv thread respectively
+  BlockCompressor send_compressor_, recv_compressor_;
+
+  std::mutex early_mutex_;
+  std::deque<grape::OutArchive> early_arrivals_;
+
+  std::atomic<size_t> sent_bytes_, sent_buffers_;
+  std::atomic<size_t> recv_bytes_, recv_buffers_, early_buffers_;
+  double idle_time_;
+  MessageRoundStat last_round_stat_;
+
   bool force_terminate_;
   grape::TerminateInfo terminate_info_;
 };
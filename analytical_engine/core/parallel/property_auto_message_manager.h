@@ -19,12 +19,13 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
-#include <map>
 #include <memory>
 #include <typeinfo>
 #include <utility>
 #include <vector>
 
+#include "glog/logging.h"
+
 #include "grape/communication/sync_comm.h"
 #include "grape/fragment/edgecut_fragment_base.h"
 #include "grape/parallel/default_message_manager.h"
@@ -52,6 +53,93 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   using vid_t = typename FRAG_T::vid_t;
   using label_id_t = typename FRAG_T::label_id_t;
 
+  struct ap_event;
+
+  /**
+   * @brief IAutoSyncer syncs the values of a registered buffer in bulk. It is
+   * created once when the buffer is registered, thus the type of the buffer
+   * is not dispatched in every round.
+   */
+  class IAutoSyncer {
+   public:
+    virtual ~IAutoSyncer() = default;
+
+    virtual void Send(PropertyAutoMessageManager& messages,
+                      const ap_event& event) = 0;
+
+    virtual void Recv(PropertyAutoMessageManager& messages,
+                      const ap_event& event) = 0;
+  };
+
+  /**
+   * @brief OuterVertexSyncer sends the updated values on outer vertices to
+   * their owners. The gids and the values to a fragment are gathered into two
+   * contiguous arrays and sent as a single message, the receiver aggregates
+   * them in one loop.
+   */
+  template <typename T>
+  class OuterVertexSyncer : public IAutoSyncer {
+    using buffer_t = grape::SyncBuffer<T, vid_t>;
+
+   public:
+    void Send(PropertyAutoMessageManager& messages,
+              const ap_event& event) override {
+      auto& frag = event.fragment;
+      auto* bptr = static_cast<buffer_t*>(event.buffer);
+      fid_t fnum = frag.fnum();
+      gids_.resize(fnum);
+      values_.resize(fnum);
+
+      for (auto v : frag.InnerVertices(event.label)) {
+        bptr->Reset(v);
+      }
+      for (auto v : frag.OuterVertices(event.label)) {
+        if (bptr->IsUpdated(v)) {
+          fid_t fid = frag.GetFragId(v);
+          gids_[fid].push_back(frag.GetOuterVertexGid(v));
+          values_[fid].push_back(bptr->GetValue(v));
+          bptr->Reset(v);
+        }
+      }
+
+      for (fid_t i = 0; i < fnum; ++i) {
+        if (!gids_[i].empty()) {
+          messages.SendToFragment<int>(i, event.event_id);
+          messages.SendToFragment<std::vector<vid_t>>(i, gids_[i]);
+          messages.SendToFragment<std::vector<T>>(i, values_[i]);
+          gids_[i].clear();
+          values_[i].clear();
+        }
+      }
+    }
+
+    void Recv(PropertyAutoMessageManager& messages,
+              const ap_event& event) override {
+      auto& frag = event.fragment;
+      auto* bptr = static_cast<buffer_t*>(event.buffer);
+      messages.GetMessage<std::vector<vid_t>>(recv_gids_);
+      messages.GetMessage<std::vector<T>>(recv_values_);
+      CHECK_EQ(recv_gids_.size(), recv_values_.size());
+
+      size_t num = recv_gids_.size();
+      recv_vertices_.resize(num);
+      for (size_t i = 0; i < num; ++i) {
+        CHECK(frag.Gid2Vertex(recv_gids_[i], recv_vertices_[i]));
+      }
+      for (size_t i = 0; i < num; ++i) {
+        bptr->Aggregate(recv_vertices_[i], std::move(recv_values_[i]));
+      }
+    }
+
+   private:
+    // buffers are kept across rounds to avoid allocations
+    std::vector<std::vector<vid_t>> gids_;
+    std::vector<std::vector<T>> values_;
+    std::vector<vid_t> recv_gids_;
+    std::vector<T> recv_values_;
+    std::vector<grape::Vertex<vid_t>> recv_vertices_;
+  };
+
   struct ap_event {
     ap_event(const FRAG_T& f, label_id_t l, grape::ISyncBuffer* b,
              grape::MessageStrategy m, int e)
@@ -62,6 +150,8 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
     grape::ISyncBuffer* buffer;
     grape::MessageStrategy message_strategy;
     int event_id;
+    // null if the type of buffer or the message strategy is not supported
+    std::unique_ptr<IAutoSyncer> syncer;
   };
 
  public:
@@ -108,246 +198,58 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
                                  grape::MessageStrategy strategy) {
     int event_id = auto_parallel_events_.size();
     auto_parallel_events_.emplace_back(frag, label, buffer, strategy, event_id);
+    if (strategy == grape::MessageStrategy::kSyncOnOuterVertex) {
+      auto_parallel_events_.back().syncer = createSyncer(buffer->GetTypeId());
+    }
   }
 
  private:
-  void aggregateAutoMessages() {
-    std::map<int, ap_event*> event_map;
-    for (auto& event : auto_parallel_events_) {
-      event_map.emplace(event.event_id, &event);
-    }
-
-    int event_id;
-    while (Base::GetMessage<int>(event_id)) {
-      ap_event* event = event_map.at(event_id);
-
-      auto& i_ec_frag = event->fragment;
-      if (event->message_strategy ==
-              grape::MessageStrategy::kSyncOnOuterVertex ||
-          event->message_strategy ==
-              grape::MessageStrategy::kAlongEdgeToOuterVertex ||
-          event->message_strategy ==
-              grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex ||
-          event->message_strategy ==
-              grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex) {
-        if (event->buffer->GetTypeId() == typeid(double)) {
-          syncOnVertexRecv<double>(i_ec_frag, event->buffer);
-        } else if (event->buffer->GetTypeId() == typeid(uint32_t)) {
-          syncOnVertexRecv<uint32_t>(i_ec_frag, event->buffer);
-        } else if (event->buffer->GetTypeId() == typeid(int32_t)) {
-          syncOnVertexRecv<int32_t>(i_ec_frag, event->buffer);
-        } else if (event->buffer->GetTypeId() == typeid(int64_t)) {
-          syncOnVertexRecv<int64_t>(i_ec_frag, event->buffer);
-        } else if (event->buffer->GetTypeId() == typeid(uint64_t)) {
-          syncOnVertexRecv<uint64_t>(i_ec_frag, event->buffer);
-        } else if (event->buffer->GetTypeId() ==
-                   typeid(std::vector<uint32_t>)) {
-          syncOnVertexRecv<std::vector<uint32_t>>(i_ec_frag, event->buffer);
-        } else {
-          LOG(FATAL) << "Unexpected data type "
-                     << event->buffer->GetTypeId().name();
-        }
-      } else {
-        LOG(FATAL) << "Unexpected message stratety "
-                   << underlying_value(event->message_strategy);
-      }
+  static std::unique_ptr<IAutoSyncer> createSyncer(const std::type_info& type) {
+    if (type == typeid(double)) {
+      return std::unique_ptr<IAutoSyncer>(new OuterVertexSyncer<double>());
+    } else if (type == typeid(uint32_t)) {
+      return std::unique_ptr<IAutoSyncer>(new OuterVertexSyncer<uint32_t>());
+    } else if (type == typeid(int32_t)) {
+      return std::unique_ptr<IAutoSyncer>(new OuterVertexSyncer<int32_t>());
+    } else if (type == typeid(int64_t)) {
+      return std::unique_ptr<IAutoSyncer>(new OuterVertexSyncer<int64_t>());
+    } else if (type == typeid(uint64_t)) {
+      return std::unique_ptr<IAutoSyncer>(new OuterVertexSyncer<uint64_t>());
     }
+    return nullptr;
   }
 
-  void generateAutoMessages() {
-    for (auto& event_ref : auto_parallel_events_) {
-      ap_event* event = &event_ref;
-      auto& i_ec_frag = event->fragment;
-      auto inner_size = i_ec_frag.InnerVertices(event->label).size();
-      if (event->buffer->updated(0, inner_size)) {
-        ForceContinue();
-        break;
-      }
+  IAutoSyncer* getSyncer(const ap_event& event) {
+    if (event.message_strategy != grape::MessageStrategy::kSyncOnOuterVertex) {
+      LOG(FATAL) << "Unexpected message stratety "
+                 << underlying_value(event.message_strategy);
     }
-
-    for (auto& event_ref : auto_parallel_events_) {
-      ap_event* event = &event_ref;
-
-      auto& i_ec_frag = event->fragment;
-      if (event->message_strategy ==
-          grape::MessageStrategy::kSyncOnOuterVertex) {
-        if (event->buffer->GetTypeId() == typeid(double)) {
-          syncOnOuterVertexSend<double>(i_ec_frag, event->label, event->buffer,
-                                        event->event_id);
-        } else if (event->buffer->GetTypeId() == typeid(uint32_t)) {
-          syncOnOuterVertexSend<uint32_t>(i_ec_frag, event->label,
-                                          event->buffer, event->event_id);
-        } else if (event->buffer->GetTypeId() == typeid(int32_t)) {
-          syncOnOuterVertexSend<int32_t>(i_ec_frag, event->label, event->buffer,
-                                         event->event_id);
-        } else if (event->buffer->GetTypeId() == typeid(int64_t)) {
-          syncOnOuterVertexSend<int64_t>(i_ec_frag, event->label, event->buffer,
-                                         event->event_id);
-        } else if (event->buffer->GetTypeId() == typeid(uint64_t)) {
-          syncOnOuterVertexSend<uint64_t>(i_ec_frag, event->label,
-                                          event->buffer, event->event_id);
-        } else {
-          LOG(FATAL) << "Unexpected data type for auto parallelization: "
-                     << event->buffer->GetTypeId().name();
-        }
-        /*
-      } else if (event->message_strategy ==
-                     grape::MessageStrategy::kAlongEdgeToOuterVertex ||
-                 event->message_strategy ==
-                     grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex ||
-                 event->message_strategy ==
-                     grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex) {
-        if (event->buffer->GetTypeId() == typeid(double)) {
-          syncOnInnerVertexSend<double>(i_ec_frag, event->label, event->buffer,
-                                        event->event_id,
-                                        event->message_strategy);
-        } else if (event->buffer->GetTypeId() == typeid(uint32_t)) {
-          syncOnInnerVertexSend<uint32_t>(i_ec_frag, event->label,
-      event->buffer, event->event_id, event->message_strategy); } else if
-      (event->buffer->GetTypeId() == typeid(int32_t)) {
-          syncOnInnerVertexSend<int32_t>(i_ec_frag, event->label, event->buffer,
-                                         event->event_id,
-                                         event->message_strategy);
-        } else if (event->buffer->GetTypeId() == typeid(int64_t)) {
-          syncOnInnerVertexSend<int64_t>(i_ec_frag, event->label, event->buffer,
-                                         event->event_id,
-                                         event->message_strategy);
-        } else if (event->buffer->GetTypeId() ==
-                   typeid(std::vector<uint32_t>)) {
-          syncOnInnerVertexSend<std::vector<uint32_t>>(i_ec_frag, event->label,
-      event->buffer, event->event_id, event->message_strategy); } else {
-          LOG(FATAL) << "Unexpected data type for auto parallelization: "
-                     << event->buffer->GetTypeId().name();
-        }
-        */
-      } else {
-        LOG(FATAL) << "Unexpected message stratety "
-                   << underlying_value(event->message_strategy);
-      }
+    if (event.syncer == nullptr) {
+      LOG(FATAL) << "Unexpected data type for auto parallelization: "
+                 << event.buffer->GetTypeId().name();
     }
+    return event.syncer.get();
   }
 
-  /*
-  template <typename T>
-  inline void syncOnInnerVertexSend(const FRAG_T& frag, label_id_t label,
-  grape::ISyncBuffer* buffer, int event_id, grape::MessageStrategy
-  message_strategy) { auto* bptr = dynamic_cast<grape::SyncBuffer<T,
-  vid_t>*>(buffer); auto inner_vertices = frag.InnerVertices(label);
-  std::vector<size_t> message_num(Base::fnum(), 0);
-
-    if (message_strategy == grape::MessageStrategy::kAlongEdgeToOuterVertex) {
-      for (auto v : inner_vertices) {
-        if (bptr->IsUpdated(v)) {
-          grape::DestList dsts = frag.IOEDests(v);
-          fid_t* ptr = dsts.begin;
-          while (ptr != dsts.end) {
-            ++message_num[*(ptr++)];
-          }
-        }
-      }
-    } else if (message_strategy ==
-               grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex) {
-      for (auto v : inner_vertices) {
-        if (bptr->IsUpdated(v)) {
-          grape::DestList dsts = frag.IEDests(v);
-          fid_t* ptr = dsts.begin;
-          while (ptr != dsts.end) {
-            ++message_num[*(ptr++)];
-          }
-        }
-      }
-    } else if (message_strategy ==
-               grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex) {
-      for (auto v : inner_vertices) {
-        if (bptr->IsUpdated(v)) {
-          grape::DestList dsts = frag.OEDests(v);
-          fid_t* ptr = dsts.begin;
-          while (ptr != dsts.end) {
-            ++message_num[*(ptr++)];
-          }
-        }
-      }
-    }
-
-    for (fid_t i = 0; i < Base::fnum(); i++) {
-      if (message_num[i] > 0) {
-        Base::SendToFragment<int>(i, event_id);
-        Base::SendToFragment<size_t>(i, message_num[i]);
-      }
-    }
-
-    if (message_strategy == grape::MessageStrategy::kAlongEdgeToOuterVertex) {
-      for (auto v : inner_vertices) {
-        if (bptr->IsUpdated(v)) {
-          Base::SendMsgThroughEdges(frag, v, bptr->GetValue(v));
-          bptr->Reset(v);
-        }
-      }
-    } else if (message_strategy ==
-               grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex) {
-      for (auto v : inner_vertices) {
-        if (bptr->IsUpdated(v)) {
-          Base::SendMsgThroughIEdges(frag, v, bptr->GetValue(v));
-          bptr->Reset(v);
-        }
-      }
-    } else if (message_strategy ==
-               grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex) {
-      for (auto v : inner_vertices) {
-        if (bptr->IsUpdated(v)) {
-          Base::SendMsgThroughOEdges(frag, v, bptr->GetValue(v));
-          bptr->Reset(v);
-        }
-      }
+  void aggregateAutoMessages() {
+    int event_id;
+    while (Base::GetMessage<int>(event_id)) {
+      auto& event = auto_parallel_events_.at(event_id);
+      getSyncer(event)->Recv(*this, event);
     }
   }
-  */
-
-  template <typename T>
-  inline void syncOnOuterVertexSend(const FRAG_T& frag, label_id_t label,
-                                    grape::ISyncBuffer* buffer, int event_id) {
-    auto* bptr = dynamic_cast<grape::SyncBuffer<T, vid_t>*>(buffer);
-    auto inner_vertices = frag.InnerVertices(label);
-    auto outer_vertices = frag.OuterVertices(label);
-    std::vector<size_t> message_num(Base::fnum(), 0);
-
-    for (auto v : inner_vertices) {
-      bptr->Reset(v);
-    }
-
-    for (auto v : outer_vertices) {
-      if (bptr->IsUpdated(v)) {
-        fid_t fid = frag.GetFragId(v);
-        ++message_num[fid];
-      }
-    }
 
-    for (fid_t i = 0; i < Base::fnum(); i++) {
-      if (message_num[i] > 0) {
-        Base::SendToFragment<int>(i, event_id);
-        Base::SendToFragment<size_t>(i, message_num[i]);
-      }
-    }
-
-    for (auto v : outer_vertices) {
-      if (bptr->IsUpdated(v)) {
-        Base::SyncStateOnOuterVertex(frag, v, bptr->GetValue(v));
-        bptr->Reset(v);
+  void generateAutoMessages() {
+    for (auto& event : auto_parallel_events_) {
+      auto inner_size = event.fragment.InnerVertices(event.label).size();
+      if (event.buffer->updated(0, inner_size)) {
+        ForceContinue();
+        break;
       }
     }
-  }
 
-  template <typename T>
-  inline void syncOnVertexRecv(const FRAG_T& frag, grape::ISyncBuffer* buffer) {
-    auto* bptr = dynamic_cast<grape::SyncBuffer<T, vid_t>*>(buffer);
-
-    size_t message_num = 0;
-    T rhs;
-    grape::Vertex<vid_t> v(0);
-    Base::GetMessage<size_t>(message_num);
-    while (message_num--) {
-      GetMessage(frag, v, rhs);
-      bptr->Aggregate(v, std::move(rhs));
+    for (auto& event : auto_parallel_events_) {
+      getSyncer(event)->Send(*this, event);
     }
   }
 
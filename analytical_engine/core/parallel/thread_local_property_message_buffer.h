@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_LOCAL_PROPERTY_MESSAGE_BUFFER_H_
 #define ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_LOCAL_PROPERTY_MESSAGE_BUFFER_H_
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -29,10 +30,17 @@ namespace gs {
  * @brief ThreadLocalPropertyMessageBuffer provides buffers for label fragment
  * for a thread. Every thead should use individual
  * ThreadLocalPropertyMessageBuffer as the class name indicated.
+ *
+ * The buffer of each destination is flushed once it exceeds a threshold,
+ * which starts small in every round and doubles after each flush until
+ * block_size. Thus the first messages of a round are sent soon and overlap
+ * with the computation, while heavy destinations still send large blocks.
  * @tparam MM_T
  */
 template <typename MM_T>
 class ThreadLocalPropertyMessageBuffer {
+  static constexpr size_t min_flush_threshold = 16 * 1024;
+
  public:
   /**
    * @brief Initialize thread local message buffer.
@@ -52,8 +60,10 @@ class ThreadLocalPropertyMessageBuffer {
     block_size_ = block_size;
     block_cap_ = block_cap;
 
-    for (auto& arc : to_send_) {
-      arc.Reserve(block_cap_);
+    thresholds_.clear();
+    thresholds_.resize(fnum_, initialThreshold());
+    for (grape::fid_t fid = 0; fid < fnum_; ++fid) {
+      to_send_[fid].Reserve(reservedSize(fid));
     }
 
     sent_size_ = 0;
@@ -79,7 +89,7 @@ class ThreadLocalPropertyMessageBuffer {
                                      const MESSAGE_T& msg) {
     grape::fid_t fid = frag.GetFragId(v);
     to_send_[fid] << frag.GetOuterVertexGid(v) << msg;
-    if (to_send_[fid].GetSize() > block_size_) {
+    if (to_send_[fid].GetSize() > thresholds_[fid]) {
       flushLocalBuffer(fid);
     }
   }
@@ -89,7 +99,7 @@ class ThreadLocalPropertyMessageBuffer {
                                      const typename GRAPH_T::vertex_t& v) {
     grape::fid_t fid = frag.GetFragId(v);
     to_send_[fid] << frag.GetOuterVertexGid(v);
-    if (to_send_[fid].GetSize() > block_size_) {
+    if (to_send_[fid].GetSize() > thresholds_[fid]) {
       flushLocalBuffer(fid);
     }
   }
@@ -115,7 +125,7 @@ class ThreadLocalPropertyMessageBuffer {
     while (ptr != dsts.end) {
       grape::fid_t fid = *(ptr++);
       to_send_[fid] << gid << msg;
-      if (to_send_[fid].GetSize() > block_size_) {
+      if (to_send_[fid].GetSize() > thresholds_[fid]) {
         flushLocalBuffer(fid);
       }
     }
@@ -142,7 +152,7 @@ class ThreadLocalPropertyMessageBuffer {
     while (ptr != dsts.end) {
       grape::fid_t fid = *(ptr++);
       to_send_[fid] << gid << msg;
-      if (to_send_[fid].GetSize() > block_size_) {
+      if (to_send_[fid].GetSize() > thresholds_[fid]) {
         flushLocalBuffer(fid);
       }
     }
@@ -169,7 +179,7 @@ class ThreadLocalPropertyMessageBuffer {
     while (ptr != dsts.end) {
       grape::fid_t fid = *(ptr++);
       to_send_[fid] << gid << msg;
-      if (to_send_[fid].GetSize() > block_size_) {
+      if (to_send_[fid].GetSize() > thresholds_[fid]) {
         flushLocalBuffer(fid);
       }
     }
@@ -193,7 +203,6 @@ class ThreadLocalPropertyMessageBuffer {
   inline void FlushMessages() {
     for (grape::fid_t fid = 0; fid < fnum_; ++fid) {
       if (to_send_[fid].GetSize() > 0) {
-        sent_size_ += to_send_[fid].GetSize();
         flushLocalBuffer(fid);
       }
     }
@@ -201,12 +210,28 @@ class ThreadLocalPropertyMessageBuffer {
 
   size_t SentMsgSize() const { return sent_size_; }
 
-  inline void Reset() { sent_size_ = 0; }
+  /**
+   * @brief Reset the sent size and the flush thresholds for a new round.
+   */
+  inline void Reset() {
+    sent_size_ = 0;
+    std::fill(thresholds_.begin(), thresholds_.end(), initialThreshold());
+  }
 
  private:
   inline void flushLocalBuffer(grape::fid_t fid) {
+    sent_size_ += to_send_[fid].GetSize();
     mm_->SendRawMsgByFid(fid, std::move(to_send_[fid]));
-    to_send_[fid].Reserve(block_cap_);
+    thresholds_[fid] = std::min(thresholds_[fid] * 2, block_size_);
+    to_send_[fid].Reserve(reservedSize(fid));
+  }
+
+  inline size_t initialThreshold() const {
+    return std::min(block_size_, min_flush_threshold);
+  }
+
+  inline size_t reservedSize(grape::fid_t fid) const {
+    return std::min(block_cap_, thresholds_[fid] * 2);
   }
 
   std::vector<grape::InArchive> to_send_;
@@ -215,6 +240,8 @@ class ThreadLocalPropertyMessageBuffer {
 
   size_t block_size_;
   size_t block_cap_;
+  // thresholds_[fid] is the size to flush the buffer of fid
+  std::vector<size_t> thresholds_;
 
   size_t sent_size_;
 };
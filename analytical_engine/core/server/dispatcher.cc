@@ -15,16 +15,30 @@
 
 #include "core/server/dispatcher.h"
 
+#include <algorithm>
+
 namespace gs {
 
 Dispatcher::Dispatcher(const grape::CommSpec& comm_spec)
     : running_(false), comm_spec_(comm_spec) {
+  // lanes run collective communications concurrently
+  int provided;
+  MPI_Query_thread(&provided);
+  concurrent_ = provided == MPI_THREAD_MULTIPLE;
+
+  exclusive_lane_.comm_spec = comm_spec_;
+  if (concurrent_) {
+    read_lane_.comm_spec = comm_spec_;
+    read_lane_.comm_spec.Dup();
+  }
   // a naive implementation using MPI
   auto publisher = comm_spec_.worker_id() == grape::kCoordinatorRank;
   // we use blocking queue as synchronizer
   if (publisher) {
-    cmd_queue_.SetLimit(1);
-    result_queue_.SetLimit(1);
+    for (auto* lane : {&exclusive_lane_, &read_lane_}) {
+      lane->cmd_queue.SetLimit(1);
+      lane->result_queue.SetLimit(1);
+    }
   }
 }
 
@@ -35,20 +49,39 @@ void Dispatcher::Start() {
   running_ = true;
   auto publisher = comm_spec_.worker_id() == grape::kCoordinatorRank;
 
-  if (publisher) {
-    auto publisher_th = std::thread([this]() { publisherLoop(); });
-    publisher_th.join();
-  } else {
-    auto subscriber_th = std::thread([this]() { subscriberLoop(); });
-    subscriber_th.join();
+  std::vector<Lane*> lanes{&exclusive_lane_};
+  if (concurrent_) {
+    lanes.push_back(&read_lane_);
+  }
+  std::vector<std::thread> lane_threads;
+  for (auto* lane : lanes) {
+    if (publisher) {
+      lane_threads.emplace_back([this, lane]() { publisherLoop(*lane); });
+    } else {
+      lane_threads.emplace_back([this, lane]() { subscriberLoop(*lane); });
+    }
+  }
+  for (auto& th : lane_threads) {
+    th.join();
   }
 }
 
 void Dispatcher::Stop() { running_ = false; }
 
 std::vector<DispatchResult> Dispatcher::Dispatch(CommandDetail& cmd) {
-  cmd_queue_.Push(cmd);
-  return result_queue_.Pop();
+  bool read_only = concurrent_ && isReadOnly(cmd);
+  auto objects = objectsOf(cmd);
+  auto& lane = read_only ? read_lane_ : exclusive_lane_;
+
+  acquireObjects(read_only, objects);
+  std::vector<DispatchResult> results;
+  {
+    std::lock_guard<std::mutex> lock(lane.mutex);
+    lane.cmd_queue.Push(cmd);
+    results = lane.result_queue.Pop();
+  }
+  releaseObjects(read_only, objects);
+  return results;
 }
 
 void Dispatcher::Subscribe(std::shared_ptr<Subscriber> subscriber) {
@@ -56,17 +89,70 @@ void Dispatcher::Subscribe(std::shared_ptr<Subscriber> subscriber) {
 }
 
 void Dispatcher::SetCommand(const CommandDetail& cmd) {
-  processCmd(cmd);
+  processCmd(cmd, comm_spec_);
   MPI_Barrier(comm_spec_.comm());
 }
 
+bool Dispatcher::isReadOnly(const CommandDetail& cmd) {
+  switch (cmd.type) {
+  case rpc::REPORT_GRAPH:
+  case rpc::GET_CONTEXT_DATA:
+  case rpc::CONTEXT_TO_NUMPY:
+  case rpc::CONTEXT_TO_DATAFRAME:
+  case rpc::GRAPH_TO_NUMPY:
+  case rpc::GRAPH_TO_DATAFRAME:
+  case rpc::GET_ENGINE_CONFIG:
+    return true;
+  default:
+    return false;
+  }
+}
+
+std::vector<std::string> Dispatcher::objectsOf(const CommandDetail& cmd) {
+  std::vector<std::string> objects;
+  for (int key : {rpc::GRAPH_NAME, rpc::APP_NAME, rpc::CTX_NAME}) {
+    auto iter = cmd.params.find(key);
+    if (iter != cmd.params.end()) {
+      objects.push_back(iter->second.s());
+    }
+  }
+  // a projection mutates its source when an app runs on it, and a context
+  // reads the graph it is computed on
+  return subscriber_->ResolveObjects(objects);
+}
+
+void Dispatcher::acquireObjects(bool read_only,
+                                const std::vector<std::string>& objects) {
+  std::unique_lock<std::mutex> lock(objects_mutex_);
+  auto& mine = read_only ? reading_objects_ : writing_objects_;
+  auto& others = read_only ? writing_objects_ : reading_objects_;
+  objects_cv_.wait(lock, [&objects, &others]() {
+    return std::none_of(
+        objects.begin(), objects.end(),
+        [&others](const std::string& obj) { return others.count(obj) != 0; });
+  });
+  mine.insert(objects.begin(), objects.end());
+}
+
+void Dispatcher::releaseObjects(bool read_only,
+                                const std::vector<std::string>& objects) {
+  {
+    std::lock_guard<std::mutex> lock(objects_mutex_);
+    auto& mine = read_only ? reading_objects_ : writing_objects_;
+    for (auto& obj : objects) {
+      mine.erase(mine.find(obj));
+    }
+  }
+  objects_cv_.notify_all();
+}
+
 std::shared_ptr<DispatchResult> Dispatcher::processCmd(
-    const CommandDetail& cmd) {
+    const CommandDetail& cmd, const grape::CommSpec& comm_spec) {
   // handle all errors and get error message
   auto r = bl::try_handle_all(
       [&, this]() -> bl::result<std::shared_ptr<DispatchResult>> {
         try {
-          return subscriber_->OnReceive(cmd);
+          return subscriber_->OnReceive(cmd, comm_spec);
         } catch (const std::exception& e) {
           RETURN_GS_ERROR(
               vineyard::ErrorCode::kCommandError,
@@ -74,7 +160,7 @@ std::shared_ptr<DispatchResult> Dispatcher::processCmd(
         }
       },
       [&](const vineyard::GSError& e) {
-        auto r = std::make_shared<DispatchResult>(comm_spec_.worker_id());
+        auto r = std::make_shared<DispatchResult>(comm_spec.worker_id());
 
         r->set_error(
             ErrorCodeToProto(e.error_code),
@@ -95,32 +181,32 @@ std::shared_ptr<DispatchResult> Dispatcher::processCmd(
   return r;
 }
 
-void Dispatcher::publisherLoop() {
+void Dispatcher::publisherLoop(Lane& lane) {
   CHECK_EQ(comm_spec_.worker_id(), grape::kCoordinatorRank);
   while (running_) {
-    auto cmd = cmd_queue_.Pop();
+    auto cmd = lane.cmd_queue.Pop();
     // process local event
-    grape::BcastSend(cmd, MPI_COMM_WORLD);
+    grape::BcastSend(cmd, lane.comm_spec.comm());
 
-    auto r = processCmd(cmd);
-    std::vector<DispatchResult> results(comm_spec_.worker_num());
+    auto r = processCmd(cmd, lane.comm_spec);
+    std::vector<DispatchResult> results(lane.comm_spec.worker_num());
 
     results[0] = std::move(*r);
-    vineyard::_GatherR(results, comm_spec_.comm());
+    vineyard::_GatherR(results, lane.comm_spec.comm());
 
-    result_queue_.Push(std::move(results));
+    lane.result_queue.Push(std::move(results));
   }
 }
 
-void Dispatcher::subscriberLoop() {
+void Dispatcher::subscriberLoop(Lane& lane) {
   CHECK_NE(comm_spec_.worker_id(), grape::kCoordinatorRank);
   while (running_) {
     CommandDetail cmd;
 
-    grape::BcastRecv(cmd, MPI_COMM_WORLD, grape::kCoordinatorRank);
-    auto r = processCmd(cmd);
+    grape::BcastRecv(cmd, lane.comm_spec.comm(), grape::kCoordinatorRank);
+    auto r = processCmd(cmd, lane.comm_spec);
 
-    vineyard::_GatherL(*r, grape::kCoordinatorRank, comm_spec_.comm());
+    vineyard::_GatherL(*r, grape::kCoordinatorRank, lane.comm_spec.comm());
   }
 }
 
@@ -15,8 +15,11 @@
 #ifndef ANALYTICAL_ENGINE_CORE_SERVER_DISPATCHER_H_
 #define ANALYTICAL_ENGINE_CORE_SERVER_DISPATCHER_H_
 
+#include <condition_variable>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <thread>
 #include <utility>
@@ -127,12 +130,35 @@ class Subscriber {
   Subscriber() = default;
   virtual ~Subscriber() = default;
 
+  /**
+   * @param comm_spec The communicator the command is dispatched on, collective
+   * communications of the command should use it.
+   */
   virtual bl::result<std::shared_ptr<DispatchResult>> OnReceive(
-      const CommandDetail& cmd) = 0;
+      const CommandDetail& cmd, const grape::CommSpec& comm_spec) = 0;
+
+  /**
+   * @brief Extend the objects named by a command with the objects they share
+   * data with, e.g., the source of a projection or the graph of a context.
+   */
+  virtual std::vector<std::string> ResolveObjects(
+      const std::vector<std::string>& objects) {
+    return objects;
+  }
 };
 
 /**
  * @brief The dispatcher broadcast commands to every worker using MPI.
+ *
+ * Commands are dispatched on two lanes, each of which has its own
+ * communicator and its own thread on every worker. Read-only commands, e.g.,
+ * REPORT_GRAPH and CONTEXT_TO_NUMPY, go through the read lane, and the others
+ * go through the exclusive lane, thus a long RUN_APP does not block reports
+ * on other graphs. A command waits until the commands in flight on the other
+ * lane do not touch the objects it touches, i.e., the graph, app and context
+ * in the params, and the objects they share data with, e.g., the source graph
+ * of a projection and the graph of a context. Without MPI_THREAD_MULTIPLE,
+ * every command goes through the exclusive lane.
  */
 class Dispatcher {
  public:
@@ -149,18 +175,42 @@ class Dispatcher {
   void SetCommand(const CommandDetail& cmd);
 
  private:
-  std::shared_ptr<DispatchResult> processCmd(const CommandDetail& cmd);
+  struct Lane {
+    grape::CommSpec comm_spec;
+    // one command in flight, thus results are popped by their callers
+    std::mutex mutex;
+    vineyard::BlockingQueue<CommandDetail> cmd_queue;
+    vineyard::BlockingQueue<std::vector<DispatchResult>> result_queue;
+  };
+
+  static bool isReadOnly(const CommandDetail& cmd);
+
+  std::vector<std::string> objectsOf(const CommandDetail& cmd);
+
+  void acquireObjects(bool read_only, const std::vector<std::string>& objects);
+
+  void releaseObjects(bool read_only, const std::vector<std::string>& objects);
+
+  std::shared_ptr<DispatchResult> processCmd(const CommandDetail& cmd,
+                                             const grape::CommSpec& comm_spec);
 
-  void publisherLoop();
+  void publisherLoop(Lane& lane);
 
-  void subscriberLoop();
+  void subscriberLoop(Lane& lane);
 
  private:
   bool running_;
+  bool concurrent_;
   grape::CommSpec comm_spec_;
   std::shared_ptr<Subscriber> subscriber_;
-  vineyard::BlockingQueue<CommandDetail> cmd_queue_;
-  vineyard::BlockingQueue<std::vector<DispatchResult>> result_queue_;
+  Lane exclusive_lane_;
+  Lane read_lane_;
+
+  std::mutex objects_mutex_;
+  std::condition_variable objects_cv_;
+  // objects named by the commands in flight on each lane
+  std::multiset<std::string> reading_objects_;
+  std::multiset<std::string> writing_objects_;
 };
 
 }  // namespace gs
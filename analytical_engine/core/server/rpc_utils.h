@@ -21,6 +21,7 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "google/protobuf/util/json_util.h"
 
@@ -110,6 +111,24 @@ class GSParams {
     return params_.find(key) != params_.end();
   }
 
+  /**
+   * @brief Serialize the values of the given keys into a string, which is
+   * equal for requests with the same values of those keys. Absent keys are
+   * skipped.
+   */
+  std::string Fingerprint(const std::vector<rpc::ParamKey>& keys) const {
+    std::string ret;
+    for (auto key : keys) {
+      auto iter = params_.find(key);
+      if (iter != params_.end()) {
+        auto value = iter->second.SerializeAsString();
+        ret += std::to_string(key) + ":" + std::to_string(value.size()) + ":" +
+               value;
+      }
+    }
+    return ret;
+  }
+
  private:
   const std::map<int, rpc::AttrValue> params_;
 };
@@ -27,6 +27,11 @@ limitations under the License.
 namespace gs {
 /**
  * @brief A VertexMap for later appended vertices
+ *
+ * The oids appended to a fragment are kept by its owner. Other workers only
+ * keep the remote oids they have resolved, see AddRemoteVertex, and the
+ * number of vertices appended to each fragment.
+ *
  * @tparam OID_T
  * @tparam VID_T
  */
@@ -46,10 +51,12 @@ class ExtraVertexMap {
     extra_oid_arrays_.resize(fnum_);
     extra_o2g_.resize(fnum_);
     base_size_.resize(fnum_);
+    vertex_nums_.resize(fnum_);
 
     for (fid_t fid = 0; fid < fnum_; fid++) {
       extra_oid_arrays_[fid].resize(label_num_);
       base_size_[fid].resize(label_num_);
+      vertex_nums_[fid].resize(label_num_, 0);
     }
     id_parser_.Init(fnum_, label_num_);
 
@@ -71,11 +78,34 @@ class ExtraVertexMap {
       gid = id_parser_.GenerateId(fid, v_label, idx);
       oid_array.push_back(oid);
       o2g[oid] = gid;
+      vertex_nums_[fid][v_label] = oid_array.size();
       return true;
     }
     return false;
   }
 
+  /**
+   * @brief Record a vertex appended to a remote fragment, the gid of which
+   * is assigned by the owner.
+   */
+  void AddRemoteVertex(const oid_t& oid, vid_t gid) {
+    fid_t fid = id_parser_.GetFid(gid);
+    if (extra_o2g_[fid].emplace(oid, gid).second) {
+      remote_g2o_.emplace(gid, oid);
+    }
+  }
+
+  /**
+   * @brief Set the number of vertices appended to a remote fragment.
+   */
+  void SetVertexNum(fid_t fid, label_id_t v_label, size_t num) {
+    vertex_nums_[fid][v_label] = num;
+  }
+
+  size_t GetVertexNum(fid_t fid, label_id_t v_label) const {
+    return vertex_nums_[fid][v_label];
+  }
+
   bool GetOid(vid_t gid, oid_t& oid) const {
     fid_t fid = id_parser_.GetFid(gid);
     label_id_t label = id_parser_.GetLabelId(gid);
@@ -92,6 +122,11 @@ class ExtraVertexMap {
         return true;
       }
     }
+    auto iter = remote_g2o_.find(gid);
+    if (iter != remote_g2o_.end()) {
+      oid = iter->second;
+      return true;
+    }
     return false;
   }
 
@@ -113,10 +148,34 @@ class ExtraVertexMap {
     return false;
   }
 
+  /**
+   * @brief The oids appended to a local fragment, ordered by their offsets.
+   */
+  const std::vector<oid_t>& GetOids(fid_t fid, label_id_t v_label) const {
+    return extra_oid_arrays_[fid][v_label];
+  }
+
+  /**
+   * @brief Keep the remote vertices resolved by another map, except those
+   * already covered by the base vertex map of this one.
+   */
+  void InheritRemoteVertices(const ExtraVertexMap<oid_t, vid_t>& other) {
+    for (auto& pair : other.remote_g2o_) {
+      fid_t fid = id_parser_.GetFid(pair.first);
+      label_id_t label = id_parser_.GetLabelId(pair.first);
+      if (static_cast<size_t>(id_parser_.GetOffset(pair.first)) >=
+          base_size_[fid][label]) {
+        AddRemoteVertex(pair.second, pair.first);
+      }
+    }
+  }
+
   size_t GetTotalNodesNum() const {
     size_t num = 0;
-    for (auto& m : extra_o2g_) {
-      num += m.size();
+    for (auto& nums : vertex_nums_) {
+      for (auto n : nums) {
+        num += n;
+      }
     }
     return num;
   }
@@ -127,6 +186,10 @@ class ExtraVertexMap {
   std::vector<ska::flat_hash_map<oid_t, vid_t>> extra_o2g_;
   vineyard::IdParser<vid_t> id_parser_;
   std::vector<std::vector<size_t>> base_size_;
+  // number of appended vertices of each fragment and label
+  std::vector<std::vector<size_t>> vertex_nums_;
+  // remote vertices resolved from their owners
+  ska::flat_hash_map<vid_t, oid_t> remote_g2o_;
   fid_t fnum_;
   label_id_t label_num_;
 };
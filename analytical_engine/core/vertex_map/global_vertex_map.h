@@ -16,24 +16,38 @@
 #ifndef ANALYTICAL_ENGINE_CORE_VERTEX_MAP_GLOBAL_VERTEX_MAP_H_
 #define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_GLOBAL_VERTEX_MAP_H_
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "grape/util.h"
+#include "grape/utils/concurrent_queue.h"
 #include "grape/vertex_map/global_vertex_map.h"
 #include "vineyard/graph/utils/string_collection.h"
 
+#include "core/vertex_map/string_id_indexer.h"
+
 namespace grape {
 
 /**
  * @brief A specialized GlobalVertexMap for string oid.
  *
+ * The oids of each fragment are kept in a StringCollection, and indexed by a
+ * StringIdIndexer which stores the lids and the hashes only.
+ *
  * * @tparam VID_T VID type
  */
 template <typename VID_T>
 class GlobalVertexMap<std::string, VID_T>
     : public VertexMapBase<std::string, VID_T> {
   using Base = VertexMapBase<std::string, VID_T>;
+  // number of oids hashed by a task in Construct
+  static constexpr VID_T hash_chunk_size = 64 * 1024;
 
  public:
   explicit GlobalVertexMap(const CommSpec& comm_spec) : Base(comm_spec) {}
@@ -47,7 +61,7 @@ class GlobalVertexMap<std::string, VID_T>
   size_t GetTotalVertexSize() {
     size_t size = 0;
     for (const auto& v : o2l_) {
-      size += v.size();
+      size += v.Size();
     }
     return size;
   }
@@ -59,28 +73,22 @@ class GlobalVertexMap<std::string, VID_T>
   void Clear() {}
 
   void AddVertex(fid_t fid, const std::string& oid) {
-    RefString ref_oid(oid);
-    auto& rm = o2l_[fid];
-    if (rm.find(ref_oid) == rm.end()) {
-      RefString key = string_collections_[fid].PutString(ref_oid);
-      rm.emplace(key, static_cast<VID_T>(rm.size()));
-    }
+    VID_T gid;
+    AddVertex(fid, oid, gid);
   }
 
   bool AddVertex(fid_t fid, const std::string& oid, VID_T& gid) {
     RefString ref_oid(oid);
-    auto& rm = o2l_[fid];
-    auto iter = rm.find(ref_oid);
-    if (iter == rm.end()) {
-      RefString key = string_collections_[fid].PutString(ref_oid);
-      gid = static_cast<VID_T>(rm.size());
-      rm.emplace(key, gid);
-      gid = Base::Lid2Gid(fid, gid);
-      return true;
-    } else {
-      gid = Base::Lid2Gid(fid, iter->second);
+    size_t hash = hashOf(ref_oid);
+    VID_T lid;
+    if (findLid(fid, ref_oid, hash, lid)) {
+      gid = Base::Lid2Gid(fid, lid);
       return false;
     }
+    string_collections_[fid].PutString(ref_oid);
+    lid = o2l_[fid].Add(hash);
+    gid = Base::Lid2Gid(fid, lid);
+    return true;
   }
 
   bool GetOid(const VID_T& gid, std::string& oid) {
@@ -100,14 +108,12 @@ class GlobalVertexMap<std::string, VID_T>
 
   bool GetGid(fid_t fid, const std::string& oid, VID_T& gid) {
     RefString ref_oid(oid);
-    auto& rm = o2l_[fid];
-    auto iter = rm.find(ref_oid);
-    if (iter == rm.end()) {
+    VID_T lid;
+    if (!findLid(fid, ref_oid, hashOf(ref_oid), lid)) {
       return false;
-    } else {
-      gid = Base::Lid2Gid(fid, iter->second);
-      return true;
     }
+    gid = Base::Lid2Gid(fid, lid);
+    return true;
   }
 
   bool GetGid(const std::string& oid, VID_T& gid) {
@@ -119,71 +125,124 @@ class GlobalVertexMap<std::string, VID_T>
     return false;
   }
 
+  /**
+   * @brief Exchange the oids of fragments between workers and index them.
+   *
+   * The collections are exchanged in a ring. Once a collection is received,
+   * it is split into chunks which are hashed by the worker threads, and the
+   * last thread finishing a chunk of a fragment builds the index of it. Thus
+   * the hashing overlaps with the exchange of the remaining fragments.
+   */
   void Construct() {
     const CommSpec& comm_spec = Base::GetCommSpec();
     int worker_id = comm_spec.worker_id();
     int worker_num = comm_spec.worker_num();
-    {
-      std::thread recv_thread([&]() {
-        int src_worker_id = (worker_id + 1) % worker_num;
-        while (src_worker_id != worker_id) {
-          for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
-            if (comm_spec.FragToWorker(fid) != src_worker_id) {
-              continue;
-            }
-            string_collections_[fid].RecvFrom(src_worker_id, comm_spec.comm());
+    fid_t fnum = comm_spec.fnum();
+    double begin = grape::GetCurrentTime();
+
+    // a task hashes the oids of [second, second + hash_chunk_size) of a
+    // fragment
+    grape::BlockingQueue<std::pair<fid_t, VID_T>> tasks;
+    tasks.SetProducerNum(1);
+    std::vector<std::vector<size_t>> hashes(fnum);
+    std::vector<std::atomic<size_t>> pending_chunks(fnum);
+    double exchange_time = 0;
+
+    std::thread recv_thread([&]() {
+      int src_worker_id = (worker_id + 1) % worker_num;
+      while (src_worker_id != worker_id) {
+        for (fid_t fid = 0; fid < fnum; ++fid) {
+          if (comm_spec.FragToWorker(fid) != src_worker_id) {
+            continue;
+          }
+          auto& sc = string_collections_[fid];
+          sc.RecvFrom(src_worker_id, comm_spec.comm());
+          VID_T vnum = static_cast<VID_T>(sc.Count());
+          hashes[fid].resize(vnum);
+          pending_chunks[fid] =
+              (static_cast<size_t>(vnum) + hash_chunk_size - 1) /
+              hash_chunk_size;
+          if (vnum == 0) {
+            o2l_[fid].Build(std::move(hashes[fid]));
+          }
+          for (size_t chunk = 0; chunk < vnum; chunk += hash_chunk_size) {
+            tasks.Put(std::make_pair(fid, static_cast<VID_T>(chunk)));
           }
-          src_worker_id = (src_worker_id + 1) % worker_num;
         }
-      });
-      std::thread send_thread([&]() {
-        int dst_worker_id = (worker_id + worker_num - 1) % worker_num;
-        while (dst_worker_id != worker_id) {
-          for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
-            if (comm_spec.FragToWorker(fid) != worker_id) {
-              continue;
-            }
-            string_collections_[fid].SendTo(dst_worker_id, comm_spec.comm());
+        src_worker_id = (src_worker_id + 1) % worker_num;
+      }
+      exchange_time = grape::GetCurrentTime() - begin;
+      tasks.DecProducerNum();
+    });
+    std::thread send_thread([&]() {
+      int dst_worker_id = (worker_id + worker_num - 1) % worker_num;
+      while (dst_worker_id != worker_id) {
+        for (fid_t fid = 0; fid < fnum; ++fid) {
+          if (comm_spec.FragToWorker(fid) != worker_id) {
+            continue;
+          }
+          string_collections_[fid].SendTo(dst_worker_id, comm_spec.comm());
+        }
+        dst_worker_id = (dst_worker_id + worker_num - 1) % worker_num;
+      }
+    });
+
+    int thread_num =
+        (std::thread::hardware_concurrency() + comm_spec.local_num() - 1) /
+        comm_spec.local_num();
+    std::vector<double> hash_time(thread_num, 0), index_time(thread_num, 0);
+    std::vector<std::thread> work_threads(thread_num);
+    for (int tid = 0; tid < thread_num; ++tid) {
+      work_threads[tid] = std::thread([&, tid] {
+        std::pair<fid_t, VID_T> task;
+        RefString rs;
+        while (tasks.Get(task)) {
+          double t0 = grape::GetCurrentTime();
+          fid_t fid = task.first;
+          auto& sc = string_collections_[fid];
+          auto& fid_hashes = hashes[fid];
+          size_t end = std::min(fid_hashes.size(),
+                                static_cast<size_t>(task.second) +
+                                    static_cast<size_t>(hash_chunk_size));
+          for (size_t lid = task.second; lid < end; ++lid) {
+            sc.Get(lid, rs);
+            fid_hashes[lid] = hashOf(rs);
+          }
+          double t1 = grape::GetCurrentTime();
+          hash_time[tid] += t1 - t0;
+          if (pending_chunks[fid].fetch_sub(1) == 1) {
+            // oids of a fragment are distinct, thus the index is built from
+            // the hashes directly
+            o2l_[fid].Build(std::move(fid_hashes));
+            index_time[tid] += grape::GetCurrentTime() - t1;
           }
-          dst_worker_id = (dst_worker_id + worker_num - 1) % worker_num;
         }
       });
-      send_thread.join();
-      recv_thread.join();
     }
-    {
-      int thread_num =
-          (std::thread::hardware_concurrency() + comm_spec.local_num() - 1) /
-          comm_spec.local_num();
-      std::atomic<fid_t> current_fid(0);
-      fid_t fnum = comm_spec.fnum();
-      std::vector<std::thread> work_threads(thread_num);
-      for (int tid = 0; tid < thread_num; ++tid) {
-        work_threads[tid] = std::thread([&] {
-          fid_t got;
-          RefString rs;
-          while (true) {
-            got = current_fid.fetch_add(1, std::memory_order_relaxed);
-            if (got >= fnum) {
-              break;
-            }
-            if (comm_spec.FragToWorker(got) == worker_id) {
-              continue;
-            }
-            auto& rm = o2l_[got];
-            VID_T vnum = static_cast<VID_T>(string_collections_[got].Count());
-            rm.reserve(vnum);
-            for (VID_T lid = 0; lid < vnum; ++lid) {
-              string_collections_[got].Get(lid, rs);
-              rm.emplace(rs, lid);
-            }
-          }
-        });
-      }
-      for (auto& thrd : work_threads) {
-        thrd.join();
-      }
+
+    send_thread.join();
+    recv_thread.join();
+    for (auto& thrd : work_threads) {
+      thrd.join();
+    }
+
+    construct_stat_.exchange_time = exchange_time;
+    construct_stat_.hash_time = 0;
+    construct_stat_.index_time = 0;
+    for (int tid = 0; tid < thread_num; ++tid) {
+      construct_stat_.hash_time += hash_time[tid];
+      construct_stat_.index_time += index_time[tid];
     }
+    construct_stat_.total_time = grape::GetCurrentTime() - begin;
+    VLOG(1) << "[worker-" << worker_id << "] vertex map constructed in "
+            << construct_stat_.total_time
+            << "s, exchange: " << construct_stat_.exchange_time
+            << "s, hash: " << construct_stat_.hash_time
+            << "s, index: " << construct_stat_.index_time << "s";
+  }
+
+  const gs::VertexMapConstructStat& GetConstructStat() const {
+    return construct_stat_;
   }
 
   template <typename IOADAPTOR_T>
@@ -245,13 +304,13 @@ class GlobalVertexMap<std::string, VID_T>
             if (got >= fnum) {
               break;
             }
-            auto& rm = o2l_[got];
             size_t vnum = string_collections_[got].Count();
-            rm.reserve(vnum);
+            std::vector<size_t> hashes(vnum);
             for (size_t lid = 0; lid < vnum; ++lid) {
               string_collections_[got].Get(lid, rs);
-              rm.emplace(rs, static_cast<VID_T>(lid));
+              hashes[lid] = hashOf(rs);
             }
+            o2l_[got].Build(std::move(hashes));
           }
         });
       }
@@ -270,8 +329,25 @@ class GlobalVertexMap<std::string, VID_T>
   }
 
  private:
+  static size_t hashOf(const RefString& oid) {
+    return std::hash<RefString>()(oid);
+  }
+
+  bool findLid(fid_t fid, const RefString& oid, size_t hash, VID_T& lid) {
+    auto& sc = string_collections_[fid];
+    RefString rs;
+    return o2l_[fid].Find(
+        hash,
+        [&](VID_T cur) {
+          sc.Get(cur, rs);
+          return rs == oid;
+        },
+        lid);
+  }
+
   std::vector<StringCollection> string_collections_;
-  std::vector<HashMap<RefString, VID_T>> o2l_;
+  std::vector<gs::StringIdIndexer<VID_T>> o2l_;
+  gs::VertexMapConstructStat construct_stat_;
 };
 
 }  // namespace grape
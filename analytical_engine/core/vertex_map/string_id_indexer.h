@@ -0,0 +1,156 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_VERTEX_MAP_STRING_ID_INDEXER_H_
+#define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_STRING_ID_INDEXER_H_
+
+#include <stddef.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace gs {
+
+/**
+ * @brief Time breakdown of the construction of a vertex map on a worker, in
+ * seconds. The hashing and indexing time is summed over all threads.
+ */
+struct VertexMapConstructStat {
+  // from the beginning of the construction to the last fragment received
+  double exchange_time = 0;
+  double hash_time = 0;
+  double index_time = 0;
+  double total_time = 0;
+};
+
+/**
+ * @brief StringIdIndexer maps keys to the dense ids 0, 1, ..., n - 1 with an
+ * open-addressing table of linear probing. The keys are not stored, only the
+ * ids in the slots and the hash of each id. Thus a key is compared only if
+ * the hash matches, and rehashing never hashes the keys again.
+ *
+ * The owner keeps the keys, e.g., a StringCollection where the key of id i is
+ * the i-th string, and provides the comparison of keys in Find.
+ *
+ * @tparam VID_T Type of ids.
+ */
+template <typename VID_T>
+class StringIdIndexer {
+  static constexpr size_t min_capacity = 16;
+
+ public:
+  StringIdIndexer() : mask_(0) {}
+
+  size_t Size() const { return hashes_.size(); }
+
+  void Reserve(size_t size) {
+    hashes_.reserve(size);
+    size_t capacity = capacityFor(size);
+    if (capacity > slots_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  /**
+   * @brief Find the id of a key.
+   *
+   * @param hash Hash of the key.
+   * @param equals equals(id) tells whether the key of id is the key to find.
+   */
+  template <typename FUNC_T>
+  bool Find(size_t hash, const FUNC_T& equals, VID_T& id) const {
+    if (slots_.empty()) {
+      return false;
+    }
+    size_t idx = hash & mask_;
+    while (slots_[idx] != emptySlot()) {
+      VID_T cur = slots_[idx];
+      if (hashes_[cur] == hash && equals(cur)) {
+        id = cur;
+        return true;
+      }
+      idx = (idx + 1) & mask_;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Add a key absent in the indexer, the id of it is Size().
+   */
+  VID_T Add(size_t hash) {
+    VID_T id = static_cast<VID_T>(hashes_.size());
+    hashes_.push_back(hash);
+    if (capacityFor(hashes_.size()) > slots_.size()) {
+      rehash(capacityFor(hashes_.size()));
+    } else {
+      insertSlot(id, hash);
+    }
+    return id;
+  }
+
+  /**
+   * @brief Rebuild the indexer from the hashes of distinct keys, the key of
+   * id i has hashes[i].
+   */
+  void Build(std::vector<size_t>&& hashes) {
+    hashes_ = std::move(hashes);
+    slots_.clear();
+    rehash(capacityFor(hashes_.size()));
+  }
+
+  size_t MemoryUsage() const {
+    return slots_.capacity() * sizeof(VID_T) +
+           hashes_.capacity() * sizeof(size_t);
+  }
+
+ private:
+  static VID_T emptySlot() { return std::numeric_limits<VID_T>::max(); }
+
+  // keeps the load factor below 0.75
+  static size_t capacityFor(size_t size) {
+    size_t capacity = min_capacity;
+    while (capacity * 3 < size * 4) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  void insertSlot(VID_T id, size_t hash) {
+    size_t idx = hash & mask_;
+    while (slots_[idx] != emptySlot()) {
+      idx = (idx + 1) & mask_;
+    }
+    slots_[idx] = id;
+  }
+
+  void rehash(size_t capacity) {
+    slots_.clear();
+    slots_.resize(capacity, emptySlot());
+    mask_ = capacity - 1;
+    VID_T size = static_cast<VID_T>(hashes_.size());
+    for (VID_T id = 0; id < size; ++id) {
+      insertSlot(id, hashes_[id]);
+    }
+  }
+
+  std::vector<VID_T> slots_;
+  std::vector<size_t> hashes_;
+  size_t mask_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_VERTEX_MAP_STRING_ID_INDEXER_H_
@@ -73,6 +73,10 @@ class ParallelPropertyWorker {
     comm_spec_ = comm_spec;
 
     messages_.Init(comm_spec_.comm());
+    messages_.EnableEagerProcessing(APP_T::order_insensitive_messages);
+    if (APP_T::compress_messages) {
+      messages_.EnableCompression();
+    }
 
     grape::InitParallelEngine(app_, pe_spec);
     grape::InitCommunicator(app_, comm_spec_.comm());
@@ -90,6 +94,7 @@ class ParallelPropertyWorker {
     }
 
     int round = 0;
+    message_stat_ = MessageRoundStat();
 
     messages_.Start();
 
@@ -98,6 +103,7 @@ class ParallelPropertyWorker {
     app_->PEval(*graph_, *context_, messages_);
 
     messages_.FinishARound();
+    message_stat_ += messages_.LastRoundStat();
 
     if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
       VLOG(1) << "[Coordinator]: Finished PEval";
@@ -112,6 +118,7 @@ class ParallelPropertyWorker {
       app_->IncEval(*graph_, *context_, messages_);
 
       messages_.FinishARound();
+      message_stat_ += messages_.LastRoundStat();
 
       if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
         VLOG(1) << "[Coordinator]: Finished IncEval - " << step;
@@ -120,10 +127,19 @@ class ParallelPropertyWorker {
     }
     MPI_Barrier(comm_spec_.comm());
     messages_.Finalize();
+    VLOG(1) << "[Worker " << comm_spec_.worker_id() << "]: processed "
+            << message_stat_.recv_buffers << " buffers ("
+            << message_stat_.early_buffers << " early), idle "
+            << message_stat_.idle_time << "s";
   }
 
   std::shared_ptr<context_t> GetContext() { return context_; }
 
+  /**
+   * @brief Communication statistics of the last query, summed over rounds.
+   */
+  const MessageRoundStat& GetMessageStat() const { return message_stat_; }
+
   void Output(std::ostream& os) { context_->Output(os); }
 
  private:
@@ -131,6 +147,7 @@ class ParallelPropertyWorker {
   std::shared_ptr<fragment_t> graph_;
   std::shared_ptr<context_t> context_;
   message_manager_t messages_;
+  MessageRoundStat message_stat_;
 
   grape::CommSpec comm_spec_;
 };
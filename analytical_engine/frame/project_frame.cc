@@ -15,10 +15,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include "boost/algorithm/string.hpp"
 
 #include "vineyard/common/util/typename.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
+#include "core/fragment/arrow_flattened_fragment.h"
 #include "core/fragment/arrow_projected_fragment.h"
 #include "core/fragment/dynamic_fragment.h"
 #include "core/fragment/dynamic_projected_fragment.h"
@@ -32,12 +35,12 @@
 
 /**
  * project_frame.cc serves as a frame to be compiled with
- * ArrowProjectedFragment/DynamicProjectedFragment. The frame will be compiled
- * when the client issues a PROJECT_TO_SIMPLE request. Then, a library will be
- * produced based on the frame. The reason we need the frame is the template
- * parameters are unknown before the project request has arrived at the
- * analytical engine. A dynamic library is necessary to prevent hardcode data
- * type in the engine.
+ * ArrowProjectedFragment/ArrowFlattenedFragment/DynamicProjectedFragment. The
+ * frame will be compiled when the client issues a PROJECT_TO_SIMPLE request.
+ * Then, a library will be produced based on the frame. The reason we need the
+ * frame is the template parameters are unknown before the project request has
+ * arrived at the analytical engine. A dynamic library is necessary to prevent
+ * hardcode data type in the engine.
  */
 namespace gs {
 
@@ -68,10 +71,14 @@ class ProjectSimpleFrame<
     auto e_label = std::to_string(e_label_id);
     auto v_prop = std::to_string(v_prop_id);
     auto e_prop = std::to_string(e_prop_id);
+    bool inline_edata = false;
+    if (params.HasKey(rpc::INLINE_EDGE_DATA)) {
+      BOOST_LEAF_ASSIGN(inline_edata, params.Get<bool>(rpc::INLINE_EDGE_DATA));
+    }
     auto input_frag =
         std::static_pointer_cast<fragment_t>(input_wrapper->fragment());
     auto projected_frag = projected_fragment_t::Project(
-        input_frag, v_label, v_prop, e_label, e_prop);
+        input_frag, v_label, v_prop, e_label, e_prop, inline_edata);
 
     rpc::graph::GraphDefPb graph_def;
     graph_def.set_key(projected_graph_name);
@@ -127,6 +134,81 @@ class ProjectSimpleFrame<
   }
 };
 
+template <typename OID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class ProjectSimpleFrame<
+    gs::ArrowFlattenedFragment<OID_T, VID_T, VDATA_T, EDATA_T>> {
+  using fragment_t = vineyard::ArrowFragment<OID_T, VID_T>;
+  using projected_fragment_t =
+      gs::ArrowFlattenedFragment<OID_T, VID_T, VDATA_T, EDATA_T>;
+  using label_id_t = typename projected_fragment_t::label_id_t;
+  using prop_id_t = typename projected_fragment_t::prop_id_t;
+
+ public:
+  static bl::result<std::shared_ptr<IFragmentWrapper>> Project(
+      std::shared_ptr<IFragmentWrapper>& input_wrapper,
+      const std::string& projected_graph_name, const rpc::GSParams& params) {
+    if (input_wrapper->graph_def().graph_type() != rpc::graph::ARROW_PROPERTY) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "graph_type should be ARROW_PROPERTY");
+    }
+
+    BOOST_LEAF_AUTO(v_label_ids, params.Get<std::string>(rpc::V_LABEL_IDS));
+    BOOST_LEAF_AUTO(e_label_ids, params.Get<std::string>(rpc::E_LABEL_IDS));
+    BOOST_LEAF_AUTO(v_prop_ids, params.Get<std::string>(rpc::V_PROP_IDS));
+    BOOST_LEAF_AUTO(e_prop_ids, params.Get<std::string>(rpc::E_PROP_IDS));
+    auto v_labels = parseIds<label_id_t>(v_label_ids);
+    auto e_labels = parseIds<label_id_t>(e_label_ids);
+    auto v_props = parseIds<prop_id_t>(v_prop_ids);
+    auto e_props = parseIds<prop_id_t>(e_prop_ids);
+    auto input_frag =
+        std::static_pointer_cast<fragment_t>(input_wrapper->fragment());
+    auto projected_frag = projected_fragment_t::Project(
+        input_frag, v_labels, v_props, e_labels, e_props);
+    if (projected_frag == nullptr) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Failed to flatten the labels of the property graph");
+    }
+
+    rpc::graph::GraphDefPb graph_def;
+    graph_def.set_key(projected_graph_name);
+    graph_def.set_graph_type(rpc::graph::ARROW_FLATTENED);
+    graph_def.set_directed(projected_frag->directed());
+
+    gs::rpc::graph::VineyardInfoPb vy_info;
+    if (graph_def.has_extension()) {
+      graph_def.extension().UnpackTo(&vy_info);
+    }
+    vy_info.set_oid_type(PropertyTypeToPb(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::oid_t>::Get())));
+    vy_info.set_vid_type(PropertyTypeToPb(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::vid_t>::Get())));
+    vy_info.set_vdata_type(PropertyTypeToPb(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::vdata_t>::Get())));
+    vy_info.set_edata_type(PropertyTypeToPb(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::edata_t>::Get())));
+    vy_info.set_property_schema_json("{}");
+    graph_def.mutable_extension()->PackFrom(vy_info);
+
+    auto wrapper = std::make_shared<FragmentWrapper<projected_fragment_t>>(
+        projected_graph_name, graph_def, projected_frag);
+    return std::dynamic_pointer_cast<IFragmentWrapper>(wrapper);
+  }
+
+ private:
+  template <typename T>
+  static std::vector<T> parseIds(const std::string& ids) {
+    std::vector<T> ret;
+    std::vector<std::string> tokens;
+    boost::split(tokens, ids, boost::is_any_of(","));
+    for (auto& token : tokens) {
+      if (!token.empty()) {
+        ret.push_back(static_cast<T>(std::stoi(token)));
+      }
+    }
+    return ret;
+  }
+};
+
 #ifdef NETWORKX
 template <typename VDATA_T, typename EDATA_T>
 class ProjectSimpleFrame<gs::DynamicProjectedFragment<VDATA_T, EDATA_T>> {
@@ -59,6 +59,7 @@ limitations under the License.
 #include "apps/clustering/triangles.h"
 #include "apps/dfs/dfs.h"
 #include "apps/hits/hits.h"
+#include "apps/kcore/core_decomposition.h"
 #include "apps/kcore/kcore.h"
 #include "apps/kshell/kshell.h"
 #include "apps/sssp/sssp_average_length.h"
@@ -326,6 +327,13 @@ void Run() {
     CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
                                        FLAGS_datasource, fnum, spec,
                                        FLAGS_kcore_k);
+  } else if (name == "core_decomposition") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = CoreDecomposition<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec);
   } else if (name == "kshell") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -28,6 +28,7 @@ limitations under the License.
 
 #include "apps/property/sssp_property_append.h"
 #include "core/flags.h"
+#include "core/loader/append_only_arrow_fragment_compactor.h"
 #include "core/loader/append_only_arrow_fragment_loader.h"
 #include "core/loader/arrow_fragment_appender.h"
 
@@ -49,6 +50,8 @@ DEFINE_string(group_id, "grape_consumer", "kafka consumer group id.");
 DEFINE_int32(partition_num, 1, "kafka topic partition number.");
 DEFINE_int32(batch_size, 10000, "kafka consume messages batch size.");
 DEFINE_int64(time_interval, 10, "kafka consume time interval/s");
+DEFINE_int32(compact_interval, 0,
+             "compact the fragment every n batches, 0 to disable.");
 
 template <typename FRAG_T>
 void RunSSSP(std::shared_ptr<FRAG_T> fragment, const grape::CommSpec& comm_spec,
@@ -182,6 +185,21 @@ int main(int argc, char** argv) {
         std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
 
     gs::ArrowFragmentAppender<OID_T, VID_T> appender(comm_spec, fragment);
+    gs::AppendOnlyArrowFragmentCompactor<OID_T, VID_T> compactor(
+        client, comm_spec, fragment);
+    int64_t batch_num = 0;
+    auto finish_compaction = [&]() {
+      fragment = boost::leaf::try_handle_all(
+          [&] { return compactor.FinishCompaction(appender); },
+          [](const vineyard::GSError& e) {
+            LOG(FATAL) << e.error_msg;
+            return std::shared_ptr<GraphType>();
+          },
+          [](boost::leaf::error_info const& unmatched) {
+            LOG(FATAL) << "Unknown failure detected" << unmatched;
+            return std::shared_ptr<GraphType>();
+          });
+    };
 
     mkdir("/tmp/sssp_out", 0777);
 
@@ -194,24 +212,20 @@ int main(int argc, char** argv) {
     }
 
     bool is_coordinator = (comm_spec.worker_id() == grape::kCoordinatorRank);
-    std::unique_ptr<KafkaConsumer> consumer;
-
-    if (is_coordinator) {
-      consumer = std::make_unique<KafkaConsumer>(
-          comm_spec.worker_id(), FLAGS_broker_list, FLAGS_group_id,
-          FLAGS_input_topic, FLAGS_partition_num, FLAGS_time_interval,
-          FLAGS_batch_size);
-    }
+    // every worker consumes the partitions assigned to its worker id, and
+    // feeds its own slice of messages to the appender
+    auto consumer = std::make_unique<KafkaConsumer>(
+        comm_spec.worker_id(), FLAGS_broker_list, FLAGS_group_id,
+        FLAGS_input_topic, FLAGS_partition_num, FLAGS_time_interval,
+        FLAGS_batch_size);
 
     int64_t total_new_edges_num;
     do {
-      std::vector<std::vector<std::string>> label_vertex_messages;
-      std::vector<std::vector<std::string>> label_edge_messages;
-
-      if (is_coordinator) {
-        label_vertex_messages.resize(FLAGS_vlabel_num);
-        label_edge_messages.resize(FLAGS_elabel_num);
-
+      std::vector<std::vector<std::string>> label_vertex_messages(
+          FLAGS_vlabel_num);
+      std::vector<std::vector<std::string>> label_edge_messages(
+          FLAGS_elabel_num);
+      {
         std::vector<std::string> vertex_messages;
         std::vector<std::string> edge_messages;
 
@@ -258,6 +272,22 @@ int main(int argc, char** argv) {
                     << " Expend time: " << grape::GetCurrentTime() - begin;
         }
       }
+      // all workers start a compaction at the same batch, and each one
+      // switches to the compacted fragment once it is ready
+      if (FLAGS_compact_interval > 0 &&
+          ++batch_num % FLAGS_compact_interval == 0) {
+        if (compactor.InProgress()) {
+          finish_compaction();
+        }
+        boost::leaf::try_handle_all(
+            [&] { return compactor.StartCompaction(); },
+            [](const vineyard::GSError& e) { LOG(FATAL) << e.error_msg; },
+            [](boost::leaf::error_info const& unmatched) {
+              LOG(FATAL) << "Unknown failure detected" << unmatched;
+            });
+      } else if (compactor.Ready()) {
+        finish_compaction();
+      }
       {
         auto begin = grape::GetCurrentTime();
         RunSSSP<GraphType>(fragment, comm_spec, "/tmp/sssp_out",
@@ -0,0 +1,195 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+#include "grape/util.h"
+#include "vineyard/client/client.h"
+
+#include "core/loader/append_only_arrow_fragment_loader.h"
+#include "core/loader/arrow_fragment_appender.h"
+
+DEFINE_string(efile, "", "edge file prefix of the base graph");
+DEFINE_string(vfile, "", "vertex file prefix of the base graph");
+DEFINE_string(append_efile, "", "edges appended to label 0, with a header");
+DEFINE_string(append_vfile, "", "vertices appended to label 0, with a header");
+DEFINE_bool(directed, false, "input graph is directed or not.");
+DEFINE_string(vineyard_socket, "", "Unix domain socket path for vineyardd");
+
+using OID_T = vineyard::property_graph_types::OID_TYPE;
+using VID_T = vineyard::property_graph_types::VID_TYPE;
+using GraphType = gs::AppendOnlyArrowFragment<OID_T, VID_T>;
+
+// Lines of the file except the header.
+std::vector<std::string> read_lines(const std::string& path) {
+  std::vector<std::string> lines;
+  std::ifstream in(path);
+  std::string line;
+  bool first = true;
+  while (std::getline(in, line)) {
+    if (!first && !line.empty()) {
+      lines.push_back(line);
+    }
+    first = false;
+  }
+  return lines;
+}
+
+std::vector<OID_T> parse_oids(const std::string& line, size_t num) {
+  std::vector<OID_T> oids;
+  size_t begin = 0;
+  while (oids.size() < num) {
+    size_t end = line.find(',', begin);
+    oids.push_back(std::stoll(line.substr(begin, end - begin)));
+    begin = end + 1;
+  }
+  return oids;
+}
+
+bool has_extra_edge(std::shared_ptr<GraphType> fragment, OID_T src,
+                    OID_T dst) {
+  grape::Vertex<VID_T> v;
+  CHECK(fragment->GetInnerVertex(0, src, v));
+  for (auto& e : fragment->GetExtraOutgoingAdjList(v, 0)) {
+    if (fragment->GetId(e.neighbor()) == dst) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Every worker appends a round-robin slice of the lines, thus most vertices
+ * are appended by a worker other than the owner, and most edges connect
+ * vertices appended by other workers, whose gids and oids are resolved from
+ * the remote owners. Then every worker checks the vertices it owns and the
+ * outgoing edges of them against the full input.
+ */
+void Check(grape::CommSpec& comm_spec, std::shared_ptr<GraphType> fragment) {
+  auto v_lines = read_lines(FLAGS_append_vfile);
+  auto e_lines = read_lines(FLAGS_append_efile);
+  std::vector<std::vector<std::string>> vertex_messages(1), edge_messages(1);
+  for (size_t i = comm_spec.worker_id(); i < v_lines.size();
+       i += comm_spec.worker_num()) {
+    vertex_messages[0].push_back(v_lines[i]);
+  }
+  for (size_t i = comm_spec.worker_id(); i < e_lines.size();
+       i += comm_spec.worker_num()) {
+    edge_messages[0].push_back(e_lines[i]);
+  }
+
+  gs::ArrowFragmentAppender<OID_T, VID_T> appender(comm_spec, fragment);
+  int64_t new_edges_num = boost::leaf::try_handle_all(
+      [&] {
+        return appender.ExtendFragment(vertex_messages, edge_messages, false,
+                                       ',', FLAGS_directed);
+      },
+      [](const vineyard::GSError& e) {
+        LOG(FATAL) << e.error_msg;
+        return 0;
+      },
+      [](boost::leaf::error_info const& unmatched) {
+        LOG(FATAL) << "Unknown failure detected" << unmatched;
+        return 0;
+      });
+
+  grape::Vertex<VID_T> v;
+  size_t owned_vertices = 0;
+  for (auto& line : v_lines) {
+    OID_T oid = parse_oids(line, 1)[0];
+    if (fragment->GetInnerVertex(0, oid, v)) {
+      CHECK_EQ(fragment->GetId(v), oid);
+      ++owned_vertices;
+    }
+  }
+
+  size_t checked_edges = 0;
+  for (auto& line : e_lines) {
+    auto oids = parse_oids(line, 2);
+    if (fragment->GetInnerVertex(0, oids[0], v)) {
+      CHECK(has_extra_edge(fragment, oids[0], oids[1]))
+          << "missing edge " << oids[0] << " -> " << oids[1];
+      ++checked_edges;
+    }
+    if (!FLAGS_directed && fragment->GetInnerVertex(0, oids[1], v)) {
+      CHECK(has_extra_edge(fragment, oids[1], oids[0]))
+          << "missing edge " << oids[1] << " -> " << oids[0];
+      ++checked_edges;
+    }
+  }
+
+  LOG(INFO) << "[worker-" << comm_spec.worker_id() << "] owns "
+            << owned_vertices << " appended vertices, added " << new_edges_num
+            << " edges, checked " << checked_edges << " appended edges";
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage(
+      "Usage: mpiexec [mpi_opts] ./test_append_remote --vineyard_socket ... "
+      "--efile ... --vfile ... --append_efile ... --append_vfile ...");
+  if (argc == 1) {
+    google::ShowUsageWithFlagsRestrict(argv[0], "test_append_remote");
+    exit(1);
+  }
+
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::ShutDownCommandLineFlags();
+
+  google::InitGoogleLogging(argv[0]);
+  google::InstallFailureSignalHandler();
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+    if (comm_spec.worker_num() == 1) {
+      LOG(WARNING) << "No remote endpoint with a single worker.";
+    }
+
+    vineyard::Client client;
+    VINEYARD_CHECK_OK(client.Connect(FLAGS_vineyard_socket));
+
+    auto loader =
+        std::make_unique<gs::AppendOnlyArrowFragmentLoader<OID_T, VID_T>>(
+            client, comm_spec, 1, 1, FLAGS_efile, FLAGS_vfile,
+            FLAGS_directed);
+    vineyard::ObjectID fragment_id = boost::leaf::try_handle_all(
+        [&loader]() { return loader->LoadFragment(); },
+        [](const vineyard::GSError& e) {
+          LOG(FATAL) << "Failed to load fragment: " << e.error_msg;
+          return 0;
+        },
+        [](boost::leaf::error_info const& unmatched) {
+          LOG(FATAL) << "Unknown failure detected" << unmatched;
+          return 0;
+        });
+    MPI_Barrier(comm_spec.comm());
+
+    auto fragment =
+        std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
+    Check(comm_spec, fragment);
+
+    MPI_Barrier(comm_spec.comm());
+    LOG(INFO) << "Append with remote endpoints passed.";
+  }
+  grape::FinalizeMPIComm();
+  return 0;
+}
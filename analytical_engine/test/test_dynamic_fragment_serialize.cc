@@ -0,0 +1,141 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/stat.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "folly/dynamic.h"
+#include "folly/json.h"
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "grape/io/local_io_adaptor.h"
+
+#include "core/fragment/dynamic_fragment.h"
+
+using FragmentType = gs::DynamicFragment;
+using vertex_map_t = FragmentType::vertex_map_t;
+
+std::shared_ptr<FragmentType> make_fragment(const grape::CommSpec& comm_spec,
+                                            bool directed) {
+  auto vm_ptr = std::make_shared<vertex_map_t>(comm_spec);
+  vm_ptr->Init();
+  auto fragment = std::make_shared<FragmentType>(vm_ptr);
+  fragment->Init(comm_spec.fid(), directed, false);
+  return fragment;
+}
+
+// Every worker checks the nodes and edges it owns, and the gids of all
+// nodes, which are resolved by the deserialized vertex map.
+void check_fragment(const grape::CommSpec& comm_spec,
+                    std::shared_ptr<FragmentType> expected,
+                    std::shared_ptr<FragmentType> restored,
+                    const std::vector<folly::dynamic>& oids) {
+  CHECK_EQ(restored->fid(), expected->fid());
+  CHECK_EQ(restored->GetEdgeNum(), expected->GetEdgeNum());
+  CHECK_EQ(restored->GetInnerVerticesNum(), expected->GetInnerVerticesNum());
+
+  size_t owned = 0;
+  for (auto& oid : oids) {
+    FragmentType::vid_t expected_gid, restored_gid;
+    bool found = expected->GetVertexMap()->GetGid(oid, expected_gid);
+    CHECK_EQ(restored->GetVertexMap()->GetGid(oid, restored_gid), found)
+        << folly::toJson(oid);
+    if (found) {
+      CHECK_EQ(restored_gid, expected_gid) << folly::toJson(oid);
+    }
+
+    CHECK_EQ(restored->HasNode(oid), expected->HasNode(oid));
+    FragmentType::vertex_t u, v;
+    if (expected->GetInnerVertex(oid, u) && expected->HasNode(oid)) {
+      CHECK(restored->GetInnerVertex(oid, v));
+      CHECK(restored->GetData(v) == expected->GetData(u));
+      ++owned;
+    }
+
+    for (auto& dst : oids) {
+      folly::dynamic expected_data, restored_data;
+      bool has_edge = expected->GetEdgeData(oid, dst, expected_data);
+      CHECK_EQ(restored->GetEdgeData(oid, dst, restored_data), has_edge)
+          << folly::toJson(oid) << " -> " << folly::toJson(dst);
+      if (has_edge) {
+        CHECK(restored_data == expected_data);
+      }
+    }
+  }
+  LOG(INFO) << "[worker-" << comm_spec.worker_id() << "] checked " << owned
+            << " owned nodes";
+}
+
+void TestRoundTrip(const grape::CommSpec& comm_spec, const std::string& prefix,
+                   bool directed) {
+  // int and string oids, with and without data
+  std::vector<std::string> nodes = {
+      "[0, {\"w\": 1}]", "[1]", "[\"a\", {\"s\": \"x\"}]", "[\"b\"]",
+      "[2, {\"w\": 2.5}]", "[3]"};
+  std::vector<std::string> edges = {
+      "[0, 1, {\"weight\": 1}]", "[1, \"a\"]", "[\"a\", \"b\", {\"k\": \"v\"}]",
+      "[\"b\", 0]", "[2, 2, {\"weight\": 3}]", "[3, 0]"};
+  std::vector<std::string> deleted = {"[3]"};
+  std::vector<folly::dynamic> oids = {0, 1, "a", "b", 2, 3, 100, "absent"};
+
+  auto fragment = make_fragment(comm_spec, directed);
+  fragment->ModifyVertices(nodes, gs::rpc::NX_ADD_NODES, comm_spec);
+  fragment->ModifyEdges(edges, gs::rpc::NX_ADD_EDGES, comm_spec);
+  fragment->ModifyVertices(deleted, gs::rpc::NX_DEL_NODES, comm_spec);
+
+  if (comm_spec.worker_id() == 0) {
+    mkdir(prefix.c_str(), 0755);
+  }
+  MPI_Barrier(comm_spec.comm());
+  fragment->Serialize<grape::LocalIOAdaptor>(prefix);
+  MPI_Barrier(comm_spec.comm());
+
+  // the vertex map of the restored fragment is empty before Deserialize
+  auto vm_ptr = std::make_shared<vertex_map_t>(comm_spec);
+  auto restored = std::make_shared<FragmentType>(vm_ptr);
+  restored->Deserialize<grape::LocalIOAdaptor>(prefix, comm_spec.fid());
+  check_fragment(comm_spec, fragment, restored, oids);
+
+  MPI_Barrier(comm_spec.comm());
+  LOG(INFO) << "Round trip of " << (directed ? "directed" : "undirected")
+            << " fragment passed.";
+}
+
+int main(int argc, char** argv) {
+  std::string prefix = "/tmp/test_dynamic_fragment_serialize";
+  if (argc > 1) {
+    prefix = argv[1];
+  }
+
+  google::InitGoogleLogging("test_dynamic_fragment_serialize");
+  google::InstallFailureSignalHandler();
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+
+    TestRoundTrip(comm_spec, prefix + "_undirected", false);
+    TestRoundTrip(comm_spec, prefix + "_directed", true);
+  }
+  grape::FinalizeMPIComm();
+
+  google::ShutdownGoogleLogging();
+  return 0;
+}
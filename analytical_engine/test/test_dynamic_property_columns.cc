@@ -0,0 +1,256 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+
+#include <string>
+
+#include "folly/dynamic.h"
+#include "glog/logging.h"
+
+#include "core/fragment/dynamic_fragment.h"
+#include "core/fragment/dynamic_property_columns.h"
+
+using gs::dynamic_fragment_impl::AdjList;
+using gs::dynamic_fragment_impl::IPropertyColumn;
+using gs::dynamic_fragment_impl::NbrSpace;
+using gs::dynamic_fragment_impl::PropertyColumns;
+using gs::dynamic_fragment_impl::TypedPropertyView;
+
+void TestTypedColumns() {
+  PropertyColumns columns;
+  columns.Set(0, folly::dynamic::object("i", 1)("d", 0.5)("s", "a"));
+  columns.Set(2, folly::dynamic::object("i", 3)("d", 1.5)("s", "c"));
+
+  CHECK_EQ(columns.keys().size(), 3u);
+  CHECK(columns.GetTypedColumn<int64_t>("i") != nullptr);
+  CHECK(columns.GetTypedColumn<double>("d") != nullptr);
+  CHECK(columns.GetTypedColumn<std::string>("s") != nullptr);
+  CHECK(columns.GetTypedColumn<double>("i") == nullptr);
+  CHECK(columns.GetColumn("x") == nullptr);
+
+  CHECK_EQ(columns.GetTypedColumn<int64_t>("i")->at(2), 3);
+  CHECK_EQ(columns.GetTypedColumn<std::string>("s")->at(0), "a");
+  CHECK(columns.GetRow(0) ==
+        folly::dynamic(folly::dynamic::object("i", 1)("d", 0.5)("s", "a")));
+  // the row in between has no property
+  CHECK(columns.GetRow(1) == folly::dynamic(folly::dynamic::object));
+  CHECK(columns.GetProperty(1, "i").isNull());
+  CHECK(columns.GetProperty(0, "x").isNull());
+
+  // update merges, set replaces, reset clears
+  columns.Update(0, folly::dynamic::object("i", 10));
+  CHECK(columns.GetRow(0) ==
+        folly::dynamic(folly::dynamic::object("i", 10)("d", 0.5)("s", "a")));
+  columns.Set(0, folly::dynamic::object("d", 2.5));
+  CHECK(columns.GetRow(0) == folly::dynamic(folly::dynamic::object("d", 2.5)));
+  columns.Reset(2);
+  CHECK(columns.GetRow(2) == folly::dynamic(folly::dynamic::object));
+  LOG(INFO) << "Typed columns passed.";
+}
+
+void TestMixedAndFallback() {
+  PropertyColumns columns;
+  // ints mixed with doubles fall back to folly::dynamic, each value is read
+  // back as the type it is written
+  columns.SetProperty(0, "w", 1);
+  columns.SetProperty(1, "w", 0.5);
+  columns.SetProperty(2, "w", 2);
+  CHECK(columns.GetTypedColumn<int64_t>("w") == nullptr);
+  CHECK(columns.GetTypedColumn<double>("w") == nullptr);
+  CHECK_EQ(columns.GetColumn("w")->type(), folly::dynamic::Type::OBJECT);
+  CHECK(columns.GetProperty(0, "w").isInt());
+  CHECK_EQ(columns.GetProperty(0, "w").getInt(), 1);
+  CHECK(columns.GetProperty(1, "w").isDouble());
+  CHECK_EQ(columns.GetProperty(1, "w").getDouble(), 0.5);
+  CHECK(columns.GetProperty(2, "w").isInt());
+  CHECK_EQ(columns.GetProperty(2, "w").getInt(), 2);
+  CHECK(columns.GetRow(2) == folly::dynamic(folly::dynamic::object("w", 2)));
+
+  // a double column does not accept ints either
+  columns.SetProperty(0, "d", 0.5);
+  CHECK(columns.GetTypedColumn<double>("d") != nullptr);
+  columns.SetProperty(1, "d", 3);
+  CHECK(columns.GetTypedColumn<double>("d") == nullptr);
+  CHECK(columns.GetProperty(0, "d").isDouble());
+  CHECK(columns.GetProperty(1, "d").isInt());
+  CHECK_EQ(columns.GetProperty(1, "d").getInt(), 3);
+
+  // the typed view of a mixed column is not available, and the value is
+  // still projected to double through the owner
+  TypedPropertyView<double> w_view;
+  CHECK(!columns.GetTypedView("w", w_view));
+  CHECK_EQ(w_view.owner()->GetProperty(2, "w").asDouble(), 2.0);
+
+  // heterogeneous values fall back to folly::dynamic, values are kept
+  columns.SetProperty(0, "h", 1);
+  columns.SetProperty(1, "h", "b");
+  CHECK(columns.GetTypedColumn<int64_t>("h") == nullptr);
+  CHECK(columns.GetTypedColumn<std::string>("h") == nullptr);
+  CHECK_EQ(columns.GetColumn("h")->type(), folly::dynamic::Type::OBJECT);
+  CHECK(columns.GetProperty(0, "h") == folly::dynamic(1));
+  CHECK(columns.GetProperty(1, "h") == folly::dynamic("b"));
+
+  // non-scalar values are stored in the fallback column from the beginning
+  folly::dynamic arr = folly::dynamic::array(1, 2);
+  columns.SetProperty(2, "a", arr);
+  CHECK_EQ(columns.GetColumn("a")->type(), folly::dynamic::Type::OBJECT);
+  CHECK(columns.GetProperty(2, "a") == arr);
+  columns.Reset(2);
+  CHECK(columns.GetProperty(2, "a").isNull());
+
+  // a typed view is not available for a fallback column, but reads through
+  // the owner still work
+  TypedPropertyView<int64_t> view;
+  CHECK(!columns.GetTypedView("h", view));
+  CHECK(!view.Has(0));
+  CHECK(view.owner() == &columns);
+  LOG(INFO) << "Mixed values and fallback passed.";
+}
+
+void TestViewVersion() {
+  PropertyColumns columns;
+  columns.SetProperty(0, "w", 1.0);
+  TypedPropertyView<double> view;
+  CHECK(columns.GetTypedView("w", view));
+  CHECK(view.Has(0));
+  CHECK_EQ(view[0], 1.0);
+
+  // overwriting a row in place keeps the arrays, thus the view
+  columns.SetProperty(0, "w", 2.0);
+  CHECK(view.Has(0));
+  CHECK_EQ(view[0], 2.0);
+
+  // growing the column may reallocate the arrays, the view turns stale
+  columns.SetProperty(1000, "w", 3.0);
+  CHECK(!view.Has(0));
+  CHECK(columns.GetProperty(1000, "w") == folly::dynamic(3.0));
+  CHECK(columns.GetTypedView("w", view));
+  CHECK(view.Has(1000));
+  CHECK_EQ(view[1000], 3.0);
+
+  // so do conversions, new keys and clearing
+  size_t version = columns.version();
+  columns.SetProperty(0, "w", "x");
+  CHECK_GT(columns.version(), version);
+  CHECK(!view.Has(1000));
+  CHECK(!columns.GetTypedView("w", view));
+
+  columns.SetProperty(0, "v", 1.0);
+  TypedPropertyView<double> v_view;
+  CHECK(columns.GetTypedView("v", v_view));
+  columns.Clear();
+  CHECK(!v_view.Has(0));
+
+  // a copy is independent of the origin
+  columns.SetProperty(0, "w", 1.0);
+  PropertyColumns copied(columns);
+  copied.SetProperty(0, "w", 5.0);
+  CHECK(columns.GetProperty(0, "w") == folly::dynamic(1.0));
+  CHECK(copied.GetProperty(0, "w") == folly::dynamic(5.0));
+  LOG(INFO) << "View version passed.";
+}
+
+void TestEdgeRowReuse() {
+  NbrSpace<folly::dynamic> space;
+  auto loc = space.emplace(1, folly::dynamic::object("w", 1.0));
+  bool created = false;
+  space.emplace(loc, 2, folly::dynamic::object("w", 2.0), created);
+  CHECK(created);
+  space.emplace(loc, 3, folly::dynamic::object("w", 3.0), created);
+  CHECK(created);
+  space.Compact();
+
+  auto* nbr = space[loc].find(2);
+  CHECK(nbr != nullptr);
+  size_t eid = nbr->eid();
+  CHECK(space.GetData(*nbr) ==
+        folly::dynamic(folly::dynamic::object("w", 2.0)));
+
+  // updating an existing edge merges the data in place
+  space.emplace(loc, 2, folly::dynamic::object("c", "x"), created);
+  CHECK(!created);
+  CHECK(space.GetData(*space[loc].find(2)) ==
+        folly::dynamic(folly::dynamic::object("w", 2.0)("c", "x")));
+
+  // the row of a removed edge is reused by the next new edge, and it does not
+  // carry the properties of the removed one
+  size_t rows = space.edge_columns().GetColumn("w")->size();
+  CHECK_EQ(space.remove_edge(loc, 2), 1);
+  space.emplace(loc, 4, folly::dynamic::object("w", 4.0), created);
+  CHECK(created);
+  space.Compact();
+  nbr = space[loc].find(4);
+  CHECK(nbr != nullptr);
+  CHECK_EQ(nbr->eid(), eid);
+  CHECK(space.GetData(*nbr) ==
+        folly::dynamic(folly::dynamic::object("w", 4.0)));
+  CHECK_EQ(space.edge_columns().GetColumn("w")->size(), rows);
+
+  // the typed column is the storage of the projected property
+  TypedPropertyView<double> view;
+  CHECK(space.edge_columns().GetTypedView("w", view));
+  CHECK(view.Has(eid));
+  CHECK_EQ(view[eid], 4.0);
+  LOG(INFO) << "Edge row reuse passed.";
+}
+
+void TestAdjListRows() {
+  NbrSpace<folly::dynamic> space;
+  auto loc = space.emplace(1, folly::dynamic::object("w", 1.0)("c", "a"));
+  bool created = false;
+  space.emplace(loc, 2, folly::dynamic::object("w", 2.0), created);
+  space.emplace(loc, 3, folly::dynamic::object("c", "b"), created);
+  space.Compact();
+
+  // all neighbors are inner ones
+  AdjList<folly::dynamic> adj_list(1024, 1024, &space.edge_columns(),
+                                   space[loc].begin(), space[loc].end());
+  size_t count = 0;
+  for (auto& e : adj_list) {
+    auto expected = space.GetData(*space[loc].find(e.neighbor().GetValue()));
+    // a single property is read from the columns directly
+    CHECK(e.GetProperty("w") == expected.getDefault("w"));
+    CHECK(e.GetProperty("c") == expected.getDefault("c"));
+    // the row is materialized once per edge
+    CHECK(e.data() == expected);
+    CHECK_EQ(&e.data(), &e.get_data());
+    ++count;
+  }
+  CHECK_EQ(count, 3u);
+
+  // moving back to a visited edge reads the row of it again
+  auto iter = adj_list.begin();
+  auto first = iter->data();
+  ++iter;
+  CHECK(iter->data() != first);
+  --iter;
+  CHECK(iter->data() == first);
+  LOG(INFO) << "Adjacent list rows passed.";
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging("test_dynamic_property_columns");
+  google::InstallFailureSignalHandler();
+
+  TestTypedColumns();
+  TestMixedAndFallback();
+  TestViewVersion();
+  TestEdgeRowReuse();
+  TestAdjListRows();
+
+  google::ShutdownGoogleLogging();
+  return 0;
+}
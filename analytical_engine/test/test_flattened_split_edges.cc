@@ -0,0 +1,175 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "vineyard/client/client.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+
+#include "core/fragment/arrow_flattened_fragment.h"
+#include "core/loader/arrow_fragment_loader.h"
+
+using oid_t = vineyard::property_graph_types::OID_TYPE;
+using vid_t = vineyard::property_graph_types::VID_TYPE;
+using FragmentType = vineyard::ArrowFragment<oid_t, vid_t>;
+using FlattenedFragmentType =
+    gs::ArrowFlattenedFragment<oid_t, vid_t, grape::EmptyType,
+                               grape::EmptyType>;
+using vertex_t = FlattenedFragmentType::vertex_t;
+
+template <typename ADJ_LIST_T, typename FUNC_T>
+size_t check_neighbors(const FlattenedFragmentType& fragment,
+                       const ADJ_LIST_T& adj_list, const FUNC_T& expected) {
+  size_t count = 0;
+  for (auto& e : adj_list) {
+    CHECK(expected(e.neighbor()))
+        << "unexpected neighbor " << fragment.GetId(e.neighbor());
+    ++count;
+  }
+  CHECK_EQ(count, adj_list.Size());
+  return count;
+}
+
+// The inner, outer and per-fragment slices of the adjacent list of every
+// inner vertex must partition the whole list by the fragment of neighbors.
+size_t check_split_edges(const FlattenedFragmentType& fragment,
+                         bool outgoing) {
+  fid_t fid = fragment.fid();
+  size_t checked = 0;
+  for (auto v : fragment.InnerVertices()) {
+    auto all = outgoing ? fragment.GetOutgoingAdjList(v)
+                        : fragment.GetIncomingAdjList(v);
+    auto inner = outgoing ? fragment.GetOutgoingInnerVertexAdjList(v)
+                          : fragment.GetIncomingInnerVertexAdjList(v);
+    auto outer = outgoing ? fragment.GetOutgoingOuterVertexAdjList(v)
+                          : fragment.GetIncomingOuterVertexAdjList(v);
+    size_t inner_num = check_neighbors(fragment, inner, [&](vertex_t u) {
+      return fragment.IsInnerVertex(u);
+    });
+    size_t outer_num = check_neighbors(fragment, outer, [&](vertex_t u) {
+      return fragment.IsOuterVertex(u);
+    });
+    CHECK_EQ(inner_num + outer_num, all.Size());
+
+    size_t remote_num = 0;
+    for (fid_t i = 0; i < fragment.fnum(); ++i) {
+      if (i == fid) {
+        continue;
+      }
+      auto of_frag = outgoing ? fragment.GetOutgoingAdjList(v, i)
+                              : fragment.GetIncomingAdjList(v, i);
+      remote_num += check_neighbors(fragment, of_frag, [&](vertex_t u) {
+        return fragment.GetFragId(u) == i;
+      });
+    }
+    CHECK_EQ(remote_num, outer_num);
+    checked += all.Size();
+  }
+  return checked;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 6) {
+    printf(
+        "usage: ./test_flattened_split_edges <ipc_socket> <e_label_num> "
+        "<efiles...> <v_label_num> <vfiles...> [directed]\n");
+    return 1;
+  }
+  int index = 1;
+  std::string ipc_socket = std::string(argv[index++]);
+
+  int edge_label_num = atoi(argv[index++]);
+  std::vector<std::string> efiles;
+  for (int i = 0; i < edge_label_num; ++i) {
+    efiles.push_back(argv[index++]);
+  }
+
+  int vertex_label_num = atoi(argv[index++]);
+  std::vector<std::string> vfiles;
+  for (int i = 0; i < vertex_label_num; ++i) {
+    vfiles.push_back(argv[index++]);
+  }
+
+  int directed = 1;
+  if (argc > index) {
+    directed = atoi(argv[index]);
+  }
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+    if (comm_spec.fnum() < 2) {
+      LOG(WARNING) << "No outer vertices with a single fragment.";
+    }
+
+    vineyard::Client client;
+    VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+
+    auto loader = std::make_unique<gs::ArrowFragmentLoader<oid_t, vid_t>>(
+        client, comm_spec, efiles, vfiles, directed != 0);
+    vineyard::ObjectID fragment_id = boost::leaf::try_handle_all(
+        [&loader]() { return loader->LoadFragment(); },
+        [](const vineyard::GSError& e) {
+          LOG(FATAL) << e.error_msg;
+          return 0;
+        },
+        [](const boost::leaf::error_info& unmatched) {
+          LOG(FATAL) << "Unmatched error " << unmatched;
+          return 0;
+        });
+    MPI_Barrier(comm_spec.comm());
+
+    auto fragment =
+        std::dynamic_pointer_cast<FragmentType>(client.GetObject(fragment_id));
+
+    // every edge label reaches all vertex labels, thus the nbr units of an
+    // edge label are grouped by the label of neighbors rather than by the
+    // fragment of neighbors
+    std::vector<vineyard::property_graph_types::LABEL_ID_TYPE> v_labels,
+        e_labels;
+    std::vector<vineyard::property_graph_types::PROP_ID_TYPE> v_props,
+        e_props;
+    for (int i = 0; i < vertex_label_num; ++i) {
+      v_labels.push_back(i);
+      v_props.push_back(-1);
+    }
+    for (int i = 0; i < edge_label_num; ++i) {
+      e_labels.push_back(i);
+      e_props.push_back(-1);
+    }
+    auto flattened = FlattenedFragmentType::Project(fragment, v_labels,
+                                                    v_props, e_labels, e_props);
+    CHECK(flattened != nullptr);
+    flattened->PrepareToRunApp(
+        grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex, true);
+
+    size_t oe_num = check_split_edges(*flattened, true);
+    size_t ie_num = directed ? check_split_edges(*flattened, false) : 0;
+    LOG(INFO) << "[frag-" << flattened->fid() << "] checked " << oe_num
+              << " outgoing and " << ie_num << " incoming edges";
+
+    MPI_Barrier(comm_spec.comm());
+    LOG(INFO) << "Split edges of flattened fragment passed.";
+  }
+  grape::FinalizeMPIComm();
+  return 0;
+}
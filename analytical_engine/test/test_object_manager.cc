@@ -0,0 +1,72 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include "glog/logging.h"
+
+#include "core/object/gs_object.h"
+#include "core/object/object_manager.h"
+
+std::shared_ptr<gs::GSObject> make_object(const std::string& id) {
+  return std::make_shared<gs::GSObject>(id, gs::ObjectType::kFragmentWrapper);
+}
+
+void TestRemoveProjection() {
+  gs::ObjectManager manager;
+  auto projected = make_object("projected");
+  CHECK(manager.PutObject(make_object("graph")));
+  CHECK(manager.PutObject(projected));
+  manager.PutProjection("graph", "sig/0", projected);
+  CHECK(manager.GetProjection("graph", "sig/0") == projected);
+  CHECK(manager.GetProjection("graph", "sig/1") == nullptr);
+
+  // an alias of the cached projection does not evict it
+  CHECK(manager.PutObject(make_object("alias")));
+  CHECK(manager.RemoveObject("alias"));
+  CHECK(manager.GetProjection("graph", "sig/0") == projected);
+
+  // the removed projection must not be reused
+  CHECK(manager.RemoveObject("projected"));
+  CHECK(manager.GetProjection("graph", "sig/0") == nullptr);
+  CHECK(manager.HasObject("graph"));
+  LOG(INFO) << "Remove projection passed.";
+}
+
+void TestRemoveSource() {
+  gs::ObjectManager manager;
+  auto projected = make_object("projected");
+  CHECK(manager.PutObject(make_object("graph")));
+  CHECK(manager.PutObject(projected));
+  manager.PutProjection("graph", "sig/0", projected);
+
+  CHECK(manager.RemoveObject("graph"));
+  CHECK(manager.GetProjection("graph", "sig/0") == nullptr);
+  CHECK(manager.HasObject("projected"));
+  CHECK(!manager.RemoveObject("graph"));
+  LOG(INFO) << "Remove source passed.";
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging("test_object_manager");
+  google::InstallFailureSignalHandler();
+
+  TestRemoveProjection();
+  TestRemoveSource();
+
+  google::ShutdownGoogleLogging();
+  return 0;
+}
@@ -0,0 +1,161 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "vineyard/client/client.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+
+#include "core/fragment/arrow_projected_fragment.h"
+#include "core/loader/arrow_fragment_loader.h"
+
+#define OID_TYPE int64_t
+#define VID_TYPE uint64_t
+
+template class vineyard::BasicArrowVertexMapBuilder<OID_TYPE, VID_TYPE>;
+template class vineyard::ArrowVertexMap<OID_TYPE, VID_TYPE>;
+template class vineyard::ArrowVertexMapBuilder<OID_TYPE, VID_TYPE>;
+template class gs::ArrowProjectedVertexMap<OID_TYPE, VID_TYPE>;
+template class gs::ArrowProjectedFragment<OID_TYPE, VID_TYPE, int64_t,
+                                          int64_t>;
+
+using FragmentType = vineyard::ArrowFragment<OID_TYPE, VID_TYPE>;
+using ProjectedFragmentType =
+    gs::ArrowProjectedFragment<OID_TYPE, VID_TYPE, int64_t, int64_t>;
+
+// The edge data, either inlined or read from the edge table, must be the same
+// as the edge table looked up by eid, both in forward and backward traversal.
+template <typename ADJ_LIST_T>
+size_t check_adj_list(const ADJ_LIST_T& adj_list, const int64_t* edata) {
+  size_t count = 0;
+  for (auto& e : adj_list) {
+    CHECK_EQ(e.get_data(), edata[e.edge_id()]);
+    CHECK_EQ(e.data(), edata[e.edge_id()]);
+    ++count;
+  }
+  CHECK_EQ(count, adj_list.Size());
+  if (adj_list.NotEmpty()) {
+    auto begin = adj_list.begin();
+    auto iter = adj_list.end();
+    do {
+      --iter;
+      CHECK_EQ(iter->get_data(), edata[iter->edge_id()]);
+    } while (iter != begin);
+  }
+  return count;
+}
+
+void check_fragment(std::shared_ptr<FragmentType> fragment,
+                    std::shared_ptr<ProjectedFragmentType> projected) {
+  auto table = fragment->edge_data_table(0);
+  const int64_t* edata = NULL;
+  if (table->num_rows() != 0) {
+    edata = std::dynamic_pointer_cast<arrow::Int64Array>(
+                table->column(0)->chunk(0))
+                ->raw_values();
+  }
+
+  size_t oe_num = 0, ie_num = 0;
+  for (auto v : projected->InnerVertices()) {
+    oe_num += check_adj_list(projected->GetOutgoingAdjList(v), edata);
+    ie_num += check_adj_list(projected->GetIncomingAdjList(v), edata);
+  }
+  LOG(INFO) << "[frag-" << projected->fid() << "] checked " << oe_num
+            << " outgoing and " << ie_num << " incoming edges";
+}
+
+int main(int argc, char** argv) {
+  if (argc < 6) {
+    printf(
+        "usage: ./test_project_inline_edata <e_label_num> <efile...> "
+        "<v_label_num> <vfiles...> "
+        "[directed]\n");
+    return 1;
+  }
+  int index = 1;
+  int edge_label_num = atoi(argv[index++]);
+  std::vector<std::string> efiles;
+  for (int i = 0; i < edge_label_num; ++i) {
+    efiles.push_back(argv[index++]);
+  }
+
+  int vertex_label_num = atoi(argv[index++]);
+  std::vector<std::string> vfiles;
+  for (int i = 0; i < vertex_label_num; ++i) {
+    vfiles.push_back(argv[index++]);
+  }
+
+  int directed = 1;
+  if (argc > index) {
+    directed = atoi(argv[index]);
+  }
+
+  grape::InitMPIComm();
+  grape::CommSpec comm_spec;
+  comm_spec.Init(MPI_COMM_WORLD);
+
+  vineyard::Client& client = vineyard::Client::Default();
+
+  using oid_t = OID_TYPE;
+  using vid_t = VID_TYPE;
+
+  auto loader = std::make_unique<vineyard::ArrowFragmentLoader<oid_t, vid_t>>(
+      client, comm_spec, efiles, vfiles, directed != 0);
+
+  int exit_code = boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<int> {
+        BOOST_LEAF_AUTO(obj_id, loader->LoadFragment());
+        LOG(INFO) << "got fragment: " << obj_id;
+
+        std::shared_ptr<FragmentType> fragment =
+            std::dynamic_pointer_cast<FragmentType>(client.GetObject(obj_id));
+        for (bool inline_edata : {false, true}) {
+          std::shared_ptr<ProjectedFragmentType> projected_fragment =
+              ProjectedFragmentType::Project(fragment, "0", "0", "0", "0",
+                                             inline_edata);
+          CHECK(projected_fragment != nullptr);
+          CHECK_EQ(
+              projected_fragment->meta().GetKeyValue<int>("inline_edata"),
+              inline_edata ? 1 : 0);
+          CHECK_EQ(projected_fragment->meta().HasKey("oe_edata"),
+                   inline_edata);
+          check_fragment(fragment, projected_fragment);
+
+          // the fragment constructed from the metadata reads the sealed
+          // arrays
+          auto reloaded = std::dynamic_pointer_cast<ProjectedFragmentType>(
+              client.GetObject(projected_fragment->id()));
+          check_fragment(fragment, reloaded);
+        }
+
+        MPI_Barrier(comm_spec.comm());
+        LOG(INFO) << "Inline edge data passed.";
+        return 0;
+      },
+      [](const vineyard::GSError& error) {
+        std::cerr << error.error_msg;
+        return 1;
+      },
+      [](const boost::leaf::error_info& e) { return 1; });
+
+  grape::FinalizeMPIComm();
+  return exit_code;
+}
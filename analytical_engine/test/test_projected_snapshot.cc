@@ -0,0 +1,144 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "folly/dynamic.h"
+#include "folly/json.h"
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+
+#include "core/fragment/dynamic_fragment.h"
+#include "core/fragment/dynamic_projected_fragment.h"
+
+using FragmentType = gs::DynamicFragment;
+using ProjectedFragmentType = gs::DynamicProjectedFragment<int64_t, double>;
+using edge_map_t = std::map<std::pair<int64_t, int64_t>, double>;
+
+constexpr int64_t kNodeNum = 10000;
+
+std::string edge_line(int64_t src, int64_t dst, double w) {
+  auto data = folly::dynamic::object("w", w);
+  return folly::toJson(folly::dynamic::array(src, dst, data));
+}
+
+// The outgoing edges of the inner vertices must be the expected ones, either
+// read from the snapshot or projected on the fly.
+void check_edges(std::shared_ptr<ProjectedFragmentType> projected,
+                 const edge_map_t& expected) {
+  size_t inner_edges = 0;
+  for (auto& pair : expected) {
+    ProjectedFragmentType::vertex_t u;
+    if (projected->GetInnerVertex(folly::dynamic(pair.first.first), u)) {
+      ++inner_edges;
+    }
+  }
+  size_t checked = 0;
+  for (auto u : projected->InnerVertices()) {
+    int64_t src = projected->GetId(u).asInt();
+    for (auto& e : projected->GetOutgoingAdjList(u)) {
+      int64_t dst = projected->GetId(e.neighbor()).asInt();
+      auto iter = expected.find(std::make_pair(src, dst));
+      CHECK(iter != expected.end()) << src << " -> " << dst;
+      CHECK_EQ(e.data(), iter->second) << src << " -> " << dst;
+      ++checked;
+    }
+  }
+  CHECK_EQ(checked, inner_edges);
+}
+
+void TestSnapshotVersion(const grape::CommSpec& comm_spec) {
+  auto vm_ptr = std::make_shared<FragmentType::vertex_map_t>(comm_spec);
+  vm_ptr->Init();
+  auto fragment = std::make_shared<FragmentType>(vm_ptr);
+  fragment->Init(comm_spec.fid(), true, false);
+
+  // enough neighbor lists to build the snapshot with multiple threads
+  std::vector<std::string> nodes, edges;
+  edge_map_t expected;
+  for (int64_t i = 0; i < kNodeNum; ++i) {
+    nodes.push_back(folly::toJson(
+        folly::dynamic::array(i, folly::dynamic::object("v", i))));
+    for (int64_t step : {1, 7, 13}) {
+      int64_t dst = (i * step + 5) % kNodeNum;
+      double w = i + 0.5;
+      edges.push_back(edge_line(i, dst, w));
+      expected[std::make_pair(i, dst)] = w;
+    }
+  }
+  fragment->ModifyVertices(nodes, gs::rpc::NX_ADD_NODES, comm_spec);
+  fragment->ModifyEdges(edges, gs::rpc::NX_ADD_EDGES, comm_spec);
+
+  auto projected = ProjectedFragmentType::Project(fragment, "v", "w");
+  auto strategy = grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  projected->PrepareToRunApp(strategy, true);
+  CHECK(projected->snapshot().IsValid(fragment->version()));
+  check_edges(projected, expected);
+
+  // the snapshot is stale once the edges are modified, the getters project
+  // the neighbors on the fly until the next run
+  std::vector<std::string> updated;
+  for (int64_t i = 0; i < kNodeNum; i += 3) {
+    int64_t dst = (i + 5) % kNodeNum;
+    updated.push_back(edge_line(i, dst, -1.0 * i));
+    expected[std::make_pair(i, dst)] = -1.0 * i;
+  }
+  fragment->ModifyEdges(updated, gs::rpc::NX_UPDATE_EDGES, comm_spec);
+  CHECK(!projected->snapshot().IsValid(fragment->version()));
+  check_edges(projected, expected);
+
+  std::vector<std::string> added = {edge_line(0, kNodeNum - 1, 42.0)};
+  expected[std::make_pair(0, kNodeNum - 1)] = 42.0;
+  fragment->ModifyEdges(added, gs::rpc::NX_ADD_EDGES, comm_spec);
+  fragment->PrepareToRunApp(strategy, true);
+  check_edges(projected, expected);
+
+  // rebuilt for the new version
+  projected->PrepareToRunApp(strategy, true);
+  CHECK(projected->snapshot().IsValid(fragment->version()));
+  check_edges(projected, expected);
+
+  // released when unloaded, and rebuilt by the next run
+  projected->ReleaseSnapshot();
+  CHECK(!projected->snapshot().IsValid(fragment->version()));
+  check_edges(projected, expected);
+  projected->PrepareToRunApp(strategy, true);
+  CHECK(projected->snapshot().IsValid(fragment->version()));
+  check_edges(projected, expected);
+
+  MPI_Barrier(comm_spec.comm());
+  LOG(INFO) << "Snapshot version passed.";
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging("test_projected_snapshot");
+  google::InstallFailureSignalHandler();
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+    TestSnapshotVersion(comm_spec);
+  }
+  grape::FinalizeMPIComm();
+
+  google::ShutdownGoogleLogging();
+  return 0;
+}
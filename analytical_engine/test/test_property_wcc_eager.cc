@@ -0,0 +1,139 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "vineyard/client/client.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+
+#include "apps/property/wcc_property.h"
+#include "benchmarks/apps/wcc/property_wcc.h"
+#include "core/loader/arrow_fragment_loader.h"
+
+using FragmentType =
+    vineyard::ArrowFragment<vineyard::property_graph_types::OID_TYPE,
+                            vineyard::property_graph_types::VID_TYPE>;
+
+// Both apps label a component with the minimum gid of it.
+std::string RunReference(std::shared_ptr<FragmentType> fragment,
+                         const grape::CommSpec& comm_spec) {
+  using AppType = gs::WCCProperty<FragmentType>;
+  auto app = std::make_shared<AppType>();
+  auto worker = AppType::CreateWorker(app, fragment);
+  auto spec = grape::DefaultParallelEngineSpec();
+  worker->Init(comm_spec, spec);
+  worker->Query();
+  std::ostringstream os;
+  worker->Output(os);
+  worker->Finalize();
+  return os.str();
+}
+
+// The messages of the other workers are consumed in the middle of a round,
+// and the result must not depend on when they arrive.
+std::string RunEager(std::shared_ptr<FragmentType> fragment,
+                     const grape::CommSpec& comm_spec) {
+  using AppType = gs::benchmarks::PropertyWCC<FragmentType>;
+  static_assert(AppType::order_insensitive_messages,
+                "PropertyWCC is expected to process messages eagerly");
+  auto app = std::make_shared<AppType>();
+  auto worker = AppType::CreateWorker(app, fragment);
+  auto spec = grape::DefaultParallelEngineSpec();
+  worker->Init(comm_spec, spec);
+  worker->Query();
+  std::ostringstream os;
+  worker->Output(os);
+
+  auto& stat = worker->GetMessageStat();
+  CHECK_LE(stat.early_buffers, stat.recv_buffers);
+  LOG(INFO) << "[worker-" << comm_spec.worker_id() << "] received "
+            << stat.recv_buffers << " buffers, " << stat.early_buffers
+            << " of them early";
+  worker->Finalize();
+  return os.str();
+}
+
+int main(int argc, char** argv) {
+  if (argc < 6) {
+    printf(
+        "usage: ./test_property_wcc_eager <e_label_num> <efile...> "
+        "<v_label_num> <vfiles...> "
+        "[directed]\n");
+    return 1;
+  }
+  int index = 1;
+  int edge_label_num = atoi(argv[index++]);
+  std::vector<std::string> efiles;
+  for (int i = 0; i < edge_label_num; ++i) {
+    efiles.push_back(argv[index++]);
+  }
+
+  int vertex_label_num = atoi(argv[index++]);
+  std::vector<std::string> vfiles;
+  for (int i = 0; i < vertex_label_num; ++i) {
+    vfiles.push_back(argv[index++]);
+  }
+  // PropertyWCC runs on the first labels only
+  CHECK_EQ(edge_label_num, 1);
+  CHECK_EQ(vertex_label_num, 1);
+
+  int directed = 1;
+  if (argc > index) {
+    directed = atoi(argv[index]);
+  }
+
+  grape::InitMPIComm();
+  grape::CommSpec comm_spec;
+  comm_spec.Init(MPI_COMM_WORLD);
+
+  vineyard::Client& client = vineyard::Client::Default();
+
+  auto loader = std::make_unique<
+      vineyard::ArrowFragmentLoader<vineyard::property_graph_types::OID_TYPE,
+                                    vineyard::property_graph_types::VID_TYPE>>(
+      client, comm_spec, efiles, vfiles, directed != 0);
+
+  int exit_code = boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<int> {
+        BOOST_LEAF_AUTO(obj_id, loader->LoadFragment());
+        LOG(INFO) << "got fragment: " << obj_id;
+
+        std::shared_ptr<FragmentType> fragment =
+            std::dynamic_pointer_cast<FragmentType>(client.GetObject(obj_id));
+        std::string expected = RunReference(fragment, comm_spec);
+        std::string actual = RunEager(fragment, comm_spec);
+        CHECK(actual == expected)
+            << "components of fragment " << fragment->fid() << " differ";
+
+        MPI_Barrier(comm_spec.comm());
+        LOG(INFO) << "Eager WCC passed.";
+        return 0;
+      },
+      [](const vineyard::GSError& error) {
+        std::cerr << error.error_msg;
+        return 1;
+      },
+      [](const boost::leaf::error_info& e) { return 1; });
+
+  grape::FinalizeMPIComm();
+  return exit_code;
+}
@@ -322,6 +322,7 @@ def compile_graph_frame(workspace: str, library_name, attr: dict, engine_config:
         cmake_commands += ["-DPROPERTY_GRAPH_FRAME=True"]
     elif (
         graph_type == graph_def_pb2.ARROW_PROJECTED
+        or graph_type == graph_def_pb2.ARROW_FLATTENED
         or graph_type == graph_def_pb2.DYNAMIC_PROJECTED
     ):
         cmake_commands += ["-DPROJECT_FRAME=True"]
@@ -718,6 +719,12 @@ def _pre_process_for_project_to_simple_op(op, op_result_pool, key_to_op, **kwarg
     schema = GraphSchema()
     schema.from_graph_def(r.graph_def)
     graph_name = r.graph_def.key
+    if schema.vertex_label_num > 1 or schema.edge_label_num > 1:
+        # edge data of flattened graphs are always read by eid
+        if types_pb2.INLINE_EDGE_DATA in op.attr:
+            del op.attr[types_pb2.INLINE_EDGE_DATA]
+        _pre_process_for_flatten_to_simple_op(op, schema, graph_name)
+        return
     check_argument(
         schema.vertex_label_num == 1,
         "Cannot project to simple, vertex label number is not one.",
@@ -743,6 +750,13 @@ def _pre_process_for_project_to_simple_op(op, op_result_pool, key_to_op, **kwarg
     e_prop_id, edata_type = (e_props[0].id, e_props[0].type) if e_props else (-1, None)
     oid_type = schema.oid_type
     vid_type = schema.vid_type
+    # only fixed-width edge data can be inlined, drop the flag otherwise thus
+    # the projection is shared with the ones without it
+    if types_pb2.INLINE_EDGE_DATA in op.attr and edata_type in (
+        None,
+        graph_def_pb2.STRING,
+    ):
+        del op.attr[types_pb2.INLINE_EDGE_DATA]
     op.attr[types_pb2.GRAPH_NAME].CopyFrom(
         attr_value_pb2.AttrValue(s=graph_name.encode("utf-8"))
     )
@@ -767,6 +781,72 @@ def _pre_process_for_project_to_simple_op(op, op_result_pool, key_to_op, **kwarg
     )
 
 
+def _pre_process_for_flatten_to_simple_op(op, schema, graph_name):
+    # merge all labels into one simple graph, the data of a label is the
+    # selected property, or its only property if none is selected. Labels
+    # without such a property have default data, and the properties used
+    # by vertex (edge) labels must share the same type.
+    def _get_label_props(labels, get_props, get_label_id, selected):
+        label_ids, prop_ids, data_types = [], [], set()
+        for label in labels:
+            props = get_props(label)
+            if selected is not None:
+                props = [prop for prop in props if prop.name == selected]
+            check_argument(
+                len(props) <= 1,
+                f"Cannot project to simple, label {label} has more than one "
+                "property, select the one to use.",
+            )
+            label_ids.append(str(get_label_id(label)))
+            prop_ids.append(str(props[0].id) if props else "-1")
+            if props:
+                data_types.add(props[0].type)
+        check_argument(
+            len(data_types) <= 1,
+            "Cannot project to simple, properties of labels have different types.",
+        )
+        data_type = data_types.pop() if data_types else None
+        return ",".join(label_ids), ",".join(prop_ids), data_type
+
+    def _get_selected(key):
+        return op.attr[key].s.decode("utf-8") if key in op.attr else None
+
+    v_label_ids, v_prop_ids, vdata_type = _get_label_props(
+        schema.vertex_labels,
+        schema.get_vertex_properties,
+        schema.get_vertex_label_id,
+        _get_selected(types_pb2.V_PROP_KEY),
+    )
+    e_label_ids, e_prop_ids, edata_type = _get_label_props(
+        schema.edge_labels,
+        schema.get_edge_properties,
+        schema.get_edge_label_id,
+        _get_selected(types_pb2.E_PROP_KEY),
+    )
+    op.attr[types_pb2.GRAPH_NAME].CopyFrom(
+        attr_value_pb2.AttrValue(s=graph_name.encode("utf-8"))
+    )
+    op.attr[types_pb2.GRAPH_TYPE].CopyFrom(
+        utils.graph_type_to_attr(graph_def_pb2.ARROW_FLATTENED)
+    )
+    op.attr[types_pb2.V_LABEL_IDS].CopyFrom(utils.s_to_attr(v_label_ids))
+    op.attr[types_pb2.V_PROP_IDS].CopyFrom(utils.s_to_attr(v_prop_ids))
+    op.attr[types_pb2.E_LABEL_IDS].CopyFrom(utils.s_to_attr(e_label_ids))
+    op.attr[types_pb2.E_PROP_IDS].CopyFrom(utils.s_to_attr(e_prop_ids))
+    op.attr[types_pb2.OID_TYPE].CopyFrom(
+        utils.s_to_attr(utils.data_type_to_cpp(schema.oid_type))
+    )
+    op.attr[types_pb2.VID_TYPE].CopyFrom(
+        utils.s_to_attr(utils.data_type_to_cpp(schema.vid_type))
+    )
+    op.attr[types_pb2.V_DATA_TYPE].CopyFrom(
+        utils.s_to_attr(utils.data_type_to_cpp(vdata_type))
+    )
+    op.attr[types_pb2.E_DATA_TYPE].CopyFrom(
+        utils.s_to_attr(utils.data_type_to_cpp(edata_type))
+    )
+
+
 def _pre_process_for_project_op(op, op_result_pool, key_to_op, **kwargs):
     def _get_all_v_props_id(schema, label):
         props = schema.get_vertex_properties(label)
@@ -1095,6 +1175,10 @@ GRAPH_HEADER_MAP = {
         "gs::ArrowProjectedFragment",
         "core/fragment/arrow_projected_fragment.h",
     ),
+    graph_def_pb2.ARROW_FLATTENED: (
+        "gs::ArrowFlattenedFragment",
+        "core/fragment/arrow_flattened_fragment.h",
+    ),
     graph_def_pb2.DYNAMIC_PROPERTY: (
         "gs::DynamicFragment",
         "core/fragment/dynamic_fragment.h",
@@ -1115,6 +1199,7 @@ def _codegen_graph_info(attr):
         )
     elif graph_class in (
         "gs::ArrowProjectedFragment",
+        "gs::ArrowFlattenedFragment",
         "grape::ImmutableEdgecutFragment",
     ):
         # in a format of gs::ArrowProjectedFragment<int64_t, uint32_t, double, double>
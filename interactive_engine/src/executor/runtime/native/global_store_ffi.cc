@@ -56,6 +56,11 @@ int get_vertices_next(GetVertexIterator iter, Vertex* v_out) {
                                       v_out);
 }
 
+int get_vertices_next_batch(GetVertexIterator iter, Vertex* v_out, int count) {
+  return htap_impl::get_vertices_next_batch(
+      (htap_impl::GetVertexIteratorImpl*)iter, v_out, count);
+}
+
 GetAllVerticesIterator get_all_vertices(GraphHandle graph,
                                         PartitionId partition_id,
                                         LabelId* labels, int labels_count,
@@ -92,6 +97,12 @@ int get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out) {
       (htap_impl::GetAllVerticesIteratorImpl*)iter, v_out);
 }
 
+int get_all_vertices_next_batch(GetAllVerticesIterator iter, Vertex* v_out,
+                                int count) {
+  return htap_impl::get_all_vertices_next_batch(
+      (htap_impl::GetAllVerticesIteratorImpl*)iter, v_out, count);
+}
+
 VertexId get_vertex_id(GraphHandle graph, Vertex v) { return (VertexId)v; }
 
 OuterId get_outer_id(GraphHandle graph, Vertex v) {
@@ -132,6 +143,12 @@ int get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
   return r;
 }
 
+int get_vertex_property_batch(GraphHandle graph, Vertex* vs, int count,
+                              PropertyId id, Property* p_out) {
+  return htap_impl::get_vertex_property_batch(
+      static_cast<htap_impl::GraphHandleImpl*>(graph), vs, count, id, p_out);
+}
+
 PropertiesIterator get_vertex_properties(GraphHandle graph, Vertex v) {
   PropertiesIterator ret = malloc(sizeof(htap_impl::PropertiesIteratorImpl));
   htap_impl::GraphHandleImpl* handle =
@@ -189,6 +206,11 @@ int out_edge_next(OutEdgeIterator iter, struct Edge* e_out) {
   return htap_impl::out_edge_next((htap_impl::EdgeIteratorImpl*)iter, e_out);
 }
 
+int out_edge_next_batch(OutEdgeIterator iter, struct Edge* e_out, int count) {
+  return htap_impl::out_edge_next_batch((htap_impl::EdgeIteratorImpl*)iter,
+                                        e_out, count);
+}
+
 InEdgeIterator get_in_edges(GraphHandle graph, PartitionId partition_id,
                             VertexId dst_id, LabelId* labels, int labels_count,
                             int64_t limit) {
@@ -235,6 +257,11 @@ int in_edge_next(InEdgeIterator iter, struct Edge* e_out) {
   return htap_impl::in_edge_next((htap_impl::EdgeIteratorImpl*)iter, e_out);
 }
 
+int in_edge_next_batch(InEdgeIterator iter, struct Edge* e_out, int count) {
+  return htap_impl::in_edge_next_batch((htap_impl::EdgeIteratorImpl*)iter,
+                                       e_out, count);
+}
+
 GetAllEdgesIterator get_all_edges(GraphHandle graph, PartitionId partition_id,
                                   LabelId* labels, int labels_count,
                                   int64_t limit) {
@@ -280,6 +307,12 @@ int get_all_edges_next(GetAllEdgesIterator iter, struct Edge* e_out) {
       (htap_impl::GetAllEdgesIteratorImpl*)iter, e_out);
 }
 
+int get_all_edges_next_batch(GetAllEdgesIterator iter, struct Edge* e_out,
+                             int count) {
+  return htap_impl::get_all_edges_next_batch(
+      (htap_impl::GetAllEdgesIteratorImpl*)iter, e_out, count);
+}
+
 VertexId get_edge_src_id(GraphHandle graph, struct Edge* e) { return e->src; }
 
 VertexId get_edge_dst_id(GraphHandle graph, struct Edge* e) { return e->dst; }
@@ -369,6 +402,12 @@ int get_edge_property(GraphHandle graph, struct Edge* e, PropertyId id,
   return r;
 }
 
+int get_edge_property_batch(GraphHandle graph, struct Edge* es, int count,
+                            PropertyId id, Property* p_out) {
+  return htap_impl::get_edge_property_batch(
+      static_cast<htap_impl::GraphHandleImpl*>(graph), es, count, id, p_out);
+}
+
 PropertiesIterator get_edge_properties(GraphHandle graph, struct Edge* e) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
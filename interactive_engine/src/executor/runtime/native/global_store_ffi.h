@@ -97,6 +97,10 @@ void free_get_vertex_iterator(GetVertexIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Vertex
 int get_vertices_next(GetVertexIterator iter, Vertex* v_out);
 
+// 从迭代器取出至多count个元素，填入调用者提供的v_out数组
+// 返回值是实际取出的元素个数，返回0表示迭代结束
+int get_vertices_next_batch(GetVertexIterator iter, Vertex* v_out, int count);
+
 // 查询某个partition内部的所有相关label的点
 // labels是待查询label的列表
 // labels_count表示这个label列表的长度
@@ -114,6 +118,11 @@ void free_get_all_vertices_iterator(GetAllVerticesIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Vertex
 int get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out);
 
+// 从迭代器取出至多count个元素，填入调用者提供的v_out数组
+// 返回值是实际取出的元素个数，返回0表示迭代结束
+int get_all_vertices_next_batch(GetAllVerticesIterator iter, Vertex* v_out,
+                                int count);
+
 // 获取点id
 VertexId get_vertex_id(GraphHandle graph, Vertex v);
 
@@ -128,6 +137,13 @@ LabelId get_vertex_label(GraphHandle graph, Vertex v);
 int get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
                         struct Property* p_out);
 
+// 批量获取count个点的同一个属性，第i个结果写入p_out[i]
+// 属性列的类型在获取图句柄时已解析，读取时不再做类型转换和判断
+// 点不存在或者没有该属性时，p_out[i].type为INVALID
+// 返回值是成功获取的属性个数
+int get_vertex_property_batch(GraphHandle graph, Vertex* vs, int count,
+                              PropertyId id, struct Property* p_out);
+
 // 获取点的属性列表，返回一个迭代器
 PropertiesIterator get_vertex_properties(GraphHandle graph, Vertex v);
 
@@ -148,6 +164,10 @@ void free_out_edge_iterator(OutEdgeIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int out_edge_next(OutEdgeIterator iter, struct Edge* e_out);
 
+// 从迭代器取出至多count个元素，填入调用者提供的e_out数组
+// 返回值是实际取出的元素个数，返回0表示迭代结束
+int out_edge_next_batch(OutEdgeIterator iter, struct Edge* e_out, int count);
+
 // 查询某个partition内的点的入边
 // src_ids是待查询的点id列表
 // labels是label列表，表示查询这些点的这些label的出边
@@ -164,6 +184,10 @@ void free_in_edge_iterator(InEdgeIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int in_edge_next(InEdgeIterator iter, struct Edge* e_out);
 
+// 从迭代器取出至多count个元素，填入调用者提供的e_out数组
+// 返回值是实际取出的元素个数，返回0表示迭代结束
+int in_edge_next_batch(InEdgeIterator iter, struct Edge* e_out, int count);
+
 // 查询某个partition内某些label的边数据
 // labels是待查询的label列表
 // labels_count表示label列表的长度
@@ -180,6 +204,11 @@ void free_get_all_edges_iterator(GetAllEdgesIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int get_all_edges_next(GetAllEdgesIterator iter, struct Edge* e_out);
 
+// 从迭代器取出至多count个元素，填入调用者提供的e_out数组
+// 返回值是实际取出的元素个数，返回0表示迭代结束
+int get_all_edges_next_batch(GetAllEdgesIterator iter, struct Edge* e_out,
+                             int count);
+
 // 从edge对象获取起点id
 VertexId get_edge_src_id(GraphHandle graph, struct Edge* e);
 
@@ -202,6 +231,12 @@ LabelId get_edge_label(GraphHandle graph, struct Edge* e);
 int get_edge_property(GraphHandle graph, struct Edge*, PropertyId id,
                       struct Property* p_out);
 
+// 批量获取count条边的同一个属性，第i个结果写入p_out[i]
+// 边不存在或者没有该属性时，p_out[i].type为INVALID
+// 返回值是成功获取的属性个数
+int get_edge_property_batch(GraphHandle graph, struct Edge* es, int count,
+                            PropertyId id, struct Property* p_out);
+
 // 获取边的属性列表，返回一个迭代器
 PropertiesIterator get_edge_properties(GraphHandle graph, struct Edge*);
 
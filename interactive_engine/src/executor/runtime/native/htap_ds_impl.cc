@@ -15,6 +15,7 @@
  */
 #include "htap_ds_impl.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <string>
@@ -25,6 +26,152 @@
 
 namespace htap_impl {
 
+static void init_property_column(arrow::Table* table, PropertyId col_id,
+                                 PropertyColumn* column) {
+  column->type = INVALID;
+  column->array = NULL;
+  column->values = NULL;
+  auto chunked_array = table->column(col_id);
+  if (chunked_array->num_chunks() == 0) {
+    return;
+  }
+  const arrow::Array* array = chunked_array->chunk(0).get();
+  column->array = array;
+  switch (table->field(col_id)->type()->id()) {
+    case arrow::Type::BOOL:
+      column->type = BOOL;
+      break;
+    case arrow::Type::INT8:
+      column->type = CHAR;
+      column->values =
+          static_cast<const arrow::Int8Array*>(array)->raw_values();
+      break;
+    case arrow::Type::INT16:
+      column->type = SHORT;
+      column->values =
+          static_cast<const arrow::Int16Array*>(array)->raw_values();
+      break;
+    case arrow::Type::INT32:
+      column->type = INT;
+      column->values =
+          static_cast<const arrow::Int32Array*>(array)->raw_values();
+      break;
+    case arrow::Type::INT64:
+      column->type = LONG;
+      column->values =
+          static_cast<const arrow::Int64Array*>(array)->raw_values();
+      break;
+    case arrow::Type::FLOAT:
+      column->type = FLOAT;
+      column->values =
+          static_cast<const arrow::FloatArray*>(array)->raw_values();
+      break;
+    case arrow::Type::DOUBLE:
+      column->type = DOUBLE;
+      column->values =
+          static_cast<const arrow::DoubleArray*>(array)->raw_values();
+      break;
+    case arrow::Type::STRING:
+    case arrow::Type::LARGE_STRING:
+      column->type = STRING;
+      break;
+    default:
+      break;
+  }
+}
+
+static int get_property_from_column(const PropertyColumn& column,
+                                    int64_t row_id, Property* p_out) {
+  PodProperties pp;
+  pp.long_value = 0;
+  switch (column.type) {
+    case BOOL:
+      pp.bool_value =
+          static_cast<const arrow::BooleanArray*>(column.array)->Value(row_id);
+      break;
+    case CHAR:
+      pp.char_value = static_cast<const int8_t*>(column.values)[row_id];
+      break;
+    case SHORT:
+      pp.int16_value = static_cast<const int16_t*>(column.values)[row_id];
+      break;
+    case INT:
+      pp.int_value = static_cast<const int32_t*>(column.values)[row_id];
+      break;
+    case LONG:
+      pp.long_value = static_cast<const int64_t*>(column.values)[row_id];
+      break;
+    case FLOAT:
+      pp.float_value = static_cast<const float*>(column.values)[row_id];
+      break;
+    case DOUBLE:
+      pp.double_value = static_cast<const double*>(column.values)[row_id];
+      break;
+    case STRING:
+      if (column.array->type_id() == arrow::Type::LARGE_STRING) {
+        auto view = static_cast<const arrow::LargeStringArray*>(column.array)
+                        ->GetView(row_id);
+        pp.long_value = view.length();
+        p_out->data = const_cast<void*>(static_cast<const void*>(view.data()));
+      } else {
+        auto view = static_cast<const arrow::StringArray*>(column.array)
+                        ->GetView(row_id);
+        pp.long_value = view.length();
+        p_out->data = const_cast<void*>(static_cast<const void*>(view.data()));
+      }
+      break;
+    default:
+      LOG(ERROR) << "invalid dt is = "
+                 << (column.array == NULL ? "null"
+                                          : column.array->type()->ToString());
+      return -1;
+  }
+  p_out->type = column.type;
+  p_out->len = pp.long_value;
+  return 0;
+}
+
+static int get_property_from_table(arrow::Table* table, int64_t row_id,
+                                   PropertyId col_id, Property* p_out) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__;
+#endif
+  PropertyColumn column;
+  init_property_column(table, col_id, &column);
+  p_out->id = col_id;
+  int r = get_property_from_column(column, row_id, p_out);
+#ifndef NDEBUG
+  LOG(INFO) << "finish " << __FUNCTION__;
+#endif
+  return r;
+}
+
+static LabelColumns* init_label_columns(FRAGMENT_TYPE* frag, int label_num,
+                                        bool vertex_or_edge) {
+  LabelColumns* ret = new LabelColumns[label_num];
+  for (int i = 0; i < label_num; ++i) {
+    std::shared_ptr<arrow::Table> table = vertex_or_edge
+                                              ? frag->vertex_data_table(i)
+                                              : frag->edge_data_table(i);
+    ret[i].column_num = table->num_columns();
+    ret[i].columns = new PropertyColumn[ret[i].column_num];
+    for (int j = 0; j < ret[i].column_num; ++j) {
+      init_property_column(table.get(), j, &ret[i].columns[j]);
+    }
+  }
+  return ret;
+}
+
+static void free_label_columns(LabelColumns* label_columns, int label_num) {
+  if (label_columns == NULL) {
+    return;
+  }
+  for (int i = 0; i < label_num; ++i) {
+    delete[] label_columns[i].columns;
+  }
+  delete[] label_columns;
+}
+
 void get_graph_handle(ObjectId id, PartitionId channel_num,
                       GraphHandleImpl* handle) {
 #ifndef NDEBUG
@@ -129,6 +276,22 @@ void get_graph_handle(ObjectId id, PartitionId channel_num,
     }
   }
 
+  handle->vertex_columns = static_cast<LabelColumns**>(
+      malloc(sizeof(LabelColumns*) * total_frag_num));
+  handle->edge_columns = static_cast<LabelColumns**>(
+      malloc(sizeof(LabelColumns*) * total_frag_num));
+  for (vineyard::fid_t i = 0; i < total_frag_num; ++i) {
+    handle->vertex_columns[i] = NULL;
+    handle->edge_columns[i] = NULL;
+  }
+  for (FRAG_ID_TYPE i = 0; i < handle->local_fnum; ++i) {
+    FRAG_ID_TYPE fid = handle->local_fragments[i];
+    handle->vertex_columns[fid] = init_label_columns(
+        &handle->fragments[fid], vertex_label_num, true);
+    handle->edge_columns[fid] =
+        init_label_columns(&handle->fragments[fid], edge_label_num, false);
+  }
+
   LOG(INFO) << "finish get graph handle: " << id << ", handle = " << handle;
 }
 
@@ -140,6 +303,12 @@ void free_graph_handle(GraphHandleImpl* handle) {
     free(handle->vertex_chunk_sizes[i]);
   }
   free(handle->vertex_chunk_sizes);
+  for (FRAG_ID_TYPE i = 0; i < handle->fnum; ++i) {
+    free_label_columns(handle->vertex_columns[i], handle->vertex_label_num);
+    free_label_columns(handle->edge_columns[i], handle->edge_label_num);
+  }
+  free(handle->vertex_columns);
+  free(handle->edge_columns);
 
   delete[] handle->fragments;
   if (handle->local_fragments != NULL) {
@@ -154,67 +323,6 @@ void free_graph_handle(GraphHandleImpl* handle) {
 #endif
 }
 
-static int get_property_from_table(arrow::Table* table, int64_t row_id,
-                                   PropertyId col_id, Property* p_out) {
-#ifndef NDEBUG
-  LOG(INFO) << "enter " << __FUNCTION__;
-#endif
-  std::shared_ptr<arrow::DataType> dt = table->field(col_id)->type();
-  std::shared_ptr<arrow::Array> array = table->column(col_id)->chunk(0);
-  p_out->id = col_id;
-  PodProperties pp;
-  if (dt == arrow::boolean()) {
-    p_out->type = BOOL;
-    pp.bool_value =
-        std::dynamic_pointer_cast<arrow::BooleanArray>(array)->Value(row_id);
-  } else if (dt == arrow::int8()) {
-    p_out->type = CHAR;
-    pp.char_value =
-        std::dynamic_pointer_cast<arrow::Int8Array>(array)->Value(row_id);
-  } else if (dt == arrow::int16()) {
-    p_out->type = SHORT;
-    pp.int16_value =
-        std::dynamic_pointer_cast<arrow::Int16Array>(array)->Value(row_id);
-  } else if (dt == arrow::int32()) {
-    p_out->type = INT;
-    pp.int_value =
-        std::dynamic_pointer_cast<arrow::Int32Array>(array)->Value(row_id);
-  } else if (dt == arrow::int64()) {
-    p_out->type = LONG;
-    pp.long_value =
-        std::dynamic_pointer_cast<arrow::Int64Array>(array)->Value(row_id);
-  } else if (dt == arrow::float32()) {
-    p_out->type = FLOAT;
-    pp.float_value =
-        std::dynamic_pointer_cast<arrow::FloatArray>(array)->Value(row_id);
-  } else if (dt == arrow::float64()) {
-    p_out->type = DOUBLE;
-    pp.double_value =
-        std::dynamic_pointer_cast<arrow::DoubleArray>(array)->Value(row_id);
-  } else if (dt == arrow::utf8()) {
-    p_out->type = STRING;
-    auto view =
-        std::dynamic_pointer_cast<arrow::StringArray>(array)->GetView(row_id);
-    pp.long_value = view.length();
-    p_out->data = const_cast<void*>(static_cast<const void*>(view.data()));
-  } else if (dt == arrow::large_utf8()) {
-    p_out->type = STRING;
-    auto view =
-        std::dynamic_pointer_cast<arrow::LargeStringArray>(array)->GetView(
-            row_id);
-    pp.long_value = view.length();
-    p_out->data = const_cast<void*>(static_cast<const void*>(view.data()));
-  } else {
-    LOG(ERROR) << "invalid dt is = " << dt->ToString();
-    return -1;
-  }
-  p_out->len = pp.long_value;
-#ifndef NDEBUG
-  LOG(INFO) << "finish " << __FUNCTION__;
-#endif
-  return 0;
-}
-
 static void get_properties_from_table(std::shared_ptr<arrow::Table> table,
                                       int row_id,
                                       PropertiesIteratorImpl* iter) {
@@ -342,6 +450,16 @@ int get_vertices_next(GetVertexIteratorImpl* iter, Vertex* v_out) {
   }
 }
 
+int get_vertices_next_batch(GetVertexIteratorImpl* iter, Vertex* v_out,
+                            int count) {
+  int num = std::min(count, iter->count - iter->index);
+  for (int i = 0; i < num; ++i) {
+    v_out[i] = iter->ids[iter->index + i];
+  }
+  iter->index += num;
+  return num;
+}
+
 static typename FRAGMENT_TYPE::vertex_range_t get_sub_range(
     const typename FRAGMENT_TYPE::vertex_range_t& super_range,
     VID_TYPE chunk_size, PartitionId channel_id) {
@@ -470,6 +588,28 @@ int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out) {
   return 0;
 }
 
+int get_all_vertices_next_batch(GetAllVerticesIteratorImpl* iter,
+                                Vertex* v_out, int count) {
+  int num = 0;
+  while (num < count && iter->range_id != iter->range_num) {
+    VID_TYPE range_end = iter->ranges[iter->range_id].second;
+    if (iter->cur_vertex_id == range_end) {
+      ++iter->range_id;
+      if (iter->range_id != iter->range_num) {
+        iter->cur_vertex_id = iter->ranges[iter->range_id].first;
+      }
+      continue;
+    }
+    VID_TYPE end = iter->cur_vertex_id +
+                   std::min<VID_TYPE>(range_end - iter->cur_vertex_id,
+                                      static_cast<VID_TYPE>(count - num));
+    while (iter->cur_vertex_id != end) {
+      v_out[num++] = (Vertex)iter->cur_vertex_id++;
+    }
+  }
+  return num;
+}
+
 EdgeId get_edge_id(FRAGMENT_TYPE* frag, LabelId label, int64_t offset) {
 #ifndef NDEBUG
   LOG(INFO) << "enter = " << __FUNCTION__ << ", label = " << label
@@ -520,6 +660,87 @@ int properties_next(PropertiesIteratorImpl* iter, Property* p_out) {
   return get_property_from_table(iter->table, iter->row_id, col_id, p_out);
 }
 
+static void invalid_property(PropertyId id, Property* p_out) {
+  p_out->id = id;
+  p_out->type = INVALID;
+  p_out->data = NULL;
+  p_out->len = 0;
+}
+
+static const PropertyColumn* find_property_column(LabelColumns* label_columns,
+                                                  LabelId label,
+                                                  PropertyId col_id,
+                                                  int64_t row_id) {
+  if (label_columns == NULL || col_id < 0 ||
+      col_id >= label_columns[label].column_num) {
+    return NULL;
+  }
+  const PropertyColumn* column = &label_columns[label].columns[col_id];
+  if (column->array == NULL || row_id >= column->array->length()) {
+    return NULL;
+  }
+  return column;
+}
+
+// Column index of the property in the label, or -1 when the property id is
+// out of the range of the schema.
+static PropertyId property_column_id(const vineyard::Entry& entry,
+                                     PropertyId id) {
+  if (id < 0 || static_cast<size_t>(id) >= entry.reverse_mapping.size()) {
+    return -1;
+  }
+  return entry.reverse_mapping[id];
+}
+
+int get_vertex_property_batch(GraphHandleImpl* handle, const Vertex* vs,
+                              int count, PropertyId id, Property* p_out) {
+  auto& entries = handle->schema->VertexEntries();
+  int found = 0;
+  for (int i = 0; i < count; ++i) {
+    VID_TYPE v = (VID_TYPE)vs[i];
+    FRAG_ID_TYPE fid = handle->vid_parser.GetFid(v);
+    LabelId label = handle->vid_parser.GetLabelId(v);
+    int64_t offset = handle->vid_parser.GetOffset(v);
+    invalid_property(id, &p_out[i]);
+    if (fid >= handle->fnum || label < 0 ||
+        label >= handle->vertex_label_num) {
+      continue;
+    }
+    const PropertyColumn* column =
+        find_property_column(handle->vertex_columns[fid], label,
+                             property_column_id(entries[label], id), offset);
+    if (column != NULL &&
+        get_property_from_column(*column, offset, &p_out[i]) == 0) {
+      ++found;
+    }
+  }
+  return found;
+}
+
+int get_edge_property_batch(GraphHandleImpl* handle, const Edge* es, int count,
+                            PropertyId id, Property* p_out) {
+  auto& entries = handle->schema->EdgeEntries();
+  int found = 0;
+  for (int i = 0; i < count; ++i) {
+    EID_TYPE e = (EID_TYPE)es[i].offset;
+    FRAG_ID_TYPE fid = handle->eid_parser.GetFid(e);
+    LabelId label = handle->eid_parser.GetLabelId(e);
+    int64_t offset = handle->eid_parser.GetOffset(e);
+    invalid_property(id, &p_out[i]);
+    if (fid >= handle->fnum || label < 0 || label >= handle->edge_label_num) {
+      continue;
+    }
+    const PropertyColumn* column =
+        find_property_column(handle->edge_columns[fid], label,
+                             property_column_id(entries[label], id), offset);
+    if (column != NULL &&
+        get_property_from_column(*column, offset, &p_out[i]) == 0) {
+      ++found;
+    }
+  }
+  return found;
+}
+
 void free_properties_iterator(PropertiesIteratorImpl* iter) {}
 
 void empty_edge_iterator(EdgeIteratorImpl* iter) {
@@ -754,6 +975,47 @@ int in_edge_next(EdgeIteratorImpl* iter, Edge* e_out) {
   return 0;
 }
 
+static int edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int count,
+                           bool outgoing) {
+  int num = 0;
+  while (num < count && iter->list_id != iter->list_num) {
+    const AdjListUnit& list = iter->lists[iter->list_id];
+    if (iter->cur_edge == list.end) {
+      ++iter->list_id;
+      if (iter->list_id != iter->list_num) {
+        iter->cur_edge = iter->lists[iter->list_id].begin;
+      }
+      continue;
+    }
+    FRAG_ID_TYPE fid = iter->fragment->fid();
+    const NBR_TYPE* end =
+        iter->cur_edge +
+        std::min<ptrdiff_t>(list.end - iter->cur_edge, count - num);
+    for (; iter->cur_edge != end; ++iter->cur_edge, ++num) {
+      VID_TYPE nbr =
+          iter->fragment->Vertex2Gid(VERTEX_TYPE(iter->cur_edge->vid));
+      if (outgoing) {
+        e_out[num].src = iter->src;
+        e_out[num].dst = nbr;
+      } else {
+        e_out[num].src = nbr;
+        e_out[num].dst = iter->src;
+      }
+      e_out[num].offset =
+          iter->eid_parser->GenerateId(fid, list.label, iter->cur_edge->eid);
+    }
+  }
+  return num;
+}
+
+int out_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int count) {
+  return edge_next_batch(iter, e_out, count, true);
+}
+
+int in_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int count) {
+  return edge_next_batch(iter, e_out, count, false);
+}
+
 void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
                    const VID_TYPE* chunk_sizes,
                    vineyard::IdParser<EID_TYPE>* eid_parser, LabelId* labels,
@@ -862,6 +1124,23 @@ int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out) {
 #endif
 }
 
+int get_all_edges_next_batch(GetAllEdgesIteratorImpl* iter, Edge* e_out,
+                             int count) {
+  int num = 0;
+  while (num < count) {
+    // the adjacent lists of the current vertex are capped by the limit
+    // already, get_all_edges_next moves to the next vertex
+    int got = edge_next_batch(&iter->ei, e_out + num, count - num, true);
+    iter->index += got;
+    num += got;
+    if (num == count || get_all_edges_next(iter, e_out + num) != 0) {
+      break;
+    }
+    ++num;
+  }
+  return num;
+}
+
 void free_edge_iterator(EdgeIteratorImpl* iter) {
   if (iter->lists != NULL) {
     free(iter->lists);
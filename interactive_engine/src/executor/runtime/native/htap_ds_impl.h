@@ -36,6 +36,21 @@ using EID_TYPE = typename FRAGMENT_TYPE::eid_t;
 using VERTEX_RANGE_TYPE = std::pair<VID_TYPE, VID_TYPE>;
 using VERTEX_TYPE = typename FRAGMENT_TYPE::vertex_t;
 
+// A property column of a label with its type resolved when the graph handle
+// is created, thus reading a value doesn't cast the array nor compare the
+// datatype again.
+struct PropertyColumn {
+  PropertyType type;
+  const arrow::Array* array;
+  // raw values of numeric columns, NULL for bool and string columns
+  const void* values;
+};
+
+struct LabelColumns {
+  PropertyColumn* columns;
+  int column_num;
+};
+
 struct GraphHandleImpl {
   vineyard::Client* client;
   FRAGMENT_TYPE* fragments;
@@ -51,6 +66,10 @@ struct GraphHandleImpl {
 
   PartitionId channel_num;
   VID_TYPE** vertex_chunk_sizes;
+
+  // indexed by [fid][label], only filled for local fragments
+  LabelColumns** vertex_columns;
+  LabelColumns** edge_columns;
 };
 
 inline int get_edge_partition_id(EID_TYPE id, GraphHandleImpl* handle) {
@@ -75,6 +94,9 @@ void free_get_vertex_iterator(GetVertexIteratorImpl* iter);
 
 int get_vertices_next(GetVertexIteratorImpl* iter, Vertex* v_out);
 
+int get_vertices_next_batch(GetVertexIteratorImpl* iter, Vertex* v_out,
+                            int count);
+
 struct GetAllVerticesIteratorImpl {
   VERTEX_RANGE_TYPE* ranges;
   int range_num;
@@ -92,6 +114,9 @@ void free_get_all_vertices_iterator(GetAllVerticesIteratorImpl* iter);
 
 int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out);
 
+int get_all_vertices_next_batch(GetAllVerticesIteratorImpl* iter,
+                                Vertex* v_out, int count);
+
 struct PropertiesIteratorImpl {
   GraphHandleImpl* handle;
   arrow::Table* table;
@@ -140,12 +165,16 @@ void get_out_edges(FRAGMENT_TYPE* frag,
 
 int out_edge_next(EdgeIteratorImpl* iter, Edge* e_out);
 
+int out_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int count);
+
 void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
                   VertexId dst_id, LabelId* labels, int labels_count,
                   int64_t limit, EdgeIteratorImpl* iter);
 
 int in_edge_next(EdgeIteratorImpl* iter, Edge* e_out);
 
+int in_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int count);
+
 struct GetAllEdgesIteratorImpl {
   FRAGMENT_TYPE* fragment;
   LabelId* e_labels;
@@ -172,6 +201,9 @@ void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
 
 int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out);
 
+int get_all_edges_next_batch(GetAllEdgesIteratorImpl* iter, Edge* e_out,
+                             int count);
+
 void free_edge_iterator(EdgeIteratorImpl* iter);
 
 void free_get_all_edges_iterator(GetAllEdgesIteratorImpl* iter);
@@ -186,6 +218,12 @@ void get_edge_properties(FRAGMENT_TYPE* frag, LabelId label, int64_t offset,
 
 int properties_next(PropertiesIteratorImpl* iter, Property* p_out);
 
+int get_vertex_property_batch(GraphHandleImpl* handle, const Vertex* vs,
+                              int count, PropertyId id, Property* p_out);
+
+int get_edge_property_batch(GraphHandleImpl* handle, const Edge* es, int count,
+                            PropertyId id, Property* p_out);
+
 void free_properties_iterator(PropertiesIteratorImpl* iter);
 
 union PodProperties {
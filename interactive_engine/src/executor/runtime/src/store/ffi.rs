@@ -45,9 +45,12 @@ type FFIState = i32;
 const STATE_SUCCESS: i32 = 0;
 const STATE_FAILED: i32 = -1;
 
+/// Number of vertices or edges fetched from a native iterator per ffi call.
+const FFI_BATCH_SIZE: usize = 64;
+
 
 #[repr(C)]
-#[derive(Debug)]
+#[derive(Debug, Default, Clone, Copy)]
 pub struct EdgeHandle {
     src: i64,
     dst: i64,
@@ -67,6 +70,7 @@ impl EdgeHandle {
 #[repr(C)]
 #[derive(Debug)]
 pub enum PropertyType {
+    Invalid = 0,
     Bool = 1,
     Char = 2,
     Short = 3,
@@ -106,14 +110,17 @@ extern {
     fn get_vertices(graph: GraphHandle, partition_id: FFIPartitionId, label: *const FFILabelId, ids: *const VertexId, count: i32) -> GetVertexIterator;
     fn free_get_vertex_iterator(iter: GetVertexIterator);
     fn get_vertices_next(iter: GetVertexIterator, v_out: *mut VertexHandle) -> FFIState;
+    fn get_vertices_next_batch(iter: GetVertexIterator, v_out: *mut VertexHandle, count: i32) -> i32;
 
     fn get_all_vertices(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32, limit: i64) -> GetAllVerticesIterator;
     fn free_get_all_vertices_iterator(iter: GetAllVerticesIterator);
     fn get_all_vertices_next(iter: GetAllVerticesIterator, v_out: *mut VertexHandle) -> FFIState;
+    fn get_all_vertices_next_batch(iter: GetAllVerticesIterator, v_out: *mut VertexHandle, count: i32) -> i32;
 
     fn get_vertex_id(graph: GraphHandle, v: VertexHandle) -> VertexId;
     fn get_vertex_label(graph: GraphHandle, v: VertexHandle) -> LabelId;
     fn get_vertex_property(graph: GraphHandle, v: VertexHandle, id: PropertyId, p_out: *mut NativeProperty) -> FFIState;
+    fn get_vertex_property_batch(graph: GraphHandle, vs: *const VertexHandle, count: i32, id: PropertyId, p_out: *mut NativeProperty) -> i32;
     fn get_vertex_properties(graph: GraphHandle, v: VertexHandle) -> PropertiesIterator;
 
     fn free_properties_iterator(iter: PropertiesIterator);
@@ -122,14 +129,17 @@ extern {
     fn get_out_edges(graph: GraphHandle, partition_id: FFIPartitionId, src_id: VertexId, labels: *const FFILabelId, label_count: i32, limit: i64) -> OutEdgeIterator;
     fn free_out_edge_iterator(iter: OutEdgeIterator);
     fn out_edge_next(iter: OutEdgeIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn out_edge_next_batch(iter: OutEdgeIterator, e_out: *mut EdgeHandle, count: i32) -> i32;
 
     fn get_in_edges(graph: GraphHandle, partition_id: FFIPartitionId, dst_id: VertexId, labels: *const FFILabelId, label_count: i32, limit: i64) -> InEdgeIterator;
     fn free_in_edge_iterator(iter: InEdgeIterator);
     fn in_edge_next(iter: InEdgeIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn in_edge_next_batch(iter: InEdgeIterator, e_out: *mut EdgeHandle, count: i32) -> i32;
 
     fn get_all_edges(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32, limit: i64) -> GetAllEdgesIterator;
     fn free_get_all_edges_iterator(iter: GetAllEdgesIterator);
     fn get_all_edges_next(iter: GetAllEdgesIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn get_all_edges_next_batch(iter: GetAllEdgesIterator, e_out: *mut EdgeHandle, count: i32) -> i32;
 
     fn get_edge_src_id(graph: GraphHandle, e: *const EdgeHandle) -> VertexId;
     fn get_edge_dst_id(graph: GraphHandle, e: *const EdgeHandle) -> VertexId;
@@ -138,6 +148,7 @@ extern {
     fn get_edge_dst_label(graph: GraphHandle, e: *const EdgeHandle) -> LabelId;
     fn get_edge_label(graph: GraphHandle, e: *const EdgeHandle) -> LabelId;
     fn get_edge_property(graph: GraphHandle, e: *const EdgeHandle, id: PropertyId, p_out: *mut NativeProperty) -> FFIState;
+    fn get_edge_property_batch(graph: GraphHandle, es: *const EdgeHandle, count: i32, id: PropertyId, p_out: *mut NativeProperty) -> i32;
     fn get_edge_properties(graph: GraphHandle, e: *const EdgeHandle) -> PropertiesIterator;
 
     fn get_property_as_bool(property: *const NativeProperty, out: *mut bool) -> FFIState;
@@ -235,10 +246,11 @@ impl GlobalGraphQuery for FFIGraphStore {
                      edge_labels: &Vec<LabelId>, condition: Option<&Condition>,
                      dedup_prop_ids: Option<&Vec<u32>>, output_prop_ids: Option<&Vec<u32>>,
                      limit: usize) -> Box<Iterator<Item=(VertexId, Self::EI)>> {
+        let prop_ids = get_prefetch_prop_ids(output_prop_ids);
         CommonEdgeQuery::new(self.graph, src_ids, edge_labels, limit as i64)
-            .run(|graph, partition_id, src_id, labels, label_count, limit| {
+            .run(move |graph, partition_id, src_id, labels, label_count, limit| {
                 let iter = unsafe { get_out_edges(graph, partition_id, src_id, labels.as_ptr(), label_count, get_limit_value(limit)) };
-                let ret = FFIOutEdgeIter::new(graph, iter);
+                let ret = FFIOutEdgeIter::with_properties(graph, iter, prop_ids.clone());
                 GlobalEdgeIter::Out(ret)
             })
     }
@@ -258,10 +270,11 @@ impl GlobalGraphQuery for FFIGraphStore {
                     edge_labels: &Vec<LabelId>, condition: Option<&Condition>,
                     dedup_prop_ids: Option<&Vec<u32>>, output_prop_ids: Option<&Vec<u32>>,
                     limit: usize) -> Box<Iterator<Item=(VertexId, Self::EI)>> {
+        let prop_ids = get_prefetch_prop_ids(output_prop_ids);
         CommonEdgeQuery::new(self.graph, dst_ids, edge_labels, limit as i64)
-            .run(|graph, partition_id, dst_id, labels, label_count, limit| {
+            .run(move |graph, partition_id, dst_id, labels, label_count, limit| {
                 let iter = unsafe { get_in_edges(graph, partition_id, dst_id, labels.as_ptr(), label_count, get_limit_value(limit)) };
-                let ret = FFIInEdgeIter::new(graph, iter);
+                let ret = FFIInEdgeIter::with_properties(graph, iter, prop_ids.clone());
                 GlobalEdgeIter::In(ret)
             })
     }
@@ -286,15 +299,17 @@ impl GlobalGraphQuery for FFIGraphStore {
 
     fn get_vertex_properties(&self, si: i64, ids: Vec<(PartitionId, Vec<(Option<LabelId>, Vec<VertexId>)>)>, output_prop_ids: Option<&Vec<u32>>) -> Self::VI {
         let graph = self.graph;
+        let prop_ids = get_prefetch_prop_ids(output_prop_ids);
         let iter = ids.into_iter().flat_map(move |(partition_id, ids)| {
+            let prop_ids = prop_ids.clone();
             ids.into_iter().flat_map(move |(label, ids)| {
                 if let Some(l) = label {
                     let label_val = l as FFILabelId;
                     let iter = unsafe { get_vertices(graph, partition_id as FFIPartitionId, &label_val as *const FFILabelId, ids.as_ptr(), ids.len() as i32) };
-                    FFIGetVertexIter::new(graph, iter)
+                    FFIGetVertexIter::with_properties(graph, iter, prop_ids.clone())
                 } else {
                     let iter = unsafe { get_vertices(graph, partition_id as FFIPartitionId, std::ptr::null(), ids.as_ptr(), ids.len() as i32) };
-                    FFIGetVertexIter::new(graph, iter)
+                    FFIGetVertexIter::with_properties(graph, iter, prop_ids.clone())
                 }
             })
         });
@@ -309,10 +324,11 @@ impl GlobalGraphQuery for FFIGraphStore {
         let graph = self.graph;
         let labels: Vec<FFILabelId> = labels_ref.iter().map(|v| *v as FFILabelId).collect();
         let label_count = labels.len() as i32;
+        let prop_ids = get_prefetch_prop_ids(output_prop_ids);
         let iter = partition_ids.clone().into_iter().map(|v| v as FFIPartitionId).flat_map(move |partition_id| {
             let curr_labels = labels.clone();
             let iter = unsafe { get_all_vertices(graph, partition_id, curr_labels.as_ptr(), label_count, get_limit_value(limit as i64)) };
-            FFIGetAllVerticesIter::new(graph, iter)
+            FFIGetAllVerticesIter::with_properties(graph, iter, prop_ids.clone())
         });
         GlobalVertexIter::Normal(Box::new(iter))
     }
@@ -321,10 +337,11 @@ impl GlobalGraphQuery for FFIGraphStore {
         let graph = self.graph;
         let labels: Vec<FFILabelId> = labels_ref.iter().map(|v| *v as FFILabelId).collect();
         let label_count = labels.len() as i32;
+        let prop_ids = get_prefetch_prop_ids(output_prop_ids);
         let iter = partition_ids.clone().into_iter().map(|v| v as FFIPartitionId).flat_map(move |partition_id| {
             let curr_labels = labels.clone();
             let iter = unsafe { get_all_edges(graph, partition_id, curr_labels.as_ptr(), label_count, get_limit_value(limit as i64)) };
-            FFIAllEdgesIter::new(graph, iter)
+            FFIAllEdgesIter::with_properties(graph, iter, prop_ids.clone())
         });
         GlobalEdgeIter::Common(Box::new(iter))
     }
@@ -411,13 +428,14 @@ impl CommonEdgeQuery {
         }
     }
 
-    pub fn run<T, F: 'static + Copy + Fn(GraphHandle, FFIPartitionId, VertexId, Vec<FFILabelId>, i32, i64) -> T>(self, process: F) -> Box<Iterator<Item=(VertexId, T)>> {
+    pub fn run<T, F: 'static + Clone + Fn(GraphHandle, FFIPartitionId, VertexId, Vec<FFILabelId>, i32, i64) -> T>(self, process: F) -> Box<Iterator<Item=(VertexId, T)>> {
         let graph = self.graph;
         let label_count = self.label_count;
         let limit = self.limit;
         let curr_labels = self.labels.clone();
         let ret = self.ids.into_iter().flat_map(move |(partition_id, ids)| {
             let process_labels = curr_labels.clone();
+            let process = process.clone();
             ids.into_iter().map(move |id| {
                 let ret = process(graph, partition_id as FFIPartitionId, id, process_labels.clone(), label_count, limit);
                 (id, ret)
@@ -499,6 +517,7 @@ pub const INVALID_PROP_ID: u32 = 9999;
 pub struct FFIVertex {
     graph: GraphHandle,
     handle: VertexHandle,
+    prefetched: Vec<(u32, Option<Property>)>,
 }
 
 impl Vertex for FFIVertex {
@@ -516,6 +535,9 @@ impl Vertex for FFIVertex {
         if prop_id >= INVALID_PROP_ID {
             return None;
         }
+        if let Some(property) = get_prefetched_property(&self.prefetched, prop_id) {
+            return property;
+        }
         let mut property = NativeProperty::default();
         let state = unsafe { get_vertex_property(self.graph, self.handle, prop_id as PropertyId, &mut property) };
         if state == STATE_SUCCESS {
@@ -532,9 +554,14 @@ impl Vertex for FFIVertex {
 
 impl FFIVertex {
     pub fn new(graph: GraphHandle, handle: VertexHandle) -> Self {
+        Self::with_properties(graph, handle, vec![])
+    }
+
+    fn with_properties(graph: GraphHandle, handle: VertexHandle, prefetched: Vec<(u32, Option<Property>)>) -> Self {
         FFIVertex {
             graph,
             handle,
+            prefetched,
         }
     }
 }
@@ -581,16 +608,97 @@ unsafe impl Send for IdOnlyVertex {}
 
 unsafe impl Sync for IdOnlyVertex {}
 
+/// Items of a native iterator fetched `FFI_BATCH_SIZE` at a time, together
+/// with the requested properties of them, which are read by one ffi call per
+/// property for the whole batch.
+struct FFIBatch<T> {
+    items: Vec<T>,
+    cursor: usize,
+    prop_ids: Vec<u32>,
+    properties: Vec<Vec<(u32, Option<Property>)>>,
+}
+
+impl<T: Copy + Default> FFIBatch<T> {
+    fn new(prop_ids: Vec<u32>) -> Self {
+        FFIBatch {
+            items: vec![],
+            cursor: 0,
+            prop_ids,
+            properties: vec![],
+        }
+    }
+
+    /// `fetch` fills at most `count` items and returns the number of them,
+    /// `read` reads a property of `count` items into `p_out` as
+    /// `get_vertex_property_batch` does.
+    fn next<F, R>(&mut self, fetch: F, read: R) -> Option<(T, Vec<(u32, Option<Property>)>)>
+        where F: FnOnce(*mut T, i32) -> i32,
+              R: Fn(*const T, i32, PropertyId, *mut NativeProperty) -> i32 {
+        if self.cursor == self.items.len() {
+            self.items.resize(FFI_BATCH_SIZE, T::default());
+            let count = fetch(self.items.as_mut_ptr(), FFI_BATCH_SIZE as i32);
+            self.items.truncate(count.max(0) as usize);
+            self.cursor = 0;
+            self.prefetch(read);
+        }
+        let item = *self.items.get(self.cursor)?;
+        let properties = match self.properties.get_mut(self.cursor) {
+            Some(properties) => std::mem::replace(properties, vec![]),
+            None => vec![],
+        };
+        self.cursor += 1;
+        Some((item, properties))
+    }
+
+    fn prefetch<R: Fn(*const T, i32, PropertyId, *mut NativeProperty) -> i32>(&mut self, read: R) {
+        self.properties.clear();
+        if self.prop_ids.is_empty() || self.items.is_empty() {
+            return;
+        }
+        let count = self.items.len();
+        let prop_num = self.prop_ids.len();
+        self.properties = (0..count).map(|_| Vec::with_capacity(prop_num)).collect();
+        let mut native: Vec<NativeProperty> = (0..count).map(|_| NativeProperty::default()).collect();
+        for prop_id in self.prop_ids.iter() {
+            read(self.items.as_ptr(), count as i32, *prop_id as PropertyId, native.as_mut_ptr());
+            for (properties, property) in self.properties.iter_mut().zip(native.iter()) {
+                properties.push((*prop_id, property.to_property()));
+            }
+        }
+    }
+}
+
+/// Ids of the output properties which are read in batches, none when all the
+/// properties are output.
+fn get_prefetch_prop_ids(output_prop_ids: Option<&Vec<u32>>) -> Vec<u32> {
+    match output_prop_ids {
+        Some(prop_ids) => prop_ids.iter().filter(|id| **id < INVALID_PROP_ID).cloned().collect(),
+        None => vec![],
+    }
+}
+
+/// `Some(property)` when the property is prefetched, where the property is
+/// `None` if the vertex or edge does not have it.
+fn get_prefetched_property(prefetched: &Vec<(u32, Option<Property>)>, prop_id: u32) -> Option<Option<Property>> {
+    prefetched.iter().find(|(id, _)| *id == prop_id).map(|(_, property)| property.clone())
+}
+
 struct FFIGetVertexIter {
     graph: GraphHandle,
     iter: GetVertexIterator,
+    batch: FFIBatch<VertexHandle>,
 }
 
 impl FFIGetVertexIter {
     pub fn new(graph: GraphHandle, iter: GetVertexIterator) -> Self {
+        Self::with_properties(graph, iter, vec![])
+    }
+
+    pub fn with_properties(graph: GraphHandle, iter: GetVertexIterator, prop_ids: Vec<u32>) -> Self {
         FFIGetVertexIter {
             graph,
             iter,
+            batch: FFIBatch::new(prop_ids),
         }
     }
 }
@@ -599,13 +707,11 @@ impl Iterator for FFIGetVertexIter {
     type Item = FFIVertex;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut vertex_handle = 0;
-        let state = unsafe { get_vertices_next(self.iter, &mut vertex_handle as *mut VertexHandle) };
-        if state == STATE_SUCCESS {
-            let v = FFIVertex::new(self.graph, vertex_handle);
-            return Some(v);
-        }
-        None
+        let (graph, iter) = (self.graph, self.iter);
+        let (vertex_handle, properties) = self.batch.next(
+            |out, count| unsafe { get_vertices_next_batch(iter, out, count) },
+            |items, count, prop_id, p_out| unsafe { get_vertex_property_batch(graph, items, count, prop_id, p_out) })?;
+        Some(FFIVertex::with_properties(graph, vertex_handle, properties))
     }
 }
 
@@ -618,13 +724,19 @@ impl Drop for FFIGetVertexIter {
 struct FFIGetAllVerticesIter {
     graph: GraphHandle,
     iter: GetAllVerticesIterator,
+    batch: FFIBatch<VertexHandle>,
 }
 
 impl FFIGetAllVerticesIter {
     pub fn new(graph: GraphHandle, iter: GetAllVerticesIterator) -> Self {
+        Self::with_properties(graph, iter, vec![])
+    }
+
+    pub fn with_properties(graph: GraphHandle, iter: GetAllVerticesIterator, prop_ids: Vec<u32>) -> Self {
         FFIGetAllVerticesIter {
             graph,
             iter,
+            batch: FFIBatch::new(prop_ids),
         }
     }
 }
@@ -633,13 +745,11 @@ impl Iterator for FFIGetAllVerticesIter {
     type Item = FFIVertex;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut vertex_handle = 0;
-        let state = unsafe { get_all_vertices_next(self.iter, &mut vertex_handle as *mut VertexHandle) };
-        if state == STATE_SUCCESS {
-            let v = FFIVertex::new(self.graph, vertex_handle);
-            return Some(v);
-        }
-        None
+        let (graph, iter) = (self.graph, self.iter);
+        let (vertex_handle, properties) = self.batch.next(
+            |out, count| unsafe { get_all_vertices_next_batch(iter, out, count) },
+            |items, count, prop_id, p_out| unsafe { get_vertex_property_batch(graph, items, count, prop_id, p_out) })?;
+        Some(FFIVertex::with_properties(graph, vertex_handle, properties))
     }
 }
 
@@ -700,13 +810,19 @@ impl Iterator for FFIGetInVertexIdsIter {
 pub struct FFIEdge {
     graph: GraphHandle,
     handle: EdgeHandle,
+    prefetched: Vec<(u32, Option<Property>)>,
 }
 
 impl FFIEdge {
     pub fn new(graph: GraphHandle, handle: EdgeHandle) -> Self {
+        Self::with_properties(graph, handle, vec![])
+    }
+
+    fn with_properties(graph: GraphHandle, handle: EdgeHandle, prefetched: Vec<(u32, Option<Property>)>) -> Self {
         FFIEdge {
             graph,
             handle,
+            prefetched,
         }
     }
 }
@@ -739,6 +855,9 @@ impl Edge for FFIEdge {
     }
 
     fn get_property(&self, prop_id: u32) -> Option<Property> {
+        if let Some(property) = get_prefetched_property(&self.prefetched, prop_id) {
+            return property;
+        }
         let mut property = NativeProperty::default();
         let state = unsafe { get_edge_property(self.graph, &self.handle, prop_id as PropertyId, &mut property) };
         if state == STATE_SUCCESS {
@@ -760,13 +879,19 @@ unsafe impl Send for FFIEdge {}
 pub struct FFIOutEdgeIter {
     graph: GraphHandle,
     iter: OutEdgeIterator,
+    batch: FFIBatch<EdgeHandle>,
 }
 
 impl FFIOutEdgeIter {
     pub fn new(graph: GraphHandle, iter: OutEdgeIterator) -> Self {
+        Self::with_properties(graph, iter, vec![])
+    }
+
+    pub fn with_properties(graph: GraphHandle, iter: OutEdgeIterator, prop_ids: Vec<u32>) -> Self {
         FFIOutEdgeIter {
             graph,
             iter,
+            batch: FFIBatch::new(prop_ids),
         }
     }
 }
@@ -775,13 +900,11 @@ impl Iterator for FFIOutEdgeIter {
     type Item = FFIEdge;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut edge_handle = EdgeHandle::new();
-        let state = unsafe { out_edge_next(self.iter, &mut edge_handle as *mut EdgeHandle) };
-        if state == STATE_SUCCESS {
-            let e = FFIEdge::new(self.graph, edge_handle);
-            return Some(e);
-        }
-        None
+        let (graph, iter) = (self.graph, self.iter);
+        let (edge_handle, properties) = self.batch.next(
+            |out, count| unsafe { out_edge_next_batch(iter, out, count) },
+            |items, count, prop_id, p_out| unsafe { get_edge_property_batch(graph, items, count, prop_id, p_out) })?;
+        Some(FFIEdge::with_properties(graph, edge_handle, properties))
     }
 }
 
@@ -794,13 +917,19 @@ impl Drop for FFIOutEdgeIter {
 pub struct FFIInEdgeIter {
     graph: GraphHandle,
     iter: InEdgeIterator,
+    batch: FFIBatch<EdgeHandle>,
 }
 
 impl FFIInEdgeIter {
     pub fn new(graph: GraphHandle, iter: InEdgeIterator) -> Self {
+        Self::with_properties(graph, iter, vec![])
+    }
+
+    pub fn with_properties(graph: GraphHandle, iter: InEdgeIterator, prop_ids: Vec<u32>) -> Self {
         FFIInEdgeIter {
             graph,
             iter,
+            batch: FFIBatch::new(prop_ids),
         }
     }
 }
@@ -809,13 +938,11 @@ impl Iterator for FFIInEdgeIter {
     type Item = FFIEdge;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut edge_handle = EdgeHandle::new();
-        let state = unsafe { in_edge_next(self.iter, &mut edge_handle as *mut EdgeHandle) };
-        if state == STATE_SUCCESS {
-            let e = FFIEdge::new(self.graph, edge_handle);
-            return Some(e);
-        }
-        None
+        let (graph, iter) = (self.graph, self.iter);
+        let (edge_handle, properties) = self.batch.next(
+            |out, count| unsafe { in_edge_next_batch(iter, out, count) },
+            |items, count, prop_id, p_out| unsafe { get_edge_property_batch(graph, items, count, prop_id, p_out) })?;
+        Some(FFIEdge::with_properties(graph, edge_handle, properties))
     }
 }
 
@@ -828,13 +955,19 @@ impl Drop for FFIInEdgeIter {
 struct FFIAllEdgesIter {
     graph: GraphHandle,
     iter: GetAllEdgesIterator,
+    batch: FFIBatch<EdgeHandle>,
 }
 
 impl FFIAllEdgesIter {
     pub fn new(graph: GraphHandle, iter: GetAllEdgesIterator) -> Self {
+        Self::with_properties(graph, iter, vec![])
+    }
+
+    pub fn with_properties(graph: GraphHandle, iter: GetAllEdgesIterator, prop_ids: Vec<u32>) -> Self {
         FFIAllEdgesIter {
             graph,
             iter,
+            batch: FFIBatch::new(prop_ids),
         }
     }
 }
@@ -843,13 +976,11 @@ impl Iterator for FFIAllEdgesIter {
     type Item = FFIEdge;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut edge_handle = EdgeHandle::new();
-        let state = unsafe { get_all_edges_next(self.iter, &mut edge_handle as *mut EdgeHandle) };
-        if state == STATE_SUCCESS {
-            let e = FFIEdge::new(self.graph, edge_handle);
-            return Some(e);
-        }
-        None
+        let (graph, iter) = (self.graph, self.iter);
+        let (edge_handle, properties) = self.batch.next(
+            |out, count| unsafe { get_all_edges_next_batch(iter, out, count) },
+            |items, count, prop_id, p_out| unsafe { get_edge_property_batch(graph, items, count, prop_id, p_out) })?;
+        Some(FFIEdge::with_properties(graph, edge_handle, properties))
     }
 }
 
@@ -1028,6 +1159,7 @@ impl NativeProperty {
                     return ret.map(|x| Property::ListString(x));
                 }
             }
+            PropertyType::Invalid => {}
         }
         None
     }
@@ -1308,6 +1440,7 @@ impl PropertyType {
             PropertyType::FloatList => DataType::ListFloat,
             PropertyType::DoubleList => DataType::ListDouble,
             PropertyType::StringList => DataType::ListString,
+            PropertyType::Invalid => DataType::Unknown,
         }
     }
 }
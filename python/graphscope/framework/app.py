@@ -91,7 +91,8 @@ def not_compatible_for(*graph_types):
             terms = {
                 "arrow_property": graph.graph_type == graph_def_pb2.ARROW_PROPERTY,
                 "dynamic_property": graph.graph_type == graph_def_pb2.DYNAMIC_PROPERTY,
-                "arrow_projected": graph.graph_type == graph_def_pb2.ARROW_PROJECTED,
+                "arrow_projected": graph.graph_type
+                in (graph_def_pb2.ARROW_PROJECTED, graph_def_pb2.ARROW_FLATTENED),
                 "dynamic_projected": graph.graph_type
                 == graph_def_pb2.DYNAMIC_PROJECTED,
             }
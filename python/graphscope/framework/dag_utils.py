@@ -367,9 +367,24 @@ def report_graph(
                       DEG_BY_LOC,
                       IN_DEG_BY_LOC,
                       OUT_DEG_BY_LOC,
-                      NODES_BY_LOC)
-        node (str): node id, used as node id with 'NODE' report types. (optional)
-        edge (str): an edge with 'EDGE' report types. (optional)
+                      NODES_BY_LOC,
+                      HAS_NODES,
+                      NODES_DATA,
+                      DEG_BY_NODES,
+                      IN_DEG_BY_NODES,
+                      OUT_DEG_BY_NODES,
+                      NEIGHBORS_BY_NODES,
+                      SUCCS_BY_NODES,
+                      PREDS_BY_NODES,
+                      HAS_EDGES,
+                      ALL_NODES_DATA,
+                      ALL_DEG,
+                      ALL_IN_DEG,
+                      ALL_OUT_DEG)
+        node (str): node id, used as node id with 'NODE' report types,
+            or a json list of nodes with 'NODES' report types. (optional)
+        edge (str): an edge with 'EDGE' report types, or a json list of edges
+            with HAS_EDGES. (optional)
         fid (int): fragment id, with 'LOC' report types. (optional)
         lid (int): local id of node in grape_engine, with 'LOC; report types. (optional)
         key (str): edge key for MultiGraph or MultiDiGraph, with 'EDGE' report types. (optional)
@@ -431,6 +446,9 @@ def project_arrow_property_graph_to_simple(
     e_data_type=None,
     oid_type=None,
     vid_type=None,
+    v_prop=None,
+    e_prop=None,
+    inline_edata=False,
 ):
     """Project arrow property graph to a simple graph.
 
@@ -441,12 +459,25 @@ def project_arrow_property_graph_to_simple(
         v_prop_id (int): Property id of vertex used to project.
         e_label_id (int): Label id of edge used to project.
         e_prop_id (int): Property id of edge used to project.
+        v_prop (str): Name of the vertex property used as vertex data when
+            several labels are flattened, labels without it have default data.
+        e_prop (str): Name of the edge property used as edge data when
+            several labels are flattened, labels without it have default data.
+        inline_edata (bool): Whether to store the fixed-width edge data along
+            with the adjacency lists, which makes apps read edge data
+            sequentially at the cost of a copy of it. Defaults to False.
 
     Returns:
         An op to project `graph`, results in a simple ARROW_PROJECTED graph.
     """
     check_argument(graph.graph_type == graph_def_pb2.ARROW_PROPERTY)
     config = {}
+    if v_prop is not None:
+        config[types_pb2.V_PROP_KEY] = utils.s_to_attr(v_prop)
+    if e_prop is not None:
+        config[types_pb2.E_PROP_KEY] = utils.s_to_attr(e_prop)
+    if inline_edata:
+        config[types_pb2.INLINE_EDGE_DATA] = utils.b_to_attr(True)
     op = Operation(
         graph.session_id,
         types_pb2.PROJECT_TO_SIMPLE,
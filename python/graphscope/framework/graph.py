@@ -287,9 +287,11 @@ class GraphDAGNode(DAGNode, GraphInterface):
         """
         return self._graph_type
 
-    def _project_to_simple(self):
+    def _project_to_simple(self, v_prop=None, e_prop=None, inline_edata=False):
         check_argument(self.graph_type == graph_def_pb2.ARROW_PROPERTY)
-        op = dag_utils.project_arrow_property_graph_to_simple(self)
+        op = dag_utils.project_arrow_property_graph_to_simple(
+            self, v_prop=v_prop, e_prop=e_prop, inline_edata=inline_edata
+        )
         # construct dag node
         graph_dag_node = GraphDAGNode(self._session, op)
         graph_dag_node._base_graph = self
@@ -785,6 +787,8 @@ class Graph(GraphInterface):
             template = f"vineyard::ArrowFragment<{oid_type},{vid_type}>"
         elif self._graph_type == graph_def_pb2.ARROW_PROJECTED:
             template = f"gs::ArrowProjectedFragment<{oid_type},{vid_type},{vdata_type},{edata_type}>"
+        elif self._graph_type == graph_def_pb2.ARROW_FLATTENED:
+            template = f"gs::ArrowFlattenedFragment<{oid_type},{vid_type},{vdata_type},{edata_type}>"
         elif self._graph_type == graph_def_pb2.DYNAMIC_PROJECTED:
             template = f"gs::DynamicProjectedFragment<{vdata_type},{edata_type}>"
         else:
@@ -872,8 +876,14 @@ class Graph(GraphInterface):
         self._session = None
         return rlt
 
-    def _project_to_simple(self):
-        return self._session._wrapper(self._graph_node._project_to_simple())
+    def _project_to_simple(self, v_prop=None, e_prop=None, inline_edata=False):
+        graph_dag_node = self._graph_node._project_to_simple(
+            v_prop, e_prop, inline_edata
+        )
+        if self._schema.vertex_label_num > 1 or self._schema.edge_label_num > 1:
+            # multiple labels are flattened into one simple graph
+            graph_dag_node._graph_type = graph_def_pb2.ARROW_FLATTENED
+        return self._session._wrapper(graph_dag_node)
 
     def add_column(self, results, selector):
         return self._session._wrapper(self._graph_node.add_column(results, selector))
@@ -118,6 +118,8 @@ def graph_type_to_cpp_class(graph_type):
         return "vineyard::ArrowFragment"
     if graph_type == graph_def_pb2.ARROW_PROJECTED:
         return "gs::ArrowProjectedFragment"
+    if graph_type == graph_def_pb2.ARROW_FLATTENED:
+        return "gs::ArrowFlattenedFragment"
     return "null"
 
 
@@ -721,6 +721,40 @@ def k_core(G, k=None, core_number=None):
     return graphscope.k_core(G, k)
 
 
+@project_to_simple
+def core_number(G):
+    """Returns the core number for each vertex.
+
+    A k-core is a maximal subgraph that contains nodes of degree k or more.
+
+    The core number of a node is the largest value k of a k-core containing
+    that node.
+
+    Parameters
+    ----------
+    G : networkx graph
+      A graph or directed graph
+
+    Returns
+    -------
+    :class:`VertexDataContext`: A context with each vertex assigned with its
+    core number.
+
+    Notes
+    -----
+    For directed graphs the node degree is defined to be the
+    in-degree + out-degree. The k-core or k-shell of any k can be derived
+    from the core numbers, without running the app again.
+
+    References
+    ----------
+    .. [1] An O(m) Algorithm for Cores Decomposition of Networks
+       Vladimir Batagelj and Matjaz Zaversnik,  2003.
+       https://arxiv.org/abs/cs.DS/0310049
+    """
+    return AppAssets(algo="core_decomposition", context="vertex_data")(G)
+
+
 @project_to_simple
 def clustering(G):
     r"""Compute the clustering coefficient for nodes.
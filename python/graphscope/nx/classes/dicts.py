@@ -70,7 +70,7 @@ class NodeAttrDict(MutableMapping):
     def __init__(self, graph, node, data=None):
         self._graph = graph
         self._node = node
-        if data:
+        if data is not None:
             self.mapping = data
         else:
             self.mapping = graph.get_node_data(node)
@@ -24,10 +24,7 @@ from copy import deepcopy
 from networkx import freeze
 from networkx.classes.coreviews import AdjacencyView
 from networkx.classes.digraph import DiGraph as RefDiGraph
-from networkx.classes.reportviews import DiDegreeView
-from networkx.classes.reportviews import InDegreeView
 from networkx.classes.reportviews import InEdgeView
-from networkx.classes.reportviews import OutDegreeView
 from networkx.classes.reportviews import OutEdgeView
 
 from graphscope.client.session import get_default_session
@@ -36,6 +33,9 @@ from graphscope.framework.dag_utils import copy_graph
 from graphscope.framework.graph_schema import GraphSchema
 from graphscope.nx import NetworkXError
 from graphscope.nx.classes.graph import Graph
+from graphscope.nx.classes.reportviews import DiDegreeView
+from graphscope.nx.classes.reportviews import InDegreeView
+from graphscope.nx.classes.reportviews import OutDegreeView
 from graphscope.nx.convert import from_gs_graph
 from graphscope.nx.convert import to_nx_graph
 from graphscope.nx.utils.compat import patch_docstring
@@ -26,9 +26,7 @@ from networkx import freeze
 from networkx.classes.coreviews import AdjacencyView
 from networkx.classes.graph import Graph as RefGraph
 from networkx.classes.graphviews import generic_graph_view
-from networkx.classes.reportviews import DegreeView
 from networkx.classes.reportviews import EdgeView
-from networkx.classes.reportviews import NodeView
 
 from graphscope import nx
 from graphscope.client.session import get_default_session
@@ -40,6 +38,8 @@ from graphscope.framework.graph_schema import GraphSchema
 from graphscope.nx import NetworkXError
 from graphscope.nx.classes.dicts import AdjDict
 from graphscope.nx.classes.dicts import NodeDict
+from graphscope.nx.classes.reportviews import DegreeView
+from graphscope.nx.classes.reportviews import NodeView
 from graphscope.nx.convert import from_gs_graph
 from graphscope.nx.convert import to_nx_graph
 from graphscope.nx.utils.compat import patch_docstring
@@ -1457,10 +1457,15 @@ class Graph(_GraphBase):
             bunch = iter([nbunch])
         else:  # if nbunch is a sequence of nodes
 
-            def bunch_iter(nlist, adj):
+            def bunch_iter(nlist):
                 try:
-                    for n in nlist:
-                        if n in adj:
+                    nodes = list(nlist)
+                    for n in nodes:
+                        hash(n)
+                    # check the existence of all nodes in one round trip
+                    has_nodes = self._batch_get_by_nodes(nodes, types_pb2.HAS_NODES)
+                    for n in nodes:
+                        if has_nodes[n]:
                             yield n
                 except TypeError as e:
                     message = e.args[0]
@@ -1475,7 +1480,7 @@ class Graph(_GraphBase):
                     else:
                         raise
 
-            bunch = bunch_iter(nbunch, self._adj)
+            bunch = bunch_iter(nbunch)
         return bunch
 
     def copy(self, as_view=False):
@@ -1917,6 +1922,70 @@ class Graph(_GraphBase):
         )
         return op.eval()
 
+    @parse_ret_as_dict
+    def _batch_get_by_nodes(self, nodes, report_type, weight=None):
+        """Get reports of a list of nodes in one round trip.
+
+        Parameters
+        ----------
+        nodes: list
+            the nodes to report, or the edges with types_pb2.HAS_EDGES.
+        report_type:
+            the report type of report graph operation,
+                types_pb2.HAS_NODES: whether the nodes are in the graph,
+                types_pb2.HAS_EDGES: whether the edges are in the graph,
+                types_pb2.NODES_DATA: the data of nodes,
+                types_pb2.(OUT_|IN_)DEG_BY_NODES: the degree of nodes,
+                types_pb2.(NEIGHBORS|SUCCS|PREDS)_BY_NODES: the neighbors of
+                    nodes, as [[nbr, ...], [edge data, ...]].
+        weight: the edge attribute to get degree. if is None, default 1
+
+        Returns
+        -------
+        dict: node (or edge tuple) -> value, the value of a node not in graph is
+        None, or False with HAS_NODES and HAS_EDGES.
+
+        Examples
+        --------
+        >>> g = nx.Graph()
+        >>> g.add_edges_from([(0, 1), (0, 2)])
+        >>> g._batch_get_by_nodes([0, 1, 3], types_pb2.DEG_BY_NODES)
+        {0: 2.0, 1: 1.0, 3: None}
+        """
+        if report_type == types_pb2.HAS_EDGES:
+            op = dag_utils.report_graph(self, report_type, edge=json.dumps(nodes))
+        else:
+            op = dag_utils.report_graph(
+                self, report_type, node=json.dumps(nodes), key=weight
+            )
+        return op.eval()
+
+    @parse_ret_as_dict
+    def _get_all(self, report_type=types_pb2.ALL_NODES_DATA, weight=None):
+        """Get the data or degree of all nodes in one round trip.
+
+        Parameters
+        ----------
+        report_type:
+            the report type of report graph operation,
+                types_pb2.ALL_NODES_DATA: the data of all nodes,
+                types_pb2.ALL_(OUT_|IN_)DEG: the degree of all nodes.
+        weight: the edge attribute to get degree. if is None, default 1
+
+        Returns
+        -------
+        dict: node -> value
+
+        Examples
+        --------
+        >>> g = nx.Graph()
+        >>> g.add_edges_from([(0, 1), (0, 2)])
+        >>> g._get_all(types_pb2.ALL_DEG)
+        {0: 2.0, 1: 1.0, 2: 1.0}
+        """
+        op = dag_utils.report_graph(self, report_type, key=weight)
+        return op.eval()
+
     def _project_to_simple(self, v_prop=None, e_prop=None):
         """Project nx graph to a simple graph to run builtin alogorithms.
 
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+from networkx.classes import reportviews
+
+from graphscope.nx.classes.dicts import NodeAttrDict
+from graphscope.proto import types_pb2
+
+__all__ = [
+    "NodeView",
+    "NodeDataView",
+    "DiDegreeView",
+    "DegreeView",
+    "OutDegreeView",
+    "InDegreeView",
+]
+
+
+# NB: the views of networkx fetch the data or the neighbors of nodes one by
+# one, the views here fetch them of all nodes (or of the nbunch) in one round
+# trip, and keep the class names, thus the repr, of networkx.
+class NodeView(reportviews.NodeView):
+    __slots__ = ()
+
+    def __call__(self, data=False, default=None):
+        if data is False:
+            return self
+        return NodeDataView(self._nodes, data, default)
+
+    def data(self, data=True, default=None):
+        if data is False:
+            return self
+        return NodeDataView(self._nodes, data, default)
+
+
+class NodeDataView(reportviews.NodeDataView):
+    __slots__ = ()
+
+    def __iter__(self):
+        data = self._data
+        if data is False:
+            return iter(self._nodes)
+        graph = self._nodes._graph
+        all_data = graph._get_all(types_pb2.ALL_NODES_DATA)
+        if data is True:
+            return ((n, NodeAttrDict(graph, n, dd)) for n, dd in all_data.items())
+        return (
+            (n, dd[data] if data in dd else self._default) for n, dd in all_data.items()
+        )
+
+
+class DiDegreeView(reportviews.DiDegreeView):
+    # report types of a list of nodes and of all nodes
+    _by_nodes_type = types_pb2.DEG_BY_NODES
+    _all_type = types_pb2.ALL_DEG
+
+    def __getitem__(self, n):
+        degrees = self._graph._batch_get_by_nodes(
+            [n], self._by_nodes_type, self._weight
+        )
+        degree = degrees.get(n)
+        if degree is None:
+            raise KeyError(n)
+        return self._cast(degree)
+
+    def __iter__(self):
+        if self._nodes is self._succ:
+            degrees = self._graph._get_all(self._all_type, self._weight)
+            for n, degree in degrees.items():
+                yield (n, self._cast(degree))
+        else:
+            nodes = list(self._nodes)
+            degrees = self._graph._batch_get_by_nodes(
+                nodes, self._by_nodes_type, self._weight
+            )
+            for n in nodes:
+                yield (n, self._cast(degrees[n]))
+
+    def _cast(self, degree):
+        # the engine sums the degree in double
+        return int(degree) if self._weight is None else degree
+
+
+class DegreeView(DiDegreeView):
+    pass
+
+
+class OutDegreeView(DiDegreeView):
+    _by_nodes_type = types_pb2.OUT_DEG_BY_NODES
+    _all_type = types_pb2.ALL_OUT_DEG
+
+
+class InDegreeView(DiDegreeView):
+    _by_nodes_type = types_pb2.IN_DEG_BY_NODES
+    _all_type = types_pb2.ALL_IN_DEG
@@ -129,3 +129,55 @@ class TestBreadthLimitedSearch:
     def bfs_test_edges(self):
         edges = nx.builtin.bfs_edges(self.G, source=9, depth_limit=4)
         assert list(edges) == [(9, 8), (9, 10), (8, 7), (7, 2), (2, 1), (2, 3)]
+
+
+@pytest.mark.usefixtures("graphscope_session")
+class TestBFSMultiFragment:
+    """BFS trees are not unique, thus the results are checked against the
+    depths networkx finds: the reached nodes are the same, and every tree
+    edge goes from depth d to d + 1 along an edge of the graph."""
+
+    def setup_method(self):
+        import networkx
+
+        self.nxG = networkx.gnp_random_graph(300, 0.02, seed=42)
+        self.G = nx.Graph(self.nxG)
+        self.source = 0
+        self.depth_limit = 3
+        self.depths = networkx.single_source_shortest_path_length(
+            self.nxG, self.source, cutoff=self.depth_limit
+        )
+
+    def teardown_method(self):
+        del self.G
+        del self.nxG
+
+    def check_tree_edges(self, edges):
+        reached = {self.source}
+        for u, v in edges:
+            assert self.nxG.has_edge(u, v)
+            assert self.depths[v] == self.depths[u] + 1
+            reached.add(v)
+        # every reached node except the source has exactly one tree edge
+        assert len(edges) == len(reached) - 1
+        assert reached == set(self.depths.keys())
+
+    def test_bfs_edges(self):
+        edges = nx.builtin.bfs_edges(
+            self.G, source=self.source, depth_limit=self.depth_limit
+        )
+        self.check_tree_edges([tuple(e) for e in edges])
+
+    def test_bfs_predecessors(self):
+        ctx = nx.builtin.bfs_predecessors(
+            self.G, source=self.source, depth_limit=self.depth_limit
+        )
+        df = ctx.to_dataframe({"r": "r"})
+        self.check_tree_edges(list(zip(df["Col 1"], df["Col 0"])))
+
+    def test_bfs_successors(self):
+        ctx = nx.builtin.bfs_successors(
+            self.G, source=self.source, depth_limit=self.depth_limit
+        )
+        df = ctx.to_dataframe({"r": "r"})
+        self.check_tree_edges(list(zip(df["Col 0"], df["Col 1"])))
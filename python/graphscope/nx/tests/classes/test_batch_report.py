@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import networkx
+import pytest
+
+from graphscope import nx
+from graphscope.proto import types_pb2
+
+edges = [(0, 1, {"w": 2.0}), (0, 2, {}), (1, 3, {"w": 0.5}), (3, 3, {"w": 3.0})]
+nodes = [(0, {"foo": "bar"}), (1, {}), (2, {"foo": 1}), (3, {}), (4, {})]
+
+
+@pytest.mark.usefixtures("graphscope_session")
+class TestBatchReport:
+    Graph = nx.Graph
+    RefGraph = networkx.Graph
+
+    def setup_method(self):
+        self.G = self.Graph()
+        self.G.add_nodes_from(nodes)
+        self.G.add_edges_from(edges)
+        self.R = self.RefGraph()
+        self.R.add_nodes_from(nodes)
+        self.R.add_edges_from(edges)
+
+    def test_degree(self):
+        # the self loop on 3 is counted twice
+        assert dict(self.G.degree) == dict(self.R.degree)
+        assert dict(self.G.degree(weight="w")) == dict(self.R.degree(weight="w"))
+        assert self.G.degree[3] == self.R.degree[3]
+        assert self.G.degree(3, weight="w") == self.R.degree(3, weight="w")
+
+    def test_degree_nbunch(self):
+        # absent nodes are skipped, the order of nbunch is kept
+        nbunch = [3, 100, 0, "x", 4]
+        assert list(self.G.degree(nbunch)) == list(self.R.degree(nbunch))
+        assert list(self.G.degree(nbunch, weight="w")) == list(
+            self.R.degree(nbunch, weight="w")
+        )
+        assert list(self.G.degree([100, 101])) == []
+        with pytest.raises(KeyError):
+            self.G.degree[100]
+
+    def test_nbunch_iter(self):
+        assert list(self.G.nbunch_iter([4, 100, 1, (0, 1)])) == [4, 1]
+        assert list(self.G.nbunch_iter([])) == []
+        with pytest.raises(nx.NetworkXError):
+            list(self.G.nbunch_iter([[0]]))
+
+    def test_nodes_data(self):
+        assert dict(self.G.nodes(data=True)) == dict(self.R.nodes(data=True))
+        assert dict(self.G.nodes(data="foo")) == dict(self.R.nodes(data="foo"))
+        assert dict(self.G.nodes.data("foo", default=0)) == dict(
+            self.R.nodes.data("foo", default=0)
+        )
+        # the data dicts write through to the graph
+        for n, dd in self.G.nodes(data=True):
+            if n == 1:
+                dd["foo"] = "baz"
+        assert self.G.nodes[1]["foo"] == "baz"
+
+    def test_batch_get_by_nodes(self):
+        G = self.G
+        ret = G._batch_get_by_nodes([0, 100, 3], types_pb2.HAS_NODES)
+        assert ret == {0: True, 100: False, 3: True}
+        ret = G._batch_get_by_nodes([0, 100], types_pb2.NODES_DATA)
+        assert ret == {0: {"foo": "bar"}, 100: None}
+        ret = G._batch_get_by_nodes([1, 100], types_pb2.DEG_BY_NODES)
+        assert ret == {1: 2, 100: None}
+        assert G._batch_get_by_nodes([], types_pb2.DEG_BY_NODES) == {}
+
+    def test_has_edges(self):
+        queries = [(0, 1), (1, 0), (0, 3), (3, 3), (0, 100), (100, 101)]
+        ret = self.G._batch_get_by_nodes(queries, types_pb2.HAS_EDGES)
+        assert ret == {e: self.R.has_edge(*e) for e in queries}
+
+
+@pytest.mark.usefixtures("graphscope_session")
+class TestDiBatchReport(TestBatchReport):
+    Graph = nx.DiGraph
+    RefGraph = networkx.DiGraph
+
+    def test_in_out_degree(self):
+        nbunch = [3, 100, 0]
+        for weight in (None, "w"):
+            assert dict(self.G.in_degree(weight=weight)) == dict(
+                self.R.in_degree(weight=weight)
+            )
+            assert dict(self.G.out_degree(weight=weight)) == dict(
+                self.R.out_degree(weight=weight)
+            )
+            assert list(self.G.in_degree(nbunch, weight=weight)) == list(
+                self.R.in_degree(nbunch, weight=weight)
+            )
+            assert list(self.G.out_degree(nbunch, weight=weight)) == list(
+                self.R.out_degree(nbunch, weight=weight)
+            )
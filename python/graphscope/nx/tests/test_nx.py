@@ -17,6 +17,7 @@
 #
 
 import os
+import threading
 
 import pytest
 
@@ -562,6 +563,66 @@ class TestDiGraphProjectTest(TestGraphProjectTest):
         cls.g.add_node(1, vdata_int=123)
 
 
+@pytest.mark.usefixtures("graphscope_session")
+class TestConcurrentCommands(object):
+    """Reports run on the read lane of the engine while apps run."""
+
+    def run_concurrently(self, target, check):
+        errors = []
+
+        def run():
+            try:
+                for _ in range(3):
+                    target()
+            except Exception as e:  # pylint: disable=broad-except
+                errors.append(e)
+
+        t = threading.Thread(target=run)
+        t.start()
+        checked = 0
+        while t.is_alive() or checked == 0:
+            check()
+            checked += 1
+        t.join()
+        assert not errors
+
+    def test_report_on_other_graph_while_running_app(self):
+        g1 = nx.complete_graph(200)
+        g2 = nx.path_graph(100)
+
+        def check():
+            assert g2.number_of_nodes() == 100
+            assert g2.degree(0) == 1
+            assert g2.has_edge(98, 99)
+
+        self.run_concurrently(lambda: nx.builtin.pagerank(g1), check)
+
+    def test_report_on_source_while_running_app_on_projection(self):
+        # the app runs on the projection of g, which shares data with g
+        g = nx.complete_graph(200)
+
+        def check():
+            assert g.number_of_nodes() == 200
+            assert g.number_of_edges() == 200 * 199 // 2
+            assert g.degree(0) == 199
+
+        self.run_concurrently(lambda: nx.builtin.degree_centrality(g), check)
+
+    def test_modify_graph_while_reading_context(self):
+        g = nx.path_graph(100)
+        ctx = nx.builtin.core_number(g)
+        expected = ctx.to_numpy("r")
+
+        def modify():
+            g.add_edge(0, 50)
+            g.remove_edge(0, 50)
+
+        def check():
+            assert (ctx.to_numpy("r") == expected).all()
+
+        self.run_concurrently(modify, check)
+
+
 @pytest.mark.usefixtures("graphscope_session")
 class TestImportNetworkxModuleWithSession(object):
     @classmethod
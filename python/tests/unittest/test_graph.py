@@ -87,6 +87,20 @@ def test_project_to_simple_with_id(p2p_property_graph, sssp_result):
     assert np.allclose(r, sssp_result["directed"])
 
 
+def test_project_to_simple_with_inline_edata(p2p_property_graph, sssp_result):
+    pg = p2p_property_graph.project(
+        vertices={"person": ["id"]}, edges={"knows": ["dist"]}
+    )
+    ctx = sssp(pg._project_to_simple(inline_edata=True), src=6)
+    r = (
+        ctx.to_dataframe({"node": "v.id", "r": "r"})
+        .sort_values(by=["node"])
+        .to_numpy(dtype=float)
+    )
+    r[r == 1.7976931348623157e308] = float("inf")  # replace limit::max with inf
+    assert np.allclose(r, sssp_result["directed"])
+
+
 def test_error_label_on_project_to_simple(arrow_property_graph):
     g = arrow_property_graph
     # g has vertex labels: v0, v1, v2, v3, each label has a property: weight
@@ -124,6 +138,51 @@ def test_error_relationship_on_project_to_simple(arrow_modern_graph):
         pg._project_to_simple()
 
 
+def _sssp_of_modern_graph(pg):
+    ctx = sssp(pg, src=1)
+    r = (
+        ctx.to_dataframe({"node": "v.id", "r": "r"})
+        .sort_values(by=["node"])
+        .to_numpy(dtype=float)
+    )
+    r[r == 1.7976931348623157e308] = float("inf")  # replace limit::max with inf
+    return r
+
+
+def test_flatten_to_simple(arrow_modern_graph):
+    g = arrow_modern_graph
+    # person and software are merged, as well as knows and created
+    pg = g.project(
+        vertices={"person": [], "software": []},
+        edges={"knows": ["weight"], "created": ["weight"]},
+    )
+    expected = [[1, 0.0], [2, 0.5], [3, 0.4], [4, 1.0], [5, 2.0], [6, np.inf]]
+    assert np.allclose(_sssp_of_modern_graph(pg), expected)
+
+    # labels without property have default data
+    pg = g.project(
+        vertices={"person": [], "software": []},
+        edges={"knows": ["weight"], "created": []},
+    )
+    expected = [[1, 0.0], [2, 0.5], [3, 0.0], [4, 1.0], [5, 1.0], [6, np.inf]]
+    assert np.allclose(_sssp_of_modern_graph(pg), expected)
+
+
+def test_flatten_to_simple_with_selected_property(arrow_modern_graph):
+    g = arrow_modern_graph
+    pg = g.project(
+        vertices={"person": ["name", "age"], "software": ["name", "lang"]},
+        edges={"knows": ["weight"], "created": ["weight"]},
+    )
+    with pytest.raises(Exception, match="more than one property"):
+        pg._project_to_simple()
+    # software has no age
+    sg = pg._project_to_simple(v_prop="age")
+    assert sg.graph_type == graph_def_pb2.ARROW_FLATTENED
+    expected = [[1, 0.0], [2, 0.5], [3, 0.4], [4, 1.0], [5, 2.0], [6, np.inf]]
+    assert np.allclose(_sssp_of_modern_graph(sg), expected)
+
+
 def test_unload(graphscope_session):
     graph = graphscope_session.g()
     prefix = os.path.expandvars("${GS_TEST_DIR}/property")